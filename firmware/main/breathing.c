@@ -0,0 +1,228 @@
+/**
+ * @file breathing.c
+ * @brief Breathing-rate estimation from a decimated CSI amplitude branch
+ */
+
+#include "breathing.h"
+#include <math.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Anti-alias cutoff as a fraction of the decimated rate (2.5 Hz at 10 Hz)
+#define LOWPASS_CUTOFF_RATIO 0.25f
+
+// Q of the two sections of a 4th-order Butterworth low-pass
+static const float s_butterworth_q[2] = { 0.54119610f, 1.30656296f };
+
+// Frequency grid (breaths per minute). The peak is searched in the
+// breathing band; quality compares it with a wider reference band, so
+// broadband motion up to 1 Hz lowers it
+#define GRID_STEP_BPM 0.5f
+#define REF_MIN_BPM 3.0f
+#define REF_MAX_BPM 60.0f
+#define GRID_BINS ((int)((REF_MAX_BPM - REF_MIN_BPM) / GRID_STEP_BPM) + 1)
+#define PEAK_FIRST_BIN ((int)((BREATHING_MIN_BPM - REF_MIN_BPM) / GRID_STEP_BPM))
+#define PEAK_LAST_BIN ((int)((BREATHING_MAX_BPM - REF_MIN_BPM) / GRID_STEP_BPM))
+
+// Q8.8 storage of amplitudes
+#define Q8_8_SCALE 256.0f
+
+static void biquad_lowpass(breathing_biquad_t *bq, float cutoff_hz, float rate_hz, float q)
+{
+    float k = tanf((float)M_PI * cutoff_hz / rate_hz);
+    float norm = 1.0f / (1.0f + k / q + k * k);
+    bq->b0 = k * k * norm;
+    bq->b1 = 2.0f * bq->b0;
+    bq->b2 = bq->b0;
+    bq->a1 = 2.0f * (k * k - 1.0f) * norm;
+    bq->a2 = (1.0f - k / q + k * k) * norm;
+    bq->z1 = 0.0f;
+    bq->z2 = 0.0f;
+}
+
+/**
+ * @brief Set the state to the steady state for a constant input
+ *
+ * Avoids a start-up transient from the large DC amplitude.
+ */
+static void biquad_prime(breathing_biquad_t *bq, float x)
+{
+    bq->z1 = x * (1.0f - bq->b0);
+    bq->z2 = x * (bq->b2 - bq->a2);
+}
+
+static float biquad_run(breathing_biquad_t *bq, float x)
+{
+    float y = bq->b0 * x + bq->z1;
+    bq->z1 = bq->b1 * x - bq->a1 * y + bq->z2;
+    bq->z2 = bq->b2 * x - bq->a2 * y;
+    return y;
+}
+
+static uint16_t to_q8_8(float value)
+{
+    float q = value * Q8_8_SCALE + 0.5f;
+    if (q < 0.0f) return 0;
+    if (q > 65535.0f) return 65535;
+    return (uint16_t)q;
+}
+
+void breathing_init(breathing_estimator_t *est, uint16_t *storage, int capacity,
+                    float input_rate_hz, int decimation)
+{
+    memset(est, 0, sizeof(*est));
+    est->ring = storage;
+    est->capacity = capacity;
+    est->decimation = decimation > 0 ? decimation : 1;
+    est->rate_hz = input_rate_hz / est->decimation;
+
+    for (int i = 0; i < 2; i++) {
+        biquad_lowpass(&est->lowpass[i], est->rate_hz * LOWPASS_CUTOFF_RATIO, input_rate_hz,
+                       s_butterworth_q[i]);
+    }
+}
+
+void breathing_reset(breathing_estimator_t *est)
+{
+    est->phase = 0;
+    est->primed = false;
+    est->head = 0;
+    est->count = 0;
+}
+
+void breathing_push(breathing_estimator_t *est, float value)
+{
+    if (!est->primed) {
+        biquad_prime(&est->lowpass[0], value);
+        biquad_prime(&est->lowpass[1], value);
+        est->primed = true;
+    }
+
+    // The filter runs at the input rate; only every decimation-th output is kept
+    float y = biquad_run(&est->lowpass[1], biquad_run(&est->lowpass[0], value));
+    if (++est->phase < est->decimation) {
+        return;
+    }
+    est->phase = 0;
+
+    if (est->capacity <= 0) {
+        return;
+    }
+    est->ring[est->head] = to_q8_8(y);
+    est->head = (est->head + 1) % est->capacity;
+    if (est->count < est->capacity) {
+        est->count++;
+    }
+}
+
+float breathing_sample_mean(const float *amplitude, int num_subcarriers)
+{
+    float sum = 0.0f;
+    for (int s = 0; s < num_subcarriers; s++) {
+        sum += amplitude[s];
+    }
+    return num_subcarriers > 0 ? sum / num_subcarriers : 0.0f;
+}
+
+float breathing_history_seconds(const breathing_estimator_t *est)
+{
+    return est->rate_hz > 0.0f ? est->count / est->rate_hz : 0.0f;
+}
+
+bool breathing_estimate(const breathing_estimator_t *est, int min_samples,
+                        breathing_estimate_t *out)
+{
+    const int n = est->count;
+    memset(out, 0, sizeof(*out));
+    if (n < min_samples || n < 3) {
+        return false;
+    }
+    const int oldest = (est->head - n + est->capacity) % est->capacity;
+
+    // Least-squares line through the history (removes DC and slow drift)
+    float mean = 0.0f, cov = 0.0f;
+    const float t_mid = (n - 1) * 0.5f;
+    for (int t = 0, i = oldest; t < n; t++, i = (i + 1 == est->capacity ? 0 : i + 1)) {
+        float x = est->ring[i] / Q8_8_SCALE;
+        mean += x;
+        cov += (t - t_mid) * x;
+    }
+    mean /= n;
+    const float slope = cov / ((float)n * ((float)n * n - 1.0f) / 12.0f);
+
+    // Goertzel at every grid frequency, one pass over the history
+    float coeff[GRID_BINS], s1[GRID_BINS], s2[GRID_BINS];
+    for (int k = 0; k < GRID_BINS; k++) {
+        float hz = (REF_MIN_BPM + k * GRID_STEP_BPM) / 60.0f;
+        coeff[k] = 2.0f * cosf(2.0f * (float)M_PI * hz / est->rate_hz);
+        s1[k] = 0.0f;
+        s2[k] = 0.0f;
+    }
+    const float hann_step = 2.0f * (float)M_PI / (n - 1);
+    for (int t = 0, i = oldest; t < n; t++, i = (i + 1 == est->capacity ? 0 : i + 1)) {
+        float x = est->ring[i] / Q8_8_SCALE - mean - slope * (t - t_mid);
+        x *= 0.5f - 0.5f * cosf(hann_step * t);
+        for (int k = 0; k < GRID_BINS; k++) {
+            float s0 = x + coeff[k] * s1[k] - s2[k];
+            s2[k] = s1[k];
+            s1[k] = s0;
+        }
+    }
+
+    // Magnitude spectrum; s1 is reused for it
+    float total = 0.0f;
+    int peak = PEAK_FIRST_BIN;
+    for (int k = 0; k < GRID_BINS; k++) {
+        float power = s1[k] * s1[k] + s2[k] * s2[k] - coeff[k] * s1[k] * s2[k];
+        power = fmaxf(power, 0.0f);
+        total += power;
+        s1[k] = sqrtf(power);
+        if (k >= PEAK_FIRST_BIN && k <= PEAK_LAST_BIN && s1[k] > s1[peak]) {
+            peak = k;
+        }
+    }
+    if (total <= 0.0f) {
+        return true;  // Flat signal: no rate, zero quality
+    }
+
+    // Still rising at a band edge: the strongest component is outside the
+    // breathing band (drift below, motion above)
+    if ((peak == PEAK_FIRST_BIN && s1[peak - 1] >= s1[peak]) ||
+        (peak == PEAK_LAST_BIN && s1[peak + 1] >= s1[peak])) {
+        out->rate_bpm = REF_MIN_BPM + peak * GRID_STEP_BPM;
+        return true;
+    }
+
+    // Parabolic interpolation between grid points
+    float offset = 0.0f;
+    if (peak > PEAK_FIRST_BIN && peak < PEAK_LAST_BIN) {
+        float denom = s1[peak - 1] - 2.0f * s1[peak] + s1[peak + 1];
+        if (denom < 0.0f) {
+            offset = fminf(fmaxf(0.5f * (s1[peak - 1] - s1[peak + 1]) / denom, -0.5f), 0.5f);
+        }
+    }
+    out->rate_bpm = REF_MIN_BPM + (peak + offset) * GRID_STEP_BPM;
+
+    // Share of reference band power within one DFT bin of the peak (most of
+    // a Hann main lobe), rescaled so that the share white noise would have
+    // maps to 0
+    float lobe_bpm = 60.0f * est->rate_hz / n;
+    int lobe = (int)ceilf(lobe_bpm / GRID_STEP_BPM);
+    float in_lobe = 0.0f;
+    int lobe_bins = 0;
+    for (int k = peak - lobe; k <= peak + lobe; k++) {
+        if (k >= 0 && k < GRID_BINS) {
+            in_lobe += s1[k] * s1[k];
+            lobe_bins++;
+        }
+    }
+    float share = in_lobe / total;
+    float noise_share = (float)lobe_bins / GRID_BINS;
+    out->quality = noise_share < 1.0f
+        ? fminf(fmaxf((share - noise_share) / (1.0f - noise_share), 0.0f), 1.0f)
+        : 0.0f;
+    return true;
+}
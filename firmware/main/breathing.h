@@ -0,0 +1,127 @@
+/**
+ * @file breathing.h
+ * @brief Breathing-rate estimation from a decimated CSI amplitude branch
+ *
+ * A still person's breathing modulates CSI amplitude at 0.1-0.5 Hz (6-30
+ * breaths per minute). Resolving that needs 20-30 s of signal, far longer
+ * than the 500 ms pose window, but only a few Hz of bandwidth. So this
+ * branch keeps its own long, compact history:
+ *
+ *   mean amplitude per CSI sample (100 Hz)
+ *     -> 4th-order Butterworth low-pass (anti-alias)
+ *     -> keep every decimation-th sample (~10 Hz)
+ *     -> ring of uint16 Q8.8 samples (30 s = 600 bytes)
+ *
+ * breathing_estimate() detrends the ring, applies a Hann window and scans
+ * 3-60 bpm with Goertzel filters on a fine frequency grid (no scratch
+ * buffer, no FFT size constraints). The peak is searched in the breathing
+ * band and refined by parabolic interpolation. Quality is the share of the
+ * 3-60 bpm power in the peak, rescaled so white noise scores near 0: a
+ * clean periodic signal scores above 0.8; noise and broadband motion stay
+ * mostly below 0.4.
+ *
+ * The ring is the caller's (breathing_init()), sized with BREATHING_RING_BYTES().
+ */
+
+#ifndef BREATHING_H
+#define BREATHING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Rate of the decimated branch (Hz)
+#define BREATHING_RATE_HZ 10
+
+// Band searched for the breathing peak (breaths per minute)
+#define BREATHING_MIN_BPM 6.0f
+#define BREATHING_MAX_BPM 30.0f
+
+// Ring storage for num_samples decimated samples (constant expression)
+#define BREATHING_RING_BYTES(num_samples) ((num_samples) * sizeof(uint16_t))
+
+/**
+ * @brief One biquad section (transposed direct form II)
+ */
+typedef struct {
+    float b0, b1, b2, a1, a2;
+    float z1, z2;
+} breathing_biquad_t;
+
+/**
+ * @brief Decimating estimator state
+ */
+typedef struct {
+    breathing_biquad_t lowpass[2];     // Anti-alias filter, cascaded
+    int decimation;                    // Input samples per ring sample
+    int phase;                         // Input samples since the last ring sample
+    bool primed;                       // Filter state initialized from the first input
+    float rate_hz;                     // Rate of the ring samples
+
+    uint16_t *ring;                    // Q8.8 amplitudes, oldest overwritten first
+    int capacity;                      // Ring size in samples
+    int head;                          // Next slot to be written
+    int count;                         // Valid samples
+} breathing_estimator_t;
+
+/**
+ * @brief Result of one estimate
+ */
+typedef struct {
+    float rate_bpm;            // Breathing rate (breaths per minute)
+    float quality;             // Peak prominence in the band [0.0, 1.0]
+} breathing_estimate_t;
+
+/**
+ * @brief Initialize the estimator
+ *
+ * @param est           Estimator
+ * @param storage       BREATHING_RING_BYTES(capacity) bytes
+ * @param capacity      Ring size in decimated samples (window length x rate)
+ * @param input_rate_hz Rate of breathing_push() calls (CSI sampling rate)
+ * @param decimation    Input samples per ring sample (input_rate_hz / BREATHING_RATE_HZ)
+ */
+void breathing_init(breathing_estimator_t *est, uint16_t *storage, int capacity,
+                    float input_rate_hz, int decimation);
+
+/**
+ * @brief Clear history and filter state
+ */
+void breathing_reset(breathing_estimator_t *est);
+
+/**
+ * @brief Feed one input sample (e.g. mean amplitude over subcarriers)
+ *
+ * A few multiply-adds per call; every decimation-th call stores a sample.
+ */
+void breathing_push(breathing_estimator_t *est, float value);
+
+/**
+ * @brief Mean amplitude over the first num_subcarriers entries of a sample
+ */
+float breathing_sample_mean(const float *amplitude, int num_subcarriers);
+
+/**
+ * @brief Seconds of decimated history currently held
+ */
+float breathing_history_seconds(const breathing_estimator_t *est);
+
+/**
+ * @brief Estimate the breathing rate from the history
+ *
+ * @param est         Estimator
+ * @param min_samples Fewest decimated samples to estimate from
+ * @param out         Output estimate
+ * @return false if there is not enough history yet (out zeroed)
+ */
+bool breathing_estimate(const breathing_estimator_t *est, int min_samples,
+                        breathing_estimate_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BREATHING_H
@@ -0,0 +1,364 @@
+/**
+ * @file console_cmd.c
+ * @brief Runtime settings and the line-based command parser of the console
+ */
+
+#include "console_cmd.h"
+#include "pose_smoother.h"
+#include <ctype.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef enum {
+    KEY_INT,
+    KEY_FLOAT,
+    KEY_OUTPUT,
+} key_kind_t;
+
+/**
+ * @brief One setting: where it lives in console_settings_t and its range
+ */
+typedef struct {
+    const char *name;
+    key_kind_t kind;
+    size_t offset;
+    float min;
+    float max;
+    const char *help;
+} console_key_t;
+
+#define TUNING(field) (offsetof(console_settings_t, tuning) + offsetof(pose_tuning_t, field))
+
+static const console_key_t s_keys[] = {
+    { "empty_amp_std", KEY_FLOAT, TUNING(empty_amp_std), 0.01f, 100.0f,
+      "amplitude std below which the room is empty (0.01-100)" },
+    { "moving_phase_var", KEY_FLOAT, TUNING(moving_phase_var), 0.01f, 100.0f,
+      "phase variance of full motion (0.01-100)" },
+    { "moving_level", KEY_FLOAT, TUNING(moving_level), 0.0f, 1.0f,
+      "motion level above which a person is moving (0-1)" },
+    { "smoothing_lag", KEY_INT, TUNING(smoothing_lag), -1, POSE_SMOOTHER_MAX_LAG,
+      "smoother lag in windows, -1 disables smoothing (-1-8)" },
+    { "smoothing_stay", KEY_INT, TUNING(smoothing_stay_permille), 500, 999,
+      "probability that the class stays, per mille (500-999)" },
+    { "gate_refresh", KEY_INT, TUNING(gate_refresh), 1, 120,
+      "recompute at least every N windows, 1 disables gating (1-120)" },
+    { "event_threshold", KEY_FLOAT, TUNING(event_threshold), 1.0f, 1000.0f,
+      "CUSUM threshold of the event detector (1-1000)" },
+    { "output", KEY_OUTPUT, offsetof(console_settings_t, output), 0, 0,
+      "serial streams: none or a comma list of csi, json, binary" },
+    { "decimation", KEY_INT, offsetof(console_settings_t, decimation), 1, 100,
+      "print one result in N (1-100)" },
+    { "traffic_hz", KEY_INT, offsetof(console_settings_t, traffic_hz), CONSOLE_TRAFFIC_MIN_HZ,
+      CONSOLE_TRAFFIC_MAX_HZ, "packets per second sent to the gateway (1-100)" },
+};
+
+#define NUM_KEYS ((int)(sizeof(s_keys) / sizeof(s_keys[0])))
+
+static const struct {
+    const char *name;
+    console_cmd_t cmd;
+    int min_args;              // Arguments after the command word
+    int max_args;
+} s_commands[] = {
+    { "help", CONSOLE_CMD_HELP, 0, 0 },
+    { "get", CONSOLE_CMD_GET, 0, 1 },
+    { "set", CONSOLE_CMD_SET, 2, 2 },
+    { "save", CONSOLE_CMD_SAVE, 0, 0 },
+    { "load", CONSOLE_CMD_LOAD, 0, 0 },
+    { "defaults", CONSOLE_CMD_DEFAULTS, 0, 0 },
+    { "stats", CONSOLE_CMD_STATS, 0, 0 },
+    { "hist", CONSOLE_CMD_HIST, 0, 0 },
+};
+
+static const struct {
+    const char *name;
+    int bit;
+} s_outputs[] = {
+    { "csi", CONSOLE_OUTPUT_CSI },
+    { "json", CONSOLE_OUTPUT_JSON },
+    { "binary", CONSOLE_OUTPUT_BINARY },
+};
+
+#define NUM_OUTPUTS ((int)(sizeof(s_outputs) / sizeof(s_outputs[0])))
+
+bool console_line_push(console_line_t *line, char c)
+{
+    // The overflowed line was reported, start afresh
+    if (line->overflow && line->len == 0) {
+        line->overflow = false;
+    }
+    if (c == '\r' || c == '\n') {
+        // CRLF and blank lines end nothing
+        if (line->len == 0 && !line->overflow) {
+            return false;
+        }
+        line->buf[line->len] = '\0';
+        line->len = 0;
+        return true;
+    }
+    if (line->overflow) {
+        return false;
+    }
+    if (c == '\b' || c == 0x7f) {
+        if (line->len > 0) {
+            line->len--;
+        }
+        return false;
+    }
+    if (line->len >= CONSOLE_LINE_MAX) {
+        line->overflow = true;
+        return false;
+    }
+    line->buf[line->len++] = c;
+    return false;
+}
+
+static int find_key(const char *name)
+{
+    for (int k = 0; k < NUM_KEYS; k++) {
+        if (strcmp(s_keys[k].name, name) == 0) {
+            return k;
+        }
+    }
+    return -1;
+}
+
+esp_err_t console_parse(char *line, console_command_t *cmd)
+{
+    char *args[4];
+    int argc = 0;
+    char *p = line;
+
+    while (*p != '\0') {
+        while (isspace((unsigned char)*p)) {
+            *p++ = '\0';
+        }
+        if (*p == '\0') {
+            break;
+        }
+        if (argc == (int)(sizeof(args) / sizeof(args[0]))) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        args[argc++] = p;
+        while (*p != '\0' && !isspace((unsigned char)*p)) {
+            p++;
+        }
+    }
+    if (argc == 0) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    for (size_t c = 0; c < sizeof(s_commands) / sizeof(s_commands[0]); c++) {
+        if (strcmp(s_commands[c].name, args[0]) != 0) {
+            continue;
+        }
+        if (argc - 1 < s_commands[c].min_args || argc - 1 > s_commands[c].max_args) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        cmd->cmd = s_commands[c].cmd;
+        cmd->key = -1;
+        cmd->value = NULL;
+        if (argc > 1) {
+            cmd->key = find_key(args[1]);
+            if (cmd->key < 0) {
+                return ESP_ERR_NOT_FOUND;
+            }
+        }
+        if (argc > 2) {
+            cmd->value = args[2];
+        }
+        return ESP_OK;
+    }
+    return ESP_ERR_NOT_FOUND;
+}
+
+int console_key_count(void)
+{
+    return NUM_KEYS;
+}
+
+const char *console_key_name(int key)
+{
+    return key >= 0 && key < NUM_KEYS ? s_keys[key].name : NULL;
+}
+
+const char *console_key_help(int key)
+{
+    return key >= 0 && key < NUM_KEYS ? s_keys[key].help : NULL;
+}
+
+/**
+ * @brief Parse an output list ("none" or e.g. "json,binary")
+ */
+static bool parse_output(const char *value, int *bits)
+{
+    if (strcmp(value, "none") == 0) {
+        *bits = 0;
+        return true;
+    }
+    int out = 0;
+    const char *p = value;
+    while (true) {
+        size_t len = strcspn(p, ",");
+        int o = 0;
+        while (o < NUM_OUTPUTS &&
+               (strlen(s_outputs[o].name) != len || strncmp(s_outputs[o].name, p, len) != 0)) {
+            o++;
+        }
+        if (o == NUM_OUTPUTS) {
+            return false;
+        }
+        out |= s_outputs[o].bit;
+        if (p[len] == '\0') {
+            break;
+        }
+        p += len + 1;
+    }
+    *bits = out;
+    return true;
+}
+
+esp_err_t console_settings_set(console_settings_t *settings, int key, const char *value)
+{
+    if (key < 0 || key >= NUM_KEYS) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    const console_key_t *k = &s_keys[key];
+    void *field = (char *)settings + k->offset;
+    char *end = NULL;
+
+    errno = 0;
+    switch (k->kind) {
+        case KEY_INT: {
+            long v = strtol(value, &end, 10);
+            if (end == value || *end != '\0' || errno != 0 || v < (long)k->min ||
+                v > (long)k->max) {
+                return ESP_ERR_INVALID_ARG;
+            }
+            *(int *)field = (int)v;
+            return ESP_OK;
+        }
+        case KEY_FLOAT: {
+            float v = strtof(value, &end);
+            if (end == value || *end != '\0' || errno != 0 || !(v >= k->min && v <= k->max)) {
+                return ESP_ERR_INVALID_ARG;
+            }
+            *(float *)field = v;
+            return ESP_OK;
+        }
+        case KEY_OUTPUT: {
+            int bits;
+            if (!parse_output(value, &bits)) {
+                return ESP_ERR_INVALID_ARG;
+            }
+            *(int *)field = bits;
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_INVALID_ARG;
+}
+
+/**
+ * @brief Format one value; output lists are quoted when quote is set
+ */
+static int format_value(const console_settings_t *settings, int key, bool quote, char *buf,
+                        size_t capacity)
+{
+    const console_key_t *k = &s_keys[key];
+    const void *field = (const char *)settings + k->offset;
+
+    switch (k->kind) {
+        case KEY_INT:
+            return snprintf(buf, capacity, "%d", *(const int *)field);
+        case KEY_FLOAT:
+            return snprintf(buf, capacity, "%g", (double)*(const float *)field);
+        case KEY_OUTPUT: {
+            int bits = *(const int *)field;
+            int len = snprintf(buf, capacity, "%s%s", quote ? "\"" : "", bits == 0 ? "none" : "");
+            for (int o = 0; o < NUM_OUTPUTS; o++) {
+                if (bits & s_outputs[o].bit) {
+                    bits &= ~s_outputs[o].bit;
+                    len += snprintf(buf + len, (size_t)len < capacity ? capacity - len : 0, "%s%s",
+                                    s_outputs[o].name, bits != 0 ? "," : "");
+                }
+            }
+            len += snprintf(buf + len, (size_t)len < capacity ? capacity - len : 0, "%s",
+                            quote ? "\"" : "");
+            return len;
+        }
+    }
+    return 0;
+}
+
+size_t console_settings_json(const console_settings_t *settings, int key, char *buf,
+                             size_t capacity)
+{
+    size_t len = 0;
+    if (capacity == 0) {
+        return 0;
+    }
+    for (int k = 0; k < NUM_KEYS; k++) {
+        if (key >= 0 && k != key) {
+            continue;
+        }
+        char value[48];
+        format_value(settings, k, true, value, sizeof(value));
+        len += snprintf(buf + len, capacity - len, "%s\"%s\":%s", len > 0 ? "," : "",
+                        s_keys[k].name, value);
+        if (len >= capacity) {
+            return capacity - 1;
+        }
+    }
+    return len;
+}
+
+size_t console_settings_save(const console_settings_t *settings, char *buf, size_t capacity)
+{
+    size_t len = 0;
+    if (capacity == 0) {
+        return 0;
+    }
+    for (int k = 0; k < NUM_KEYS; k++) {
+        char value[48];
+        format_value(settings, k, false, value, sizeof(value));
+        len += snprintf(buf + len, capacity - len, "%s=%s\n", s_keys[k].name, value);
+        if (len >= capacity) {
+            return 0;
+        }
+    }
+    return len;
+}
+
+esp_err_t console_settings_load(console_settings_t *settings, const char *text)
+{
+    console_settings_t loaded = *settings;
+    const char *p = text;
+
+    while (*p != '\0') {
+        size_t len = strcspn(p, "\n");
+        char line[CONSOLE_LINE_MAX + 1];
+        if (len > CONSOLE_LINE_MAX) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        memcpy(line, p, len);
+        line[len] = '\0';
+        p += len + (p[len] == '\n' ? 1 : 0);
+
+        char *eq = strchr(line, '=');
+        if (eq == NULL) {
+            if (len == 0) {
+                continue;
+            }
+            return ESP_ERR_INVALID_ARG;
+        }
+        *eq = '\0';
+        int key = find_key(line);
+        if (key >= 0 && console_settings_set(&loaded, key, eq + 1) != ESP_OK) {
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+    *settings = loaded;
+    return ESP_OK;
+}
@@ -0,0 +1,175 @@
+/**
+ * @file console_cmd.h
+ * @brief Runtime settings and the line-based command parser of the console
+ *
+ * Thresholds, output choice and traffic rate used to need a rebuild. The
+ * serial console (serial_console.h) changes them at run time with one
+ * command per line:
+ *
+ *   help                  list the commands and settings
+ *   get [key]             print all settings, or one
+ *   set <key> <value>     change a setting (applied from the next window)
+ *   save                  persist the current settings in NVS
+ *   load                  reload the settings saved in NVS
+ *   defaults              back to the boot defaults (save to persist)
+ *   stats                 counters: windows, latency, gating, events, deadline, CSI pool,
+ *                         per model cadence, latency and CPU share, then the memory
+ *                         report (heaps, task stacks, arena per module)
+ *   hist                  latency, class and degradation level histograms
+ *
+ * Settings are named fields of console_settings_t (see the key table in
+ * console_cmd.c): the pipeline tuning (pose_tuning_t), the serial output
+ * streams, result decimation and the traffic generator rate. They are
+ * saved as "key=value" lines, so settings saved by an older firmware still
+ * load: unknown keys are skipped and new keys keep their defaults.
+ *
+ * tools/host/console_check covers the parser, the setters and the
+ * persistence format.
+ */
+
+#ifndef CONSOLE_CMD_H
+#define CONSOLE_CMD_H
+
+#include "esp_err.h"
+#include "pose_inference.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Longest command line (longer lines are rejected)
+#define CONSOLE_LINE_MAX 96
+
+// Serial output streams (bits of console_settings_t.output)
+#define CONSOLE_OUTPUT_CSI    (1 << 0)  // Raw CSI JSON line per packet
+#define CONSOLE_OUTPUT_JSON   (1 << 1)  // JSON line per result and event
+#define CONSOLE_OUTPUT_BINARY (1 << 2)  // Binary record per result and event (pose_record.h)
+
+// Traffic generator rate limits (the FreeRTOS tick is 100 Hz)
+#define CONSOLE_TRAFFIC_MIN_HZ 1
+#define CONSOLE_TRAFFIC_MAX_HZ 100
+
+/**
+ * @brief Everything the console can change
+ */
+typedef struct {
+    pose_tuning_t tuning;      // Pipeline tuning, applied with pose_set_tuning()
+    int output;                // CONSOLE_OUTPUT_* streams printed on serial
+    int decimation;            // Print one result in N (events are never decimated)
+    int traffic_hz;            // Packets per second sent to the gateway
+} console_settings_t;
+
+/**
+ * @brief Console commands
+ */
+typedef enum {
+    CONSOLE_CMD_HELP = 0,
+    CONSOLE_CMD_GET,
+    CONSOLE_CMD_SET,
+    CONSOLE_CMD_SAVE,
+    CONSOLE_CMD_LOAD,
+    CONSOLE_CMD_DEFAULTS,
+    CONSOLE_CMD_STATS,
+    CONSOLE_CMD_HIST,
+} console_cmd_t;
+
+/**
+ * @brief A parsed command line
+ */
+typedef struct {
+    console_cmd_t cmd;         // Command
+    int key;                   // Setting index (console_key_name()), -1 for all
+    const char *value;         // SET: value text, points into the parsed line
+} console_command_t;
+
+/**
+ * @brief Line assembler for characters arriving one by one
+ */
+typedef struct {
+    char buf[CONSOLE_LINE_MAX + 1];
+    size_t len;
+    bool overflow;             // Current line is too long and will be rejected
+} console_line_t;
+
+/**
+ * @brief Add one received character
+ *
+ * Handles CR, LF and CRLF line ends and backspace. Blank lines are skipped.
+ *
+ * @param line Line assembler
+ * @param c    Received character
+ * @return true when a line is complete: line->buf holds it (NUL-terminated)
+ *         unless line->overflow is set, and the next call starts a new line
+ */
+bool console_line_push(console_line_t *line, char c);
+
+/**
+ * @brief Parse a command line
+ *
+ * Tokenizes line in place (cmd->value points into it).
+ *
+ * @param line Command line, without the line end
+ * @param cmd  Output command
+ * @return ESP_OK, ESP_ERR_NOT_FOUND for an unknown command or key,
+ *         ESP_ERR_INVALID_ARG for missing or extra arguments
+ */
+esp_err_t console_parse(char *line, console_command_t *cmd);
+
+/**
+ * @brief Number of settings
+ */
+int console_key_count(void);
+
+/**
+ * @brief Name of a setting, or NULL if key is out of range
+ */
+const char *console_key_name(int key);
+
+/**
+ * @brief One-line description of a setting, with its range
+ */
+const char *console_key_help(int key);
+
+/**
+ * @brief Set one setting from text
+ *
+ * Leaves settings unchanged unless the whole value parses and is in range.
+ *
+ * @return ESP_OK, ESP_ERR_NOT_FOUND for a bad key, ESP_ERR_INVALID_ARG for
+ *         a malformed or out-of-range value
+ */
+esp_err_t console_settings_set(console_settings_t *settings, int key, const char *value);
+
+/**
+ * @brief Format settings as the fields of a JSON object ("key":value,...)
+ *
+ * @param key -1 for every setting
+ * @return Length written (truncated to capacity - 1, always NUL-terminated)
+ */
+size_t console_settings_json(const console_settings_t *settings, int key, char *buf,
+                             size_t capacity);
+
+/**
+ * @brief Serialize every setting as "key=value" lines (the NVS format)
+ *
+ * @return Length written, or 0 if buf is too small
+ */
+size_t console_settings_save(const console_settings_t *settings, char *buf, size_t capacity);
+
+/**
+ * @brief Apply serialized settings on top of settings
+ *
+ * Unknown keys are skipped, so older and newer firmware can read each
+ * other's settings; a malformed or out-of-range value rejects the whole text.
+ *
+ * @return ESP_OK, or ESP_ERR_INVALID_ARG with settings unchanged
+ */
+esp_err_t console_settings_load(console_settings_t *settings, const char *text);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CONSOLE_CMD_H
@@ -0,0 +1,121 @@
+/**
+ * @file csi_features.c
+ * @brief Portable CSI feature extraction shared by firmware and host tools
+ *
+ * Nothing in this file may depend on ESP-IDF or FreeRTOS: tools/host builds
+ * it unchanged for offline dataset processing.
+ */
+
+#include "csi_features.h"
+#include "csi_kernels.h"
+#include <math.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+void csi_window_stats(const float *amplitude, const float *phase, const int8_t *rssi,
+                      int num_samples, int num_subcarriers, csi_window_stats_t *out)
+{
+    csi_kernel_window_stats(amplitude, phase, rssi, num_samples, num_subcarriers, out);
+}
+
+float csi_phase_diff_variance(const float *phase, int len)
+{
+    if (len < 2) return 0.0f;
+
+    // Calculate differences between consecutive samples
+    float sum_diff_sq = 0.0f;
+    for (int i = 1; i < len; i++) {
+        float diff = phase[i] - phase[i-1];
+        // Wrap phase difference to [-π, π]
+        while (diff > M_PI) diff -= 2 * M_PI;
+        while (diff < -M_PI) diff += 2 * M_PI;
+        sum_diff_sq += diff * diff;
+    }
+
+    return sum_diff_sq / (len - 1);
+}
+
+void csi_normalize_sample(const float *amplitude, const float *phase, int len,
+                          int num_subcarriers, float *out)
+{
+    int n = len < num_subcarriers ? len : num_subcarriers;
+    float *amp_out = out;
+    float *phase_out = out + num_subcarriers;
+
+    // Pad or truncate to fixed size
+    for (int i = 0; i < num_subcarriers; i++) {
+        amp_out[i] = i < n ? amplitude[i] : 0.0f;
+        phase_out[i] = i < n ? phase[i] : 0.0f;
+    }
+
+    // Normalize amplitude (z-score, padded entries included like np.pad)
+    float mean = csi_kernel_mean(amp_out, num_subcarriers, 1);
+    float std = csi_kernel_std(amp_out, num_subcarriers, 1, mean);
+    for (int i = 0; i < num_subcarriers; i++) {
+        amp_out[i] = (amp_out[i] - mean) / (std + 1e-6f);
+    }
+
+    // Normalize phase to [-1, 1]
+    for (int i = 0; i < num_subcarriers; i++) {
+        phase_out[i] = phase_out[i] / (float)M_PI;
+    }
+}
+
+void csi_normalize_batch(const float *amplitude, const float *phase, int num_rows,
+                         int num_subcarriers, float *out)
+{
+    for (int i = 0; i < num_rows; i++) {
+        csi_normalize_sample(&amplitude[i * num_subcarriers], &phase[i * num_subcarriers],
+                             num_subcarriers, num_subcarriers, &out[i * 2 * num_subcarriers]);
+    }
+}
+
+int csi_num_windows(int num_samples, int window_size, int stride)
+{
+    if (window_size <= 0 || stride <= 0 || num_samples < window_size) {
+        return 0;
+    }
+    return (num_samples - window_size) / stride + 1;
+}
+
+int csi_window_stats_sliding(const float *amplitude, const float *phase, const int8_t *rssi,
+                             int num_samples, int num_subcarriers, int window_size,
+                             int stride, float *out)
+{
+    int num_windows = csi_num_windows(num_samples, window_size, stride);
+
+    for (int w = 0; w < num_windows; w++) {
+        int t0 = w * stride;
+        csi_window_stats_t stats;
+        csi_window_stats(&amplitude[t0 * num_subcarriers], &phase[t0 * num_subcarriers],
+                         &rssi[t0], window_size, num_subcarriers, &stats);
+        float *row = &out[w * CSI_NUM_WINDOW_STATS];
+        row[0] = stats.amplitude_mean;
+        row[1] = stats.amplitude_std;
+        row[2] = stats.phase_variance;
+        row[3] = stats.rssi_mean;
+    }
+    return num_windows;
+}
+
+void csi_ring_linearize(const float *ring, int num_samples, int head, int row_len, float *out)
+{
+    int tail = num_samples - head;
+    memcpy(out, &ring[head * row_len], (size_t)tail * row_len * sizeof(float));
+    memcpy(&out[tail * row_len], ring, (size_t)head * row_len * sizeof(float));
+}
+
+void csi_quantize_int8(const float *in, int len, float scale, int zero_point, int8_t *out)
+{
+    csi_kernel_quantize_int8(in, len, scale, zero_point, out);
+}
+
+void csi_dequantize_int8(const int8_t *in, int len, float scale, int zero_point, float *out)
+{
+    for (int i = 0; i < len; i++) {
+        out[i] = (float)(in[i] - zero_point) * scale;
+    }
+}
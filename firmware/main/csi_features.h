@@ -0,0 +1,159 @@
+/**
+ * @file csi_features.h
+ * @brief Portable CSI feature extraction shared by firmware and host tools
+ *
+ * These are the window statistics the pose pipeline is built on. They are
+ * kept free of ESP-IDF and FreeRTOS dependencies so the exact same code can
+ * be compiled into the firmware and into the host tools under tools/host,
+ * which guarantees offline feature extraction matches what the device sees.
+ *
+ * The same library is built as a shared object for Python (see
+ * tools/csi_features.py), which train_pose_model.py and analyze_csi.py use
+ * for preprocessing so training sees exactly what the device computes.
+ *
+ * Buffer Layout:
+ * -------------
+ * Temporal windows are stored sample-major, exactly like the firmware's
+ * temporal buffers: element [t * num_subcarriers + s] is subcarrier s of
+ * sample t.
+ */
+
+#ifndef CSI_FEATURES_H
+#define CSI_FEATURES_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Values per row written by csi_window_stats_sliding()
+#define CSI_NUM_WINDOW_STATS 4
+
+/**
+ * @brief Aggregate statistics of one temporal CSI window
+ */
+typedef struct {
+    float amplitude_mean;   // Mean amplitude over all samples and subcarriers
+    float amplitude_std;    // Std of amplitude over all samples and subcarriers
+    float phase_variance;   // RMS of per-subcarrier phase std over time
+    int8_t rssi_mean;       // Average RSSI over the window (dBm)
+} csi_window_stats_t;
+
+/**
+ * @brief Compute window statistics over a temporal CSI buffer
+ *
+ * @param amplitude Amplitude buffer, num_samples * num_subcarriers floats
+ * @param phase     Phase buffer, num_samples * num_subcarriers floats
+ * @param rssi      RSSI per sample, num_samples entries
+ * @param num_samples     Number of samples (time steps) in the window
+ * @param num_subcarriers Number of subcarriers per sample
+ * @param out       Output statistics
+ */
+void csi_window_stats(const float *amplitude, const float *phase, const int8_t *rssi,
+                      int num_samples, int num_subcarriers, csi_window_stats_t *out);
+
+/**
+ * @brief Variance of consecutive phase differences, wrapped to [-π, π]
+ *
+ * Phase variance is a good indicator of human activity.
+ * Static environments have stable phase; humans cause fluctuations.
+ *
+ * @param phase Phase time series (radians)
+ * @param len   Number of entries
+ * @return Mean squared wrapped phase difference
+ */
+float csi_phase_diff_variance(const float *phase, int len);
+
+/**
+ * @brief Normalize one CSI sample into a model input row
+ *
+ * Produces [amplitude z-score (num_subcarriers), phase / π (num_subcarriers)],
+ * zero-padding or truncating the input to num_subcarriers. This matches
+ * CSIDataPreprocessor.parse_sample in models/training/train_pose_model.py.
+ *
+ * @param amplitude Input amplitudes
+ * @param phase     Input phases (radians)
+ * @param len       Number of valid input subcarriers
+ * @param num_subcarriers Model subcarrier count
+ * @param out       Output row, 2 * num_subcarriers floats
+ */
+void csi_normalize_sample(const float *amplitude, const float *phase, int len,
+                          int num_subcarriers, float *out);
+
+/**
+ * @brief Normalize a batch of padded samples
+ *
+ * Applies csi_normalize_sample() to num_rows rows that are already padded
+ * to num_subcarriers.
+ *
+ * @param amplitude Amplitudes, num_rows * num_subcarriers floats
+ * @param phase     Phases, num_rows * num_subcarriers floats
+ * @param num_rows  Number of samples
+ * @param num_subcarriers Subcarriers per sample
+ * @param out       Output, num_rows * 2 * num_subcarriers floats
+ */
+void csi_normalize_batch(const float *amplitude, const float *phase, int num_rows,
+                         int num_subcarriers, float *out);
+
+/**
+ * @brief Number of sliding windows in a series
+ *
+ * @return Windows of window_size samples starting every stride samples
+ */
+int csi_num_windows(int num_samples, int window_size, int stride);
+
+/**
+ * @brief Window statistics over every sliding window of a series
+ *
+ * Output rows are [amplitude_mean, amplitude_std, phase_variance, rssi_mean],
+ * one per window as counted by csi_num_windows().
+ *
+ * @param amplitude Amplitudes, num_samples * num_subcarriers floats
+ * @param phase     Phases, num_samples * num_subcarriers floats
+ * @param rssi      RSSI per sample
+ * @param num_samples     Number of samples in the series
+ * @param num_subcarriers Subcarriers per sample
+ * @param window_size Samples per window
+ * @param stride      Samples between window starts
+ * @param out       Output, csi_num_windows() * CSI_NUM_WINDOW_STATS floats
+ * @return Number of windows written
+ */
+int csi_window_stats_sliding(const float *amplitude, const float *phase, const int8_t *rssi,
+                             int num_samples, int num_subcarriers, int window_size,
+                             int stride, float *out);
+
+/**
+ * @brief Copy a ring buffer into a contiguous window, oldest sample first
+ *
+ * @param ring      Ring storage, num_samples * row_len elements
+ * @param num_samples Ring capacity in samples
+ * @param head      Index of the oldest sample (next slot to be written)
+ * @param row_len   Elements per sample
+ * @param out       Output, num_samples * row_len elements
+ */
+void csi_ring_linearize(const float *ring, int num_samples, int head, int row_len, float *out);
+
+/**
+ * @brief Quantize floats to int8 with TFLite affine parameters
+ *
+ * q = clamp(round(x / scale) + zero_point, -128, 127)
+ *
+ * @param in    Input values
+ * @param len   Number of values
+ * @param scale Quantization scale
+ * @param zero_point Quantization zero point
+ * @param out   Output int8 values
+ */
+void csi_quantize_int8(const float *in, int len, float scale, int zero_point, int8_t *out);
+
+/**
+ * @brief Dequantize int8 values: x = (q - zero_point) * scale
+ */
+void csi_dequantize_int8(const int8_t *in, int len, float scale, int zero_point, float *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CSI_FEATURES_H
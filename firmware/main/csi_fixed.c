@@ -0,0 +1,232 @@
+/**
+ * @file csi_fixed.c
+ * @brief Fixed-point CSI path: I/Q to window statistics and model input
+ *
+ * Nothing in this file may depend on ESP-IDF or FreeRTOS: tools/host builds
+ * it unchanged to check it against the float path.
+ */
+
+#include "csi_fixed.h"
+#include <math.h>
+#include <stddef.h>
+
+// CORDIC vectors are scaled by 2^CORDIC_SHIFT so the shifts keep precision
+#define CORDIC_SHIFT 14
+#define CORDIC_ITERATIONS 16
+
+// Angle accumulator: π = 2^23, rounded to Q15 at the end
+#define ANGLE_BITS 23
+#define ANGLE_PI (1 << ANGLE_BITS)
+
+// atan(2^-i) / π * 2^23
+static const int32_t s_atan_table[CORDIC_ITERATIONS] = {
+    2097152, 1238021, 654136, 332050, 166669, 83416, 41718, 20860,
+    10430, 5215, 2608, 1304, 652, 326, 163, 81,
+};
+
+// Inverse CORDIC gain, Q16 (0.60725)
+#define CORDIC_INV_GAIN_Q16 39797
+
+void csi_fixed_iq(const int8_t *iq, int num_subcarriers, int16_t *amplitude, int16_t *phase)
+{
+    for (int i = 0; i < num_subcarriers; i++) {
+        int32_t x = (int32_t)iq[2 * i] << CORDIC_SHIFT;
+        int32_t y = (int32_t)iq[2 * i + 1] << CORDIC_SHIFT;
+        int32_t angle = 0;
+        if (x == 0 && y == 0) {
+            amplitude[i] = 0;
+            phase[i] = 0;  // Like atan2f(0, 0)
+            continue;
+        }
+
+        // Left half-plane: rotate by π so the iterations only cover ±π/2
+        if (x < 0) {
+            angle = y >= 0 ? ANGLE_PI : -ANGLE_PI;
+            x = -x;
+            y = -y;
+        }
+        // Vectoring mode: drive y to zero, accumulating the rotation
+        for (int k = 0; k < CORDIC_ITERATIONS; k++) {
+            int32_t dx = y >> k;
+            int32_t dy = x >> k;
+            if (y > 0) {
+                x += dx;
+                y -= dy;
+                angle += s_atan_table[k];
+            } else {
+                x -= dx;
+                y += dy;
+                angle -= s_atan_table[k];
+            }
+        }
+
+        // x is now |H| * 2^14 / 0.60725
+        int64_t amp = ((int64_t)x * CORDIC_INV_GAIN_Q16 +
+                       (1LL << (15 + CORDIC_SHIFT - CSI_FIXED_AMP_FRAC_BITS))) >>
+                      (16 + CORDIC_SHIFT - CSI_FIXED_AMP_FRAC_BITS);
+        amplitude[i] = (int16_t)amp;
+
+        int32_t q = (angle + (1 << (ANGLE_BITS - 16))) >> (ANGLE_BITS - 15);
+        if (q > CSI_FIXED_PHASE_ONE - 1) q = CSI_FIXED_PHASE_ONE - 1;
+        if (q < -CSI_FIXED_PHASE_ONE) q = -CSI_FIXED_PHASE_ONE;
+        phase[i] = (int16_t)q;
+    }
+}
+
+static int16_t saturate_q(float v)
+{
+    long q = lroundf(v);
+    if (q > INT16_MAX) q = INT16_MAX;
+    if (q < INT16_MIN) q = INT16_MIN;
+    return (int16_t)q;
+}
+
+void csi_fixed_from_float(const float *amplitude, const float *phase, int len,
+                          int16_t *amplitude_q, int16_t *phase_q)
+{
+    for (int i = 0; i < len; i++) {
+        amplitude_q[i] = saturate_q(amplitude[i] * CSI_FIXED_AMP_ONE);
+        phase_q[i] = saturate_q(phase[i] * (CSI_FIXED_PHASE_ONE / (float)M_PI));
+    }
+}
+
+void csi_fixed_to_float(const int16_t *amplitude_q, const int16_t *phase_q, int len,
+                        float *amplitude, float *phase)
+{
+    for (int i = 0; i < len && amplitude != NULL; i++) {
+        amplitude[i] = amplitude_q[i] * (1.0f / CSI_FIXED_AMP_ONE);
+    }
+    for (int i = 0; i < len && phase != NULL; i++) {
+        phase[i] = phase_q[i] * ((float)M_PI / CSI_FIXED_PHASE_ONE);
+    }
+}
+
+uint32_t csi_fixed_isqrt64(uint64_t v)
+{
+    // Bit by bit, two result bits per step of the remainder
+    uint64_t result = 0;
+    uint64_t bit = 1ULL << 62;
+    while (bit > v) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (v >= result + bit) {
+            v -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)result;
+}
+
+/**
+ * @brief n^2 * variance of a series from its sum and sum of squares (exact)
+ */
+static inline int64_t scaled_variance(int64_t sum, int64_t sum_sq, int n)
+{
+    return (int64_t)n * sum_sq - sum * sum;
+}
+
+void csi_fixed_window_stats(const int16_t *amplitude, const int16_t *phase, const int8_t *rssi,
+                            int num_samples, int num_subcarriers, csi_window_stats_t *out)
+{
+    const int total = num_samples * num_subcarriers;
+    if (num_samples <= 0 || num_subcarriers <= 0) {
+        out->amplitude_mean = 0.0f;
+        out->amplitude_std = 0.0f;
+        out->phase_variance = 0.0f;
+        out->rssi_mean = 0;
+        return;
+    }
+
+    // Amplitude over the whole window. A row's squares (<= 64 * 2^29) can
+    // overflow int32, so rows are added to int64 sums
+    int64_t sum = 0, sum_sq = 0;
+    for (int t = 0; t < num_samples; t++) {
+        const int16_t *row = &amplitude[t * num_subcarriers];
+        int32_t row_sum = 0;
+        int64_t row_sq = 0;
+        for (int s = 0; s < num_subcarriers; s++) {
+            row_sum += row[s];
+            row_sq += (int32_t)row[s] * row[s];
+        }
+        sum += row_sum;
+        sum_sq += row_sq;
+    }
+    // sqrt(total^2 variance) = total * std, in Q8.7
+    uint32_t scaled_std = csi_fixed_isqrt64((uint64_t)scaled_variance(sum, sum_sq, total));
+    out->amplitude_mean = (float)sum / ((float)total * CSI_FIXED_AMP_ONE);
+    out->amplitude_std = (float)scaled_std / ((float)total * CSI_FIXED_AMP_ONE);
+
+    // Phase: variance per subcarrier over time (Q30 of π^2), summed
+    int64_t total_var = 0;
+    for (int s = 0; s < num_subcarriers; s++) {
+        int32_t sub_sum = 0;
+        int64_t sub_sq = 0;
+        for (int t = 0; t < num_samples; t++) {
+            int32_t p = phase[t * num_subcarriers + s];
+            sub_sum += p;
+            sub_sq += p * p;
+        }
+        total_var += scaled_variance(sub_sum, sub_sq, num_samples) /
+                     ((int64_t)num_samples * num_samples);
+    }
+    uint32_t rms_q15 = csi_fixed_isqrt64((uint64_t)(total_var / num_subcarriers));
+    out->phase_variance = (float)rms_q15 * ((float)M_PI / CSI_FIXED_PHASE_ONE);
+
+    int rssi_sum = 0;
+    for (int t = 0; t < num_samples; t++) {
+        rssi_sum += rssi[t];
+    }
+    out->rssi_mean = (int8_t)(rssi_sum / num_samples);
+}
+
+static inline int8_t clamp_int8(int64_t q)
+{
+    if (q < -128) q = -128;
+    if (q > 127) q = 127;
+    return (int8_t)q;
+}
+
+// Precision of the per-row amplitude multiplier
+#define ROW_SHIFT 32
+
+void csi_fixed_prepare_input(const int16_t *amplitude, const int16_t *phase, int num_samples,
+                             int num_subcarriers, float scale, int zero_point, int8_t *out)
+{
+    const int n = num_subcarriers;
+    // 1 / scale in Q16: the one float operation per window
+    const int64_t inv_scale_q16 = llroundf(65536.0f / scale);
+
+    for (int t = 0; t < num_samples; t++) {
+        const int16_t *amp = &amplitude[t * n];
+        const int16_t *ph = &phase[t * n];
+        int8_t *row = &out[t * 2 * n];
+
+        int32_t sum = 0;
+        int64_t sum_sq = 0;
+        for (int s = 0; s < n; s++) {
+            sum += amp[s];
+            sum_sq += (int32_t)amp[s] * amp[s];
+        }
+        // (a - mean) / std = (n a - sum) / (n std), with n std = sqrt(n^2 variance)
+        uint32_t scaled_std = csi_fixed_isqrt64((uint64_t)scaled_variance(sum, sum_sq, n));
+        int64_t multiplier = 0;
+        if (scaled_std > 0) {
+            multiplier = ((inv_scale_q16 << (ROW_SHIFT - 16)) + scaled_std / 2) / scaled_std;
+        }
+        for (int s = 0; s < n; s++) {
+            int64_t centered = (int64_t)n * amp[s] - sum;
+            int64_t q = (centered * multiplier + (1LL << (ROW_SHIFT - 1))) >> ROW_SHIFT;
+            row[s] = clamp_int8(q + zero_point);
+        }
+
+        // phase / π / scale = p * inv_scale_q16 / 2^31
+        for (int s = 0; s < n; s++) {
+            int64_t q = ((int64_t)ph[s] * inv_scale_q16 + (1LL << 30)) >> 31;
+            row[n + s] = clamp_int8(q + zero_point);
+        }
+    }
+}
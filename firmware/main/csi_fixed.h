@@ -0,0 +1,101 @@
+/**
+ * @file csi_fixed.h
+ * @brief Fixed-point CSI path: I/Q to window statistics and model input
+ *
+ * With CONFIG_POSE_FIXED_POINT the pipeline keeps CSI samples as int16
+ * instead of float, from the raw I/Q bytes to the int8 model input:
+ *
+ *   int8 I/Q -> csi_fixed_iq() -> int16 window buffers
+ *            -> csi_fixed_window_stats()     (integer sums, one sqrt at the end)
+ *            -> csi_fixed_prepare_input()    (per-row integer multiplier)
+ *            -> occupancy_estimate_q7()      (integer covariance)
+ *
+ * Scales:
+ *
+ *   amplitude  Q8.7: |H| * 128. int8 I/Q give |H| <= 181.02, so it fits int16
+ *   phase      Q15 fraction of π: phase / π * 32768, [-π, π) -> [-32768, 32767]
+ *
+ * Sums and variances are int64; the only floats left are the statistics
+ * handed to the threshold detector (one conversion per window) and the
+ * input tensor scale (one reciprocal per window). Results are within the
+ * tolerances tools/host/fixed_point_check verifies against the float path.
+ */
+
+#ifndef CSI_FIXED_H
+#define CSI_FIXED_H
+
+#include "csi_features.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Amplitude: Q8.7
+#define CSI_FIXED_AMP_FRAC_BITS 7
+#define CSI_FIXED_AMP_ONE (1 << CSI_FIXED_AMP_FRAC_BITS)
+
+// Phase: Q15 fraction of π
+#define CSI_FIXED_PHASE_ONE 32768
+
+/**
+ * @brief Amplitude and phase of raw CSI (CORDIC, integer only)
+ *
+ * Replaces sqrtf()/atan2f() per subcarrier. Amplitude is within 1/128 and
+ * phase within 2 LSB (2e-4 rad) of the float results; a phase of exactly
+ * +π (Q = 0, I < 0) saturates to 32767 like atan2f() gives +π.
+ *
+ * @param iq              Interleaved I, Q bytes, 2 * num_subcarriers
+ * @param num_subcarriers Subcarriers
+ * @param amplitude       Output, Q8.7
+ * @param phase           Output, Q15 fraction of π
+ */
+void csi_fixed_iq(const int8_t *iq, int num_subcarriers, int16_t *amplitude, int16_t *phase);
+
+/**
+ * @brief Fixed-point samples from float ones (rounded, saturated)
+ */
+void csi_fixed_from_float(const float *amplitude, const float *phase, int len,
+                          int16_t *amplitude_q, int16_t *phase_q);
+
+/**
+ * @brief Float samples from fixed-point ones
+ *
+ * @param amplitude Output amplitudes, or NULL
+ * @param phase     Output phases (radians), or NULL
+ */
+void csi_fixed_to_float(const int16_t *amplitude_q, const int16_t *phase_q, int len,
+                        float *amplitude, float *phase);
+
+/**
+ * @brief floor(sqrt(v))
+ */
+uint32_t csi_fixed_isqrt64(uint64_t v);
+
+/**
+ * @brief csi_window_stats() over a fixed-point window
+ *
+ * Means and variances come from exact integer sums; the result is converted
+ * to float once, for the detector thresholds.
+ *
+ * @param amplitude Amplitude window (Q8.7), num_samples * num_subcarriers
+ * @param phase     Phase window (Q15 of π), num_samples * num_subcarriers
+ */
+void csi_fixed_window_stats(const int16_t *amplitude, const int16_t *phase, const int8_t *rssi,
+                            int num_samples, int num_subcarriers, csi_window_stats_t *out);
+
+/**
+ * @brief pose_model_prepare_input() over a fixed-point window
+ *
+ * Each row is z-scored and quantized with one integer multiplier per row
+ * (one division) instead of a float division per value. Outputs are within
+ * 1 of the float path.
+ */
+void csi_fixed_prepare_input(const int16_t *amplitude, const int16_t *phase, int num_samples,
+                             int num_subcarriers, float scale, int zero_point, int8_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CSI_FIXED_H
@@ -0,0 +1,69 @@
+/**
+ * @file csi_history.c
+ * @brief Cold CSI history ring in PSRAM, filled one hop at a time
+ */
+
+#include "csi_history.h"
+#include <string.h>
+
+size_t csi_history_slot_bytes(size_t hop_bytes)
+{
+    return CSI_HISTORY_SLOT_BYTES(hop_bytes);
+}
+
+size_t csi_history_storage_bytes(size_t hop_bytes, int num_slots)
+{
+    return csi_history_slot_bytes(hop_bytes) * (size_t)num_slots;
+}
+
+void csi_history_init(csi_history_t *history, void *storage, size_t hop_bytes, int num_slots)
+{
+    history->slots = (uint8_t *)storage;
+    history->hop_bytes = hop_bytes;
+    history->slot_bytes = csi_history_slot_bytes(hop_bytes);
+    history->num_slots = num_slots;
+    history->head = 0;
+    history->count = 0;
+}
+
+void csi_history_push(csi_history_t *history, const void *hop)
+{
+    if (history->num_slots <= 0) {
+        return;
+    }
+
+    // The slot is line aligned, so this writes whole lines apart from the
+    // padding tail, which no other slot shares
+    memcpy(history->slots + (size_t)history->head * history->slot_bytes, hop, history->hop_bytes);
+
+    history->head = (history->head + 1) % history->num_slots;
+    if (history->count < history->num_slots) {
+        history->count++;
+    }
+}
+
+int csi_history_count(const csi_history_t *history)
+{
+    return history->count;
+}
+
+const void *csi_history_get(const csi_history_t *history, int age)
+{
+    if (age < 0 || age >= history->count) {
+        return NULL;
+    }
+    int slot = (history->head - 1 - age + history->num_slots) % history->num_slots;
+    return history->slots + (size_t)slot * history->slot_bytes;
+}
+
+int csi_history_read(const csi_history_t *history, int num_hops, void *out)
+{
+    int n = num_hops < history->count ? num_hops : history->count;
+    uint8_t *dst = (uint8_t *)out;
+
+    for (int age = n - 1; age >= 0; age--) {
+        memcpy(dst, csi_history_get(history, age), history->hop_bytes);
+        dst += history->hop_bytes;
+    }
+    return n;
+}
@@ -0,0 +1,117 @@
+/**
+ * @file csi_history.h
+ * @brief Cold CSI history ring in PSRAM, filled one hop at a time
+ *
+ * Hot/Cold Placement:
+ * ------------------
+ * The working set of the current hop (the samples being collected, the
+ * window statistics and, later, model activations) is small and is touched
+ * on every sample and every inference, so it lives in internal SRAM. Older
+ * hops are only needed by slower consumers (longer-context features,
+ * debugging dumps) and are spilled here, to PSRAM.
+ *
+ * Data moves between the tiers in whole cache lines: every slot of the ring
+ * starts on a cache-line boundary and spans a whole number of lines, so a
+ * spill never shares a PSRAM cache line with a neighbouring slot and never
+ * forces a partially-written line to be filled and written back.
+ *
+ * The caller provides the ring storage, normally from the memory arena.
+ */
+
+#ifndef CSI_HISTORY_H
+#define CSI_HISTORY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ESP32-S3 data cache line size (CONFIG_ESP32S3_DATA_CACHE_LINE_SIZE)
+#ifdef CONFIG_ESP32S3_DATA_CACHE_LINE_SIZE
+#define CSI_HISTORY_LINE_BYTES CONFIG_ESP32S3_DATA_CACHE_LINE_SIZE
+#else
+#define CSI_HISTORY_LINE_BYTES 32
+#endif
+
+/**
+ * @brief Ring of past hops, each stored as one line-aligned slot
+ */
+typedef struct {
+    uint8_t *slots;            // num_slots * slot_bytes, line aligned
+    size_t hop_bytes;          // Payload bytes per hop
+    size_t slot_bytes;         // hop_bytes rounded up to whole cache lines
+    int num_slots;             // Capacity in hops
+    int head;                  // Next slot to be written
+    int count;                 // Number of valid hops
+} csi_history_t;
+
+// Slot size as a constant expression, for static memory budget tables
+#define CSI_HISTORY_SLOT_BYTES(hop_bytes) \
+    (((hop_bytes) + CSI_HISTORY_LINE_BYTES - 1) / CSI_HISTORY_LINE_BYTES * CSI_HISTORY_LINE_BYTES)
+
+/**
+ * @brief Slot size for one hop, rounded up to whole cache lines
+ */
+size_t csi_history_slot_bytes(size_t hop_bytes);
+
+/**
+ * @brief Bytes of storage needed for a ring of num_slots hops
+ *
+ * Use this for the memory budget entry, with CSI_HISTORY_LINE_BYTES alignment.
+ */
+size_t csi_history_storage_bytes(size_t hop_bytes, int num_slots);
+
+/**
+ * @brief Attach storage and clear the ring
+ *
+ * @param history   Ring to initialize
+ * @param storage   csi_history_storage_bytes() bytes, CSI_HISTORY_LINE_BYTES aligned
+ * @param hop_bytes Payload bytes per hop
+ * @param num_slots Capacity in hops
+ */
+void csi_history_init(csi_history_t *history, void *storage, size_t hop_bytes, int num_slots);
+
+/**
+ * @brief Spill one hop from the hot tier into the ring
+ *
+ * Overwrites the oldest hop once the ring is full.
+ *
+ * @param history Ring
+ * @param hop     hop_bytes bytes to copy (normally in internal SRAM)
+ */
+void csi_history_push(csi_history_t *history, const void *hop);
+
+/**
+ * @brief Number of hops currently held
+ */
+int csi_history_count(const csi_history_t *history);
+
+/**
+ * @brief Address of a past hop in the ring
+ *
+ * @param history Ring
+ * @param age     0 = most recently spilled hop, count - 1 = oldest
+ * @return Pointer into PSRAM, or NULL if age is out of range
+ */
+const void *csi_history_get(const csi_history_t *history, int age);
+
+/**
+ * @brief Copy past hops back into a contiguous buffer, oldest first
+ *
+ * Used by consumers that need a longer context in fast memory: the hops are
+ * streamed out of PSRAM one slot (whole cache lines) at a time.
+ *
+ * @param history  Ring
+ * @param num_hops Number of most recent hops to copy
+ * @param out      num_hops * hop_bytes bytes
+ * @return Number of hops copied (less than num_hops if not enough history)
+ */
+int csi_history_read(const csi_history_t *history, int num_hops, void *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CSI_HISTORY_H
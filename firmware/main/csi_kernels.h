@@ -0,0 +1,122 @@
+/**
+ * @file csi_kernels.h
+ * @brief Inline bodies of the per-window CSI kernels
+ *
+ * csi_features.c exports these with runtime dimensions. Callers whose
+ * dimensions are compile-time constants (pose_dims.h) call them directly
+ * instead: once inlined, every loop has a constant trip count and stride,
+ * so the compiler can unroll it and drop the bounds arithmetic. The results
+ * are bit-identical to the exported functions; only the code differs.
+ */
+
+#ifndef CSI_KERNELS_H
+#define CSI_KERNELS_H
+
+#include "csi_features.h"
+#include <math.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CSI_KERNEL_PI 3.14159265358979323846f
+
+/**
+ * @brief Mean of a strided series
+ */
+static inline float csi_kernel_mean(const float *data, int len, int stride)
+{
+    if (len == 0) return 0.0f;
+    float sum = 0.0f;
+    for (int i = 0; i < len; i++) {
+        sum += data[i * stride];
+    }
+    return sum / len;
+}
+
+/**
+ * @brief Standard deviation of a strided series
+ */
+static inline float csi_kernel_std(const float *data, int len, int stride, float mean)
+{
+    if (len == 0) return 0.0f;
+    float sum_sq_diff = 0.0f;
+    for (int i = 0; i < len; i++) {
+        float diff = data[i * stride] - mean;
+        sum_sq_diff += diff * diff;
+    }
+    return sqrtf(sum_sq_diff / len);
+}
+
+/**
+ * @brief csi_window_stats()
+ */
+static inline void csi_kernel_window_stats(const float *amplitude, const float *phase,
+                                           const int8_t *rssi, int num_samples,
+                                           int num_subcarriers, csi_window_stats_t *out)
+{
+    int total_samples = num_samples * num_subcarriers;
+
+    // Amplitude statistics across all subcarriers and time steps
+    out->amplitude_mean = csi_kernel_mean(amplitude, total_samples, 1);
+    out->amplitude_std = csi_kernel_std(amplitude, total_samples, 1, out->amplitude_mean);
+
+    // Phase variance (per subcarrier over time first, then across subcarriers).
+    // Subcarrier s is read with a stride instead of being copied out, which
+    // keeps the stack small and avoids a second pass over PSRAM.
+    float total_phase_var = 0.0f;
+    for (int s = 0; s < num_subcarriers; s++) {
+        float sub_mean = csi_kernel_mean(&phase[s], num_samples, num_subcarriers);
+        float sub_std = csi_kernel_std(&phase[s], num_samples, num_subcarriers, sub_mean);
+        total_phase_var += sub_std * sub_std;
+    }
+    out->phase_variance = num_subcarriers > 0 ? sqrtf(total_phase_var / num_subcarriers) : 0.0f;
+
+    // Average RSSI
+    int rssi_sum = 0;
+    for (int i = 0; i < num_samples; i++) {
+        rssi_sum += rssi[i];
+    }
+    out->rssi_mean = num_samples > 0 ? (int8_t)(rssi_sum / num_samples) : 0;
+}
+
+/**
+ * @brief csi_normalize_sample() of a row that is already num_subcarriers long
+ */
+static inline void csi_kernel_normalize_row(const float *amplitude, const float *phase,
+                                            int num_subcarriers, float *out)
+{
+    float *amp_out = out;
+    float *phase_out = out + num_subcarriers;
+
+    float mean = csi_kernel_mean(amplitude, num_subcarriers, 1);
+    float std = csi_kernel_std(amplitude, num_subcarriers, 1, mean);
+    for (int i = 0; i < num_subcarriers; i++) {
+        amp_out[i] = (amplitude[i] - mean) / (std + 1e-6f);
+    }
+    for (int i = 0; i < num_subcarriers; i++) {
+        phase_out[i] = phase[i] / CSI_KERNEL_PI;
+    }
+}
+
+/**
+ * @brief csi_quantize_int8()
+ */
+static inline void csi_kernel_quantize_int8(const float *in, int len, float scale,
+                                            int zero_point, int8_t *out)
+{
+    // A true division: x * (1 / scale) rounds differently at some .5 ties
+    for (int i = 0; i < len; i++) {
+        long q = lroundf(in[i] / scale) + zero_point;
+        if (q < -128) q = -128;
+        if (q > 127) q = 127;
+        out[i] = (int8_t)q;
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CSI_KERNELS_H
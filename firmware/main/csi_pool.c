@@ -0,0 +1,148 @@
+/**
+ * @file csi_pool.c
+ * @brief Fixed-size lock-free pool of CSI records
+ */
+
+#include "csi_pool.h"
+#include "wifi_csi.h"
+#include <stddef.h>
+
+// Index stored in free_head when the free list is empty
+#define POOL_EMPTY 0xFFFFu
+
+#define HEAD_INDEX(h) ((h) & 0xFFFFu)
+#define HEAD_TAG(h) ((h) >> 16)
+#define MAKE_HEAD(tag, index) ((((tag) & 0xFFFFu) << 16) | ((index) & 0xFFFFu))
+
+/**
+ * @brief Map a record pointer back to its index
+ *
+ * @return Index, or -1 if the pointer is not a record of this pool
+ */
+static int record_index(const csi_pool_t *pool, const csi_data_t *record)
+{
+    if (record < pool->records || record >= pool->records + pool->capacity) {
+        return -1;
+    }
+    ptrdiff_t offset = (const char *)record - (const char *)pool->records;
+    if (offset % (ptrdiff_t)sizeof(csi_data_t) != 0) {
+        return -1;
+    }
+    return (int)(record - pool->records);
+}
+
+static void push_free(csi_pool_t *pool, uint32_t index)
+{
+    uint32_t head = __atomic_load_n(&pool->free_head, __ATOMIC_RELAXED);
+    uint32_t desired;
+    do {
+        __atomic_store_n(&pool->next[index], HEAD_INDEX(head), __ATOMIC_RELAXED);
+        desired = MAKE_HEAD(HEAD_TAG(head) + 1, index);
+    } while (!__atomic_compare_exchange_n(&pool->free_head, &head, desired, true,
+                                          __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+static void update_peak(csi_pool_t *pool, uint32_t in_use)
+{
+    uint32_t peak = __atomic_load_n(&pool->peak_in_use, __ATOMIC_RELAXED);
+    while (in_use > peak &&
+           !__atomic_compare_exchange_n(&pool->peak_in_use, &peak, in_use, true,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+esp_err_t csi_pool_init(csi_pool_t *pool, csi_data_t *records, uint32_t capacity)
+{
+    if (pool == NULL || records == NULL || capacity == 0 || capacity > CSI_POOL_MAX_RECORDS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pool->records = records;
+    pool->capacity = capacity;
+    for (uint32_t i = 0; i < capacity; i++) {
+        pool->next[i] = i + 1 < capacity ? i + 1 : POOL_EMPTY;
+        pool->refs[i] = 0;
+    }
+    pool->in_use = 0;
+    pool->peak_in_use = 0;
+    pool->allocations = 0;
+    pool->exhausted = 0;
+    pool->misuse = 0;
+    __atomic_store_n(&pool->free_head, MAKE_HEAD(0, 0), __ATOMIC_RELEASE);
+    return ESP_OK;
+}
+
+csi_data_t *csi_pool_alloc(csi_pool_t *pool)
+{
+    uint32_t head = __atomic_load_n(&pool->free_head, __ATOMIC_ACQUIRE);
+    uint32_t desired;
+    uint32_t index;
+    do {
+        index = HEAD_INDEX(head);
+        if (index == POOL_EMPTY) {
+            __atomic_add_fetch(&pool->exhausted, 1, __ATOMIC_RELAXED);
+            return NULL;
+        }
+        // next[index] may be stale if another thread won the race; the tag
+        // makes the CAS below fail in that case
+        uint32_t next = __atomic_load_n(&pool->next[index], __ATOMIC_RELAXED);
+        desired = MAKE_HEAD(HEAD_TAG(head) + 1, next);
+    } while (!__atomic_compare_exchange_n(&pool->free_head, &head, desired, true,
+                                          __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE));
+
+    __atomic_store_n(&pool->refs[index], 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&pool->allocations, 1, __ATOMIC_RELAXED);
+    update_peak(pool, __atomic_add_fetch(&pool->in_use, 1, __ATOMIC_RELAXED));
+    return &pool->records[index];
+}
+
+esp_err_t csi_pool_retain(csi_pool_t *pool, const csi_data_t *record)
+{
+    int index = record_index(pool, record);
+    if (index < 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint32_t refs = __atomic_load_n(&pool->refs[index], __ATOMIC_RELAXED);
+    do {
+        if (refs == 0) {
+            return ESP_ERR_INVALID_STATE;
+        }
+    } while (!__atomic_compare_exchange_n(&pool->refs[index], &refs, refs + 1, true,
+                                          __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+    return ESP_OK;
+}
+
+esp_err_t csi_pool_release(csi_pool_t *pool, const csi_data_t *record)
+{
+    int index = record_index(pool, record);
+    if (index < 0) {
+        __atomic_add_fetch(&pool->misuse, 1, __ATOMIC_RELAXED);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint32_t refs = __atomic_load_n(&pool->refs[index], __ATOMIC_RELAXED);
+    do {
+        if (refs == 0) {
+            __atomic_add_fetch(&pool->misuse, 1, __ATOMIC_RELAXED);
+            return ESP_ERR_INVALID_STATE;
+        }
+    } while (!__atomic_compare_exchange_n(&pool->refs[index], &refs, refs - 1, true,
+                                          __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
+
+    if (refs == 1) {
+        __atomic_sub_fetch(&pool->in_use, 1, __ATOMIC_RELAXED);
+        push_free(pool, (uint32_t)index);
+    }
+    return ESP_OK;
+}
+
+void csi_pool_get_stats(const csi_pool_t *pool, csi_pool_stats_t *stats)
+{
+    stats->capacity = pool->capacity;
+    stats->in_use = __atomic_load_n(&pool->in_use, __ATOMIC_RELAXED);
+    stats->peak_in_use = __atomic_load_n(&pool->peak_in_use, __ATOMIC_RELAXED);
+    stats->allocations = __atomic_load_n(&pool->allocations, __ATOMIC_RELAXED);
+    stats->exhausted = __atomic_load_n(&pool->exhausted, __ATOMIC_RELAXED);
+    stats->misuse = __atomic_load_n(&pool->misuse, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,117 @@
+/**
+ * @file csi_pool.h
+ * @brief Fixed-size lock-free pool of CSI records
+ *
+ * The WiFi CSI callback runs on the WiFi task with a small stack. Instead of
+ * building a ~530 byte csi_data_t on that stack and copying it around, the
+ * callback takes a record from this pool, fills it in place and hands the
+ * pointer on.
+ *
+ * Ownership:
+ * ---------
+ * Records are reference counted. csi_pool_alloc() returns a record with one
+ * reference owned by the caller. Whoever keeps a record beyond the call it
+ * was handed to takes its own reference with csi_pool_retain(); every
+ * reference is dropped with csi_pool_release(), and the record returns to
+ * the pool when the last one is gone. Passing a record on without retaining
+ * it transfers the caller's reference.
+ *
+ * Concurrency:
+ * -----------
+ * The free list is a Treiber stack whose head packs a 16-bit index and a
+ * 16-bit modification tag into one 32-bit word, so alloc and release are a
+ * single compare-and-swap with no ABA problem and never block: safe from the
+ * WiFi task, other tasks on either core and ISRs. Only GCC/Clang __atomic
+ * builtins are used, so the module also builds on the host.
+ */
+
+#ifndef CSI_POOL_H
+#define CSI_POOL_H
+
+#include "esp_err.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Record type, defined in wifi_csi.h
+typedef struct csi_data csi_data_t;
+
+// Largest pool supported (indices are 16 bits, the arrays below are inline)
+#define CSI_POOL_MAX_RECORDS 64
+
+/**
+ * @brief Pool usage counters
+ */
+typedef struct {
+    uint32_t capacity;         // Records in the pool
+    uint32_t in_use;           // Records currently allocated
+    uint32_t peak_in_use;      // Highest in_use seen
+    uint32_t allocations;      // Successful csi_pool_alloc() calls
+    uint32_t exhausted;        // csi_pool_alloc() calls that found the pool empty
+    uint32_t misuse;           // Releases of foreign or already-free records
+} csi_pool_stats_t;
+
+/**
+ * @brief Pool state (treat as opaque)
+ */
+typedef struct {
+    csi_data_t *records;                      // Record storage (caller provided)
+    uint32_t capacity;
+    uint32_t free_head;                       // (tag << 16) | index of first free record
+    uint32_t next[CSI_POOL_MAX_RECORDS];      // Free list links
+    uint32_t refs[CSI_POOL_MAX_RECORDS];      // Reference count per record
+    uint32_t in_use;
+    uint32_t peak_in_use;
+    uint32_t allocations;
+    uint32_t exhausted;
+    uint32_t misuse;
+} csi_pool_t;
+
+/**
+ * @brief Initialize a pool over caller-provided records
+ *
+ * Not thread safe: call before the pool is shared.
+ *
+ * @param pool     Pool to initialize
+ * @param records  Storage for capacity records
+ * @param capacity Number of records (1..CSI_POOL_MAX_RECORDS)
+ * @return ESP_OK, or ESP_ERR_INVALID_ARG
+ */
+esp_err_t csi_pool_init(csi_pool_t *pool, csi_data_t *records, uint32_t capacity);
+
+/**
+ * @brief Take a free record
+ *
+ * @return Record with one reference owned by the caller, or NULL if the pool
+ *         is exhausted (counted in csi_pool_stats_t.exhausted)
+ */
+csi_data_t *csi_pool_alloc(csi_pool_t *pool);
+
+/**
+ * @brief Take an additional reference to an allocated record
+ *
+ * @return ESP_OK, or ESP_ERR_INVALID_ARG / ESP_ERR_INVALID_STATE for a
+ *         foreign or free record
+ */
+esp_err_t csi_pool_retain(csi_pool_t *pool, const csi_data_t *record);
+
+/**
+ * @brief Drop a reference; the last one returns the record to the pool
+ *
+ * @return ESP_OK, or ESP_ERR_INVALID_ARG / ESP_ERR_INVALID_STATE for a
+ *         foreign or already-free record (counted in misuse)
+ */
+esp_err_t csi_pool_release(csi_pool_t *pool, const csi_data_t *record);
+
+/**
+ * @brief Snapshot of the usage counters
+ */
+void csi_pool_get_stats(const csi_pool_t *pool, csi_pool_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CSI_POOL_H
@@ -0,0 +1,35 @@
+/**
+ * @file csi_window_kernels.cpp
+ * @brief C entry points to the templated window statistics
+ *
+ * Nothing in this file may depend on ESP-IDF or FreeRTOS: tools/host builds
+ * it unchanged to benchmark it.
+ */
+
+#include "csi_window_kernels.h"
+#include "csi_window_kernels.hpp"
+#include "pose_dims.h"
+
+namespace {
+
+using BuildDims = csi::FixedDims<POSE_WINDOW_SAMPLES, POSE_NUM_SUBCARRIERS>;
+
+}  // namespace
+
+extern "C" void csi_window_stats_dims_f32(const float *amplitude, const float *phase,
+                                          const int8_t *rssi, csi_window_stats_t *out)
+{
+    csi::window_stats(BuildDims{}, amplitude, phase, rssi, out);
+}
+
+extern "C" void csi_window_stats_dims_i16(const int16_t *amplitude, const int16_t *phase,
+                                          const int8_t *rssi, csi_window_stats_t *out)
+{
+    csi::window_stats(BuildDims{}, amplitude, phase, rssi, out);
+}
+
+extern "C" void csi_window_stats_dims_i8(const int8_t *amplitude, const int8_t *phase,
+                                         const int8_t *rssi, csi_window_stats_t *out)
+{
+    csi::window_stats(BuildDims{}, amplitude, phase, rssi, out);
+}
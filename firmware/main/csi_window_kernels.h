@@ -0,0 +1,43 @@
+/**
+ * @file csi_window_kernels.h
+ * @brief C entry points to the templated window statistics
+ *
+ * Instantiations of csi::window_stats() (csi_window_kernels.hpp) for one
+ * window of the build's dimensions, POSE_WINDOW_SAMPLES x
+ * POSE_NUM_SUBCARRIERS (pose_dims.h). Each gives the same result as the
+ * runtime-dimension function named below for such a window.
+ */
+
+#ifndef CSI_WINDOW_KERNELS_H
+#define CSI_WINDOW_KERNELS_H
+
+#include "csi_features.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief csi_window_stats() of a float window
+ */
+void csi_window_stats_dims_f32(const float *amplitude, const float *phase, const int8_t *rssi,
+                               csi_window_stats_t *out);
+
+/**
+ * @brief csi_fixed_window_stats() of a Q8.7 / Q15 window
+ */
+void csi_window_stats_dims_i16(const int16_t *amplitude, const int16_t *phase,
+                               const int8_t *rssi, csi_window_stats_t *out);
+
+/**
+ * @brief Statistics of an int8 window (whole-unit amplitude, Q7 fraction of π)
+ */
+void csi_window_stats_dims_i8(const int8_t *amplitude, const int8_t *phase, const int8_t *rssi,
+                              csi_window_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CSI_WINDOW_KERNELS_H
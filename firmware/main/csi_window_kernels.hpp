@@ -0,0 +1,241 @@
+/**
+ * @file csi_window_kernels.hpp
+ * @brief Window statistics templated on sample type and window dimensions
+ *
+ * csi_window_stats() (float) and csi_fixed_window_stats() (int16) take the
+ * window dimensions as arguments. Here the sample type and the dimensions
+ * are template parameters, and one body serves both kinds of dimensions:
+ *
+ *   csi::window_stats(csi::FixedDims<Samples, Subcarriers>{}, amplitude, ...)
+ *   csi::window_stats(csi::RuntimeDims{samples, subcarriers}, amplitude, ...)
+ *
+ * With FixedDims every trip count and stride is a constant, so the loops
+ * unroll and the integer ones vectorize. Per-subcarrier phase sums run
+ * across subcarriers in the inner loop (the contiguous direction of the
+ * sample-major window) rather than striding down each subcarrier.
+ *
+ * Sample types (SampleTraits):
+ *
+ *   float    amplitude, phase in radians; same operations in the same order
+ *            as csi_window_stats()
+ *   int16_t  Q8.7 amplitude, Q15 fraction of π (csi_fixed.h); same integer
+ *            sums as csi_fixed_window_stats()
+ *   int8_t   amplitude in whole units, Q7 fraction of π
+ *
+ * Integer sums are exact, so the compiler may reorder them; float sums keep
+ * csi_window_stats()'s order to give the same result, so constant
+ * dimensions only buy them unrolling.
+ *
+ * C code calls the instantiations for the build's dimensions through
+ * csi_window_kernels.h. Portable like csi_features.c.
+ */
+
+#pragma once
+
+#include "csi_features.h"
+#include "csi_fixed.h"
+
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+
+namespace csi {
+
+// CSI records (wifi_csi.h) carry at most 64 subcarriers
+constexpr int kMaxWindowSubcarriers = 64;
+
+// Integer sums are exact up to the Kconfig limits (200 samples x 64 subcarriers)
+constexpr int kMaxWindowValues = 200 * kMaxWindowSubcarriers;
+
+/**
+ * @brief Window dimensions known at compile time
+ */
+template <int Samples, int Subcarriers>
+struct FixedDims {
+    static_assert(Samples > 0 && Subcarriers > 0 && Subcarriers <= kMaxWindowSubcarriers &&
+                  Samples * Subcarriers <= kMaxWindowValues,
+                  "window dimensions out of range");
+    static constexpr int max_subcarriers = Subcarriers;
+    static constexpr int samples() { return Samples; }
+    static constexpr int subcarriers() { return Subcarriers; }
+};
+
+/**
+ * @brief Window dimensions known at run time (within the limits of FixedDims)
+ */
+struct RuntimeDims {
+    static constexpr int max_subcarriers = kMaxWindowSubcarriers;
+    int num_samples;
+    int num_subcarriers;
+    int samples() const { return num_samples; }
+    int subcarriers() const { return num_subcarriers; }
+};
+
+/**
+ * @brief Scale and accumulator types of a sample type
+ */
+template <typename T>
+struct SampleTraits;
+
+template <>
+struct SampleTraits<float> {
+    using Sum = float;
+    using SquareSum = float;
+};
+
+template <>
+struct SampleTraits<int16_t> {
+    using Sum = int32_t;
+    using SquareSum = int64_t;       // One square reaches 2^30
+    static constexpr int amp_one = CSI_FIXED_AMP_ONE;
+    static constexpr int phase_one = CSI_FIXED_PHASE_ONE;
+};
+
+template <>
+struct SampleTraits<int8_t> {
+    using Sum = int32_t;
+    using SquareSum = int32_t;       // 2^14 per square, 2^28 per window
+    static constexpr int amp_one = 1;
+    static constexpr int phase_one = 128;
+};
+
+namespace detail {
+
+template <typename Dims>
+void rssi_mean(const Dims &dims, const int8_t *rssi, csi_window_stats_t *out)
+{
+    int rssi_sum = 0;
+    for (int t = 0; t < dims.samples(); t++) {
+        rssi_sum += rssi[t];
+    }
+    out->rssi_mean = (int8_t)(rssi_sum / dims.samples());
+}
+
+template <typename Dims>
+void window_stats_float(const Dims &dims, const float *amplitude, const float *phase,
+                        csi_window_stats_t *out)
+{
+    const int n = dims.subcarriers();
+    const int total = dims.samples() * n;
+
+    // Amplitude over the whole window, one running sum like csi_kernel_mean()
+    float sum = 0.0f;
+    for (int i = 0; i < total; i++) {
+        sum += amplitude[i];
+    }
+    const float mean = sum / total;
+    float sum_sq_diff = 0.0f;
+    for (int i = 0; i < total; i++) {
+        float diff = amplitude[i] - mean;
+        sum_sq_diff += diff * diff;
+    }
+    out->amplitude_mean = mean;
+    out->amplitude_std = std::sqrt(sum_sq_diff / total);
+
+    // Phase: every subcarrier's sums advance together, row by row; each
+    // subcarrier still adds its samples in time order
+    float sub_mean[Dims::max_subcarriers];
+    float sub_sq[Dims::max_subcarriers];
+    for (int s = 0; s < n; s++) {
+        sub_mean[s] = 0.0f;
+        sub_sq[s] = 0.0f;
+    }
+    for (int t = 0; t < dims.samples(); t++) {
+        const float *row = &phase[t * n];
+        for (int s = 0; s < n; s++) {
+            sub_mean[s] += row[s];
+        }
+    }
+    for (int s = 0; s < n; s++) {
+        sub_mean[s] /= dims.samples();
+    }
+    for (int t = 0; t < dims.samples(); t++) {
+        const float *row = &phase[t * n];
+        for (int s = 0; s < n; s++) {
+            float diff = row[s] - sub_mean[s];
+            sub_sq[s] += diff * diff;
+        }
+    }
+    float total_phase_var = 0.0f;
+    for (int s = 0; s < n; s++) {
+        float sub_std = std::sqrt(sub_sq[s] / dims.samples());
+        total_phase_var += sub_std * sub_std;
+    }
+    out->phase_variance = std::sqrt(total_phase_var / n);
+}
+
+template <typename T, typename Dims>
+void window_stats_integer(const Dims &dims, const T *amplitude, const T *phase,
+                          csi_window_stats_t *out)
+{
+    using Traits = SampleTraits<T>;
+    using Sum = typename Traits::Sum;
+    using SquareSum = typename Traits::SquareSum;
+    const int n = dims.subcarriers();
+    const int samples = dims.samples();
+    const int total = samples * n;
+
+    // Amplitude over the whole window: exact, so free to vectorize
+    Sum sum = 0;
+    SquareSum sum_sq = 0;
+    for (int i = 0; i < total; i++) {
+        sum += amplitude[i];
+        sum_sq += (SquareSum)amplitude[i] * amplitude[i];
+    }
+    // sqrt(total^2 variance) = total * std
+    uint32_t scaled_std = csi_fixed_isqrt64((uint64_t)((int64_t)total * sum_sq -
+                                                       (int64_t)sum * sum));
+    out->amplitude_mean = (float)sum / ((float)total * Traits::amp_one);
+    out->amplitude_std = (float)scaled_std / ((float)total * Traits::amp_one);
+
+    // Phase: variance per subcarrier over time, summed
+    Sum sub_sum[Dims::max_subcarriers];
+    SquareSum sub_sq[Dims::max_subcarriers];
+    for (int s = 0; s < n; s++) {
+        sub_sum[s] = 0;
+        sub_sq[s] = 0;
+    }
+    for (int t = 0; t < samples; t++) {
+        const T *row = &phase[t * n];
+        for (int s = 0; s < n; s++) {
+            sub_sum[s] += row[s];
+            sub_sq[s] += (SquareSum)row[s] * row[s];
+        }
+    }
+    int64_t total_var = 0;
+    for (int s = 0; s < n; s++) {
+        total_var += ((int64_t)samples * sub_sq[s] - (int64_t)sub_sum[s] * sub_sum[s]) /
+                     ((int64_t)samples * samples);
+    }
+    uint32_t rms = csi_fixed_isqrt64((uint64_t)(total_var / n));
+    out->phase_variance = (float)rms * (3.14159265358979323846f / Traits::phase_one);
+}
+
+}  // namespace detail
+
+/**
+ * @brief Statistics of one sample-major window
+ *
+ * @param dims      FixedDims<Samples, Subcarriers>{} or RuntimeDims{...}
+ * @param amplitude dims.samples() * dims.subcarriers() samples
+ * @param phase     dims.samples() * dims.subcarriers() samples
+ * @param rssi      RSSI per sample
+ * @param out       Output statistics
+ */
+template <typename T, typename Dims>
+void window_stats(const Dims &dims, const T *amplitude, const T *phase, const int8_t *rssi,
+                  csi_window_stats_t *out)
+{
+    if (dims.samples() <= 0 || dims.subcarriers() <= 0) {
+        *out = csi_window_stats_t{};
+        return;
+    }
+    if constexpr (std::is_floating_point_v<T>) {
+        detail::window_stats_float(dims, amplitude, phase, out);
+    } else {
+        detail::window_stats_integer(dims, amplitude, phase, out);
+    }
+    detail::rssi_mean(dims, rssi, out);
+}
+
+}  // namespace csi
@@ -0,0 +1,126 @@
+/**
+ * @file deadline_sched.c
+ * @brief Per-window time budget with stepwise degradation of the pipeline
+ */
+
+#include "deadline_sched.h"
+#include <stdbool.h>
+#include <string.h>
+
+void deadline_default_config(deadline_config_t *config, uint32_t deadline_us)
+{
+    config->deadline_us = deadline_us;
+    config->recover_fraction = 0.75f;
+    config->recover_windows = 4;
+    config->decay = 0.25f;
+    config->probe_windows = 100;
+}
+
+void deadline_init(deadline_sched_t *sched, const deadline_config_t *config)
+{
+    memset(sched, 0, sizeof(*sched));
+    sched->config = *config;
+    sched->level = DEADLINE_LEVEL_FULL;
+    sched->last_level = DEADLINE_LEVEL_FULL;
+}
+
+/**
+ * @brief Projected cost of a level, from the current level's estimate
+ *
+ * @return Cost, or a negative value if a cheaper level's ratio is unknown
+ */
+static float projected_cost(const deadline_sched_t *sched, int level)
+{
+    float cost = sched->cost_us[sched->level];
+    for (int l = sched->level + 1; l <= level; l++) {
+        if (sched->ratio[l] <= 0.0f) {
+            return -1.0f;
+        }
+        cost *= sched->ratio[l];
+    }
+    // A dearer level with no known ratio is assumed to cost the same
+    for (int l = sched->level; l > level; l--) {
+        if (sched->ratio[l] > 0.0f) {
+            cost /= sched->ratio[l];
+        }
+    }
+    return cost;
+}
+
+deadline_level_t deadline_begin(deadline_sched_t *sched)
+{
+    const float budget = (float)sched->config.deadline_us;
+    int level = sched->level;
+    if (sched->cost_us[level] <= 0.0f || sched->windows == sched->decided_windows) {
+        return sched->level;  // Nothing measured at this level, or since the last call
+    }
+    sched->decided_windows = sched->windows;
+
+    if (sched->cost_us[level] > budget) {
+        // At least one step; more while the projection says they are needed
+        sched->calm = 0;
+        while (level < DEADLINE_LEVELS - 1) {
+            level++;
+            float cost = projected_cost(sched, level);
+            if (cost < 0.0f || cost <= budget) {
+                break;
+            }
+        }
+        sched->level = (deadline_level_t)level;
+    } else if (level > DEADLINE_LEVEL_FULL) {
+        const float room = sched->config.recover_fraction * budget;
+        if (projected_cost(sched, level - 1) <= room) {
+            sched->calm++;
+        } else {
+            sched->calm = 0;
+        }
+        // A ratio learned under a spike overstates the level above: try it
+        // now and then anyway, as long as this level leaves room
+        bool probe = ++sched->held >= sched->config.probe_windows && sched->cost_us[level] <= room;
+        if (sched->calm >= sched->config.recover_windows || probe) {
+            sched->level = (deadline_level_t)(level - 1);
+        }
+    }
+    if (sched->level != (deadline_level_t)level || level == DEADLINE_LEVEL_FULL) {
+        sched->calm = 0;
+        sched->held = 0;
+    }
+    return sched->level;
+}
+
+void deadline_end(deadline_sched_t *sched, deadline_level_t level, uint32_t cost_us)
+{
+    const float cost = (float)cost_us;
+    sched->windows++;
+    sched->level_windows[level]++;
+    if (cost_us > sched->config.deadline_us) {
+        sched->misses++;
+    }
+
+    if (level != sched->last_level || sched->cost_us[level] <= 0.0f) {
+        // First window at this level since it was entered: an old estimate
+        // may come from another load, so start over from this one
+        sched->cost_us[level] = cost;
+
+        // One level up from a window that met the deadline: both ran under
+        // about the same load, so learn their ratio. Stepping down follows
+        // a slow window, which says more about the load than the level
+        if ((int)level == (int)sched->last_level - 1 && cost > 0.0f &&
+            sched->last_cost_us > 0.0f && sched->last_cost_us <= (float)sched->config.deadline_us) {
+            int cheaper = sched->last_level;
+            float ratio = sched->last_cost_us / cost;
+            ratio = ratio < 1.0f ? ratio : 1.0f;
+            float *learned = &sched->ratio[cheaper];
+            *learned = *learned > 0.0f ? *learned + sched->config.decay * (ratio - *learned)
+                                       : ratio;
+        }
+    } else if (cost > sched->cost_us[level]) {
+        // Slower: believe it at once
+        sched->cost_us[level] = cost;
+    } else {
+        sched->cost_us[level] += sched->config.decay * (cost - sched->cost_us[level]);
+    }
+
+    sched->last_level = level;
+    sched->last_cost_us = cost;
+}
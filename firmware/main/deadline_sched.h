@@ -0,0 +1,116 @@
+/**
+ * @file deadline_sched.h
+ * @brief Per-window time budget with stepwise degradation of the pipeline
+ *
+ * run_inference() runs synchronously in the WiFi driver's CSI callback
+ * (wifi_csi_rx_cb() -> csi_to_pose_callback()): while it works the WiFi RX
+ * task is blocked, and the CSI packets that arrive meanwhile are dropped,
+ * leaving gaps in the next windows. The scheduler keeps a cost
+ * estimate for each degradation level and, before a window, picks the
+ * level whose projected cost fits the deadline:
+ *
+ *   DEADLINE_LEVEL_FULL            every stage
+ *   DEADLINE_LEVEL_NO_SPECTRAL     no breathing spectrum, no zone lookup
+ *   DEADLINE_LEVEL_HALF_OCCUPANCY  occupancy from the newest half window
+ *   DEADLINE_LEVEL_THRESHOLD       window statistics and the threshold
+ *                                  detector only; occupancy from presence
+ *
+ * Costs rise to a slower measurement at once and decay slowly, so a load
+ * spike degrades the next window. Levels that have not run yet are
+ * projected from the cost ratio between neighbouring levels, learned when
+ * the scheduler steps up from a window that met the deadline;
+ * with no ratio known yet it moves one level per window. It steps back up
+ * once the level above is projected to fit within recover_fraction of the
+ * deadline for recover_windows windows in a row, and tries the level above
+ * every probe_windows windows in case a spike skewed a ratio. Only
+ * measured windows count towards these: a deadline_begin() with no
+ * deadline_end() since the last one (a window that was skipped, not
+ * computed) keeps the level and changes nothing.
+ *
+ * tools/host/deadline_check runs it under artificial CPU load.
+ */
+
+#ifndef DEADLINE_SCHED_H
+#define DEADLINE_SCHED_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Degradation levels, cheapest last
+ */
+typedef enum {
+    DEADLINE_LEVEL_FULL = 0,
+    DEADLINE_LEVEL_NO_SPECTRAL = 1,
+    DEADLINE_LEVEL_HALF_OCCUPANCY = 2,
+    DEADLINE_LEVEL_THRESHOLD = 3,
+} deadline_level_t;
+
+#define DEADLINE_LEVELS 4
+
+/**
+ * @brief Scheduler configuration
+ */
+typedef struct {
+    uint32_t deadline_us;      // Budget of one window
+    float recover_fraction;    // Step up once the level above fits this share of the budget
+    int recover_windows;       // ... for this many windows in a row
+    float decay;               // Weight of a faster measurement in the cost estimate
+    int probe_windows;         // Try the level above after this many windows regardless
+} deadline_config_t;
+
+/**
+ * @brief Scheduler state and counters
+ */
+typedef struct {
+    deadline_config_t config;
+    float cost_us[DEADLINE_LEVELS];    // Cost estimate per level, 0 until measured
+    float ratio[DEADLINE_LEVELS];      // cost(level) / cost(level - 1), 0 until learned
+    deadline_level_t level;            // Level of the next window
+    deadline_level_t last_level;       // Level of the last measured window
+    float last_cost_us;                // Its cost
+    int calm;                          // Windows in a row with room to step up
+    int held;                          // Windows at a degraded level since the last step
+    uint32_t windows;                  // Windows measured
+    uint32_t decided_windows;          // Windows measured when the level was last picked
+    uint32_t misses;                   // Windows over the deadline
+    uint32_t level_windows[DEADLINE_LEVELS];  // Windows measured per level
+} deadline_sched_t;
+
+/**
+ * @brief Default configuration for a budget: recover at 75% for 4 windows,
+ *        probe every 100
+ */
+void deadline_default_config(deadline_config_t *config, uint32_t deadline_us);
+
+/**
+ * @brief Initialize (or reset) a scheduler at DEADLINE_LEVEL_FULL
+ */
+void deadline_init(deadline_sched_t *sched, const deadline_config_t *config);
+
+/**
+ * @brief Level to run the next window at
+ *
+ * Degrades while the projected cost exceeds the deadline, or steps up one
+ * level when there has been room for long enough. Call it only for
+ * windows that are computed and measured with deadline_end(); without a
+ * new measurement it returns the current level unchanged.
+ */
+deadline_level_t deadline_begin(deadline_sched_t *sched);
+
+/**
+ * @brief Record what a window cost
+ *
+ * @param level   Level it ran at (normally the one deadline_begin() returned)
+ * @param cost_us Time it took
+ */
+void deadline_end(deadline_sched_t *sched, deadline_level_t level, uint32_t cost_us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DEADLINE_SCHED_H
@@ -0,0 +1,197 @@
+/**
+ * @file event_detector.c
+ * @brief Per-sample sudden-event and fall detection (CUSUM on motion energy)
+ */
+
+#include "event_detector.h"
+#include "pose_record.h"
+#include <math.h>
+#include <string.h>
+
+// Keeps log10 finite for identical consecutive samples
+#define ENERGY_FLOOR 1e-6f
+
+void event_detector_default_config(event_detector_config_t *config, float sample_rate_hz)
+{
+    config->short_samples = (int)(0.04f * sample_rate_hz + 0.5f);
+    config->long_samples = (int)(5.0f * sample_rate_hz + 0.5f);
+    config->warmup_samples = (int)(2.0f * sample_rate_hz + 0.5f);
+    config->min_spread_db = 1.5f;
+    config->drift = 1.0f;
+    config->threshold = 12.0f;
+    config->fall_rise_db = 6.0f;
+    config->still_margin_db = 0.0f;
+    config->settle_samples = (int)(1.0f * sample_rate_hz + 0.5f);
+    config->still_samples = (int)(1.0f * sample_rate_hz + 0.5f);
+    if (config->short_samples < 1) {
+        config->short_samples = 1;
+    }
+}
+
+esp_err_t event_detector_init(event_detector_t *det, const event_detector_config_t *config)
+{
+    if (config->short_samples < 1 || config->long_samples < 1 || config->warmup_samples < 0 ||
+        config->settle_samples < 0 || config->still_samples < 1 ||
+        !(config->min_spread_db > 0.0f) || !(config->threshold > 0.0f) ||
+        !(config->drift >= 0.0f)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memset(det, 0, sizeof(*det));
+    det->config = *config;
+    det->hold = -1;
+    return ESP_OK;
+}
+
+/**
+ * @brief Mean squared change since the previous sample, in dB
+ */
+static float motion_energy_db(event_detector_t *det, const float *amplitude, int subs)
+{
+    float sum = 0.0f;
+    for (int s = 0; s < subs; s++) {
+        float d = amplitude[s] - det->prev[s];
+        sum += d * d;
+        det->prev[s] = amplitude[s];
+    }
+    return 10.0f * log10f(sum / subs + ENERGY_FLOOR);
+}
+
+/**
+ * @brief Follow a fired event; true when it turns out to be a fall
+ */
+static bool follow_event(event_detector_t *det, motion_event_t *event)
+{
+    const event_detector_config_t *cfg = &det->config;
+
+    det->hold++;
+    if (det->short_db > det->peak_db) {
+        det->peak_db = det->short_db;
+    }
+    if (det->hold <= cfg->settle_samples) {
+        return false;
+    }
+    det->still_sum += det->short_db;
+    if (det->hold < cfg->settle_samples + cfg->still_samples) {
+        return false;
+    }
+
+    // Resume tracking at the level after the event
+    float still_db = det->still_sum / cfg->still_samples;
+    float rise_db = det->peak_db - det->baseline_db;
+    bool fall = rise_db >= cfg->fall_rise_db && still_db <= det->baseline_db + cfg->still_margin_db;
+    det->long_db = still_db;
+    det->cusum = 0.0f;
+    det->hold = -1;
+
+    if (fall) {
+        *event = det->pending;
+        event->type = MOTION_EVENT_FALL;
+        event->sample = det->samples - 1;
+        event->rise_db = rise_db;
+    }
+    return fall;
+}
+
+bool event_detector_push(event_detector_t *det, const float *amplitude, int num_subcarriers,
+                         motion_event_t *event)
+{
+    const event_detector_config_t *cfg = &det->config;
+    int subs = num_subcarriers < EVENT_MAX_SUBCARRIERS ? num_subcarriers : EVENT_MAX_SUBCARRIERS;
+    if (subs <= 0) {
+        return false;
+    }
+    if (!det->primed) {
+        memcpy(det->prev, amplitude, subs * sizeof(float));
+        det->primed = true;
+        return false;
+    }
+
+    float energy_db = motion_energy_db(det, amplitude, subs);
+    det->samples++;
+    if (det->samples == 1) {
+        det->short_db = energy_db;
+        det->long_db = energy_db;
+        det->long_var = cfg->min_spread_db * cfg->min_spread_db;
+        return false;
+    }
+    det->short_db += (energy_db - det->short_db) / cfg->short_samples;
+
+    if (det->hold >= 0) {
+        return follow_event(det, event);
+    }
+
+    float min_var = cfg->min_spread_db * cfg->min_spread_db;
+    float diff = det->short_db - det->long_db;
+    float z = diff / sqrtf(det->long_var > min_var ? det->long_var : min_var);
+    det->cusum = fmaxf(0.0f, det->cusum + z - cfg->drift);
+
+    if (det->samples > (uint32_t)cfg->warmup_samples && det->cusum >= cfg->threshold) {
+        det->events++;
+        det->pending = (motion_event_t){
+            .id = det->events,
+            .type = MOTION_EVENT_SUDDEN,
+            .sample = det->samples - 1,
+            .score = det->cusum,
+            .rise_db = diff,
+        };
+        det->hold = 0;
+        det->baseline_db = det->long_db;
+        det->peak_db = det->short_db;
+        det->still_sum = 0.0f;
+        *event = det->pending;
+        return true;
+    }
+
+    // Baseline: converges quickly while warming up, then follows slowly
+    int n = (int)det->samples < cfg->long_samples ? (int)det->samples : cfg->long_samples;
+    det->long_db += diff / n;
+    det->long_var += (diff * diff - det->long_var) / n;
+    return false;
+}
+
+static void put_u32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static uint32_t get_u32(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+size_t motion_event_encode(const motion_event_t *event, uint8_t *buf, size_t capacity)
+{
+    uint8_t *p = pose_record_begin(buf, capacity, POSE_RECORD_TYPE_EVENT,
+                                   MOTION_EVENT_RECORD_BYTES);
+    if (p == NULL) {
+        return 0;
+    }
+    float rise = event->rise_db * 2.0f + 0.5f;
+    float score = event->score * 10.0f + 0.5f;
+    put_u32(&p[0], event->id);
+    put_u32(&p[4], event->timestamp);
+    p[8] = (uint8_t)event->type;
+    p[9] = rise <= 0.0f ? 0 : (rise >= 255.0f ? 255 : (uint8_t)rise);
+    uint16_t s = score <= 0.0f ? 0 : (score >= 65535.0f ? 65535 : (uint16_t)score);
+    p[10] = (uint8_t)s;
+    p[11] = (uint8_t)(s >> 8);
+    return pose_record_finish(buf);
+}
+
+esp_err_t motion_event_decode(const uint8_t *payload, size_t len, motion_event_t *event)
+{
+    if (len != MOTION_EVENT_RECORD_BYTES ||
+        (payload[8] != MOTION_EVENT_SUDDEN && payload[8] != MOTION_EVENT_FALL)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memset(event, 0, sizeof(*event));
+    event->id = get_u32(&payload[0]);
+    event->timestamp = get_u32(&payload[4]);
+    event->type = (motion_event_type_t)payload[8];
+    event->rise_db = payload[9] / 2.0f;
+    event->score = (payload[10] | (payload[11] << 8)) / 10.0f;
+    return ESP_OK;
+}
@@ -0,0 +1,155 @@
+/**
+ * @file event_detector.h
+ * @brief Per-sample sudden-event and fall detection (CUSUM on motion energy)
+ *
+ * Window classification reports every 500ms, and a fall is over in less
+ * than that. This detector runs on every CSI sample instead:
+ *
+ *   energy  e_t = mean over subcarriers of (a_t - a_{t-1})^2, in dB
+ *   short   fast average of e_t (tens of ms): the current motion level
+ *   long    slow average of short and its spread (seconds): the baseline
+ *   CUSUM   S_t = max(0, S_{t-1} + (short - long) / spread - drift)
+ *
+ * S_t crossing the threshold is a sudden rise of motion against whatever
+ * the room was doing before (a fall, but also someone walking in), and
+ * fires MOTION_EVENT_SUDDEN at once, within a few samples of the onset.
+ * The detector then holds the pre-event baseline and watches what follows:
+ * a large enough peak followed by stillness (motion no higher than before
+ * the event) is confirmed with MOTION_EVENT_FALL for the same event id.
+ * Other sudden events just resume baseline tracking at the new level.
+ *
+ * motion_event_encode() writes an event as a POSE_RECORD_TYPE_EVENT record
+ * (pose_record.h):
+ *
+ *   offset size  field
+ *        0    4  event id (a FALL repeats the id of its SUDDEN)
+ *        4    4  timestamp (ms)
+ *        8    1  type (motion_event_type_t)
+ *        9    1  peak rise over the baseline, 0.5 dB
+ *       10    2  CUSUM statistic at the trigger, 0.1
+ */
+
+#ifndef EVENT_DETECTOR_H
+#define EVENT_DETECTOR_H
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Subcarriers the detector compares between samples
+#define EVENT_MAX_SUBCARRIERS 64
+
+// Event record payload
+#define MOTION_EVENT_RECORD_BYTES 12
+
+/**
+ * @brief Event types
+ */
+typedef enum {
+    MOTION_EVENT_SUDDEN = 1,  // Sudden rise of motion (fired at the onset)
+    MOTION_EVENT_FALL = 2,    // The sudden event was a fall (peak, then stillness)
+} motion_event_type_t;
+
+/**
+ * @brief One detected event
+ */
+typedef struct {
+    uint32_t id;               // Event number since init
+    motion_event_type_t type;  // Event type
+    uint32_t sample;           // Input sample that fired the event
+    uint32_t timestamp;        // Milliseconds (set by the caller)
+    float score;               // CUSUM statistic at the trigger
+    float rise_db;             // Peak motion energy over the pre-event baseline
+} motion_event_t;
+
+/**
+ * @brief Detector configuration (durations in samples)
+ */
+typedef struct {
+    int short_samples;         // Time constant of the short average
+    int long_samples;          // Time constant of the baseline
+    int warmup_samples;        // No events until the baseline has this many samples
+    float min_spread_db;       // Floor of the baseline spread
+    float drift;               // CUSUM allowance per sample (in spreads)
+    float threshold;           // CUSUM decision threshold
+    float fall_rise_db;        // Peak rise over the baseline a fall needs
+    float still_margin_db;     // Stillness: mean energy at most baseline + margin
+    int settle_samples;        // From the trigger to the stillness check
+    int still_samples;         // Length of the stillness check
+} event_detector_config_t;
+
+/**
+ * @brief Detector state (treat as opaque)
+ */
+typedef struct {
+    event_detector_config_t config;
+    float prev[EVENT_MAX_SUBCARRIERS];  // Amplitudes of the previous sample
+    bool primed;                        // prev is valid
+    uint32_t samples;                   // Samples seen since init
+    uint32_t events;                    // SUDDEN events fired
+    float short_db;                     // Short average of the energy
+    float long_db;                      // Baseline
+    float long_var;                     // Baseline spread squared
+    float cusum;                        // CUSUM statistic
+    // Event being followed, hold < 0 when idle
+    int hold;                           // Samples since the trigger
+    float baseline_db;                  // Baseline at the trigger
+    float peak_db;                      // Highest short average since the trigger
+    float still_sum;                    // Energy summed over the stillness check
+    motion_event_t pending;             // The SUDDEN event, for its FALL
+} event_detector_t;
+
+/**
+ * @brief Default configuration for a sample rate
+ *
+ * 40ms short average, 5s baseline, 2s of warm-up. A fall is confirmed
+ * 2s after its onset: 1s to settle, then 1s of stillness.
+ */
+void event_detector_default_config(event_detector_config_t *config, float sample_rate_hz);
+
+/**
+ * @brief Initialize a detector
+ *
+ * @return ESP_OK, or ESP_ERR_INVALID_ARG if a duration or threshold is not positive
+ */
+esp_err_t event_detector_init(event_detector_t *det, const event_detector_config_t *config);
+
+/**
+ * @brief Add one CSI sample
+ *
+ * @param det             Detector
+ * @param amplitude       Subcarrier amplitudes
+ * @param num_subcarriers Subcarriers (only the first EVENT_MAX_SUBCARRIERS are used)
+ * @param event           Output: the event, when one fires
+ * @return true if an event fired on this sample
+ */
+bool event_detector_push(event_detector_t *det, const float *amplitude, int num_subcarriers,
+                         motion_event_t *event);
+
+/**
+ * @brief Encode an event as a POSE_RECORD_TYPE_EVENT record
+ *
+ * @return Record size in bytes, or 0 if buf is too small
+ */
+size_t motion_event_encode(const motion_event_t *event, uint8_t *buf, size_t capacity);
+
+/**
+ * @brief Decode the payload of a POSE_RECORD_TYPE_EVENT record
+ *
+ * @param payload Record payload (pose_record_parse())
+ * @param len     Payload size
+ * @param event   Output event (sample is not part of the record and reads 0)
+ * @return ESP_OK, or ESP_ERR_INVALID_ARG for a malformed payload
+ */
+esp_err_t motion_event_decode(const uint8_t *payload, size_t len, motion_event_t *event);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EVENT_DETECTOR_H
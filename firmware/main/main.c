@@ -33,6 +33,13 @@
 
 #include "wifi_csi.h"
 #include "pose_inference.h"
+#include "pose_dims.h"
+#include "mem_arena.h"
+#include "placement_bench.h"
+#include "mem_metrics.h"
+#include "pose_record.h"
+#include "console_cmd.h"
+#include "serial_console.h"
 
 // Logging tag - used to identify log messages from this file
 static const char *TAG = "main";
@@ -50,6 +57,20 @@ static EventGroupHandle_t s_wifi_event_group;
 static int s_retry_num = 0;
 #define MAX_RETRY CONFIG_WIFI_MAXIMUM_RETRY
 
+// Serial output defaults; the console can change them (console_apply)
+#ifdef CONFIG_POSE_BINARY_RECORDS
+#define DEFAULT_OUTPUT (CONSOLE_OUTPUT_CSI | CONSOLE_OUTPUT_JSON | CONSOLE_OUTPUT_BINARY)
+#else
+#define DEFAULT_OUTPUT (CONSOLE_OUTPUT_CSI | CONSOLE_OUTPUT_JSON)
+#endif
+#define DEFAULT_TRAFFIC_HZ 100
+
+// Read by the WiFi and traffic tasks, written by the console task
+static int s_output = DEFAULT_OUTPUT;
+static int s_decimation = 1;
+static int s_traffic_hz = DEFAULT_TRAFFIC_HZ;
+static uint32_t s_results_seen = 0;
+
 /**
  * @brief Pose detection callback
  *
@@ -67,17 +88,100 @@ static void pose_detection_callback(const pose_result_t *result, void *user_ctx)
     ESP_LOGI(TAG, "  Pose Class: %s", pose_names[result->pose_class % 7]);
     ESP_LOGI(TAG, "  Confidence: %.2f", result->confidence);
     ESP_LOGI(TAG, "  Motion Level: %.2f", result->motion_level);
+    if (result->breathing_quality > 0.0f) {
+        ESP_LOGI(TAG, "  Breathing: %.1f bpm (quality %.2f)",
+                 result->breathing_rate_bpm, result->breathing_quality);
+    }
+    ESP_LOGI(TAG, "  People: %d (confidence %.2f)", result->occupancy,
+             result->occupancy_confidence);
+    if (result->zone >= 0) {
+        ESP_LOGI(TAG, "  Zone: %d (probability %.2f)", result->zone,
+                 result->zone_prob[result->zone] / 255.0f);
+    }
+    if (result->skeleton.num_keypoints > 0) {
+        ESP_LOGI(TAG, "  Skeleton: %d keypoints", result->skeleton.num_keypoints);
+    }
     ESP_LOGI(TAG, "  Inference Time: %lu ms", result->inference_time_ms);
     ESP_LOGI(TAG, "  Stats: amp_mean=%.2f, amp_std=%.2f, phase_var=%.4f",
              result->amplitude_mean, result->amplitude_std, result->phase_variance);
     ESP_LOGI(TAG, "=====================");
 
+    // Print one result in s_decimation
+    if (++s_results_seen % __atomic_load_n(&s_decimation, __ATOMIC_RELAXED) != 0) {
+        return;
+    }
+    int output = __atomic_load_n(&s_output, __ATOMIC_RELAXED);
+
     // Stream pose results over serial in JSON format
-    printf("{\"pose_result\":true,\"detected\":%s,\"pose_class\":%d,\"confidence\":%.2f,\"motion\":%.2f}\n",
-           result->human_detected ? "true" : "false",
-           result->pose_class,
-           result->confidence,
-           result->motion_level);
+    if (output & CONSOLE_OUTPUT_JSON) {
+        printf("{\"pose_result\":true,\"seq\":%lu,\"detected\":%s,\"pose_class\":%d,\"confidence\":%.2f,\"motion\":%.2f,\"breathing_bpm\":%.1f,\"breathing_quality\":%.2f,\"people\":%d,\"people_confidence\":%.2f,\"zone\":%d}\n",
+               result->sequence,
+               result->human_detected ? "true" : "false",
+               result->pose_class,
+               result->confidence,
+               result->motion_level,
+               result->breathing_rate_bpm,
+               result->breathing_quality,
+               result->occupancy,
+               result->occupancy_confidence,
+               result->zone);
+
+#ifdef CONFIG_POSE_ZONES
+        // Per-link fingerprint for tools/zone_calibrate.py
+        uint8_t energy[ZONE_MAX_LINKS];
+        uint8_t macs[ZONE_MAX_LINKS][6];
+        int num_links = 0;
+        if (pose_get_zone_fingerprint(energy, macs, &num_links) == ESP_OK && num_links > 0) {
+            printf("{\"zone_energy\":[");
+            for (int l = 0; l < num_links; l++) {
+                printf("%s%d", l > 0 ? "," : "", energy[l]);
+            }
+            printf("],\"macs\":[");
+            for (int l = 0; l < num_links; l++) {
+                printf("%s\"%02x:%02x:%02x:%02x:%02x:%02x\"", l > 0 ? "," : "", macs[l][0],
+                       macs[l][1], macs[l][2], macs[l][3], macs[l][4], macs[l][5]);
+            }
+            printf("]}\n");
+        }
+#endif
+    }
+
+    if (output & CONSOLE_OUTPUT_BINARY) {
+        // Same result, skeleton included, as a framed binary record
+        uint8_t record[POSE_RECORD_MAX_BYTES];
+        size_t record_len = pose_record_encode(result, record, sizeof(record));
+        fwrite(record, 1, record_len, stdout);
+        fflush(stdout);
+    }
+}
+
+/**
+ * @brief Motion event callback
+ *
+ * Called on the CSI sample that fires the event, so the line goes out
+ * ahead of any pending window result: no logging first, flushed at once.
+ * Events are never decimated.
+ */
+static void pose_event_callback(const motion_event_t *event, void *user_ctx)
+{
+    int output = __atomic_load_n(&s_output, __ATOMIC_RELAXED);
+
+    if (output & CONSOLE_OUTPUT_JSON) {
+        printf("{\"event\":\"%s\",\"id\":%lu,\"ts\":%lu,\"score\":%.1f,\"rise_db\":%.1f}\n",
+               event->type == MOTION_EVENT_FALL ? "fall" : "sudden",
+               event->id,
+               event->timestamp,
+               event->score,
+               event->rise_db);
+    }
+
+    if (output & CONSOLE_OUTPUT_BINARY) {
+        uint8_t record[POSE_RECORD_HEADER_BYTES + MOTION_EVENT_RECORD_BYTES +
+                       POSE_RECORD_CRC_BYTES];
+        size_t record_len = motion_event_encode(event, record, sizeof(record));
+        fwrite(record, 1, record_len, stdout);
+    }
+    fflush(stdout);
 }
 
 /**
@@ -86,7 +190,12 @@ static void pose_detection_callback(const pose_result_t *result, void *user_ctx)
 static void csi_to_pose_callback(const csi_data_t *csi, void *ctx)
 {
     // Forward CSI data to pose estimation module
+    pose_process_link(csi->mac, csi->amplitude, csi->num_subcarriers);
+#if POSE_FIXED_POINT
+    pose_process_csi_q(csi->amplitude_q, csi->phase_q, csi->num_subcarriers, csi->rssi);
+#else
     pose_process_csi(csi->amplitude, csi->phase, csi->num_subcarriers, csi->rssi);
+#endif
 }
 
 /**
@@ -223,6 +332,7 @@ static void traffic_generator_task(void *pvParameters)
     esp_netif_t *netif = esp_netif_get_handle_from_ifkey("WIFI_STA_DEF");
     if (netif == NULL) {
         ESP_LOGE(TAG, "Failed to get netif handle");
+        mem_metrics_unwatch_task(NULL);
         vTaskDelete(NULL);
         return;
     }
@@ -236,6 +346,7 @@ static void traffic_generator_task(void *pvParameters)
     int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
     if (sock < 0) {
         ESP_LOGE(TAG, "Failed to create socket: errno %d", errno);
+        mem_metrics_unwatch_task(NULL);
         vTaskDelete(NULL);
         return;
     }
@@ -266,22 +377,49 @@ static void traffic_generator_task(void *pvParameters)
             ESP_LOGW(TAG, "Send failed: errno %d", errno);
         }
 
-        // Log periodically (every ~5 seconds at 100Hz)
-        if (packet_count % 500 == 0 && packet_count > 0) {
+        // Log periodically (every ~5 seconds)
+        int rate_hz = __atomic_load_n(&s_traffic_hz, __ATOMIC_RELAXED);
+        if (packet_count % (5 * rate_hz) == 0 && packet_count > 0) {
             ESP_LOGI(TAG, "Traffic gen: %lu packets sent", packet_count);
         }
 
-        // Send at ~100 Hz for good CSI rate
-        vTaskDelay(pdMS_TO_TICKS(10));
+        // Send at ~100 Hz by default for good CSI rate (traffic_hz on the console)
+        vTaskDelay(pdMS_TO_TICKS(1000 / rate_hz));
     }
 
     close(sock);
+    mem_metrics_unwatch_task(NULL);
     vTaskDelete(NULL);
 }
 
+#ifdef CONFIG_POSE_CONSOLE
+/**
+ * @brief Apply console settings (called at boot and from the console task)
+ *
+ * Pipeline tuning switches over at the next window; output choice,
+ * decimation and traffic rate are single words read by the other tasks.
+ */
+static esp_err_t console_apply(const console_settings_t *settings)
+{
+    esp_err_t ret = pose_set_tuning(&settings->tuning);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    wifi_csi_set_streaming(settings->output & CONSOLE_OUTPUT_CSI);
+    __atomic_store_n(&s_output, settings->output, __ATOMIC_RELAXED);
+    __atomic_store_n(&s_decimation, settings->decimation, __ATOMIC_RELAXED);
+    __atomic_store_n(&s_traffic_hz, settings->traffic_hz, __ATOMIC_RELAXED);
+    return ESP_OK;
+}
+#endif
+
 static void start_traffic_generator(void)
 {
-    xTaskCreate(traffic_generator_task, "traffic_gen", 4096, NULL, 5, NULL);
+    TaskHandle_t task = NULL;
+    xTaskCreate(traffic_generator_task, "traffic_gen", 4096, NULL, 5, &task);
+    if (task != NULL) {
+        mem_metrics_watch_task(task, "traffic_gen");
+    }
 }
 
 /**
@@ -339,6 +477,28 @@ void app_main(void)
     }
     ESP_ERROR_CHECK(ret);
 
+    // Heap/stack instrumentation (installs the failed-allocation hook)
+    mem_metrics_init(NULL);
+    mem_metrics_watch_task(NULL, "main");
+
+#ifdef CONFIG_POSE_PLACEMENT_BENCH
+    // Compare SRAM/PSRAM/hot-cold placement before the arena takes the memory
+    placement_bench_run(20);
+#endif
+
+    // Carve every long-lived buffer from one internal SRAM block and one
+    // PSRAM block, so there is no heap churn once the pipeline is running
+    const mem_budget_t budgets[] = {
+        wifi_csi_get_memory_budget(),
+        pose_get_memory_budget(),
+    };
+    ret = mem_arena_init(budgets, sizeof(budgets) / sizeof(budgets[0]));
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Memory budget does not fit!");
+        return;
+    }
+    mem_arena_print_layout();
+
     // Initialize WiFi in station mode
     ret = wifi_init_sta();
     if (ret != ESP_OK) {
@@ -355,11 +515,14 @@ void app_main(void)
         return;
     }
 
+    // CSI callbacks, and with them pose inference, run on the WiFi driver task
+    mem_metrics_watch_task_by_name("wifi");
+
     // Initialize pose estimation module
     pose_config_t pose_cfg = {
-        .window_size_ms = 500,
-        .sampling_rate_hz = 100,
-        .num_subcarriers = 52,
+        .window_size_ms = POSE_WINDOW_MS,
+        .sampling_rate_hz = POSE_SAMPLE_RATE_HZ,
+        .num_subcarriers = POSE_NUM_SUBCARRIERS,
         .use_amplitude = true,
         .use_phase = true,
         .enable_presence_detection = true,
@@ -377,6 +540,18 @@ void app_main(void)
 
     // Register pose detection result callback
     pose_register_callback(pose_detection_callback, NULL);
+    pose_register_event_callback(pose_event_callback, NULL);
+
+#ifdef CONFIG_POSE_CONSOLE
+    // Settings saved with the console's "save" command override the defaults
+    console_settings_t console_defaults = {
+        .output = DEFAULT_OUTPUT,
+        .decimation = 1,
+        .traffic_hz = DEFAULT_TRAFFIC_HZ,
+    };
+    pose_get_tuning(&console_defaults.tuning);
+    serial_console_start(&console_defaults, console_apply);
+#endif
 
     // Start traffic generator to create WiFi packets for CSI collection
     // CSI is only captured when packets are being sent/received!
@@ -394,6 +569,15 @@ void app_main(void)
                  esp_get_free_heap_size(),
                  esp_get_minimum_free_heap_size());
 
+        // Dropped packets here mean consumers hold CSI records too long
+        csi_pool_stats_t pool;
+        wifi_csi_get_pool_stats(&pool);
+        ESP_LOGI(TAG, "CSI pool: %lu/%lu in use, peak %lu, exhausted %lu",
+                 pool.in_use, pool.capacity, pool.peak_in_use, pool.exhausted);
+
+        // Check memory thresholds; the full report is the console's "stats"
+        mem_metrics_poll(NULL);
+
         // Delay for 10 seconds
         // vTaskDelay is the FreeRTOS way to sleep - it yields to other tasks
         vTaskDelay(pdMS_TO_TICKS(10000));
@@ -0,0 +1,270 @@
+/**
+ * @file mem_arena.c
+ * @brief Startup arena for all long-lived pose/CSI buffers
+ *
+ * Only ESP-IDF's logging and heap_caps APIs are used here; tools/host
+ * provides stand-ins for both so the arena also builds on the host.
+ */
+
+#include "mem_arena.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include <string.h>
+
+static const char *TAG = "mem_arena";
+
+// Maximum number of module budgets passed to mem_arena_init()
+#define MEM_ARENA_MAX_BUDGETS 8
+
+static const char *const s_region_names[MEM_REGION_COUNT] = {
+    "internal",
+    "psram",
+};
+
+static const uint32_t s_region_caps[MEM_REGION_COUNT] = {
+    MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT,
+    MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT,
+};
+
+// State variables
+static bool s_initialized = false;
+static uint8_t *s_region_base[MEM_REGION_COUNT];
+static size_t s_region_used[MEM_REGION_COUNT];
+static mem_budget_t s_budgets[MEM_ARENA_MAX_BUDGETS];
+static size_t s_num_budgets = 0;
+
+static size_t entry_align(const mem_budget_entry_t *e)
+{
+    return e->align ? e->align : MEM_ARENA_DEFAULT_ALIGN;
+}
+
+static size_t align_up(size_t value, size_t align)
+{
+    return (value + align - 1) & ~(align - 1);
+}
+
+/**
+ * @brief Lay out every entry in budget order
+ *
+ * The layout depends only on the budgets, so the same walk is used to size
+ * the regions, to carve the buffers and to print the layout map.
+ *
+ * @param used      Output: bytes used per region
+ * @param max_align Output: largest alignment requested per region
+ * @param carve     Store buffer addresses in the entries' out pointers
+ */
+static esp_err_t walk_layout(size_t used[MEM_REGION_COUNT], size_t max_align[MEM_REGION_COUNT],
+                             bool carve)
+{
+    for (int r = 0; r < MEM_REGION_COUNT; r++) {
+        used[r] = 0;
+        max_align[r] = MEM_ARENA_DEFAULT_ALIGN;
+    }
+
+    for (size_t b = 0; b < s_num_budgets; b++) {
+        for (size_t i = 0; i < s_budgets[b].count; i++) {
+            const mem_budget_entry_t *e = &s_budgets[b].entries[i];
+            size_t align = entry_align(e);
+            if (e->region >= MEM_REGION_COUNT || e->out == NULL || (align & (align - 1)) != 0) {
+                ESP_LOGE(TAG, "Invalid budget entry '%s'", e->name ? e->name : "?");
+                return ESP_ERR_INVALID_ARG;
+            }
+            size_t offset = align_up(used[e->region], align);
+            if (carve) {
+                *e->out = s_region_base[e->region] + offset;
+            }
+            used[e->region] = offset + e->size;
+            if (align > max_align[e->region]) {
+                max_align[e->region] = align;
+            }
+        }
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief Explain why a region could not be allocated
+ */
+static void report_failure(mem_region_t failed, const size_t used[MEM_REGION_COUNT])
+{
+    ESP_LOGE(TAG, "Memory budget does not fit in %s: need %zu bytes, "
+                  "free %zu, largest block %zu",
+             s_region_names[failed], used[failed],
+             heap_caps_get_free_size(s_region_caps[failed]),
+             heap_caps_get_largest_free_block(s_region_caps[failed]));
+
+    for (size_t b = 0; b < s_num_budgets; b++) {
+        for (size_t i = 0; i < s_budgets[b].count; i++) {
+            const mem_budget_entry_t *e = &s_budgets[b].entries[i];
+            if (e->region == failed) {
+                ESP_LOGE(TAG, "  %-24s %8zu bytes", e->name, e->size);
+            }
+        }
+    }
+
+    for (int r = 0; r < MEM_REGION_COUNT; r++) {
+        ESP_LOGE(TAG, "  [%s] budget %zu bytes, free %zu, largest block %zu",
+                 s_region_names[r], used[r],
+                 heap_caps_get_free_size(s_region_caps[r]),
+                 heap_caps_get_largest_free_block(s_region_caps[r]));
+    }
+}
+
+static void clear_out_pointers(void)
+{
+    for (size_t b = 0; b < s_num_budgets; b++) {
+        for (size_t i = 0; i < s_budgets[b].count; i++) {
+            *s_budgets[b].entries[i].out = NULL;
+        }
+    }
+}
+
+esp_err_t mem_arena_init(const mem_budget_t *budgets, size_t num_budgets)
+{
+    if (s_initialized) {
+        ESP_LOGE(TAG, "Already initialized");
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (budgets == NULL || num_budgets > MEM_ARENA_MAX_BUDGETS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memcpy(s_budgets, budgets, num_budgets * sizeof(mem_budget_t));
+    s_num_budgets = num_budgets;
+
+    size_t used[MEM_REGION_COUNT];
+    size_t max_align[MEM_REGION_COUNT];
+    esp_err_t ret = walk_layout(used, max_align, false);
+    if (ret != ESP_OK) {
+        s_num_budgets = 0;
+        return ret;
+    }
+
+    // One block per region; fail fast without leaking the other region
+    for (int r = 0; r < MEM_REGION_COUNT; r++) {
+        s_region_base[r] = NULL;
+        if (used[r] == 0) {
+            continue;
+        }
+        s_region_base[r] = heap_caps_aligned_alloc(max_align[r], used[r], s_region_caps[r]);
+        if (s_region_base[r] == NULL) {
+            report_failure((mem_region_t)r, used);
+            for (int p = 0; p < r; p++) {
+                heap_caps_free(s_region_base[p]);
+                s_region_base[p] = NULL;
+                s_region_used[p] = 0;
+            }
+            clear_out_pointers();
+            s_num_budgets = 0;
+            return ESP_ERR_NO_MEM;
+        }
+        memset(s_region_base[r], 0, used[r]);
+        s_region_used[r] = used[r];
+    }
+
+    // Carve buffers
+    walk_layout(used, max_align, true);
+
+    s_initialized = true;
+    ESP_LOGI(TAG, "Arena ready: %zu bytes internal, %zu bytes PSRAM",
+             s_region_used[MEM_REGION_INTERNAL], s_region_used[MEM_REGION_PSRAM]);
+    return ESP_OK;
+}
+
+void mem_arena_deinit(void)
+{
+    if (!s_initialized) {
+        return;
+    }
+
+    clear_out_pointers();
+    for (int r = 0; r < MEM_REGION_COUNT; r++) {
+        if (s_region_base[r] != NULL) {
+            heap_caps_free(s_region_base[r]);
+            s_region_base[r] = NULL;
+        }
+        s_region_used[r] = 0;
+    }
+    s_num_budgets = 0;
+    s_initialized = false;
+}
+
+bool mem_arena_is_ready(void)
+{
+    return s_initialized;
+}
+
+void mem_arena_print_layout(void)
+{
+    if (!s_initialized) {
+        ESP_LOGW(TAG, "Arena not initialized");
+        return;
+    }
+
+    size_t cursor[MEM_REGION_COUNT] = {0};
+
+    ESP_LOGI(TAG, "=== Memory Layout ===");
+    ESP_LOGI(TAG, "  %-24s %-8s %8s %8s  %s", "buffer", "region", "offset", "size", "address");
+    for (size_t b = 0; b < s_num_budgets; b++) {
+        for (size_t i = 0; i < s_budgets[b].count; i++) {
+            const mem_budget_entry_t *e = &s_budgets[b].entries[i];
+            size_t offset = align_up(cursor[e->region], entry_align(e));
+            cursor[e->region] = offset + e->size;
+            ESP_LOGI(TAG, "  %-24s %-8s %8zu %8zu  %p",
+                     e->name, s_region_names[e->region], offset, e->size, *e->out);
+        }
+    }
+    for (int r = 0; r < MEM_REGION_COUNT; r++) {
+        ESP_LOGI(TAG, "  [%s] %zu bytes at %p, heap free after arena: %zu",
+                 s_region_names[r], s_region_used[r], (void *)s_region_base[r],
+                 heap_caps_get_free_size(s_region_caps[r]));
+    }
+    ESP_LOGI(TAG, "=====================");
+}
+
+size_t mem_arena_used(mem_region_t region)
+{
+    return region < MEM_REGION_COUNT ? s_region_used[region] : 0;
+}
+
+bool mem_arena_contains(mem_region_t region, const void *ptr)
+{
+    if (region >= MEM_REGION_COUNT || s_region_base[region] == NULL) {
+        return false;
+    }
+    const uint8_t *p = (const uint8_t *)ptr;
+    return p >= s_region_base[region] && p < s_region_base[region] + s_region_used[region];
+}
+
+size_t mem_arena_get_module_usage(mem_arena_module_usage_t *out, size_t max_modules)
+{
+    size_t count = 0;
+
+    for (size_t b = 0; b < s_num_budgets; b++) {
+        for (size_t i = 0; i < s_budgets[b].count; i++) {
+            const mem_budget_entry_t *e = &s_budgets[b].entries[i];
+            const char *dot = strchr(e->name, '.');
+            size_t len = dot ? (size_t)(dot - e->name) : strlen(e->name);
+            if (len >= MEM_ARENA_MODULE_NAME_LEN) {
+                len = MEM_ARENA_MODULE_NAME_LEN - 1;
+            }
+
+            size_t m = 0;
+            while (m < count && !(strncmp(out[m].module, e->name, len) == 0 &&
+                                  out[m].module[len] == '\0')) {
+                m++;
+            }
+            if (m == count) {
+                if (count == max_modules) {
+                    continue;
+                }
+                memset(&out[m], 0, sizeof(out[m]));
+                memcpy(out[m].module, e->name, len);
+                count++;
+            }
+            out[m].bytes[e->region] += e->size;
+            out[m].buffers++;
+        }
+    }
+    return count;
+}
@@ -0,0 +1,136 @@
+/**
+ * @file mem_arena.h
+ * @brief Startup arena for all long-lived pose/CSI buffers
+ *
+ * Instead of each module calling malloc/heap_caps_malloc on its own, modules
+ * publish a declarative budget: a table of named buffers, each with a size,
+ * alignment and memory region. At startup mem_arena_init() sums the budgets,
+ * allocates exactly one block of internal SRAM and one block of PSRAM, and
+ * carves every buffer out of them.
+ *
+ * This gives us:
+ * - No heap churn after startup (nothing is freed or reallocated at runtime)
+ * - Fail-fast: if a region cannot hold its budget, nothing is allocated and
+ *   a report shows requested vs. available memory per region
+ * - Predictable placement: hot buffers are pinned to internal SRAM, bulk
+ *   history to PSRAM, and mem_arena_print_layout() shows where everything is
+ *
+ * Memory Regions (ESP32-S3FH4R2):
+ * ------------------------------
+ * - MEM_REGION_INTERNAL: ~300KB usable SRAM, single-cycle access
+ * - MEM_REGION_PSRAM:    2MB Quad SPI PSRAM at 80MHz, cached, several
+ *                        times slower on cache misses
+ */
+
+#ifndef MEM_ARENA_H
+#define MEM_ARENA_H
+
+#include "esp_err.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Alignment used when a budget entry leaves align at 0
+#define MEM_ARENA_DEFAULT_ALIGN 16
+
+/**
+ * @brief Memory region a buffer is carved from
+ */
+typedef enum {
+    MEM_REGION_INTERNAL = 0,   // Internal SRAM (fast, scarce)
+    MEM_REGION_PSRAM,          // External PSRAM (slow, abundant)
+    MEM_REGION_COUNT
+} mem_region_t;
+
+/**
+ * @brief One long-lived buffer in a module's memory budget
+ */
+typedef struct {
+    const char *name;          // Shown in the layout map, e.g. "pose.amplitude"
+    size_t size;               // Size in bytes
+    size_t align;              // Alignment in bytes (power of two, 0 = default)
+    mem_region_t region;       // Where the buffer must live
+    void **out;                // Receives the buffer address (NULL on deinit)
+} mem_budget_entry_t;
+
+/**
+ * @brief A module's memory budget
+ */
+typedef struct {
+    const mem_budget_entry_t *entries;
+    size_t count;
+} mem_budget_t;
+
+// Longest module name reported by mem_arena_get_module_usage()
+#define MEM_ARENA_MODULE_NAME_LEN 16
+
+/**
+ * @brief Arena bytes attributed to one module
+ *
+ * The module is the part of the buffer name before the first '.', so
+ * "pose.amplitude" and "pose.phase" both count towards "pose".
+ */
+typedef struct {
+    char module[MEM_ARENA_MODULE_NAME_LEN];
+    size_t bytes[MEM_REGION_COUNT];    // Bytes per region (without padding)
+    uint32_t buffers;                  // Number of buffers
+} mem_arena_module_usage_t;
+
+/**
+ * @brief Allocate both regions and carve every budgeted buffer
+ *
+ * All buffers are zeroed. On failure nothing stays allocated, every out
+ * pointer is left NULL and a per-region report is logged.
+ *
+ * @param budgets     Module budgets
+ * @param num_budgets Number of budgets
+ * @return ESP_OK on success
+ *         ESP_ERR_INVALID_STATE if already initialized
+ *         ESP_ERR_INVALID_ARG for malformed entries
+ *         ESP_ERR_NO_MEM if a region cannot hold its budget
+ */
+esp_err_t mem_arena_init(const mem_budget_t *budgets, size_t num_budgets);
+
+/**
+ * @brief Release both regions and clear every out pointer
+ */
+void mem_arena_deinit(void);
+
+/**
+ * @brief Check whether the arena has been initialized
+ */
+bool mem_arena_is_ready(void);
+
+/**
+ * @brief Log the layout map: every buffer with region, offset, size and address
+ */
+void mem_arena_print_layout(void);
+
+/**
+ * @brief Bytes carved from a region (including alignment padding)
+ */
+size_t mem_arena_used(mem_region_t region);
+
+/**
+ * @brief Check whether an address lies inside a region of the arena
+ */
+bool mem_arena_contains(mem_region_t region, const void *ptr);
+
+/**
+ * @brief Arena usage grouped by module, in budget order
+ *
+ * @param out         Output array
+ * @param max_modules Capacity of out
+ * @return Number of modules written
+ */
+size_t mem_arena_get_module_usage(mem_arena_module_usage_t *out, size_t max_modules);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MEM_ARENA_H
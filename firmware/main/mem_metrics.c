@@ -0,0 +1,289 @@
+/**
+ * @file mem_metrics.c
+ * @brief Heap and stack high-water instrumentation
+ */
+
+#include "mem_metrics.h"
+#include "mem_arena.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "freertos/semphr.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char *TAG = "mem_metrics";
+
+// Default thresholds
+#define DEFAULT_MIN_FREE_INTERNAL (32 * 1024)
+#define DEFAULT_MIN_FREE_PSRAM (256 * 1024)
+#define DEFAULT_MIN_LARGEST_INTERNAL (16 * 1024)
+#define DEFAULT_MIN_STACK_FREE 512
+
+static const char *const s_heap_names[MEM_METRICS_HEAP_COUNT] = {
+    "internal",
+    "psram",
+    "dma",
+};
+
+static const uint32_t s_heap_caps[MEM_METRICS_HEAP_COUNT] = {
+    MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT,
+    MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT,
+    MALLOC_CAP_DMA,
+};
+
+/**
+ * @brief A watched task and its alert state
+ */
+typedef struct {
+    TaskHandle_t handle;
+    const char *name;
+    bool alert_active;
+} watched_task_t;
+
+// State variables
+static bool s_initialized = false;
+static mem_metrics_config_t s_config;
+static SemaphoreHandle_t s_mutex = NULL;
+static watched_task_t s_tasks[MEM_METRICS_MAX_TASKS];
+static int s_num_tasks = 0;
+
+// Alert state of the heap checks
+static bool s_alert_internal_free = false;
+static bool s_alert_psram_free = false;
+static bool s_alert_internal_largest = false;
+static uint32_t s_alerts = 0;
+
+// Updated from the failed-allocation hook (any task)
+static uint32_t s_failed_allocs = 0;
+static size_t s_failed_alloc_largest = 0;
+
+/**
+ * @brief Called by the heap on every failed allocation
+ */
+static void on_alloc_failed(size_t size, uint32_t caps, const char *function_name)
+{
+    (void)caps;
+    (void)function_name;
+    __atomic_add_fetch(&s_failed_allocs, 1, __ATOMIC_RELAXED);
+    size_t largest = __atomic_load_n(&s_failed_alloc_largest, __ATOMIC_RELAXED);
+    while (size > largest &&
+           !__atomic_compare_exchange_n(&s_failed_alloc_largest, &largest, size, true,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+/**
+ * @brief Edge-triggered low-water check with hysteresis
+ */
+static void check_threshold(bool *active, const char *what, const char *name,
+                            size_t value, size_t threshold)
+{
+    if (threshold == 0) {
+        return;
+    }
+
+    if (!*active && value < threshold) {
+        *active = true;
+        s_alerts++;
+        ESP_LOGW(TAG, "ALERT: %s %s = %zu bytes, below %zu", name, what, value, threshold);
+        printf("{\"mem_alert\":\"%s\",\"name\":\"%s\",\"value\":%zu,\"threshold\":%zu}\n",
+               what, name, value, threshold);
+    } else if (*active && value >= threshold + threshold * MEM_METRICS_HYSTERESIS_PCT / 100) {
+        *active = false;
+        ESP_LOGI(TAG, "Recovered: %s %s = %zu bytes", name, what, value);
+    }
+}
+
+static void sample(mem_metrics_snapshot_t *out)
+{
+    for (int h = 0; h < MEM_METRICS_HEAP_COUNT; h++) {
+        mem_metrics_heap_info_t *info = &out->heap[h];
+        info->total = heap_caps_get_total_size(s_heap_caps[h]);
+        info->free = heap_caps_get_free_size(s_heap_caps[h]);
+        info->min_free = heap_caps_get_minimum_free_size(s_heap_caps[h]);
+        info->largest_block = heap_caps_get_largest_free_block(s_heap_caps[h]);
+    }
+
+    out->num_tasks = s_num_tasks;
+    for (int i = 0; i < s_num_tasks; i++) {
+        mem_metrics_task_info_t *info = &out->tasks[i];
+        info->name = s_tasks[i].name;
+        // ESP-IDF reports the high-water mark in bytes
+        info->stack_free_min = uxTaskGetStackHighWaterMark(s_tasks[i].handle);
+    }
+
+    out->failed_allocs = __atomic_load_n(&s_failed_allocs, __ATOMIC_RELAXED);
+    out->failed_alloc_largest = __atomic_load_n(&s_failed_alloc_largest, __ATOMIC_RELAXED);
+    out->alerts = s_alerts;
+}
+
+esp_err_t mem_metrics_init(const mem_metrics_config_t *config)
+{
+    if (s_initialized) {
+        return ESP_OK;
+    }
+
+    if (config != NULL) {
+        memcpy(&s_config, config, sizeof(mem_metrics_config_t));
+    } else {
+        s_config.min_free_internal = DEFAULT_MIN_FREE_INTERNAL;
+        s_config.min_free_psram = DEFAULT_MIN_FREE_PSRAM;
+        s_config.min_largest_internal = DEFAULT_MIN_LARGEST_INTERNAL;
+        s_config.min_stack_free = DEFAULT_MIN_STACK_FREE;
+    }
+
+    s_mutex = xSemaphoreCreateMutex();
+    if (s_mutex == NULL) {
+        ESP_LOGE(TAG, "Failed to create mutex");
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_err_t ret = heap_caps_register_failed_alloc_callback(on_alloc_failed);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed-allocation hook not installed: %s", esp_err_to_name(ret));
+    }
+
+    s_initialized = true;
+    ESP_LOGI(TAG, "Thresholds: internal free %zu, PSRAM free %zu, internal block %zu, "
+                  "stack %lu bytes",
+             s_config.min_free_internal, s_config.min_free_psram,
+             s_config.min_largest_internal, s_config.min_stack_free);
+    return ESP_OK;
+}
+
+esp_err_t mem_metrics_watch_task(TaskHandle_t task, const char *name)
+{
+    if (!s_initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (task == NULL) {
+        task = xTaskGetCurrentTaskHandle();
+    }
+
+    esp_err_t ret = ESP_OK;
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    if (s_num_tasks >= MEM_METRICS_MAX_TASKS) {
+        ret = ESP_ERR_NO_MEM;
+    } else {
+        s_tasks[s_num_tasks].handle = task;
+        s_tasks[s_num_tasks].name = name;
+        s_tasks[s_num_tasks].alert_active = false;
+        s_num_tasks++;
+    }
+    xSemaphoreGive(s_mutex);
+    return ret;
+}
+
+void mem_metrics_unwatch_task(TaskHandle_t task)
+{
+    if (!s_initialized) {
+        return;
+    }
+    if (task == NULL) {
+        task = xTaskGetCurrentTaskHandle();
+    }
+
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    for (int i = 0; i < s_num_tasks; i++) {
+        if (s_tasks[i].handle == task) {
+            memmove(&s_tasks[i], &s_tasks[i + 1], (s_num_tasks - i - 1) * sizeof(watched_task_t));
+            s_num_tasks--;
+            break;
+        }
+    }
+    xSemaphoreGive(s_mutex);
+}
+
+esp_err_t mem_metrics_watch_task_by_name(const char *task_name)
+{
+    TaskHandle_t task = xTaskGetHandle(task_name);
+    if (task == NULL) {
+        ESP_LOGW(TAG, "Task '%s' not found", task_name);
+        return ESP_ERR_NOT_FOUND;
+    }
+    return mem_metrics_watch_task(task, task_name);
+}
+
+void mem_metrics_poll(mem_metrics_snapshot_t *out)
+{
+    if (!s_initialized) {
+        return;
+    }
+
+    mem_metrics_snapshot_t snap;
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    sample(&snap);
+
+    check_threshold(&s_alert_internal_free, "heap_free", "internal",
+                    snap.heap[MEM_METRICS_HEAP_INTERNAL].free, s_config.min_free_internal);
+    if (snap.heap[MEM_METRICS_HEAP_PSRAM].total > 0) {
+        check_threshold(&s_alert_psram_free, "heap_free", "psram",
+                        snap.heap[MEM_METRICS_HEAP_PSRAM].free, s_config.min_free_psram);
+    }
+    check_threshold(&s_alert_internal_largest, "largest_block", "internal",
+                    snap.heap[MEM_METRICS_HEAP_INTERNAL].largest_block,
+                    s_config.min_largest_internal);
+    for (int i = 0; i < snap.num_tasks; i++) {
+        check_threshold(&s_tasks[i].alert_active, "stack_free", snap.tasks[i].name,
+                        snap.tasks[i].stack_free_min, s_config.min_stack_free);
+    }
+    snap.alerts = s_alerts;
+    xSemaphoreGive(s_mutex);
+
+    if (out != NULL) {
+        memcpy(out, &snap, sizeof(snap));
+    }
+}
+
+void mem_metrics_print(void)
+{
+    if (!s_initialized) {
+        ESP_LOGW(TAG, "Not initialized");
+        return;
+    }
+
+    mem_metrics_snapshot_t snap;
+    mem_metrics_poll(&snap);
+
+    ESP_LOGI(TAG, "=== Memory Metrics ===");
+    ESP_LOGI(TAG, "  %-10s %9s %9s %9s %9s", "heap", "total", "free", "min free", "largest");
+    for (int h = 0; h < MEM_METRICS_HEAP_COUNT; h++) {
+        const mem_metrics_heap_info_t *info = &snap.heap[h];
+        ESP_LOGI(TAG, "  %-10s %9zu %9zu %9zu %9zu", s_heap_names[h],
+                 info->total, info->free, info->min_free, info->largest_block);
+    }
+
+    ESP_LOGI(TAG, "  %-16s %s", "task", "stack free (min)");
+    for (int i = 0; i < snap.num_tasks; i++) {
+        ESP_LOGI(TAG, "  %-16s %lu", snap.tasks[i].name, snap.tasks[i].stack_free_min);
+    }
+
+    mem_arena_module_usage_t modules[MEM_METRICS_MAX_MODULES];
+    size_t num_modules = mem_arena_get_module_usage(modules, MEM_METRICS_MAX_MODULES);
+    ESP_LOGI(TAG, "  %-16s %9s %9s %8s", "module", "internal", "psram", "buffers");
+    for (size_t m = 0; m < num_modules; m++) {
+        ESP_LOGI(TAG, "  %-16s %9zu %9zu %8lu", modules[m].module,
+                 modules[m].bytes[MEM_REGION_INTERNAL], modules[m].bytes[MEM_REGION_PSRAM],
+                 modules[m].buffers);
+    }
+    ESP_LOGI(TAG, "  Failed allocations: %lu (largest %zu bytes), alerts: %lu",
+             snap.failed_allocs, snap.failed_alloc_largest, snap.alerts);
+    ESP_LOGI(TAG, "======================");
+
+    // Machine-readable copy for tools on the serial stream
+    printf("{\"mem_stats\":true");
+    for (int h = 0; h < MEM_METRICS_HEAP_COUNT; h++) {
+        printf(",\"%s\":{\"free\":%zu,\"min_free\":%zu,\"largest\":%zu}", s_heap_names[h],
+               snap.heap[h].free, snap.heap[h].min_free, snap.heap[h].largest_block);
+    }
+    printf(",\"stacks\":{");
+    for (int i = 0; i < snap.num_tasks; i++) {
+        printf("%s\"%s\":%lu", i ? "," : "", snap.tasks[i].name, snap.tasks[i].stack_free_min);
+    }
+    printf("},\"modules\":{");
+    for (size_t m = 0; m < num_modules; m++) {
+        printf("%s\"%s\":[%zu,%zu]", m ? "," : "", modules[m].module,
+               modules[m].bytes[MEM_REGION_INTERNAL], modules[m].bytes[MEM_REGION_PSRAM]);
+    }
+    printf("},\"failed_allocs\":%lu,\"alerts\":%lu}\n", snap.failed_allocs, snap.alerts);
+}
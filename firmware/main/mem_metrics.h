@@ -0,0 +1,146 @@
+/**
+ * @file mem_metrics.h
+ * @brief Heap and stack high-water instrumentation
+ *
+ * Collects what we need to size buffers for longer windows safely:
+ *
+ * - Per heap capability (internal, PSRAM, DMA): free, minimum free ever and
+ *   largest free block (free vs. largest block shows fragmentation)
+ * - Per watched task: stack high-water mark (least free stack ever)
+ * - Per module: bytes carved from the memory arena, plus the number of heap
+ *   allocations that failed anywhere in the firmware
+ *
+ * mem_metrics_poll() samples everything and raises an alert when a value
+ * crosses its threshold. Alerts are edge-triggered: each one is reported
+ * once as a warning and a JSON line on serial, and re-armed when the value
+ * recovers by MEM_METRICS_HYSTERESIS_PCT percent.
+ */
+
+#ifndef MEM_METRICS_H
+#define MEM_METRICS_H
+
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Tasks that can be watched
+#define MEM_METRICS_MAX_TASKS 8
+
+// Modules reported from the memory arena
+#define MEM_METRICS_MAX_MODULES 8
+
+// Recovery margin before an alert can fire again
+#define MEM_METRICS_HYSTERESIS_PCT 10
+
+/**
+ * @brief Heap capability classes that are tracked
+ */
+typedef enum {
+    MEM_METRICS_HEAP_INTERNAL = 0,
+    MEM_METRICS_HEAP_PSRAM,
+    MEM_METRICS_HEAP_DMA,
+    MEM_METRICS_HEAP_COUNT
+} mem_metrics_heap_t;
+
+/**
+ * @brief Alert thresholds (0 disables a check)
+ */
+typedef struct {
+    size_t min_free_internal;      // Alert when free internal heap drops below (bytes)
+    size_t min_free_psram;         // Alert when free PSRAM drops below (bytes)
+    size_t min_largest_internal;   // Alert when the largest internal block drops below (bytes)
+    uint32_t min_stack_free;       // Alert when a task's stack high-water drops below (bytes)
+} mem_metrics_config_t;
+
+/**
+ * @brief State of one heap capability class
+ */
+typedef struct {
+    size_t total;              // Heap size (bytes)
+    size_t free;               // Currently free (bytes)
+    size_t min_free;           // Lowest free since boot (bytes)
+    size_t largest_block;      // Largest allocatable block (bytes)
+} mem_metrics_heap_info_t;
+
+/**
+ * @brief Stack usage of one watched task
+ */
+typedef struct {
+    const char *name;
+    uint32_t stack_free_min;   // High-water mark: least free stack ever (bytes)
+} mem_metrics_task_info_t;
+
+/**
+ * @brief One sample of all metrics
+ */
+typedef struct {
+    mem_metrics_heap_info_t heap[MEM_METRICS_HEAP_COUNT];
+    mem_metrics_task_info_t tasks[MEM_METRICS_MAX_TASKS];
+    int num_tasks;
+    uint32_t failed_allocs;    // Heap allocations that failed since init
+    size_t failed_alloc_largest; // Largest failed request (bytes)
+    uint32_t alerts;           // Alerts raised since init
+} mem_metrics_snapshot_t;
+
+/**
+ * @brief Initialize metrics collection
+ *
+ * Installs a failed-allocation hook, so call it early in app_main().
+ *
+ * @param config Thresholds (NULL for defaults)
+ * @return ESP_OK on success
+ */
+esp_err_t mem_metrics_init(const mem_metrics_config_t *config);
+
+/**
+ * @brief Watch a task's stack high-water mark
+ *
+ * @param task Task handle (NULL for the calling task)
+ * @param name Name shown in reports (static storage)
+ * @return ESP_OK, or ESP_ERR_NO_MEM if MEM_METRICS_MAX_TASKS are watched
+ */
+esp_err_t mem_metrics_watch_task(TaskHandle_t task, const char *name);
+
+/**
+ * @brief Stop watching a task
+ *
+ * Must be called before a watched task deletes itself.
+ *
+ * @param task Task handle (NULL for the calling task)
+ */
+void mem_metrics_unwatch_task(TaskHandle_t task);
+
+/**
+ * @brief Watch a task by its FreeRTOS name (e.g. the WiFi driver's "wifi")
+ *
+ * @return ESP_OK, or ESP_ERR_NOT_FOUND if no such task exists yet
+ */
+esp_err_t mem_metrics_watch_task_by_name(const char *task_name);
+
+/**
+ * @brief Sample all metrics and raise alerts for crossed thresholds
+ *
+ * @param out Snapshot (may be NULL)
+ */
+void mem_metrics_poll(mem_metrics_snapshot_t *out);
+
+/**
+ * @brief Log a full report (the stats command)
+ *
+ * Heaps, task stacks and per-module arena usage, followed by one JSON line
+ * for tools reading the serial stream.
+ */
+void mem_metrics_print(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MEM_METRICS_H
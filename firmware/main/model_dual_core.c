@@ -0,0 +1,171 @@
+/**
+ * @file model_dual_core.c
+ * @brief Second-core backend of model_layers.h
+ */
+
+#include "model_dual_core.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include <stdatomic.h>
+
+static const char *TAG = "model_dual_core";
+
+#define WORKER_STACK 2048
+
+// How long the caller spins for the other half before taking it back or blocking
+#define WAIT_SPIN_US 50
+
+/**
+ * @brief Life of the range handed to a worker
+ *
+ * POSTED -> CLAIMED -> DONE when the worker runs it, POSTED -> CANCELLED
+ * when the caller takes it back first. Whoever moves it out of POSTED
+ * computes the range.
+ */
+enum {
+    JOB_IDLE = 0,
+    JOB_POSTED,
+    JOB_CLAIMED,
+    JOB_DONE,
+    JOB_CANCELLED,
+};
+
+/**
+ * @brief Worker pinned to one core, and the range it was handed
+ */
+typedef struct {
+    TaskHandle_t task;
+    SemaphoreHandle_t done;    // Given after each finished range (a wake-up hint)
+    model_range_fn_t fn;
+    void *arg;
+    int ch_begin;
+    int ch_end;
+    atomic_int state;
+} worker_t;
+
+static worker_t s_workers[2];
+static worker_t *s_started;
+static model_split_t s_split;
+static bool s_ready = false;
+
+static void worker_task(void *pvParameters)
+{
+    worker_t *w = pvParameters;
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        int expected = JOB_POSTED;
+        if (!atomic_compare_exchange_strong_explicit(&w->state, &expected, JOB_CLAIMED,
+                                                     memory_order_acquire,
+                                                     memory_order_relaxed)) {
+            continue;  // Taken back by the caller
+        }
+        w->fn(w->arg, w->ch_begin, w->ch_end);
+        atomic_store_explicit(&w->state, JOB_DONE, memory_order_release);
+        xSemaphoreGive(w->done);
+    }
+}
+
+static bool start_range(void *ctx, model_range_fn_t fn, void *arg, int ch_begin, int ch_end)
+{
+    (void)ctx;
+    worker_t *w = &s_workers[xPortGetCoreID() == 0 ? 1 : 0];
+    w->fn = fn;
+    w->arg = arg;
+    w->ch_begin = ch_begin;
+    w->ch_end = ch_end;
+    atomic_store_explicit(&w->state, JOB_POSTED, memory_order_release);
+    s_started = w;
+    xTaskNotifyGive(w->task);
+    return true;
+}
+
+static void wait_range(void *ctx)
+{
+    (void)ctx;
+    worker_t *w = s_started;
+
+    // The halves take about as long, so a running worker is close to done
+    int64_t spin_end = esp_timer_get_time() + WAIT_SPIN_US;
+    while (atomic_load_explicit(&w->state, memory_order_acquire) != JOB_DONE &&
+           esp_timer_get_time() < spin_end) {
+    }
+
+    // Not even started while the caller did its half: a higher-priority
+    // task owns the other core, so compute the range here instead
+    int expected = JOB_POSTED;
+    if (atomic_compare_exchange_strong_explicit(&w->state, &expected, JOB_CANCELLED,
+                                                memory_order_acquire, memory_order_relaxed)) {
+        w->fn(w->arg, w->ch_begin, w->ch_end);
+        return;
+    }
+
+    // Claimed, so the worker is running it: block instead of spinning. A
+    // stale give from an earlier range only costs one more check
+    while (atomic_load_explicit(&w->state, memory_order_acquire) != JOB_DONE) {
+        xSemaphoreTake(w->done, portMAX_DELAY);
+    }
+}
+
+esp_err_t model_dual_core_init(uint32_t min_macs, UBaseType_t priority)
+{
+#if portNUM_PROCESSORS < 2
+    (void)min_macs;
+    (void)priority;
+    ESP_LOGW(TAG, "Single-core build: model layers run on one core");
+    return ESP_ERR_NOT_SUPPORTED;
+#else
+    if (priority < uxTaskPriorityGet(NULL)) {
+        ESP_LOGE(TAG, "Worker priority %u is below the caller's %u", (unsigned)priority,
+                 (unsigned)uxTaskPriorityGet(NULL));
+        return ESP_ERR_INVALID_ARG;
+    }
+    s_split.min_macs = min_macs;
+    if (s_ready) {
+        return ESP_OK;
+    }
+
+    static const char *const names[] = { "model_w0", "model_w1" };
+    for (int core = 0; core < 2; core++) {
+        worker_t *w = &s_workers[core];
+        atomic_init(&w->state, JOB_IDLE);
+        w->done = xSemaphoreCreateBinary();
+        if (w->done == NULL ||
+            xTaskCreatePinnedToCore(worker_task, names[core], WORKER_STACK, w, priority, &w->task,
+                                    core) != pdPASS) {
+            ESP_LOGE(TAG, "Cannot create the worker on core %d", core);
+            model_dual_core_deinit();
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    s_split.start = start_range;
+    s_split.wait = wait_range;
+    s_split.ctx = NULL;
+    s_ready = true;
+    ESP_LOGI(TAG, "Model layers of %lu+ MACs split across both cores",
+             (unsigned long)min_macs);
+    return ESP_OK;
+#endif
+}
+
+void model_dual_core_deinit(void)
+{
+    s_ready = false;
+    for (int core = 0; core < 2; core++) {
+        worker_t *w = &s_workers[core];
+        if (w->task != NULL) {
+            vTaskDelete(w->task);
+            w->task = NULL;
+        }
+        if (w->done != NULL) {
+            vSemaphoreDelete(w->done);
+            w->done = NULL;
+        }
+    }
+}
+
+const model_split_t *model_dual_core_split(void)
+{
+    return s_ready ? &s_split : NULL;
+}
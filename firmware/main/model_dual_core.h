@@ -0,0 +1,58 @@
+/**
+ * @file model_dual_core.h
+ * @brief Second-core backend of model_layers.h
+ *
+ * One worker task is pinned to each core. A split layer hands the upper
+ * half of its output channels to the worker on the other core than the
+ * caller and computes the lower half itself. The halves take about the
+ * same time, so the caller then spins briefly on the worker's state. If
+ * the worker has not started by the end of the spin, a higher-priority
+ * task (WiFi) owns its core: the caller takes the half back and computes
+ * it. If the worker is running it, the caller blocks until it is done.
+ *
+ * The workers must have at least the priority of the task that runs the
+ * model, so that they still run if the caller has migrated to the
+ * worker's core. One task at a time may run split layers.
+ */
+
+#ifndef MODEL_DUAL_CORE_H
+#define MODEL_DUAL_CORE_H
+
+#include "esp_err.h"
+#include "model_layers.h"
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Start the worker tasks (once; later calls only update min_macs)
+ *
+ * @param min_macs Layers with fewer MACs run on the calling core alone
+ * @param priority Worker priority, at least that of the calling task,
+ *                 which runs the model
+ * @return ESP_OK, ESP_ERR_NOT_SUPPORTED on a single-core build,
+ *         ESP_ERR_INVALID_ARG if priority is below the caller's, or
+ *         ESP_ERR_NO_MEM if a task cannot be created
+ */
+esp_err_t model_dual_core_init(uint32_t min_macs, UBaseType_t priority);
+
+/**
+ * @brief Delete the worker tasks, with no split layer running
+ */
+void model_dual_core_deinit(void);
+
+/**
+ * @brief Backend for model_conv1d_split()/model_dense_split()
+ *
+ * @return NULL before model_dual_core_init() succeeds, which the layers
+ *         treat as one core
+ */
+const model_split_t *model_dual_core_split(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MODEL_DUAL_CORE_H
@@ -0,0 +1,158 @@
+/**
+ * @file model_layers.c
+ * @brief int8 Conv1D and Dense layers, split by output channel across cores
+ */
+
+#include "model_layers.h"
+#include <stddef.h>
+
+// Split points are rounded to this many channels, so the two cores write
+// separate cache lines of each output row where the layer is wide enough
+#define SPLIT_ALIGN 16
+
+/**
+ * @brief Arguments of one layer for a model_range_fn_t
+ */
+typedef struct {
+    const model_layer_t *layer;
+    const int8_t *in;
+    int steps;
+    int batch;
+    bool relu;
+    int8_t *out;
+} layer_job_t;
+
+int8_t model_requantize(int32_t acc, int32_t multiplier, int shift, bool relu)
+{
+    int64_t v = (int64_t)acc * multiplier;
+    if (shift > 0) {
+        v = (v + ((int64_t)1 << (shift - 1))) >> shift;
+    } else if (shift < 0) {
+        // Anything past 2^31 saturates anyway, and then 2^31 << 31 fits
+        v = v > INT32_MAX ? INT32_MAX : v < -INT32_MAX ? -INT32_MAX : v;
+        v *= (int64_t)1 << -shift;
+    }
+    if (relu && v < 0) {
+        v = 0;
+    }
+    if (v < -128) {
+        v = -128;
+    }
+    if (v > 127) {
+        v = 127;
+    }
+    return (int8_t)v;
+}
+
+bool model_layer_valid(const model_layer_t *layer)
+{
+    return layer->in_ch > 0 && layer->out_ch > 0 && layer->kernel > 0 &&
+           layer->weights != NULL && layer->bias != NULL &&
+           layer->shift >= MODEL_SHIFT_MIN && layer->shift <= MODEL_SHIFT_MAX;
+}
+
+uint32_t model_layer_macs(const model_layer_t *layer, int steps)
+{
+    return (uint32_t)steps * layer->out_ch * layer->kernel * layer->in_ch;
+}
+
+void model_conv1d_s8_batch(const model_layer_t *layer, const int8_t *in, int steps, int batch,
+                           bool relu, int ch_begin, int ch_end, int8_t *out)
+{
+    const int in_ch = layer->in_ch;
+    const int out_ch = layer->out_ch;
+    const int kernel = layer->kernel;
+    const int pad = kernel / 2;
+    // One channel's weights (kernel * in_ch bytes) serve every window and
+    // step before the next channel's are read
+    for (int o = ch_begin; o < ch_end; o++) {
+        const int8_t *w = &layer->weights[(size_t)o * kernel * in_ch];
+        const int32_t bias = layer->bias[o];
+        for (int b = 0; b < batch; b++) {
+            const int8_t *x_b = &in[(size_t)b * steps * in_ch];
+            int8_t *y_b = &out[(size_t)b * steps * out_ch];
+            for (int t = 0; t < steps; t++) {
+                // Taps that fall inside the input at this step
+                int k_begin = pad - t > 0 ? pad - t : 0;
+                int k_end = steps - t + pad < kernel ? steps - t + pad : kernel;
+                int32_t acc = bias;
+                for (int k = k_begin; k < k_end; k++) {
+                    const int8_t *x = &x_b[(size_t)(t + k - pad) * in_ch];
+                    const int8_t *wk = &w[k * in_ch];
+                    for (int c = 0; c < in_ch; c++) {
+                        acc += x[c] * wk[c];
+                    }
+                }
+                y_b[(size_t)t * out_ch + o] =
+                    model_requantize(acc, layer->multiplier, layer->shift, relu);
+            }
+        }
+    }
+}
+
+void model_conv1d_s8(const model_layer_t *layer, const int8_t *in, int steps, bool relu,
+                     int ch_begin, int ch_end, int8_t *out)
+{
+    model_conv1d_s8_batch(layer, in, steps, 1, relu, ch_begin, ch_end, out);
+}
+
+void model_dense_s8(const model_layer_t *layer, const int8_t *in, bool relu,
+                    int ch_begin, int ch_end, int8_t *out)
+{
+    model_conv1d_s8(layer, in, 1, relu, ch_begin, ch_end, out);
+}
+
+static void conv1d_range(void *arg, int ch_begin, int ch_end)
+{
+    const layer_job_t *job = arg;
+    model_conv1d_s8_batch(job->layer, job->in, job->steps, job->batch, job->relu, ch_begin,
+                          ch_end, job->out);
+}
+
+/**
+ * @brief Run fn over [0, channels), half on the other core if worth it
+ */
+static void run_split(const model_split_t *split, model_range_fn_t fn, void *arg,
+                      int channels, uint32_t macs)
+{
+    if (split == NULL || channels < 2 || macs < split->min_macs) {
+        fn(arg, 0, channels);
+        return;
+    }
+
+    int mid = channels / 2;
+    if (channels >= 2 * SPLIT_ALIGN) {
+        mid = (mid + SPLIT_ALIGN / 2) / SPLIT_ALIGN * SPLIT_ALIGN;
+    }
+    if (!split->start(split->ctx, fn, arg, mid, channels)) {
+        fn(arg, 0, channels);
+        return;
+    }
+    fn(arg, 0, mid);
+    split->wait(split->ctx);
+}
+
+void model_conv1d_batch_split(const model_split_t *split, const model_layer_t *layer,
+                              const int8_t *in, int steps, int batch, bool relu, int8_t *out)
+{
+    layer_job_t job = { layer, in, steps, batch, relu, out };
+    run_split(split, conv1d_range, &job, layer->out_ch, model_layer_macs(layer, steps * batch));
+}
+
+void model_conv1d_split(const model_split_t *split, const model_layer_t *layer,
+                        const int8_t *in, int steps, bool relu, int8_t *out)
+{
+    model_conv1d_batch_split(split, layer, in, steps, 1, relu, out);
+}
+
+void model_dense_split(const model_split_t *split, const model_layer_t *layer,
+                       const int8_t *in, bool relu, int8_t *out)
+{
+    model_conv1d_batch_split(split, layer, in, 1, 1, relu, out);
+}
+
+void model_dense_batch_split(const model_split_t *split, const model_layer_t *layer,
+                             const int8_t *in, int batch, bool relu, int8_t *out)
+{
+    model_conv1d_batch_split(split, layer, in, 1, batch, relu, out);
+}
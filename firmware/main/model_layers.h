@@ -0,0 +1,150 @@
+/**
+ * @file model_layers.h
+ * @brief int8 Conv1D and Dense layers, split by output channel across cores
+ *
+ * Reference kernels for the layers of LightweightPoseModel
+ * (train_pose_model.py), with the int8 arithmetic of TFLite Micro: int32
+ * accumulation, int32 bias, then a fixed-point requantization of each
+ * output. Every kernel computes a range of output channels, so one layer
+ * can run as two independent halves:
+ *
+ *   model_conv1d_split(split, layer, in, steps, relu, out)
+ *     -> split->start(channels [mid, out_ch))   other core
+ *     -> channels [0, mid)                      this core
+ *     -> split->wait()                          barrier before the next layer
+ *
+ * The halves write disjoint outputs and only read the shared input, so
+ * they need no locking, and the result is bit-identical to one core. A
+ * layer under split->min_macs multiply-accumulates runs on this core
+ * alone: there, handing over half and waiting costs more than it saves.
+ *
+ * The kernels take a batch of windows, stacked [batch][steps][ch], and
+ * loop over output channels outermost: each channel's weights are read
+ * from flash/PSRAM once for the whole batch, not once per window and step.
+ * A batch of one is the single-window case, with the same result.
+ *
+ * model_split_t is the backend: model_dual_core.h runs the other half on
+ * a task pinned to the other core, tools/host/layer_split_bench on a
+ * pthread.
+ */
+
+#ifndef MODEL_LAYERS_H
+#define MODEL_LAYERS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief One Conv1D or Dense layer (Dense: kernel 1, one step)
+ */
+typedef struct {
+    int in_ch;
+    int out_ch;
+    int kernel;                // Taps, 'same' padding
+    const int8_t *weights;     // [out_ch][kernel][in_ch]
+    const int32_t *bias;       // [out_ch]
+    int32_t multiplier;        // Requantization: (acc * multiplier) >> shift
+    int shift;                 // MODEL_SHIFT_MIN .. MODEL_SHIFT_MAX, negative shifts left
+} model_layer_t;
+
+// Requantization shifts that model_requantize() handles without overflow
+#define MODEL_SHIFT_MIN (-31)
+#define MODEL_SHIFT_MAX 62
+
+/**
+ * @brief Work on a range of output channels
+ */
+typedef void (*model_range_fn_t)(void *arg, int ch_begin, int ch_end);
+
+/**
+ * @brief How a layer's channels are shared with the other core
+ */
+typedef struct {
+    // Run fn(arg, begin, end) on the other core; false if it cannot take it,
+    // and the caller runs the range itself
+    bool (*start)(void *ctx, model_range_fn_t fn, void *arg, int ch_begin, int ch_end);
+    // Return once the range handed to start() is done
+    void (*wait)(void *ctx);
+    void *ctx;
+    uint32_t min_macs;         // Layers with fewer MACs run on one core
+} model_split_t;
+
+/**
+ * @brief Requantize an accumulator to int8 (round half up, optional ReLU)
+ *
+ * @param shift MODEL_SHIFT_MIN .. MODEL_SHIFT_MAX; 0 and negative shifts
+ *              have no rounding term
+ */
+int8_t model_requantize(int32_t acc, int32_t multiplier, int shift, bool relu);
+
+/**
+ * @brief Check a layer's shape, buffers and requantization shift
+ */
+bool model_layer_valid(const model_layer_t *layer);
+
+/**
+ * @brief Multiply-accumulates of a layer over steps
+ */
+uint32_t model_layer_macs(const model_layer_t *layer, int steps);
+
+/**
+ * @brief Conv1D over output channels [ch_begin, ch_end) of a batch of windows
+ *
+ * @param in  Input [batch][steps][in_ch]
+ * @param out Output [batch][steps][out_ch]; only the range's channels are written
+ */
+void model_conv1d_s8_batch(const model_layer_t *layer, const int8_t *in, int steps, int batch,
+                           bool relu, int ch_begin, int ch_end, int8_t *out);
+
+/**
+ * @brief Conv1D over output channels [ch_begin, ch_end)
+ *
+ * @param in  Input [steps][in_ch]
+ * @param out Output [steps][out_ch]; only the range's channels are written
+ */
+void model_conv1d_s8(const model_layer_t *layer, const int8_t *in, int steps, bool relu,
+                     int ch_begin, int ch_end, int8_t *out);
+
+/**
+ * @brief Dense over outputs [ch_begin, ch_end): in [in_ch] -> out [out_ch]
+ */
+void model_dense_s8(const model_layer_t *layer, const int8_t *in, bool relu,
+                    int ch_begin, int ch_end, int8_t *out);
+
+/**
+ * @brief Whole Conv1D layer, split across cores when it is large enough
+ *
+ * @param split Backend, or NULL to run on this core only
+ */
+void model_conv1d_split(const model_split_t *split, const model_layer_t *layer,
+                        const int8_t *in, int steps, bool relu, int8_t *out);
+
+/**
+ * @brief Whole Dense layer, split across cores when it is large enough
+ */
+void model_dense_split(const model_split_t *split, const model_layer_t *layer,
+                       const int8_t *in, bool relu, int8_t *out);
+
+/**
+ * @brief model_conv1d_split() over a batch of windows, [batch][steps][ch]
+ *
+ * The MACs of the whole batch count against split->min_macs.
+ */
+void model_conv1d_batch_split(const model_split_t *split, const model_layer_t *layer,
+                              const int8_t *in, int steps, int batch, bool relu, int8_t *out);
+
+/**
+ * @brief model_dense_split() over a batch of inputs, [batch][ch]
+ */
+void model_dense_batch_split(const model_split_t *split, const model_layer_t *layer,
+                             const int8_t *in, int batch, bool relu, int8_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MODEL_LAYERS_H
@@ -0,0 +1,124 @@
+/**
+ * @file model_net.c
+ * @brief LightweightPoseModel classifier over a batch of windows
+ */
+
+#include "model_net.h"
+
+/**
+ * @brief Max pool by 2 over time, in place: [batch][steps][ch] -> [batch][steps / 2][ch]
+ *
+ * Every output position precedes the inputs it is computed from, so
+ * writing in order never clobbers an input still to be read.
+ *
+ * @return Steps after pooling
+ */
+static int max_pool2(int8_t *x, int steps, int ch, int batch)
+{
+    const int pooled = steps / 2;
+    for (int b = 0; b < batch; b++) {
+        const int8_t *src = &x[(size_t)b * steps * ch];
+        int8_t *dst = &x[(size_t)b * pooled * ch];
+        for (int t = 0; t < pooled; t++) {
+            for (int c = 0; c < ch; c++) {
+                int8_t u = src[(size_t)2 * t * ch + c];
+                int8_t v = src[(size_t)(2 * t + 1) * ch + c];
+                dst[(size_t)t * ch + c] = u > v ? u : v;
+            }
+        }
+    }
+    return pooled;
+}
+
+/**
+ * @brief Mean over time, in place: [batch][steps][ch] -> [batch][ch]
+ *
+ * Rounds half away from zero, like the int8 Mean of TFLite Micro. Same
+ * in-place argument as max_pool2().
+ */
+static void global_average_pool(int8_t *x, int steps, int ch, int batch)
+{
+    for (int b = 0; b < batch; b++) {
+        const int8_t *src = &x[(size_t)b * steps * ch];
+        for (int c = 0; c < ch; c++) {
+            int32_t sum = 0;
+            for (int t = 0; t < steps; t++) {
+                sum += src[(size_t)t * ch + c];
+            }
+            int32_t mean = sum >= 0 ? (sum + steps / 2) / steps : -((-sum + steps / 2) / steps);
+            x[(size_t)b * ch + c] = (int8_t)mean;
+        }
+    }
+}
+
+bool model_net_valid(const model_net_t *net)
+{
+    const model_layer_t *l = net->layers;
+    for (int i = 0; i < MODEL_NET_LAYERS; i++) {
+        if (!model_layer_valid(&l[i])) {
+            return false;
+        }
+        if (i > 0 && l[i].in_ch != l[i - 1].out_ch) {
+            return false;
+        }
+        if (i >= MODEL_NET_DENSE1 && l[i].kernel != 1) {
+            return false;
+        }
+    }
+    return net->steps >= 4;
+}
+
+size_t model_net_scratch_bytes(const model_net_t *net, int batch)
+{
+    // Largest activation of one window; two alternate through the stack
+    const model_layer_t *l = net->layers;
+    size_t largest = (size_t)net->steps * l[MODEL_NET_CONV1].out_ch;
+    size_t sizes[] = {
+        (size_t)(net->steps / 2) * l[MODEL_NET_CONV2].out_ch,
+        (size_t)(net->steps / 4) * l[MODEL_NET_CONV3].out_ch,
+        (size_t)l[MODEL_NET_DENSE1].out_ch,
+        (size_t)l[MODEL_NET_DENSE2].out_ch,
+    };
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        largest = sizes[i] > largest ? sizes[i] : largest;
+    }
+    return 2 * largest * batch;
+}
+
+const int8_t *model_net_features(const model_net_t *net, const model_split_t *split,
+                                 const int8_t *in, int batch, int8_t *scratch)
+{
+    const model_layer_t *l = net->layers;
+    int8_t *a = scratch;
+    int8_t *b = scratch + model_net_scratch_bytes(net, batch) / 2;
+    int steps = net->steps;
+
+    model_conv1d_batch_split(split, &l[MODEL_NET_CONV1], in, steps, batch, true, a);
+    steps = max_pool2(a, steps, l[MODEL_NET_CONV1].out_ch, batch);
+    model_conv1d_batch_split(split, &l[MODEL_NET_CONV2], a, steps, batch, true, b);
+    steps = max_pool2(b, steps, l[MODEL_NET_CONV2].out_ch, batch);
+    model_conv1d_batch_split(split, &l[MODEL_NET_CONV3], b, steps, batch, true, a);
+    global_average_pool(a, steps, l[MODEL_NET_CONV3].out_ch, batch);
+    return a;
+}
+
+void model_net_classify(const model_net_t *net, const model_split_t *split,
+                        const int8_t *features, int batch, int8_t *scratch, int8_t *out)
+{
+    const model_layer_t *l = net->layers;
+    int8_t *a = scratch;
+    int8_t *b = scratch + model_net_scratch_bytes(net, batch) / 2;
+
+    // Features returned by model_net_features() are in the first half,
+    // which dense1 reads before dense2 overwrites it
+    model_dense_batch_split(split, &l[MODEL_NET_DENSE1], features, batch, true, b);
+    model_dense_batch_split(split, &l[MODEL_NET_DENSE2], b, batch, true, a);
+    model_dense_batch_split(split, &l[MODEL_NET_CLASSES], a, batch, false, out);
+}
+
+void model_net_invoke(const model_net_t *net, const model_split_t *split, const int8_t *in,
+                      int batch, int8_t *scratch, int8_t *out)
+{
+    const int8_t *features = model_net_features(net, split, in, batch, scratch);
+    model_net_classify(net, split, features, batch, scratch, out);
+}
@@ -0,0 +1,111 @@
+/**
+ * @file model_net.h
+ * @brief LightweightPoseModel classifier over a batch of windows
+ *
+ * The Conv1D/pool/Dense stack of train_pose_model.py (batch normalization
+ * folded into the convolutions), on the int8 kernels of model_layers.h:
+ *
+ *   conv1 (k5, ReLU) -> max pool 2 -> conv2 (k5, ReLU) -> max pool 2
+ *   -> conv3 (k3, ReLU) -> global average pool -> dense1 (ReLU)
+ *   -> dense2 (ReLU) -> classes (logits)
+ *
+ * When several links complete a window in the same hop, one call runs
+ * each layer once over all of them. The kernels read each output
+ * channel's weights once per call, so the ~45KB of weights (52
+ * subcarriers) stream from flash/PSRAM once per hop instead of once per
+ * link. Each window's logits are bit-identical to a batch of one.
+ *
+ * Memory per window in the batch, 50 samples x 52 subcarriers:
+ *
+ *   input      [steps][2 * subcarriers]      5200 bytes (the caller's)
+ *   scratch    2 x [steps][conv1 out_ch]     3200 bytes (model_net_scratch_bytes)
+ *   logits     [classes]                        6 bytes
+ *
+ * so a batch of 8 takes ~67KB of internal SRAM on top of the weights,
+ * which do not grow with the batch. tools/host/batch_infer_bench measures
+ * the latency and throughput for each batch size.
+ */
+
+#ifndef MODEL_NET_H
+#define MODEL_NET_H
+
+#include "model_layers.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Windows in one call; the memory above grows linearly with it
+#define MODEL_NET_MAX_BATCH 8
+
+/**
+ * @brief Layers of the stack, in order
+ */
+typedef enum {
+    MODEL_NET_CONV1 = 0,
+    MODEL_NET_CONV2,
+    MODEL_NET_CONV3,
+    MODEL_NET_DENSE1,
+    MODEL_NET_DENSE2,
+    MODEL_NET_CLASSES,
+    MODEL_NET_LAYERS
+} model_net_layer_t;
+
+/**
+ * @brief Weights and input length of the classifier
+ */
+typedef struct {
+    model_layer_t layers[MODEL_NET_LAYERS];
+    int steps;                 // Samples per input window
+} model_net_t;
+
+/**
+ * @brief Check that each layer is valid (model_layer_valid()), the shapes
+ * chain and the window survives pooling
+ */
+bool model_net_valid(const model_net_t *net);
+
+/**
+ * @brief Scratch needed by model_net_invoke() for `batch` windows
+ */
+size_t model_net_scratch_bytes(const model_net_t *net, int batch);
+
+/**
+ * @brief Run the classifier over a batch of windows
+ *
+ * @param split   Dual-core backend (model_dual_core_split()), or NULL
+ * @param in      Windows [batch][steps][conv1 in_ch]
+ * @param batch   1 .. MODEL_NET_MAX_BATCH
+ * @param scratch model_net_scratch_bytes(net, batch) bytes
+ * @param out     Logits [batch][classes out_ch]
+ */
+void model_net_invoke(const model_net_t *net, const model_split_t *split, const int8_t *in,
+                      int batch, int8_t *scratch, int8_t *out);
+
+/**
+ * @brief First half of model_net_invoke(): the convolutions up to the
+ *        global average pool
+ *
+ * A second head on the same features (the keypoint regression) starts
+ * from here; copy them out first if model_net_classify() runs too.
+ *
+ * @return Features [batch][conv3 out_ch], inside scratch
+ */
+const int8_t *model_net_features(const model_net_t *net, const model_split_t *split,
+                                 const int8_t *in, int batch, int8_t *scratch);
+
+/**
+ * @brief Second half of model_net_invoke(): the dense layers
+ *
+ * @param features Features [batch][dense1 in_ch], e.g. from model_net_features()
+ * @param scratch  model_net_scratch_bytes(net, batch) bytes; may hold features
+ */
+void model_net_classify(const model_net_t *net, const model_split_t *split,
+                        const int8_t *features, int batch, int8_t *scratch, int8_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MODEL_NET_H
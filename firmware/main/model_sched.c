@@ -0,0 +1,164 @@
+/**
+ * @file model_sched.c
+ * @brief Multi-rate scheduling of models over the shared sample window
+ */
+
+#include "model_sched.h"
+#include <string.h>
+
+static uint32_t gcd_u32(uint32_t a, uint32_t b)
+{
+    while (b != 0) {
+        uint32_t r = a % b;
+        a = b;
+        b = r;
+    }
+    return a;
+}
+
+/**
+ * @brief Distance from phase a to phase b on a circle of g samples
+ */
+static uint32_t circular_distance(uint32_t a, uint32_t b, uint32_t g)
+{
+    uint32_t d = (a % g + g - b % g) % g;
+    return d < g - d ? d : g - d;
+}
+
+/**
+ * @brief Samples until the first run: the first n after the current sample
+ *        and at or after warmup with n % period == phase
+ */
+static uint32_t first_countdown(const model_sched_t *sched, uint32_t period, uint32_t phase)
+{
+    uint64_t n = sched->samples + 1 > sched->warmup ? sched->samples + 1 : sched->warmup;
+    n += (phase + period - n % period) % period;
+    return (uint32_t)(n - sched->samples);
+}
+
+/**
+ * @brief Least colliding phase for a new task of `period`
+ */
+static uint32_t pick_phase(const model_sched_t *sched, uint32_t period)
+{
+    uint32_t best = 0;
+    float best_rate = 0.0f;
+    uint32_t best_min = 0, best_sum = 0;
+    for (uint32_t phase = 0; phase < period; phase++) {
+        float rate = 0.0f;
+        uint32_t min_dist = UINT32_MAX, sum_dist = 0;
+        for (int i = 0; i < sched->count; i++) {
+            const model_sched_task_t *t = &sched->tasks[i];
+            uint32_t g = gcd_u32(period, t->period);
+            uint32_t d = circular_distance(phase, t->phase, g);
+            if (d == 0) {
+                rate += (float)g / ((float)period * t->period);  // 1 / lcm
+            }
+            min_dist = d < min_dist ? d : min_dist;
+            sum_dist += d;
+        }
+        if (phase == 0 || rate < best_rate ||
+            (rate == best_rate && (min_dist > best_min ||
+                                   (min_dist == best_min && sum_dist > best_sum)))) {
+            best = phase;
+            best_rate = rate;
+            best_min = min_dist;
+            best_sum = sum_dist;
+        }
+    }
+    return best;
+}
+
+void model_sched_init(model_sched_t *sched, uint32_t warmup, int64_t (*now_us)(void))
+{
+    memset(sched, 0, sizeof(*sched));
+    sched->warmup = warmup;
+    sched->now_us = now_us;
+}
+
+int model_sched_add(model_sched_t *sched, const char *name, uint32_t period, int phase,
+                    model_sched_fn_t fn, void *ctx)
+{
+    if (sched->count >= MODEL_SCHED_MAX_TASKS || period == 0 || fn == NULL ||
+        phase < MODEL_SCHED_AUTO_PHASE || (phase >= 0 && (uint32_t)phase >= period)) {
+        return -1;
+    }
+
+    model_sched_task_t *t = &sched->tasks[sched->count];
+    memset(t, 0, sizeof(*t));
+    t->name = name;
+    t->fn = fn;
+    t->ctx = ctx;
+    t->period = period;
+    t->phase = phase == MODEL_SCHED_AUTO_PHASE ? pick_phase(sched, period) : (uint32_t)phase;
+    t->countdown = first_countdown(sched, period, t->phase);
+    return sched->count++;
+}
+
+int model_sched_tick(model_sched_t *sched)
+{
+    sched->samples++;
+    int ran = 0;
+    for (int i = 0; i < sched->count; i++) {
+        model_sched_task_t *t = &sched->tasks[i];
+        if (--t->countdown != 0) {
+            continue;
+        }
+        t->countdown = t->period;
+
+        int64_t start = sched->now_us();
+        t->fn(t->ctx);
+        uint32_t us = (uint32_t)(sched->now_us() - start);
+
+        if (t->runs == 0) {
+            t->first_run = sched->samples;
+        }
+        t->last_run = sched->samples;
+        t->runs++;
+        t->busy_us += us;
+        t->max_us = us > t->max_us ? us : t->max_us;
+        ran++;
+    }
+    if (ran > 1) {
+        sched->collisions++;
+    }
+    return ran;
+}
+
+void model_sched_get_stats(const model_sched_t *sched, int index, float sample_rate_hz,
+                           model_sched_stats_t *out)
+{
+    const model_sched_task_t *t = &sched->tasks[index];
+    memset(out, 0, sizeof(*out));
+    out->name = t->name;
+    out->period = t->period;
+    out->phase = t->phase;
+    out->runs = t->runs;
+    out->max_us = t->max_us;
+    if (t->runs > 1) {
+        out->interval_ms = (float)(t->last_run - t->first_run) / (t->runs - 1) * 1000.0f /
+                           sample_rate_hz;
+    }
+    if (t->runs > 0) {
+        out->avg_us = (float)t->busy_us / t->runs;
+    }
+    if (sched->samples > 0) {
+        out->cpu_share = (float)t->busy_us * sample_rate_hz / (sched->samples * 1e6f);
+    }
+}
+
+float model_sched_collision_rate(const model_sched_t *sched)
+{
+    float rate = 0.0f;
+    for (int i = 0; i < sched->count; i++) {
+        for (int j = i + 1; j < sched->count; j++) {
+            const model_sched_task_t *a = &sched->tasks[i];
+            const model_sched_task_t *b = &sched->tasks[j];
+            uint32_t g = gcd_u32(a->period, b->period);
+            if (a->phase % g == b->phase % g) {
+                rate += (float)g / ((float)a->period * b->period);
+            }
+        }
+    }
+    return rate;
+}
@@ -0,0 +1,135 @@
+/**
+ * @file model_sched.h
+ * @brief Multi-rate scheduling of models over the shared sample window
+ *
+ * Every model used to run at one cadence, when the window buffer wrapped.
+ * Here each model (or feature extractor) is a task with its own period and
+ * phase, in samples, and runs on the samples that satisfy
+ *
+ *   n % period == phase    (n = samples buffered so far, n >= warmup)
+ *
+ * all reading the same window. A fast presence check can then run every
+ * hop while the full pose window runs at the window rate. Tasks due on the
+ * same sample run in registration order and the sample pays for all of
+ * them, so model_sched_add() can pick the phase itself: two tasks collide
+ * exactly when their phases agree modulo the gcd of their periods, so it
+ * takes the phase with the fewest collisions per sample, then the one
+ * furthest from the other tasks' runs.
+ *
+ * Per task it keeps runs, the interval between runs, the latency of each
+ * run and the share of the stream's time spent in it (busy time over
+ * samples / sample rate). The tick only counts each task down, with no
+ * division per sample.
+ *
+ * The clock is passed in (model_sched_init()).
+ */
+
+#ifndef MODEL_SCHED_H
+#define MODEL_SCHED_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MODEL_SCHED_MAX_TASKS 4
+
+// Phase argument of model_sched_add(): pick the least colliding phase
+#define MODEL_SCHED_AUTO_PHASE (-1)
+
+typedef void (*model_sched_fn_t)(void *ctx);
+
+/**
+ * @brief One registered task
+ */
+typedef struct {
+    const char *name;
+    model_sched_fn_t fn;
+    void *ctx;
+    uint32_t period;           // Samples between runs
+    uint32_t phase;            // Runs when samples % period == phase
+    uint32_t countdown;        // Samples until the next run
+
+    uint32_t runs;
+    uint64_t first_run;        // Sample of the first run
+    uint64_t last_run;         // Sample of the last run
+    uint64_t busy_us;          // Time spent in fn
+    uint32_t max_us;           // Slowest run
+} model_sched_task_t;
+
+/**
+ * @brief Scheduler state
+ */
+typedef struct {
+    model_sched_task_t tasks[MODEL_SCHED_MAX_TASKS];
+    int count;
+    uint32_t warmup;           // No task runs before this many samples
+    uint64_t samples;          // Samples ticked
+    uint32_t collisions;       // Samples on which more than one task ran
+    int64_t (*now_us)(void);   // Clock for the latencies
+} model_sched_t;
+
+/**
+ * @brief Statistics of one task
+ */
+typedef struct {
+    const char *name;
+    uint32_t period;           // Samples
+    uint32_t phase;            // Samples
+    uint32_t runs;
+    float interval_ms;         // Mean time between runs, from the sample count
+    float avg_us;              // Mean latency of a run
+    uint32_t max_us;           // Slowest run
+    float cpu_share;           // Busy time / stream time [0, 1]
+} model_sched_stats_t;
+
+/**
+ * @brief Initialize an empty scheduler
+ *
+ * @param warmup Samples before any task may run (e.g. the window length)
+ * @param now_us Monotonic clock in microseconds
+ */
+void model_sched_init(model_sched_t *sched, uint32_t warmup, int64_t (*now_us)(void));
+
+/**
+ * @brief Register a task; it first runs on the next sample that is due
+ *
+ * @param name   Static name for the statistics
+ * @param period Samples between runs (> 0)
+ * @param phase  0 .. period-1, or MODEL_SCHED_AUTO_PHASE
+ * @return Task index, or -1 if the table is full or the arguments are invalid
+ */
+int model_sched_add(model_sched_t *sched, const char *name, uint32_t period, int phase,
+                    model_sched_fn_t fn, void *ctx);
+
+/**
+ * @brief Account one buffered sample and run the tasks due on it
+ *
+ * @return Number of tasks run
+ */
+int model_sched_tick(model_sched_t *sched);
+
+/**
+ * @brief Statistics of task `index`
+ *
+ * @param sample_rate_hz Rate of the ticks, for intervals and CPU share
+ */
+void model_sched_get_stats(const model_sched_t *sched, int index, float sample_rate_hz,
+                           model_sched_stats_t *out);
+
+/**
+ * @brief Expected collisions per sample, from the periods and phases alone
+ *
+ * Sum over task pairs whose phases agree modulo the gcd of their periods
+ * of 1 / lcm(periods): the long-run share of samples with more than one
+ * task, as long as no three tasks meet on one sample.
+ */
+float model_sched_collision_rate(const model_sched_t *sched);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MODEL_SCHED_H
@@ -0,0 +1,271 @@
+/**
+ * @file occupancy.c
+ * @brief People count from the spread of CSI amplitude variance across subcarriers
+ */
+
+#include "occupancy.h"
+#include <math.h>
+#include <string.h>
+
+// Subspace iterations. The strongest components converge in a few; the
+// rest only need to be ordered against the noise edge
+#define SUBSPACE_ITERATIONS 10
+
+/**
+ * @brief y = C x for a symmetric matrix stored as a packed upper triangle
+ */
+static void packed_matvec(const float *cov, int n, const float *x, float *y)
+{
+    memset(y, 0, n * sizeof(float));
+    for (int i = 0; i < n; i++) {
+        const float xi = x[i];
+        float acc = *cov++ * xi;
+        for (int j = i + 1; j < n; j++, cov++) {
+            acc += *cov * x[j];
+            y[j] += *cov * xi;
+        }
+        y[i] += acc;
+    }
+}
+
+static float dot(const float *a, const float *b, int n)
+{
+    float sum = 0.0f;
+    for (int i = 0; i < n; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+/**
+ * @brief Orthonormalize the rows of w into v (modified Gram-Schmidt)
+ *
+ * @param norms Output: norm of each row after removing the previous ones
+ */
+static void orthonormalize(const float *w, float *v, int rows, int n, float *norms)
+{
+    for (int k = 0; k < rows; k++) {
+        float *vk = &v[k * n];
+        memcpy(vk, &w[k * n], n * sizeof(float));
+        for (int j = 0; j < k; j++) {
+            const float *vj = &v[j * n];
+            float proj = dot(vk, vj, n);
+            for (int i = 0; i < n; i++) {
+                vk[i] -= proj * vj[i];
+            }
+        }
+        float norm = sqrtf(dot(vk, vk, n));
+        norms[k] = norm;
+        float inv = norm > 0.0f ? 1.0f / norm : 0.0f;
+        for (int i = 0; i < n; i++) {
+            vk[i] *= inv;
+        }
+    }
+}
+
+/**
+ * @brief Count the components of a packed covariance above the noise edge
+ *
+ * @param v, w Scratch, m x n floats each
+ */
+static void count_components(const float *cov, float trace, int n, int window_size,
+                             bool human_detected, float *v, float *w, occupancy_estimate_t *out)
+{
+    const int m = OCCUPANCY_COMPONENTS;
+    if (trace <= 0.0f) {
+        out->count = human_detected ? 1 : 0;  // Constant window: no variance at all
+        return;
+    }
+
+    // Starting basis: fixed pseudo-random vectors, so no component of the
+    // covariance is orthogonal to all of them in practice
+    uint32_t seed = 0x2545F491u;
+    for (int k = 0; k < m * n; k++) {
+        seed = seed * 1664525u + 1013904223u;
+        w[k] = (float)(int32_t)seed * (1.0f / 2147483648.0f);
+    }
+    float norms[OCCUPANCY_COMPONENTS];
+    orthonormalize(w, v, m, n, norms);
+
+    for (int iter = 0; iter < SUBSPACE_ITERATIONS; iter++) {
+        for (int k = 0; k < m; k++) {
+            packed_matvec(cov, n, &v[k * n], &w[k * n]);
+        }
+        orthonormalize(w, v, m, n, norms);
+    }
+
+    // Norms of the last iteration converge to the eigenvalues; keep them
+    // descending (unconverged noise components may be slightly out of order)
+    for (int k = 0; k < m; k++) {
+        float value = norms[k];
+        int j = k;
+        for (; j > 0 && out->eigenvalues[j - 1] < value; j--) {
+            out->eigenvalues[j] = out->eigenvalues[j - 1];
+        }
+        out->eigenvalues[j] = value;
+    }
+
+    // Largest eigenvalue of pure noise with variance s2 per subcarrier over
+    // window_size - 1 degrees of freedom (Marchenko-Pastur upper edge)
+    const float ratio = (float)n / (window_size - 1);
+    const float edge_factor = (1.0f + sqrtf(ratio)) * (1.0f + sqrtf(ratio)) * OCCUPANCY_EDGE_MARGIN;
+
+    // Accept components one at a time; each one accepted leaves less of the
+    // trace to the noise estimate
+    int k = 0;
+    float signal = 0.0f;
+    float threshold = 0.0f;
+    for (;;) {
+        out->noise = fmaxf(trace - signal, 0.0f) / n;
+        threshold = out->noise * edge_factor;
+        if (k == m || out->eigenvalues[k] <= threshold) {
+            break;
+        }
+        signal += out->eigenvalues[k];
+        k++;
+    }
+    out->components = (uint8_t)k;
+    out->count = (uint8_t)(k < OCCUPANCY_MAX_COUNT ? k : OCCUPANCY_MAX_COUNT);
+    if (out->count == 0 && human_detected) {
+        out->count = 1;  // Someone still: present, but no motion component
+    }
+
+    // Margin of the cut (log ratio): the gap between the last eigenvalue
+    // counted and the first one left out, beyond the edge margin. Noise
+    // eigenvalues sit near the edge and motion components far above it, so
+    // a gap no wider than the margin could as well have put the cut one
+    // component over. Without a component counted, how far the largest
+    // eigenvalue is below the threshold; at saturation, how far the last
+    // counted one is above it.
+    float margin = INFINITY;
+    if (threshold > 0.0f) {
+        if (k == 0) {
+            margin = logf(threshold / fmaxf(out->eigenvalues[0], 1e-12f));
+        } else if (k >= OCCUPANCY_MAX_COUNT) {
+            margin = logf(out->eigenvalues[OCCUPANCY_MAX_COUNT - 1] / threshold);
+        } else {
+            margin = logf(out->eigenvalues[k - 1] / fmaxf(out->eigenvalues[k], 1e-12f)) -
+                     logf(OCCUPANCY_EDGE_MARGIN);
+        }
+    }
+    out->confidence = isinf(margin) ? 1.0f : 0.5f + 0.5f * tanhf(fmaxf(margin, 0.0f));
+}
+
+/**
+ * @brief Too few samples or subcarriers for the components: presence only
+ */
+static bool window_too_small(int window_size, int n, bool human_detected,
+                             occupancy_estimate_t *out)
+{
+    memset(out, 0, sizeof(*out));
+    out->confidence = 1.0f;
+    if (window_size < OCCUPANCY_COMPONENTS + 2 || n < OCCUPANCY_COMPONENTS + 1) {
+        out->count = human_detected ? 1 : 0;
+        out->confidence = 0.5f;
+        return true;
+    }
+    return false;
+}
+
+void occupancy_estimate(const float *amplitude, int window_size, int num_subcarriers,
+                        bool human_detected, float *scratch, occupancy_estimate_t *out)
+{
+    const int n = num_subcarriers;
+    const int m = OCCUPANCY_COMPONENTS;
+    if (window_too_small(window_size, n, human_detected, out)) {
+        return;
+    }
+
+    float *cov = scratch;                          // n(n+1)/2, packed upper triangle
+    float *v = cov + (size_t)n * (n + 1) / 2;      // m x n, orthonormal basis
+    float *w = v + (size_t)m * n;                  // m x n, C v
+    float *centered = w + (size_t)m * n;           // n
+
+    // Per-subcarrier means (kept in the first row of v until the basis is built)
+    float *mean = v;
+    memset(mean, 0, n * sizeof(float));
+    for (int t = 0; t < window_size; t++) {
+        const float *row = &amplitude[t * n];
+        for (int i = 0; i < n; i++) {
+            mean[i] += row[i];
+        }
+    }
+    for (int i = 0; i < n; i++) {
+        mean[i] /= window_size;
+    }
+
+    // Covariance, upper triangle only
+    memset(cov, 0, (size_t)n * (n + 1) / 2 * sizeof(float));
+    for (int t = 0; t < window_size; t++) {
+        const float *row = &amplitude[t * n];
+        for (int i = 0; i < n; i++) {
+            centered[i] = row[i] - mean[i];
+        }
+        float *c = cov;
+        for (int i = 0; i < n; i++) {
+            const float xi = centered[i];
+            for (int j = i; j < n; j++) {
+                *c++ += xi * centered[j];
+            }
+        }
+    }
+    const float scale = 1.0f / (window_size - 1);
+    float trace = 0.0f;
+    for (int i = 0, k = 0; i < n; k += n - i, i++) {
+        trace += cov[k] * scale;
+    }
+    for (size_t k = 0; k < (size_t)n * (n + 1) / 2; k++) {
+        cov[k] *= scale;
+    }
+
+    count_components(cov, trace, n, window_size, human_detected, v, w, out);
+}
+
+void occupancy_estimate_q7(const int16_t *amplitude, int window_size, int num_subcarriers,
+                           bool human_detected, float *scratch, occupancy_estimate_t *out)
+{
+    const int n = num_subcarriers;
+    const int m = OCCUPANCY_COMPONENTS;
+    if (window_too_small(window_size, n, human_detected, out)) {
+        return;
+    }
+
+    float *cov = scratch;                          // n(n+1)/2, packed upper triangle
+    float *v = cov + (size_t)n * (n + 1) / 2;      // m x n, orthonormal basis
+    float *w = v + (size_t)m * n;                  // m x n, C v
+    int32_t *mean = (int32_t *)(w + (size_t)m * n); // n, rounded means
+    int32_t *residual = (int32_t *)v;              // n, sum - window_size * mean
+
+    // Integer means; the rounding residual is corrected for exactly below
+    for (int i = 0; i < n; i++) {
+        int32_t sum = 0;
+        for (int t = 0; t < window_size; t++) {
+            sum += amplitude[t * n + i];
+        }
+        mean[i] = (sum + window_size / 2) / window_size;
+        residual[i] = sum - window_size * mean[i];
+    }
+
+    // Covariance from exact integer sums: centered values are at most
+    // |Q8.7 amplitude|, so each product fits int32
+    const float scale = 1.0f / ((float)window_size * (window_size - 1) * (1 << 14));
+    float trace = 0.0f;
+    for (int i = 0, k = 0; i < n; i++) {
+        const int32_t mi = mean[i];
+        for (int j = i; j < n; j++, k++) {
+            const int32_t mj = mean[j];
+            int64_t acc = 0;
+            for (int t = 0; t < window_size; t++) {
+                const int16_t *row = &amplitude[t * n];
+                acc += (int32_t)(row[i] - mi) * (row[j] - mj);
+            }
+            int64_t exact = (int64_t)window_size * acc - (int64_t)residual[i] * residual[j];
+            cov[k] = (float)exact * scale;
+            if (j == i) {
+                trace += cov[k];
+            }
+        }
+    }
+
+    count_components(cov, trace, n, window_size, human_detected, v, w, out);
+}
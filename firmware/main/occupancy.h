@@ -0,0 +1,95 @@
+/**
+ * @file occupancy.h
+ * @brief People count from the spread of CSI amplitude variance across subcarriers
+ *
+ * Every moving person modulates the CSI amplitude with their own motion
+ * signal, and because each stands at a different place in the multipath
+ * field the modulation has its own pattern across subcarriers. Over one
+ * window the amplitude variations therefore span about one dimension per
+ * moving person, on top of measurement noise that is spread evenly over
+ * all subcarriers.
+ *
+ * occupancy_estimate() counts those dimensions:
+ *
+ *   centered amplitude window (T samples x S subcarriers)
+ *     -> S x S covariance (packed upper triangle)
+ *     -> largest OCCUPANCY_MAX_COUNT + 1 eigenvalues (subspace iteration)
+ *     -> noise level from the remaining trace
+ *     -> count = eigenvalues above the largest a pure-noise window would
+ *        produce (Marchenko-Pastur edge times OCCUPANCY_EDGE_MARGIN)
+ *
+ * Confidence comes from the eigenvalue gap at the cut: the last eigenvalue
+ * counted over the first one left out, beyond the edge margin. A still person adds no variance dimension; the caller's
+ * presence decision raises a count of 0 to 1. Counts saturate at
+ * OCCUPANCY_MAX_COUNT ("that many or more").
+ *
+ * Scratch memory is the caller's, normally carved from the memory arena.
+ */
+
+#ifndef OCCUPANCY_H
+#define OCCUPANCY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Largest count reported; higher counts are reported as this
+#define OCCUPANCY_MAX_COUNT 4
+
+// Components extracted: one more than the largest count, so the count
+// that saturates still has an eigenvalue below it to compare with
+#define OCCUPANCY_COMPONENTS (OCCUPANCY_MAX_COUNT + 1)
+
+// A component must exceed the pure-noise eigenvalue edge by this factor
+#define OCCUPANCY_EDGE_MARGIN 2.0f
+
+// Scratch for num_subcarriers (constant expression): packed covariance,
+// subspace vectors and the per-subcarrier means
+#define OCCUPANCY_SCRATCH_BYTES(num_subcarriers) \
+    (((size_t)(num_subcarriers) * ((num_subcarriers) + 1) / 2 + \
+      (size_t)(num_subcarriers) * (2 * OCCUPANCY_COMPONENTS + 1)) * sizeof(float))
+
+/**
+ * @brief Result of one estimate
+ */
+typedef struct {
+    uint8_t count;                           // People, 0..OCCUPANCY_MAX_COUNT
+    float confidence;                        // [0.5, 1.0]; 0.5 = count +/- 1 equally likely
+    uint8_t components;                      // Variance components above the noise edge
+    float noise;                             // Noise variance per subcarrier
+    float eigenvalues[OCCUPANCY_COMPONENTS]; // Largest covariance eigenvalues, descending
+} occupancy_estimate_t;
+
+/**
+ * @brief Estimate the number of people from one CSI window
+ *
+ * @param amplitude       Window amplitudes [window_size][num_subcarriers]
+ * @param window_size     Samples in the window (at least OCCUPANCY_COMPONENTS + 2)
+ * @param num_subcarriers Subcarriers per sample
+ * @param human_detected  Presence decision for the window: raises 0 to 1
+ * @param scratch         OCCUPANCY_SCRATCH_BYTES(num_subcarriers) bytes, float aligned
+ * @param out             Output estimate (count 0 if the window is too short)
+ */
+void occupancy_estimate(const float *amplitude, int window_size, int num_subcarriers,
+                        bool human_detected, float *scratch, occupancy_estimate_t *out);
+
+/**
+ * @brief occupancy_estimate() over a fixed-point window (csi_fixed.h)
+ *
+ * The covariance comes from exact integer sums; only the eigenvalue
+ * iteration runs in float, on the n(n+1)/2 covariance entries.
+ *
+ * @param amplitude Window amplitudes in Q8.7 [window_size][num_subcarriers]
+ */
+void occupancy_estimate_q7(const int16_t *amplitude, int window_size, int num_subcarriers,
+                           bool human_detected, float *scratch, occupancy_estimate_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OCCUPANCY_H
@@ -0,0 +1,413 @@
+/**
+ * @file placement_bench.c
+ * @brief On-device benchmark of temporal buffer placement (SRAM vs PSRAM),
+ *        of the fixed-point CSI path against the float one, and of model
+ *        layers on one core against two
+ */
+
+#include "placement_bench.h"
+#include "csi_features.h"
+#include "csi_fixed.h"
+#include "csi_history.h"
+#include "model_dual_core.h"
+#include "model_layers.h"
+#include "occupancy.h"
+#include "pose_dims.h"
+#include "pose_pipeline.h"
+#include "esp_log.h"
+#include "esp_cpu.h"
+#include "esp_heap_caps.h"
+#include "esp_random.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <math.h>
+#include <string.h>
+
+static const char *TAG = "placement_bench";
+
+// Same window as pose_inference.c (pose_dims.h)
+#define BENCH_WINDOW_BYTES (POSE_WINDOW_SAMPLES * POSE_NUM_SUBCARRIERS * sizeof(float))
+
+// Larger than the biggest ESP32-S3 data cache (64KB), so reading it evicts everything
+#define EVICT_BYTES (96 * 1024)
+
+#define CAPS_INTERNAL (MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT)
+#define CAPS_PSRAM (MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT)
+
+/**
+ * @brief One placement under test
+ */
+typedef struct {
+    const char *name;
+    uint32_t window_caps;      // Where the scanned window lives
+    uint32_t history_caps;     // Where completed windows are spilled
+} placement_t;
+
+static const placement_t s_placements[] = {
+    { "internal", CAPS_INTERNAL, CAPS_INTERNAL },
+    { "psram", CAPS_PSRAM, CAPS_PSRAM },
+    { "hot/cold", CAPS_INTERNAL, CAPS_PSRAM },
+};
+
+/**
+ * @brief Cycle totals of one placement
+ */
+typedef struct {
+    uint64_t fill;             // Writing the window sample by sample
+    uint64_t stats;            // csi_window_stats() over the window
+    uint64_t spill;            // Copying the window to the history ring
+} bench_cycles_t;
+
+static float s_sample_amp[POSE_NUM_SUBCARRIERS];
+static float s_sample_phase[POSE_NUM_SUBCARRIERS];
+static volatile uint32_t s_evict_sink;
+
+/**
+ * @brief Push every line of the buffers under test out of the data cache
+ */
+static void evict_cache(const uint8_t *evict)
+{
+    uint32_t sum = 0;
+    for (size_t i = 0; i < EVICT_BYTES; i += CSI_HISTORY_LINE_BYTES) {
+        sum += evict[i];
+    }
+    s_evict_sink = sum;
+}
+
+// Model input quantization for the fixed-point comparison (a typical int8 input tensor)
+#define BENCH_INPUT_SCALE 0.03f
+#define BENCH_INPUT_ZERO_POINT (-2)
+
+static float cycles_to_us(uint64_t cycles, int iterations)
+{
+    return (float)cycles / iterations / CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ;
+}
+
+static esp_err_t bench_placement(const placement_t *p, const uint8_t *evict, int iterations,
+                                 bench_cycles_t *out)
+{
+    float *amp = heap_caps_aligned_alloc(CSI_HISTORY_LINE_BYTES, BENCH_WINDOW_BYTES,
+                                         p->window_caps);
+    float *phase = heap_caps_aligned_alloc(CSI_HISTORY_LINE_BYTES, BENCH_WINDOW_BYTES,
+                                           p->window_caps);
+    int8_t *rssi = heap_caps_malloc(POSE_WINDOW_SAMPLES, CAPS_INTERNAL);
+    void *history_mem = heap_caps_aligned_alloc(CSI_HISTORY_LINE_BYTES,
+                                                csi_history_storage_bytes(BENCH_WINDOW_BYTES, 2),
+                                                p->history_caps);
+    esp_err_t ret = ESP_OK;
+
+    if (amp == NULL || phase == NULL || rssi == NULL || history_mem == NULL) {
+        ESP_LOGE(TAG, "Cannot allocate %s buffers", p->name);
+        ret = ESP_ERR_NO_MEM;
+        goto cleanup;
+    }
+
+    // Amplitude and phase spill into one ring here; only the copy cost matters
+    csi_history_t history;
+    csi_history_init(&history, history_mem, BENCH_WINDOW_BYTES, 2);
+    memset(out, 0, sizeof(*out));
+
+    for (int it = 0; it < iterations; it++) {
+        evict_cache(evict);
+
+        // pose_process_csi(): one row per sample
+        uint32_t t0 = esp_cpu_get_cycle_count();
+        for (int t = 0; t < POSE_WINDOW_SAMPLES; t++) {
+            for (int s = 0; s < POSE_NUM_SUBCARRIERS; s++) {
+                amp[t * POSE_NUM_SUBCARRIERS + s] = s_sample_amp[s];
+                phase[t * POSE_NUM_SUBCARRIERS + s] = s_sample_phase[s];
+            }
+            rssi[t] = (int8_t)(-50 - (t & 7));
+        }
+        uint32_t t1 = esp_cpu_get_cycle_count();
+
+        // run_inference()
+        csi_window_stats_t stats;
+        csi_window_stats(amp, phase, rssi, POSE_WINDOW_SAMPLES, POSE_NUM_SUBCARRIERS, &stats);
+        uint32_t t2 = esp_cpu_get_cycle_count();
+
+        // spill_window()
+        csi_history_push(&history, amp);
+        csi_history_push(&history, phase);
+        uint32_t t3 = esp_cpu_get_cycle_count();
+
+        out->fill += t1 - t0;
+        out->stats += t2 - t1;
+        out->spill += t3 - t2;
+    }
+
+cleanup:
+    heap_caps_free(amp);
+    heap_caps_free(phase);
+    heap_caps_free(rssi);
+    heap_caps_free(history_mem);
+    return ret;
+}
+
+/**
+ * @brief Time each stage of the float and the fixed-point path
+ *
+ * Buffers are in internal SRAM and the cache is warm: this compares the
+ * arithmetic, not the memory.
+ */
+static esp_err_t bench_fixed_point(int iterations)
+{
+    const int window = POSE_WINDOW_SAMPLES * POSE_NUM_SUBCARRIERS;
+    int8_t *iq = heap_caps_malloc(2 * window, CAPS_INTERNAL);
+    float *amp = heap_caps_malloc(window * sizeof(float), CAPS_INTERNAL);
+    float *phase = heap_caps_malloc(window * sizeof(float), CAPS_INTERNAL);
+    int16_t *amp_q = heap_caps_malloc(window * sizeof(int16_t), CAPS_INTERNAL);
+    int16_t *phase_q = heap_caps_malloc(window * sizeof(int16_t), CAPS_INTERNAL);
+    int8_t *input = heap_caps_malloc(2 * window, CAPS_INTERNAL);
+    float *scratch = heap_caps_malloc(OCCUPANCY_SCRATCH_BYTES(POSE_NUM_SUBCARRIERS),
+                                      CAPS_INTERNAL);
+    int8_t rssi[POSE_WINDOW_SAMPLES] = { 0 };
+    esp_err_t ret = ESP_OK;
+
+    if (iq == NULL || amp == NULL || phase == NULL || amp_q == NULL || phase_q == NULL ||
+        input == NULL || scratch == NULL) {
+        ESP_LOGE(TAG, "Cannot allocate fixed-point buffers");
+        ret = ESP_ERR_NO_MEM;
+        goto cleanup;
+    }
+    for (int i = 0; i < 2 * window; i++) {
+        iq[i] = (int8_t)(esp_random() % 81) - 40;
+    }
+
+    // cycles[path][stage]: I/Q per packet, stats, model input, occupancy
+    uint64_t cycles[2][4] = { { 0 } };
+    csi_window_stats_t stats;
+    occupancy_estimate_t occupancy;
+    for (int it = 0; it < iterations; it++) {
+        uint32_t t0 = esp_cpu_get_cycle_count();
+        for (int t = 0; t < POSE_WINDOW_SAMPLES; t++) {
+            for (int s = 0; s < POSE_NUM_SUBCARRIERS; s++) {
+                int i = t * POSE_NUM_SUBCARRIERS + s;
+                amp[i] = sqrtf((float)(iq[2 * i] * iq[2 * i] + iq[2 * i + 1] * iq[2 * i + 1]));
+                phase[i] = atan2f((float)iq[2 * i + 1], (float)iq[2 * i]);
+            }
+        }
+        uint32_t t1 = esp_cpu_get_cycle_count();
+        csi_window_stats(amp, phase, rssi, POSE_WINDOW_SAMPLES, POSE_NUM_SUBCARRIERS, &stats);
+        uint32_t t2 = esp_cpu_get_cycle_count();
+        pose_model_prepare_input(amp, phase, POSE_WINDOW_SAMPLES, POSE_NUM_SUBCARRIERS,
+                                 BENCH_INPUT_SCALE, BENCH_INPUT_ZERO_POINT, input);
+        uint32_t t3 = esp_cpu_get_cycle_count();
+        occupancy_estimate(amp, POSE_WINDOW_SAMPLES, POSE_NUM_SUBCARRIERS, false, scratch,
+                           &occupancy);
+        uint32_t t4 = esp_cpu_get_cycle_count();
+        cycles[0][0] += t1 - t0;
+        cycles[0][1] += t2 - t1;
+        cycles[0][2] += t3 - t2;
+        cycles[0][3] += t4 - t3;
+
+        t0 = esp_cpu_get_cycle_count();
+        for (int t = 0; t < POSE_WINDOW_SAMPLES; t++) {
+            int row = t * POSE_NUM_SUBCARRIERS;
+            csi_fixed_iq(&iq[2 * row], POSE_NUM_SUBCARRIERS, &amp_q[row], &phase_q[row]);
+        }
+        t1 = esp_cpu_get_cycle_count();
+        csi_fixed_window_stats(amp_q, phase_q, rssi, POSE_WINDOW_SAMPLES, POSE_NUM_SUBCARRIERS,
+                               &stats);
+        t2 = esp_cpu_get_cycle_count();
+        csi_fixed_prepare_input(amp_q, phase_q, POSE_WINDOW_SAMPLES, POSE_NUM_SUBCARRIERS,
+                                BENCH_INPUT_SCALE, BENCH_INPUT_ZERO_POINT, input);
+        t3 = esp_cpu_get_cycle_count();
+        occupancy_estimate_q7(amp_q, POSE_WINDOW_SAMPLES, POSE_NUM_SUBCARRIERS, false, scratch,
+                              &occupancy);
+        t4 = esp_cpu_get_cycle_count();
+        cycles[1][0] += t1 - t0;
+        cycles[1][1] += t2 - t1;
+        cycles[1][2] += t3 - t2;
+        cycles[1][3] += t4 - t3;
+    }
+
+    static const char *const stages[] = { "I/Q packet", "stats", "input", "occupancy" };
+    ESP_LOGI(TAG, "=== Float vs fixed point (%d windows, cycles) ===", iterations);
+    ESP_LOGI(TAG, "  %-10s %10s %10s %8s", "stage", "float", "fixed", "speedup");
+    for (int k = 0; k < 4; k++) {
+        // I/Q is converted per packet, the other stages per window
+        int per = k == 0 ? iterations * POSE_WINDOW_SAMPLES : iterations;
+        ESP_LOGI(TAG, "  %-10s %10llu %10llu %7.2fx", stages[k], cycles[0][k] / per,
+                 cycles[1][k] / per, (float)cycles[0][k] / (float)cycles[1][k]);
+    }
+
+cleanup:
+    heap_caps_free(iq);
+    heap_caps_free(amp);
+    heap_caps_free(phase);
+    heap_caps_free(amp_q);
+    heap_caps_free(phase_q);
+    heap_caps_free(input);
+    heap_caps_free(scratch);
+    return ret;
+}
+
+/**
+ * @brief A random-weight layer of the reference model (train_pose_model.py)
+ */
+static esp_err_t make_layer(model_layer_t *layer, int in_ch, int out_ch, int kernel)
+{
+    size_t weight_bytes = (size_t)out_ch * kernel * in_ch;
+    int8_t *weights = heap_caps_malloc(weight_bytes, CAPS_INTERNAL);
+    int32_t *bias = heap_caps_calloc(out_ch, sizeof(int32_t), CAPS_INTERNAL);
+    if (weights == NULL || bias == NULL) {
+        heap_caps_free(weights);
+        heap_caps_free(bias);
+        return ESP_ERR_NO_MEM;
+    }
+    for (size_t i = 0; i < weight_bytes; i++) {
+        weights[i] = (int8_t)esp_random();
+    }
+
+    // Random weights and inputs: keep roughly 3 standard deviations in range
+    float scale = 127.0f / (3.0f * 74.0f * 74.0f * sqrtf((float)(in_ch * kernel)));
+    int shift = 30;
+    while (scale < 0.5f) {
+        scale *= 2.0f;
+        shift++;
+    }
+    *layer = (model_layer_t){ in_ch, out_ch, kernel, weights, bias,
+                              (int32_t)(scale * (1 << 30)), shift };
+    return model_layer_valid(layer) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+/**
+ * @brief Time each Conv1D/Dense layer of the reference model on one core
+ *        and split across both (model_dual_core.h)
+ *
+ * Every layer is split here, whatever CONFIG_POSE_MODEL_SPLIT_MIN_MACS
+ * says, so the table shows where the threshold belongs.
+ */
+static esp_err_t bench_dual_core(int iterations)
+{
+    // Layers and input steps of LightweightPoseModel over the bench window
+    static const struct {
+        const char *name;
+        int in_ch, out_ch, kernel, steps;
+    } shapes[] = {
+        { "conv1", POSE_MODEL_FEATURES, 32, 5, POSE_WINDOW_SAMPLES },
+        { "conv2", 32, 64, 5, POSE_WINDOW_SAMPLES / 2 },
+        { "conv3", 64, 64, 3, POSE_WINDOW_SAMPLES / 4 },
+        { "dense1", 64, 64, 1, 1 },
+        { "dense2", 64, 32, 1, 1 },
+        { "classes", 32, 6, 1, 1 },
+    };
+    const int num_layers = sizeof(shapes) / sizeof(shapes[0]);
+    const size_t act_bytes = (size_t)POSE_WINDOW_SAMPLES * POSE_MODEL_FEATURES;
+
+    // Workers started here are deleted again: the bench runs once at startup
+    const bool own_workers = model_dual_core_split() == NULL;
+    esp_err_t ret = model_dual_core_init(CONFIG_POSE_MODEL_SPLIT_MIN_MACS,
+                                         uxTaskPriorityGet(NULL) + 1);
+    if (ret != ESP_OK) {
+        return ret == ESP_ERR_NOT_SUPPORTED ? ESP_OK : ret;  // Nothing to compare on one core
+    }
+    model_split_t split = *model_dual_core_split();
+    split.min_macs = 0;
+
+    model_layer_t layers[sizeof(shapes) / sizeof(shapes[0])] = { { 0 } };
+    int8_t *in = heap_caps_malloc(act_bytes, CAPS_INTERNAL);
+    int8_t *out_one = heap_caps_malloc(act_bytes, CAPS_INTERNAL);
+    int8_t *out_two = heap_caps_malloc(act_bytes, CAPS_INTERNAL);
+    if (in == NULL || out_one == NULL || out_two == NULL) {
+        ret = ESP_ERR_NO_MEM;
+    }
+    for (int l = 0; l < num_layers && ret == ESP_OK; l++) {
+        ret = make_layer(&layers[l], shapes[l].in_ch, shapes[l].out_ch, shapes[l].kernel);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Cannot allocate model layers");
+        goto cleanup;
+    }
+    for (size_t i = 0; i < act_bytes; i++) {
+        in[i] = (int8_t)esp_random();
+    }
+
+    ESP_LOGI(TAG, "=== Model layers, one core vs two (%d runs, cycles) ===", iterations);
+    ESP_LOGI(TAG, "  %-8s %8s %10s %10s %8s %6s", "layer", "MACs", "one core", "two cores",
+             "speedup", "split");
+    for (int l = 0; l < num_layers; l++) {
+        const model_layer_t *layer = &layers[l];
+        const int steps = shapes[l].steps;
+        uint64_t one = 0, two = 0;
+        for (int it = 0; it < iterations; it++) {
+            uint32_t t0 = esp_cpu_get_cycle_count();
+            model_conv1d_split(NULL, layer, in, steps, true, out_one);
+            uint32_t t1 = esp_cpu_get_cycle_count();
+            model_conv1d_split(&split, layer, in, steps, true, out_two);
+            uint32_t t2 = esp_cpu_get_cycle_count();
+            one += t1 - t0;
+            two += t2 - t1;
+        }
+        uint32_t macs = model_layer_macs(layer, steps);
+        if (memcmp(out_one, out_two, (size_t)steps * layer->out_ch) != 0) {
+            ESP_LOGE(TAG, "  %s: split output differs from one core", shapes[l].name);
+            ret = ESP_FAIL;
+        }
+        ESP_LOGI(TAG, "  %-8s %8lu %10llu %10llu %7.2fx %6s", shapes[l].name,
+                 (unsigned long)macs, one / iterations, two / iterations,
+                 (float)one / (float)two,
+                 macs >= CONFIG_POSE_MODEL_SPLIT_MIN_MACS ? "yes" : "no");
+    }
+
+cleanup:
+    for (int l = 0; l < num_layers; l++) {
+        heap_caps_free((void *)layers[l].weights);
+        heap_caps_free((void *)layers[l].bias);
+    }
+    heap_caps_free(in);
+    heap_caps_free(out_one);
+    heap_caps_free(out_two);
+    if (own_workers) {
+        model_dual_core_deinit();
+    }
+    return ret;
+}
+
+esp_err_t placement_bench_run(int iterations)
+{
+    if (iterations <= 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint8_t *evict = heap_caps_malloc(EVICT_BYTES, CAPS_PSRAM);
+    if (evict == NULL) {
+        ESP_LOGE(TAG, "Cannot allocate cache eviction buffer");
+        return ESP_ERR_NO_MEM;
+    }
+    memset(evict, 0x5a, EVICT_BYTES);
+
+    for (int s = 0; s < POSE_NUM_SUBCARRIERS; s++) {
+        s_sample_amp[s] = 20.0f + (float)(esp_random() % 1000) / 100.0f;
+        s_sample_phase[s] = (float)(esp_random() % 628) / 100.0f - 3.14f;
+    }
+
+    ESP_LOGI(TAG, "=== Placement Benchmark (%d windows of %dx%d, cold cache) ===",
+             iterations, POSE_WINDOW_SAMPLES, POSE_NUM_SUBCARRIERS);
+    ESP_LOGI(TAG, "  %-10s %10s %10s %10s %10s", "placement", "fill us", "stats us",
+             "spill us", "total us");
+
+    esp_err_t ret = ESP_OK;
+    for (size_t i = 0; i < sizeof(s_placements) / sizeof(s_placements[0]); i++) {
+        bench_cycles_t c;
+        ret = bench_placement(&s_placements[i], evict, iterations, &c);
+        if (ret != ESP_OK) {
+            break;
+        }
+        ESP_LOGI(TAG, "  %-10s %10.1f %10.1f %10.1f %10.1f", s_placements[i].name,
+                 cycles_to_us(c.fill, iterations), cycles_to_us(c.stats, iterations),
+                 cycles_to_us(c.spill, iterations),
+                 cycles_to_us(c.fill + c.stats + c.spill, iterations));
+    }
+    ESP_LOGI(TAG, "==========================================================");
+
+    heap_caps_free(evict);
+    if (ret == ESP_OK) {
+        ret = bench_fixed_point(iterations);
+    }
+    if (ret == ESP_OK) {
+        ret = bench_dual_core(iterations);
+    }
+    return ret;
+}
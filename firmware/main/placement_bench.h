@@ -0,0 +1,56 @@
+/**
+ * @file placement_bench.h
+ * @brief On-device benchmark of temporal buffer placement (SRAM vs PSRAM),
+ *        of the fixed-point CSI path and of dual-core model layers
+ *
+ * Times one window of the pose pipeline with its buffers in each placement:
+ *
+ * - internal: window and history both in internal SRAM (upper bound, does
+ *             not fit once the history grows)
+ * - psram:    window in PSRAM (CONFIG_POSE_PLACEMENT_ALL_PSRAM)
+ * - hot/cold: window in internal SRAM, completed window spilled to PSRAM
+ *             (CONFIG_POSE_PLACEMENT_HOT_COLD, the default)
+ *
+ * Each iteration writes a window sample by sample like pose_process_csi(),
+ * runs the window statistics like run_inference() and, for hot/cold, spills
+ * the window to the history ring. The data cache is flushed between
+ * iterations so PSRAM accesses are measured cold, as they are after 500ms of
+ * WiFi and logging traffic.
+ *
+ * tools/host/placement_sim estimates the same numbers off-device.
+ *
+ * A second table compares the cycles of each stage on the float path and
+ * on the fixed-point path (CONFIG_POSE_FIXED_POINT, csi_fixed.h); the host
+ * counterpart is tools/host/fixed_point_check.
+ *
+ * A third table times each Conv1D/Dense layer of the reference model on
+ * one core and split across both (model_dual_core.h), with the split
+ * forced, next to whether CONFIG_POSE_MODEL_SPLIT_MIN_MACS would split it;
+ * the host counterpart is tools/host/layer_split_bench.
+ */
+
+#ifndef PLACEMENT_BENCH_H
+#define PLACEMENT_BENCH_H
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Run the benchmark and log a table of results
+ *
+ * Allocates its own buffers and frees them before returning, so call it
+ * before mem_arena_init() when PSRAM is tight.
+ *
+ * @param iterations Windows timed per placement
+ * @return ESP_OK, or ESP_ERR_NO_MEM if the test buffers cannot be allocated
+ */
+esp_err_t placement_bench_run(int iterations);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PLACEMENT_BENCH_H
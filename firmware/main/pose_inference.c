@@ -15,10 +15,50 @@
  * - Reduced model size (knowledge distillation)
  * - INT8 quantization for efficiency
  * - Simplified output (presence + basic pose classes)
- * - PSRAM-based buffering for temporal windows
+ * - Hot/cold placement: the window being scanned lives in internal SRAM,
+ *   completed windows are spilled to a PSRAM history ring
+ * - Per-window classes are smoothed over time with a small HMM before they
+ *   are published (pose_smoother.h)
+ * - A decimated 10 Hz amplitude branch with a 30 s history estimates the
+ *   breathing rate of still occupants (breathing.h)
+ * - The number of people is counted from the variance components of the
+ *   window across subcarriers (occupancy.h)
+ * - With several transmitters, per-link motion energy is looked up in a
+ *   calibration table in flash to localize the motion to a zone
+ *   (zone_locator.h)
+ * - Falls and other sudden motion are detected per sample and reported
+ *   through their own callback without waiting for the window
+ *   (event_detector.h)
+ * - While the scene is static, windows reuse the last computed result
+ *   instead of running the window statistics, classifier and occupancy
+ *   estimate again (window_gate.h)
+ * - Detection thresholds, smoothing, gating and the event threshold can be
+ *   retuned while running; updates apply between windows (pose_set_tuning())
+ * - Each window has a time budget; when the projected cost exceeds it, the
+ *   optional stages are shed in steps until it fits (deadline_sched.h)
+ * - With CONFIG_POSE_FIXED_POINT the window holds int16 samples and its
+ *   statistics and covariance are integer sums (csi_fixed.h)
+ * - An optional sliding-DFT spectrogram of a few subcarriers is updated
+ *   per sample as a model input (spectrogram.h)
+ * - The window buffer is a ring shared by models with their own cadence:
+ *   presence every hop, the full pipeline once per window, on interleaved
+ *   samples (model_sched.h)
  */
 
 #include "pose_inference.h"
+#include "pose_pipeline.h"
+#include "pose_dims.h"
+#include "csi_fixed.h"
+#include "csi_window_kernels.h"
+#include "breathing.h"
+#include "csi_history.h"
+#include "model_sched.h"
+#include "occupancy.h"
+#include "pose_smoother.h"
+#include "result_ring.h"
+#include "spectrogram.h"
+#include "window_gate.h"
+#include "zone_calibration.h"
 #include "esp_log.h"
 #include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
@@ -29,11 +69,109 @@
 
 static const char *TAG = "pose_inference";
 
-// Default configuration
-#define DEFAULT_WINDOW_SIZE_MS 500
-#define DEFAULT_SAMPLING_RATE_HZ 100
-#define DEFAULT_NUM_SUBCARRIERS 52
-#define TEMPORAL_BUFFER_SIZE (DEFAULT_WINDOW_SIZE_MS * DEFAULT_SAMPLING_RATE_HZ / 1000)
+// Window dimensions are fixed at build time (Kconfig, pose_dims.h)
+#define TEMPORAL_BUFFER_SIZE POSE_WINDOW_SAMPLES
+
+// Window sample type (see Kconfig "Fixed-point CSI pipeline")
+#if POSE_FIXED_POINT
+typedef int16_t csi_sample_t;
+#else
+typedef float csi_sample_t;
+#endif
+
+// Per-sample stages sized for fewer subcarriers than a build can select
+POSE_STATIC_ASSERT(POSE_NUM_SUBCARRIERS <= EVENT_MAX_SUBCARRIERS,
+                   "event detector holds fewer subcarriers than POSE_NUM_SUBCARRIERS");
+POSE_STATIC_ASSERT(POSE_NUM_SUBCARRIERS >= WINDOW_SKETCH_BANDS,
+                   "window gate needs a subcarrier per sketch band");
+POSE_STATIC_ASSERT(POSE_NUM_SUBCARRIERS > OCCUPANCY_COMPONENTS &&
+                   POSE_WINDOW_SAMPLES >= OCCUPANCY_COMPONENTS + 2,
+                   "window too small for the occupancy components");
+#define HISTORY_WINDOWS CONFIG_POSE_HISTORY_WINDOWS
+
+// Decimated breathing branch (see Kconfig "Estimate breathing rate")
+#ifdef CONFIG_POSE_BREATHING
+#define BREATHING_SAMPLES (CONFIG_POSE_BREATHING_WINDOW_S * BREATHING_RATE_HZ)
+POSE_STATIC_ASSERT(POSE_SAMPLE_RATE_HZ % BREATHING_RATE_HZ == 0,
+                   "breathing branch decimates by a whole factor");
+#else
+#define BREATHING_SAMPLES 0
+#endif
+// Estimate once 20 s (or the whole window, if shorter) have been collected
+#define BREATHING_MIN_SAMPLES (BREATHING_SAMPLES < 20 * BREATHING_RATE_HZ \
+                               ? BREATHING_SAMPLES : 20 * BREATHING_RATE_HZ)
+
+// Sliding-DFT spectrogram (see Kconfig "Keep a rolling amplitude spectrogram").
+// Each subcarrier is re-anchored every SPECTROGRAM_SUBS * 64 samples
+#define SPECTROGRAM_DFT_LEN 128
+#define SPECTROGRAM_ANCHOR_INTERVAL 64
+#ifdef CONFIG_POSE_SPECTROGRAM
+#define SPECTROGRAM_SUBS CONFIG_POSE_SPECTROGRAM_SUBCARRIERS
+#define SPECTROGRAM_BINS CONFIG_POSE_SPECTROGRAM_BINS
+#define SPECTROGRAM_HOP (CONFIG_POSE_SPECTROGRAM_HOP_MS * POSE_SAMPLE_RATE_HZ / 1000)
+#define SPECTROGRAM_COLUMNS (TEMPORAL_BUFFER_SIZE / SPECTROGRAM_HOP)
+POSE_STATIC_ASSERT(SPECTROGRAM_SUBS <= POSE_NUM_SUBCARRIERS,
+                   "more spectrogram subcarriers than POSE_NUM_SUBCARRIERS");
+POSE_STATIC_ASSERT(SPECTROGRAM_HOP >= 1 && SPECTROGRAM_COLUMNS >= 1,
+                   "spectrogram hop must be a sample to a window long");
+#define SPECTROGRAM_BYTES SPECTROGRAM_STORAGE_BYTES(SPECTROGRAM_DFT_LEN, SPECTROGRAM_BINS, \
+                                                    SPECTROGRAM_SUBS, SPECTROGRAM_COLUMNS)
+#else
+#define SPECTROGRAM_SUBS 1
+#define SPECTROGRAM_BINS 1
+#define SPECTROGRAM_HOP 1
+#define SPECTROGRAM_COLUMNS 1
+#define SPECTROGRAM_BYTES 0
+#endif
+
+// Zone localization (see Kconfig "Localize motion to zones")
+#ifdef CONFIG_POSE_ZONES
+#define ZONES_ENABLED 1
+#define ZONE_K CONFIG_POSE_ZONES_K
+#else
+#define ZONES_ENABLED 0
+#define ZONE_K 1
+#endif
+
+#ifdef CONFIG_POSE_EVENTS
+#define EVENTS_ENABLED 1
+#else
+#define EVENTS_ENABLED 0
+#endif
+
+// Smoothing default; a lag of -1 disables smoothing
+#ifdef CONFIG_POSE_SMOOTHING
+#define SMOOTHING_LAG CONFIG_POSE_SMOOTHING_LAG
+#define SMOOTHING_STAY_PERMILLE CONFIG_POSE_SMOOTHING_STAY_PERMILLE
+#else
+#define SMOOTHING_LAG -1
+#define SMOOTHING_STAY_PERMILLE 900
+#endif
+
+// Change-detection gating default; a refresh of 1 computes every window
+#ifdef CONFIG_POSE_GATING
+#define GATE_REFRESH CONFIG_POSE_GATING_REFRESH
+#else
+#define GATE_REFRESH 1
+#endif
+
+// Time budget of one window (see Kconfig "Inference time budget")
+#define DEADLINE_US (CONFIG_POSE_DEADLINE_MS * 1000)
+
+// Presence hop (see Kconfig "Presence model hop"); 0 runs no presence model
+#define PRESENCE_HOP_SAMPLES (CONFIG_POSE_PRESENCE_HOP_MS * POSE_SAMPLE_RATE_HZ / 1000)
+POSE_STATIC_ASSERT(CONFIG_POSE_PRESENCE_HOP_MS * POSE_SAMPLE_RATE_HZ % 1000 == 0,
+                   "presence hop must hold a whole number of samples");
+POSE_STATIC_ASSERT(CONFIG_POSE_PRESENCE_HOP_MS == 0 ||
+                   (PRESENCE_HOP_SAMPLES >= 1 && PRESENCE_HOP_SAMPLES < TEMPORAL_BUFFER_SIZE),
+                   "presence hop must be shorter than the window");
+
+// Region of the window run_inference() scans (see Kconfig "Temporal CSI buffer placement")
+#ifdef CONFIG_POSE_PLACEMENT_ALL_PSRAM
+#define HOT_REGION MEM_REGION_PSRAM
+#else
+#define HOT_REGION MEM_REGION_INTERNAL
+#endif
 
 // State variables
 static pose_config_t s_config;
@@ -41,171 +179,222 @@ static bool s_initialized = false;
 static SemaphoreHandle_t s_mutex = NULL;
 static pose_callback_t s_user_callback = NULL;
 static void *s_user_ctx = NULL;
-
-// Temporal CSI buffer (stored in PSRAM if available)
-static float *s_amplitude_buffer = NULL;
-static float *s_phase_buffer = NULL;
+static pose_event_callback_t s_event_callback = NULL;
+static void *s_event_ctx = NULL;
+
+// Temporal CSI buffer (carved from the memory arena, see s_memory_budget).
+// A ring: row s_buffer_index is the oldest sample, and is the first row of
+// the window when the pose model runs
+static csi_sample_t *s_amplitude_buffer = NULL;
+static csi_sample_t *s_phase_buffer = NULL;
 static int8_t *s_rssi_buffer = NULL;
 static int s_buffer_index = 0;
-static bool s_buffer_ready = false;
 
-// Latest result
-static pose_result_t s_latest_result;
+// Models run on the ring, each at its own period and phase
+static model_sched_t s_models;
+
+// Presence model output. The CSI task keeps s_presence_state and publishes
+// each update like a result_ring slot (see result_ring.h): the slot is
+// stamped odd while it is written and 2 * updates once done, and readers
+// keep a copy only if the stamp held still. With three slots the newest
+// one is never being rewritten.
+#define PRESENCE_SLOTS 3
+#define PRESENCE_WORDS ((sizeof(pose_presence_t) + 3) / 4)
+
+typedef struct {
+    uint32_t stamp;
+    uint32_t words[PRESENCE_WORDS];
+} presence_slot_t;
+
+static pose_presence_t s_presence_state;
+static presence_slot_t s_presence[PRESENCE_SLOTS];
+static uint32_t s_presence_published = 0;  // updates of the newest slot (0 = none)
+
+// Completed windows (PSRAM), oldest overwritten first
+static void *s_amplitude_history_mem = NULL;
+static void *s_phase_history_mem = NULL;
+static csi_history_t s_amplitude_history;
+static csi_history_t s_phase_history;
+
+// Breathing branch (ring carved from the memory arena)
+static uint16_t *s_breathing_ring = NULL;
+static breathing_estimator_t s_breathing;
+
+// Spectrogram state (history, bins and ring carved from the memory arena)
+static void *s_spectrogram_mem = NULL;
+static spectrogram_t s_spectrogram;
+static bool s_spectrogram_ready = false;
+
+// Occupancy scratch (covariance and subspace, carved from the memory arena)
+static float *s_occupancy_scratch = NULL;
+
+// Zone localization; the table is const and stays in flash
+static const zone_table_t s_zone_table = {
+    .entries = s_zone_calibration,
+    .count = ZONE_CALIBRATION_COUNT,
+    .num_links = ZONE_CALIBRATION_LINKS,
+    .grid_cols = ZONE_CALIBRATION_COLS,
+    .grid_rows = ZONE_CALIBRATION_ROWS,
+};
+static bool s_zone_ready = false;
+static zone_link_energy_t s_zone_energy;
+static uint8_t s_zone_macs[ZONE_MAX_LINKS][6];
+static int s_zone_links = 0;
+static uint8_t s_zone_fingerprint[ZONE_MAX_LINKS];
+
+// Per-sample event detection
+static event_detector_t s_events;
+static bool s_events_ready = false;
+
+// Sketch of the window being filled, and the result static windows reuse
+static window_sketch_t s_sketch;
+static window_gate_t s_gate;
+static pose_result_t s_last_raw;
+
+// Degradation level of each window under the time budget
+static deadline_sched_t s_deadline;
+
+// Temporal smoothing; a new config is handed over under s_mutex
+static pose_smoother_t s_smoother;
+static bool s_smoothing = false;
+static pose_smoother_config_t s_smoother_next;
+static bool s_smoother_next_enabled = false;
+static bool s_smoother_reconfigure = false;
+
+// Tuning in effect, and the update waiting for the next window
+static pose_tuning_t s_tuning;
+static pose_tuning_t s_tuning_next;
+static bool s_tuning_reconfigure = false;
+
+// Published results (lock-free, last RESULT_RING_CAPACITY kept), carved
+// from the memory arena
+static result_ring_t *s_results = NULL;
 
 // Statistics
 static uint32_t s_inferences_count = 0;
 static uint64_t s_total_inference_time_us = 0;
+static pose_histograms_t s_histograms;
+
+#define CSI_BUFFER_BYTES (TEMPORAL_BUFFER_SIZE * POSE_NUM_SUBCARRIERS * sizeof(csi_sample_t))
+
+#define CSI_HISTORY_BYTES (CSI_HISTORY_SLOT_BYTES(CSI_BUFFER_BYTES) * HISTORY_WINDOWS)
 
 /**
- * @brief Allocate buffers in PSRAM or internal RAM
+ * @brief Long-lived buffers of this module
  *
  * PSRAM is slower but abundant (2MB). Internal SRAM is fast but limited (~300KB usable).
- * For CSI temporal windows, we need PSRAM due to size requirements.
+ * Every sample is written to the current window and run_inference() scans all
+ * of it, so the window (~21KB, half that in fixed point) is the hot set and
+ * stays in internal SRAM.
+ * Completed windows are only read back by history consumers and go to PSRAM,
+ * in cache-line aligned slots. The occupancy scratch (~8KB) is rewritten
+ * and scanned repeatedly every window, so it is internal as well, like the
+ * result ring (~5.5KB), which readers on the other core poll.
  */
-static esp_err_t allocate_buffers(void)
-{
-    size_t buffer_size = TEMPORAL_BUFFER_SIZE * DEFAULT_NUM_SUBCARRIERS * sizeof(float);
-
-    ESP_LOGI(TAG, "Allocating CSI buffers: %zu bytes each", buffer_size);
-
-    // Try PSRAM first
-    s_amplitude_buffer = (float *)heap_caps_malloc(buffer_size, MALLOC_CAP_SPIRAM);
-    s_phase_buffer = (float *)heap_caps_malloc(buffer_size, MALLOC_CAP_SPIRAM);
-
-    if (s_amplitude_buffer == NULL || s_phase_buffer == NULL) {
-        ESP_LOGE(TAG, "Failed to allocate PSRAM buffers");
-        // Try internal RAM as fallback (may fail due to size)
-        if (s_amplitude_buffer == NULL) {
-            s_amplitude_buffer = (float *)malloc(buffer_size);
-        }
-        if (s_phase_buffer == NULL) {
-            s_phase_buffer = (float *)malloc(buffer_size);
-        }
-
-        if (s_amplitude_buffer == NULL || s_phase_buffer == NULL) {
-            ESP_LOGE(TAG, "Failed to allocate buffers in internal RAM too");
-            return ESP_ERR_NO_MEM;
-        }
-        ESP_LOGW(TAG, "Using internal RAM (PSRAM not available)");
-    } else {
-        ESP_LOGI(TAG, "Successfully allocated PSRAM buffers");
-    }
-
-    // RSSI buffer (smaller, can fit in internal RAM)
-    size_t rssi_size = TEMPORAL_BUFFER_SIZE * sizeof(int8_t);
-    s_rssi_buffer = (int8_t *)malloc(rssi_size);
-    if (s_rssi_buffer == NULL) {
-        ESP_LOGE(TAG, "Failed to allocate RSSI buffer");
-        return ESP_ERR_NO_MEM;
-    }
-
-    // Initialize buffers to zero
-    memset(s_amplitude_buffer, 0, buffer_size);
-    memset(s_phase_buffer, 0, buffer_size);
-    memset(s_rssi_buffer, 0, rssi_size);
-
-    return ESP_OK;
-}
+static const mem_budget_entry_t s_memory_budget[] = {
+    { "pose.amplitude", CSI_BUFFER_BYTES, CSI_HISTORY_LINE_BYTES, HOT_REGION,
+      (void **)&s_amplitude_buffer },
+    { "pose.phase", CSI_BUFFER_BYTES, CSI_HISTORY_LINE_BYTES, HOT_REGION,
+      (void **)&s_phase_buffer },
+    { "pose.rssi", TEMPORAL_BUFFER_SIZE * sizeof(int8_t), 0, MEM_REGION_INTERNAL,
+      (void **)&s_rssi_buffer },
+    { "pose.amplitude_history", CSI_HISTORY_BYTES, CSI_HISTORY_LINE_BYTES, MEM_REGION_PSRAM,
+      &s_amplitude_history_mem },
+    { "pose.phase_history", CSI_HISTORY_BYTES, CSI_HISTORY_LINE_BYTES, MEM_REGION_PSRAM,
+      &s_phase_history_mem },
+    { "pose.occupancy", OCCUPANCY_SCRATCH_BYTES(POSE_NUM_SUBCARRIERS), 0, MEM_REGION_INTERNAL,
+      (void **)&s_occupancy_scratch },
+    { "pose.results", sizeof(result_ring_t), CSI_HISTORY_LINE_BYTES, MEM_REGION_INTERNAL,
+      (void **)&s_results },
+#ifdef CONFIG_POSE_BREATHING
+    { "pose.breathing", BREATHING_RING_BYTES(BREATHING_SAMPLES), 0, MEM_REGION_INTERNAL,
+      (void **)&s_breathing_ring },
+#endif
+#ifdef CONFIG_POSE_SPECTROGRAM
+    { "pose.spectrogram", SPECTROGRAM_BYTES, 0, MEM_REGION_INTERNAL, &s_spectrogram_mem },
+#endif
+};
 
 /**
- * @brief Calculate mean of an array
+ * @brief Smoother configuration of a tuning
+ *
+ * @return false if the tuning disables smoothing
  */
-static float calculate_mean(const float *data, int len)
+static bool smoothing_config(const pose_tuning_t *tuning, pose_smoother_config_t *config)
 {
-    if (len == 0) return 0.0f;
-    float sum = 0.0f;
-    for (int i = 0; i < len; i++) {
-        sum += data[i];
+    if (tuning->smoothing_lag < 0) {
+        return false;
     }
-    return sum / len;
+    pose_smoother_default_config(config, POSE_SMOOTHER_MAX_CLASSES,
+                                 tuning->smoothing_stay_permille / 1000.0f, tuning->smoothing_lag);
+    return true;
 }
 
 /**
- * @brief Calculate standard deviation of an array
+ * @brief Pass a raw result through the temporal smoother
+ *
+ * @return false while the smoother's lag fills up (nothing to publish yet)
  */
-static float calculate_std(const float *data, int len, float mean)
+static bool smooth_result(pose_result_t *result)
 {
-    if (len == 0) return 0.0f;
-    float sum_sq_diff = 0.0f;
-    for (int i = 0; i < len; i++) {
-        float diff = data[i] - mean;
-        sum_sq_diff += diff * diff;
+    if (!s_smoothing) {
+        return true;
     }
-    return sqrtf(sum_sq_diff / len);
+
+    float probs[POSE_SMOOTHER_MAX_CLASSES];
+    pose_smoother_class_probs(result, s_smoother.config.num_classes, probs);
+    pose_result_t raw = *result;
+    return pose_smoother_update(&s_smoother, probs, &raw, result);
 }
 
 /**
- * @brief Calculate variance of phase array
+ * @brief Switch to the pending tuning and smoothing, if any, between two windows
  *
- * Phase variance is a good indicator of human activity.
- * Static environments have stable phase; humans cause fluctuations.
+ * Both are taken in one critical section, so an update made with
+ * pose_set_tuning() applies to the same window as a whole.
  */
-static float calculate_phase_variance(const float *phase, int len)
+static void apply_tuning(void)
 {
-    if (len < 2) return 0.0f;
-
-    // Calculate differences between consecutive samples
-    float sum_diff_sq = 0.0f;
-    for (int i = 1; i < len; i++) {
-        float diff = phase[i] - phase[i-1];
-        // Wrap phase difference to [-π, π]
-        while (diff > M_PI) diff -= 2 * M_PI;
-        while (diff < -M_PI) diff += 2 * M_PI;
-        sum_diff_sq += diff * diff;
+    if (!__atomic_load_n(&s_tuning_reconfigure, __ATOMIC_ACQUIRE) &&
+        !__atomic_load_n(&s_smoother_reconfigure, __ATOMIC_ACQUIRE)) {
+        return;
+    }
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    if (s_smoother_reconfigure) {
+        s_smoothing = s_smoother_next_enabled &&
+                      pose_smoother_init(&s_smoother, &s_smoother_next) == ESP_OK;
+        __atomic_store_n(&s_smoother_reconfigure, false, __ATOMIC_RELAXED);
+    }
+    bool retune = s_tuning_reconfigure;
+    pose_tuning_t next = s_tuning_next;
+    __atomic_store_n(&s_tuning_reconfigure, false, __ATOMIC_RELAXED);
+    xSemaphoreGive(s_mutex);
+    if (!retune) {
+        return;
     }
 
-    return sum_diff_sq / (len - 1);
+    // The gate restarts, so the next window is computed with the new thresholds
+    if (next.gate_refresh != s_tuning.gate_refresh) {
+        window_gate_config_t gate;
+        window_gate_default_config(&gate, next.gate_refresh);
+        window_gate_init(&s_gate, &gate);
+        window_sketch_reset(&s_sketch);
+    }
+    // The detector runs on this task too (pose_process_csi), so this is safe
+    s_events.config.threshold = next.event_threshold;
+    s_tuning = next;
 }
 
 /**
- * @brief Detect human presence based on CSI statistics
- *
- * This is a simplified detection algorithm based on the paper's insights:
- * - Human presence increases CSI variance
- * - Amplitude_std and phase_variance are key indicators
- * - RSSI changes can also indicate presence
- *
- * TODO: Replace with ML model for better accuracy
+ * @brief Window latency histogram bucket
  */
-static void detect_human_presence(float amp_mean, float amp_std, float phase_var,
-                                  int8_t rssi, pose_result_t *result)
-{
-    // Thresholds (tune these based on empirical data)
-    const float AMP_STD_THRESHOLD_EMPTY = 2.0f;
-    const float AMP_STD_THRESHOLD_PRESENT = 5.0f;
-    const float PHASE_VAR_THRESHOLD_MOVING = 0.5f;
-    const float MOTION_THRESHOLD = 0.3f;
-
-    result->amplitude_mean = amp_mean;
-    result->amplitude_std = amp_std;
-    result->phase_variance = phase_var;
-
-    // Basic presence detection
-    if (amp_std < AMP_STD_THRESHOLD_EMPTY) {
-        result->human_detected = false;
-        result->pose_class = POSE_EMPTY;
-        result->confidence = 0.9f;
-        result->motion_level = 0.0f;
-    } else {
-        result->human_detected = true;
-
-        // Calculate motion level from phase variance
-        result->motion_level = fminf(phase_var / PHASE_VAR_THRESHOLD_MOVING, 1.0f);
-
-        // Classify activity based on motion level and amplitude variance
-        if (result->motion_level < MOTION_THRESHOLD) {
-            result->pose_class = POSE_PRESENT;  // Static human
-            result->confidence = 0.7f;
-        } else {
-            result->pose_class = POSE_MOVING;   // Moving human
-            result->confidence = 0.6f;
-
-            // TODO: More sophisticated classification for walking/sitting/standing
-            // This would require a trained ML model
-        }
+static int latency_bucket(uint64_t us)
+{
+    int b = 0;
+    while (b < POSE_LATENCY_BUCKETS - 1 && us >= (128ULL << b)) {
+        b++;
     }
-
-    result->timestamp = (uint32_t)(esp_timer_get_time() / 1000);
+    return b;
 }
 
 /**
@@ -224,52 +413,76 @@ static void run_inference(void)
 
     pose_result_t result = {0};
 
-    // Aggregate statistics across temporal window
-    float amp_mean = 0.0f;
-    float amp_std = 0.0f;
-    float phase_var = 0.0f;
-    int8_t avg_rssi = 0;
-
-    // Calculate statistics across all subcarriers and time steps
-    int total_samples = TEMPORAL_BUFFER_SIZE * DEFAULT_NUM_SUBCARRIERS;
-
-    // Amplitude statistics
-    float amp_sum = 0.0f;
-    for (int i = 0; i < total_samples; i++) {
-        amp_sum += s_amplitude_buffer[i];
-    }
-    amp_mean = amp_sum / total_samples;
+    apply_tuning();
 
-    float amp_var_sum = 0.0f;
-    for (int i = 0; i < total_samples; i++) {
-        float diff = s_amplitude_buffer[i] - amp_mean;
-        amp_var_sum += diff * diff;
+    // Per-link energies are per window, whether or not the window is computed
+    if (ZONES_ENABLED) {
+        zone_link_energy_read(&s_zone_energy, s_zone_links, s_zone_fingerprint);
     }
-    amp_std = sqrtf(amp_var_sum / total_samples);
 
-    // Phase variance (sum across subcarriers first, then time)
-    float total_phase_var = 0.0f;
-    for (int s = 0; s < DEFAULT_NUM_SUBCARRIERS; s++) {
-        // Extract time series for this subcarrier
-        float subcarrier_phase[TEMPORAL_BUFFER_SIZE];
-        for (int t = 0; t < TEMPORAL_BUFFER_SIZE; t++) {
-            subcarrier_phase[t] = s_phase_buffer[t * DEFAULT_NUM_SUBCARRIERS + s];
+    // Static scene: the last computed result still holds. Reused windows
+    // are not measured, so only computed ones may move the level
+    bool reuse = window_gate_check(&s_gate, &s_sketch);
+    window_sketch_reset(&s_sketch);
+    deadline_level_t level = reuse ? s_deadline.level : deadline_begin(&s_deadline);
+    if (reuse) {
+        result = s_last_raw;
+        result.reused = true;
+    } else {
+        // Aggregate statistics across the temporal window
+        csi_window_stats_t stats;
+#if POSE_FIXED_POINT
+        csi_window_stats_dims_i16(s_amplitude_buffer, s_phase_buffer, s_rssi_buffer, &stats);
+#else
+        csi_window_stats_dims_f32(s_amplitude_buffer, s_phase_buffer, s_rssi_buffer, &stats);
+#endif
+
+        // Run detection
+        pose_detect_presence_tuned(&stats, &s_tuning, &result);
+
+        // People count; a still person counts even without a motion component.
+        // Over budget, from the newest half of the window, then from presence
+        occupancy_estimate_t occupancy = {
+            .count = result.human_detected ? 1 : 0,
+            .confidence = 0.5f,
+        };
+        if (level < DEADLINE_LEVEL_THRESHOLD) {
+            int rows = level >= DEADLINE_LEVEL_HALF_OCCUPANCY ? TEMPORAL_BUFFER_SIZE / 2
+                                                               : TEMPORAL_BUFFER_SIZE;
+            const csi_sample_t *amplitude =
+                &s_amplitude_buffer[(TEMPORAL_BUFFER_SIZE - rows) * POSE_NUM_SUBCARRIERS];
+#if POSE_FIXED_POINT
+            occupancy_estimate_q7(amplitude, rows, POSE_NUM_SUBCARRIERS, result.human_detected,
+                                  s_occupancy_scratch, &occupancy);
+#else
+            occupancy_estimate(amplitude, rows, POSE_NUM_SUBCARRIERS, result.human_detected,
+                               s_occupancy_scratch, &occupancy);
+#endif
         }
-        float sub_mean = calculate_mean(subcarrier_phase, TEMPORAL_BUFFER_SIZE);
-        float sub_var = calculate_std(subcarrier_phase, TEMPORAL_BUFFER_SIZE, sub_mean);
-        total_phase_var += sub_var * sub_var;
+        result.occupancy = occupancy.count;
+        result.occupancy_confidence = occupancy.confidence;
+
+        // Zone of the motion, from this window's per-link energies
+        result.zone = -1;
+        if (s_zone_ready && result.human_detected && level < DEADLINE_LEVEL_NO_SPECTRAL) {
+            zone_estimate_t zone;
+            zone_locate(&s_zone_table, s_zone_fingerprint, ZONE_K, &zone);
+            result.zone = zone.zone;
+            for (int z = 0; z < ZONE_MAX_ZONES; z++) {
+                result.zone_prob[z] = (uint8_t)(zone.prob[z] * 255.0f + 0.5f);
+            }
+        }
+        s_last_raw = result;
     }
-    phase_var = sqrtf(total_phase_var / DEFAULT_NUM_SUBCARRIERS);
 
-    // Average RSSI
-    int rssi_sum = 0;
-    for (int i = 0; i < TEMPORAL_BUFFER_SIZE; i++) {
-        rssi_sum += s_rssi_buffer[i];
+    // Breathing is only meaningful with someone in the room
+    breathing_estimate_t breathing;
+    if (BREATHING_SAMPLES > 0 && result.human_detected && level < DEADLINE_LEVEL_NO_SPECTRAL &&
+        breathing_estimate(&s_breathing, BREATHING_MIN_SAMPLES, &breathing)) {
+        result.breathing_rate_bpm = breathing.rate_bpm;
+        result.breathing_quality = breathing.quality;
     }
-    avg_rssi = rssi_sum / TEMPORAL_BUFFER_SIZE;
-
-    // Run detection
-    detect_human_presence(amp_mean, amp_std, phase_var, avg_rssi, &result);
+    result.timestamp = (uint32_t)(esp_timer_get_time() / 1000);
 
     // Calculate inference time
     uint64_t end_time = esp_timer_get_time();
@@ -278,24 +491,43 @@ static void run_inference(void)
     // Update statistics
     s_inferences_count++;
     s_total_inference_time_us += (end_time - start_time);
+    s_histograms.windows++;
+    s_histograms.reused += reuse ? 1 : 0;
+    s_histograms.latency[latency_bucket(end_time - start_time)]++;
+
+    // Reused windows ran none of the stages, so they say nothing about cost
+    if (!reuse) {
+        deadline_end(&s_deadline, level, (uint32_t)(end_time - start_time));
+        s_histograms.deadline_misses = s_deadline.misses;
+        s_histograms.degrade_level = (uint8_t)s_deadline.level;
+        memcpy(s_histograms.level_windows, s_deadline.level_windows,
+               sizeof(s_histograms.level_windows));
+    }
 
-    // Store result (thread-safe)
-    if (xSemaphoreTake(s_mutex, pdMS_TO_TICKS(10)) == pdTRUE) {
-        memcpy(&s_latest_result, &result, sizeof(pose_result_t));
-        xSemaphoreGive(s_mutex);
+    // Smoothing reports the window CONFIG_POSE_SMOOTHING_LAG windows back
+    if (!smooth_result(&result)) {
+        return;
     }
 
+    // Publish result (lock-free, never blocks inference)
+    result.sequence = result_ring_publish(s_results, &result);
+    s_histograms.classes[result.pose_class < POSE_CLASS_BINS - 1 ? result.pose_class
+                                                                 : POSE_CLASS_BINS - 1]++;
+
     // Log inference results
-    ESP_LOGI(TAG, "Inference #%lu: detected=%s, pose=%d, confidence=%.2f, "
-                  "amp_std=%.2f, phase_var=%.4f, motion=%.2f, latency=%lums",
+    ESP_LOGI(TAG, "Inference #%lu: detected=%s, pose=%d, confidence=%.2f, people=%d, "
+                  "amp_std=%.2f, phase_var=%.4f, motion=%.2f, latency=%lums%s%s",
              s_inferences_count,
              result.human_detected ? "yes" : "no",
              result.pose_class,
              result.confidence,
-             amp_std,
-             phase_var,
+             result.occupancy,
+             result.amplitude_std,
+             result.phase_variance,
              result.motion_level,
-             result.inference_time_ms);
+             result.inference_time_ms,
+             result.reused ? " (reused)" : "",
+             level > DEADLINE_LEVEL_FULL && !result.reused ? " (degraded)" : "");
 
     // Call user callback if registered
     if (s_user_callback != NULL) {
@@ -303,6 +535,85 @@ static void run_inference(void)
     }
 }
 
+/**
+ * @brief Spill the completed window to the PSRAM history ring
+ *
+ * Runs after inference so the copy does not add to result latency.
+ */
+static void spill_window(void)
+{
+    if (xSemaphoreTake(s_mutex, pdMS_TO_TICKS(10)) != pdTRUE) {
+        ESP_LOGW(TAG, "History busy, window not saved");
+        return;
+    }
+    csi_history_push(&s_amplitude_history, s_amplitude_buffer);
+    csi_history_push(&s_phase_history, s_phase_buffer);
+    xSemaphoreGive(s_mutex);
+}
+
+/**
+ * @brief Pose model: the full pipeline, once per window
+ *
+ * Runs when the ring has just wrapped, so it holds the window in order.
+ */
+static void run_pose_model(void *ctx)
+{
+    (void)ctx;
+    run_inference();
+    spill_window();
+}
+
+/**
+ * @brief Publish a presence update (CSI task only)
+ */
+static void publish_presence(const pose_presence_t *presence)
+{
+    uint32_t seq = presence->updates;
+    presence_slot_t *slot = &s_presence[seq % PRESENCE_SLOTS];
+    uint32_t words[PRESENCE_WORDS] = {0};
+    memcpy(words, presence, sizeof(*presence));
+
+    // Odd stamp: readers that race with the copy below discard what they read
+    __atomic_store_n(&slot->stamp, seq * 2 - 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    for (size_t i = 0; i < PRESENCE_WORDS; i++) {
+        __atomic_store_n(&slot->words[i], words[i], __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&slot->stamp, seq * 2, __ATOMIC_RELEASE);
+    __atomic_store_n(&s_presence_published, seq, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Presence model: the threshold detector on the last window, every hop
+ *
+ * The window statistics are sums over the samples, so the ring can be read
+ * as it stands, the oldest rows in the middle.
+ */
+static void run_presence_model(void *ctx)
+{
+    (void)ctx;
+    csi_window_stats_t stats;
+#if POSE_FIXED_POINT
+    csi_window_stats_dims_i16(s_amplitude_buffer, s_phase_buffer, s_rssi_buffer, &stats);
+#else
+    csi_window_stats_dims_f32(s_amplitude_buffer, s_phase_buffer, s_rssi_buffer, &stats);
+#endif
+    pose_result_t result = {0};
+    pose_detect_presence_tuned(&stats, &s_tuning, &result);
+
+    bool changed = result.human_detected != s_presence_state.human_detected;
+    s_presence_state.human_detected = result.human_detected;
+    s_presence_state.confidence = result.confidence;
+    s_presence_state.motion_level = result.motion_level;
+    s_presence_state.timestamp = (uint32_t)(esp_timer_get_time() / 1000);
+    s_presence_state.updates++;
+    publish_presence(&s_presence_state);
+    if (changed) {
+        ESP_LOGI(TAG, "Presence: %s (confidence %.2f)",
+                 result.human_detected ? "yes" : "no", result.confidence);
+    }
+}
+
 esp_err_t pose_init(const pose_config_t *config)
 {
     if (s_initialized) {
@@ -314,17 +625,107 @@ esp_err_t pose_init(const pose_config_t *config)
 
     // Load configuration or use defaults
     if (config != NULL) {
+        // Buffers and loops are sized at build time; the config has to agree
+        if (config->window_size_ms != POSE_WINDOW_MS ||
+            config->sampling_rate_hz != POSE_SAMPLE_RATE_HZ ||
+            config->num_subcarriers != POSE_NUM_SUBCARRIERS) {
+            ESP_LOGE(TAG, "Config %dms/%dHz/%d subcarriers, built for %dms/%dHz/%d",
+                     config->window_size_ms, config->sampling_rate_hz, config->num_subcarriers,
+                     POSE_WINDOW_MS, POSE_SAMPLE_RATE_HZ, POSE_NUM_SUBCARRIERS);
+            return ESP_ERR_INVALID_ARG;
+        }
         memcpy(&s_config, config, sizeof(pose_config_t));
     } else {
-        s_config.window_size_ms = DEFAULT_WINDOW_SIZE_MS;
-        s_config.sampling_rate_hz = DEFAULT_SAMPLING_RATE_HZ;
-        s_config.num_subcarriers = DEFAULT_NUM_SUBCARRIERS;
+        s_config.window_size_ms = POSE_WINDOW_MS;
+        s_config.sampling_rate_hz = POSE_SAMPLE_RATE_HZ;
+        s_config.num_subcarriers = POSE_NUM_SUBCARRIERS;
         s_config.use_amplitude = true;
         s_config.use_phase = true;
         s_config.enable_presence_detection = true;
         s_config.enable_pose_classification = false;  // Disable for now
     }
 
+    // CSI buffers come from the memory arena (see pose_get_memory_budget)
+    if (s_amplitude_buffer == NULL || s_phase_buffer == NULL || s_rssi_buffer == NULL ||
+        s_occupancy_scratch == NULL || s_results == NULL ||
+        (HISTORY_WINDOWS > 0 && (s_amplitude_history_mem == NULL || s_phase_history_mem == NULL)) ||
+        (BREATHING_SAMPLES > 0 && s_breathing_ring == NULL) ||
+        (SPECTROGRAM_BYTES > 0 && s_spectrogram_mem == NULL)) {
+        ESP_LOGE(TAG, "CSI buffers missing: add pose_get_memory_budget() to mem_arena_init()");
+        return ESP_ERR_INVALID_STATE;
+    }
+    memset(s_amplitude_buffer, 0, CSI_BUFFER_BYTES);
+    memset(s_phase_buffer, 0, CSI_BUFFER_BYTES);
+    memset(s_rssi_buffer, 0, TEMPORAL_BUFFER_SIZE * sizeof(int8_t));
+    s_buffer_index = 0;
+    memset(&s_presence_state, 0, sizeof(s_presence_state));
+    memset(s_presence, 0, sizeof(s_presence));
+    s_presence_published = 0;
+    result_ring_init(s_results);
+    csi_history_init(&s_amplitude_history, s_amplitude_history_mem, CSI_BUFFER_BYTES,
+                     HISTORY_WINDOWS);
+    csi_history_init(&s_phase_history, s_phase_history_mem, CSI_BUFFER_BYTES, HISTORY_WINDOWS);
+    breathing_init(&s_breathing, s_breathing_ring, BREATHING_SAMPLES, s_config.sampling_rate_hz,
+                   s_config.sampling_rate_hz / BREATHING_RATE_HZ);
+
+    spectrogram_config_t spectrogram = {
+        .dft_len = SPECTROGRAM_DFT_LEN,
+        .first_bin = 1,
+        .num_bins = SPECTROGRAM_BINS,
+        .num_subcarriers = SPECTROGRAM_SUBS,
+        .hop = SPECTROGRAM_HOP,
+        .columns = SPECTROGRAM_COLUMNS,
+        .anchor_interval = SPECTROGRAM_ANCHOR_INTERVAL,
+        .hann = true,
+    };
+    s_spectrogram_ready = SPECTROGRAM_BYTES > 0 &&
+                          spectrogram_init(&s_spectrogram, &spectrogram, s_spectrogram_mem);
+
+    // Links of the calibration table; an empty table learns them as they appear
+    zone_link_energy_reset(&s_zone_energy);
+    memcpy(s_zone_macs, s_zone_calibration_macs, sizeof(s_zone_macs));
+    s_zone_links = ZONE_CALIBRATION_LINKS;
+    s_zone_ready = ZONES_ENABLED && ZONE_CALIBRATION_COUNT > 0 && zone_table_valid(&s_zone_table);
+    if (ZONES_ENABLED && ZONE_CALIBRATION_COUNT > 0 && !s_zone_ready) {
+        ESP_LOGE(TAG, "Zone calibration table is invalid, regenerate zone_calibration.h");
+    }
+
+    event_detector_config_t events;
+    event_detector_default_config(&events, s_config.sampling_rate_hz);
+    s_events_ready = EVENTS_ENABLED && event_detector_init(&s_events, &events) == ESP_OK;
+
+    // Kconfig defaults; pose_set_tuning() changes them while running
+    s_tuning = (pose_tuning_t){
+        .empty_amp_std = POSE_DEFAULT_EMPTY_AMP_STD,
+        .moving_phase_var = POSE_DEFAULT_MOVING_PHASE_VAR,
+        .moving_level = POSE_DEFAULT_MOVING_LEVEL,
+        .smoothing_lag = SMOOTHING_LAG,
+        .smoothing_stay_permille = SMOOTHING_STAY_PERMILLE,
+        .gate_refresh = GATE_REFRESH,
+        .event_threshold = events.threshold,
+    };
+    s_tuning_next = s_tuning;
+    s_tuning_reconfigure = false;
+    memset(&s_histograms, 0, sizeof(s_histograms));
+
+    window_gate_config_t gate;
+    window_gate_default_config(&gate, s_tuning.gate_refresh);
+    window_gate_init(&s_gate, &gate);
+    window_sketch_reset(&s_sketch);
+
+    deadline_config_t deadline;
+    deadline_default_config(&deadline, DEADLINE_US);
+    deadline_init(&s_deadline, &deadline);
+
+    // Nothing runs before the first window is full; the pose model keeps its
+    // place at the wrap, the presence model takes the samples furthest from it
+    model_sched_init(&s_models, TEMPORAL_BUFFER_SIZE, esp_timer_get_time);
+    model_sched_add(&s_models, "pose", TEMPORAL_BUFFER_SIZE, 0, run_pose_model, NULL);
+    if (PRESENCE_HOP_SAMPLES > 0) {
+        model_sched_add(&s_models, "presence", PRESENCE_HOP_SAMPLES, MODEL_SCHED_AUTO_PHASE,
+                        run_presence_model, NULL);
+    }
+
     // Create mutex
     s_mutex = xSemaphoreCreateMutex();
     if (s_mutex == NULL) {
@@ -332,14 +733,10 @@ esp_err_t pose_init(const pose_config_t *config)
         return ESP_ERR_NO_MEM;
     }
 
-    // Allocate CSI buffers
-    esp_err_t ret = allocate_buffers();
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to allocate buffers");
-        vSemaphoreDelete(s_mutex);
-        s_mutex = NULL;
-        return ret;
-    }
+    pose_smoother_config_t smoothing;
+    s_smoothing = smoothing_config(&s_tuning, &smoothing) &&
+                  pose_smoother_init(&s_smoother, &smoothing) == ESP_OK;
+    s_smoother_reconfigure = false;
 
     // TODO: Load ML model from flash
     // TODO: Initialize TensorFlow Lite Micro interpreter
@@ -348,6 +745,36 @@ esp_err_t pose_init(const pose_config_t *config)
     ESP_LOGI(TAG, "Pose estimation initialized successfully");
     ESP_LOGI(TAG, "Config: window=%dms, rate=%dHz, subcarriers=%d",
              s_config.window_size_ms, s_config.sampling_rate_hz, s_config.num_subcarriers);
+    if (s_smoothing) {
+        ESP_LOGI(TAG, "Smoothing: HMM, lag %d windows (+%dms latency)", s_smoother.config.lag,
+                 s_smoother.config.lag * s_config.window_size_ms);
+    }
+    if (s_zone_ready) {
+        ESP_LOGI(TAG, "Zones: %dx%d grid, %d links, %d calibration entries, k=%d",
+                 s_zone_table.grid_cols, s_zone_table.grid_rows, s_zone_table.num_links,
+                 s_zone_table.count, ZONE_K);
+    } else if (ZONES_ENABLED) {
+        ESP_LOGI(TAG, "Zones: no calibration table, printing fingerprints");
+    }
+    if (s_tuning.gate_refresh > 1) {
+        ESP_LOGI(TAG, "Gating: static windows reuse the last result, refresh every %dms",
+                 s_tuning.gate_refresh * s_config.window_size_ms);
+    }
+    if (s_events_ready) {
+        ESP_LOGI(TAG, "Events: per-sample CUSUM, falls confirmed after %dms",
+                 (events.settle_samples + events.still_samples) * 1000 / s_config.sampling_rate_hz);
+    }
+    if (s_spectrogram_ready) {
+        ESP_LOGI(TAG, "Spectrogram: %d subcarriers x %d bins (%.1f-%.1f Hz), %d columns",
+                 SPECTROGRAM_SUBS, SPECTROGRAM_BINS,
+                 (float)s_config.sampling_rate_hz / SPECTROGRAM_DFT_LEN,
+                 (float)SPECTROGRAM_BINS * s_config.sampling_rate_hz / SPECTROGRAM_DFT_LEN,
+                 SPECTROGRAM_COLUMNS);
+    }
+    if (PRESENCE_HOP_SAMPLES > 0) {
+        ESP_LOGI(TAG, "Presence: every %dms, %lu samples after the window",
+                 CONFIG_POSE_PRESENCE_HOP_MS, (unsigned long)s_models.tasks[1].phase);
+    }
 
     return ESP_OK;
 }
@@ -360,19 +787,7 @@ esp_err_t pose_deinit(void)
 
     ESP_LOGI(TAG, "Deinitializing pose estimation...");
 
-    // Free buffers
-    if (s_amplitude_buffer != NULL) {
-        heap_caps_free(s_amplitude_buffer);
-        s_amplitude_buffer = NULL;
-    }
-    if (s_phase_buffer != NULL) {
-        heap_caps_free(s_phase_buffer);
-        s_phase_buffer = NULL;
-    }
-    if (s_rssi_buffer != NULL) {
-        free(s_rssi_buffer);
-        s_rssi_buffer = NULL;
-    }
+    // CSI buffers belong to the memory arena and stay allocated
 
     // Clean up mutex
     if (s_mutex != NULL) {
@@ -383,10 +798,21 @@ esp_err_t pose_deinit(void)
     s_initialized = false;
     s_user_callback = NULL;
     s_user_ctx = NULL;
+    s_event_callback = NULL;
+    s_event_ctx = NULL;
 
     return ESP_OK;
 }
 
+mem_budget_t pose_get_memory_budget(void)
+{
+    mem_budget_t budget = {
+        .entries = s_memory_budget,
+        .count = sizeof(s_memory_budget) / sizeof(s_memory_budget[0]),
+    };
+    return budget;
+}
+
 esp_err_t pose_register_callback(pose_callback_t callback, void *user_ctx)
 {
     s_user_callback = callback;
@@ -395,6 +821,69 @@ esp_err_t pose_register_callback(pose_callback_t callback, void *user_ctx)
     return ESP_OK;
 }
 
+esp_err_t pose_register_event_callback(pose_event_callback_t callback, void *user_ctx)
+{
+    s_event_callback = callback;
+    s_event_ctx = user_ctx;
+    return ESP_OK;
+}
+
+/**
+ * @brief Buffer one sample and run the models due on it
+ *
+ * @param amplitude_f Amplitude as float, for the per-sample stages (events,
+ *                    breathing, gate sketch); the same array as amplitude
+ *                    in the float build
+ */
+static void buffer_sample(const csi_sample_t *amplitude, const csi_sample_t *phase,
+                          const float *amplitude_f, int num_subcarriers, int8_t rssi)
+{
+    // Subcarriers past the window width are dropped for every stage
+    const int subs = num_subcarriers < POSE_NUM_SUBCARRIERS ? num_subcarriers
+                                                            : POSE_NUM_SUBCARRIERS;
+
+    // Events go out on the sample that fires them, ahead of the window
+    motion_event_t event;
+    if (s_events_ready && event_detector_push(&s_events, amplitude_f, subs, &event)) {
+        event.timestamp = (uint32_t)(esp_timer_get_time() / 1000);
+        s_histograms.events++;
+        if (s_event_callback != NULL) {
+            s_event_callback(&event, s_event_ctx);
+        }
+        ESP_LOGI(TAG, "Event #%lu: %s (score %.1f, rise %.1fdB)", event.id,
+                 event.type == MOTION_EVENT_FALL ? "fall" : "sudden motion", event.score,
+                 event.rise_db);
+    }
+
+    // Store CSI data in temporal buffer
+    int row = s_buffer_index * POSE_NUM_SUBCARRIERS;
+    memcpy(&s_amplitude_buffer[row], amplitude, subs * sizeof(csi_sample_t));
+    memcpy(&s_phase_buffer[row], phase, subs * sizeof(csi_sample_t));
+
+    s_rssi_buffer[s_buffer_index] = rssi;
+    s_buffer_index++;
+
+    if (BREATHING_SAMPLES > 0) {
+        breathing_push(&s_breathing, breathing_sample_mean(amplitude_f, subs));
+    }
+    if (s_spectrogram_ready) {
+        spectrogram_push(&s_spectrogram, amplitude_f, subs);
+    }
+    if (s_tuning.gate_refresh > 1) {
+        window_sketch_push(&s_sketch, amplitude_f, subs);
+    }
+
+    if (s_buffer_index >= TEMPORAL_BUFFER_SIZE) {
+        s_buffer_index = 0;
+    }
+
+    // The pose model on the wrap, the presence model every hop
+    model_sched_tick(&s_models);
+}
+
+// CSI records (wifi_csi.h) carry at most 64 subcarriers
+#define MAX_SAMPLE_SUBCARRIERS 64
+
 esp_err_t pose_process_csi(const float *amplitude, const float *phase,
                            int num_subcarriers, int8_t rssi)
 {
@@ -406,29 +895,167 @@ esp_err_t pose_process_csi(const float *amplitude, const float *phase,
         return ESP_ERR_INVALID_ARG;
     }
 
-    // Store CSI data in temporal buffer
-    int subs = fmin(num_subcarriers, s_config.num_subcarriers);
+#if POSE_FIXED_POINT
+    int16_t amplitude_q[POSE_NUM_SUBCARRIERS];
+    int16_t phase_q[POSE_NUM_SUBCARRIERS];
+    int subs = num_subcarriers < POSE_NUM_SUBCARRIERS ? num_subcarriers : POSE_NUM_SUBCARRIERS;
+    csi_fixed_from_float(amplitude, phase, subs, amplitude_q, phase_q);
+    buffer_sample(amplitude_q, phase_q, amplitude, num_subcarriers, rssi);
+#else
+    buffer_sample(amplitude, phase, amplitude, num_subcarriers, rssi);
+#endif
+
+    return ESP_OK;
+}
 
-    for (int i = 0; i < subs; i++) {
-        int idx = s_buffer_index * s_config.num_subcarriers + i;
-        s_amplitude_buffer[idx] = amplitude[i];
-        s_phase_buffer[idx] = phase[i];
+esp_err_t pose_process_csi_q(const int16_t *amplitude, const int16_t *phase,
+                             int num_subcarriers, int8_t rssi)
+{
+    if (!s_initialized) {
+        return ESP_ERR_INVALID_STATE;
     }
 
-    s_rssi_buffer[s_buffer_index] = rssi;
-    s_buffer_index++;
+    if (amplitude == NULL || phase == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
 
-    // Check if buffer is full
-    if (s_buffer_index >= TEMPORAL_BUFFER_SIZE) {
-        s_buffer_index = 0;
-        s_buffer_ready = true;
+    int subs = num_subcarriers < MAX_SAMPLE_SUBCARRIERS ? num_subcarriers : MAX_SAMPLE_SUBCARRIERS;
+    float amplitude_f[MAX_SAMPLE_SUBCARRIERS];
+#if POSE_FIXED_POINT
+    csi_fixed_to_float(amplitude, NULL, subs, amplitude_f, NULL);
+    buffer_sample(amplitude, phase, amplitude_f, subs, rssi);
+#else
+    float phase_f[MAX_SAMPLE_SUBCARRIERS];
+    csi_fixed_to_float(amplitude, phase, subs, amplitude_f, phase_f);
+    buffer_sample(amplitude_f, phase_f, amplitude_f, subs, rssi);
+#endif
+
+    return ESP_OK;
+}
+
+/**
+ * @brief Link index of a transmitter, or -1 if it is not tracked
+ */
+static int zone_link_index(const uint8_t *mac)
+{
+    for (int l = 0; l < s_zone_links; l++) {
+        if (memcmp(s_zone_macs[l], mac, 6) == 0) {
+            return l;
+        }
+    }
+    // A calibrated table fixes the links; otherwise learn them
+    if (ZONE_CALIBRATION_COUNT == 0 && s_zone_links < ZONE_MAX_LINKS) {
+        memcpy(s_zone_macs[s_zone_links], mac, 6);
+        return s_zone_links++;
+    }
+    return -1;
+}
+
+esp_err_t pose_process_link(const uint8_t *mac, const float *amplitude, int num_subcarriers)
+{
+    if (!s_initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (mac == NULL || amplitude == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!ZONES_ENABLED) {
+        return ESP_OK;
+    }
+
+    int link = zone_link_index(mac);
+    if (link >= 0) {
+        zone_link_energy_push(&s_zone_energy, link, amplitude, num_subcarriers);
+    }
+    return ESP_OK;
+}
+
+esp_err_t pose_get_zone_fingerprint(uint8_t *energy, uint8_t (*macs)[6], int *num_links)
+{
+    if (!ZONES_ENABLED) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    if (energy == NULL || macs == NULL || num_links == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memcpy(energy, s_zone_fingerprint, sizeof(s_zone_fingerprint));
+    memcpy(macs, s_zone_macs, sizeof(s_zone_macs));
+    *num_links = s_zone_links;
+    return ESP_OK;
+}
+
+/**
+ * @brief Queue a smoother configuration for the next window (mutex held)
+ */
+static void stage_smoothing(const pose_smoother_config_t *config)
+{
+    if (config != NULL) {
+        memcpy(&s_smoother_next, config, sizeof(pose_smoother_config_t));
+    }
+    s_smoother_next_enabled = config != NULL;
+    __atomic_store_n(&s_smoother_reconfigure, true, __ATOMIC_RELEASE);
+}
+
+esp_err_t pose_set_smoothing(const pose_smoother_config_t *config)
+{
+    if (!s_initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (config != NULL && !pose_smoother_config_valid(config)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    stage_smoothing(config);
+    s_tuning_next.smoothing_lag = config != NULL ? config->lag : -1;
+    xSemaphoreGive(s_mutex);
+
+    if (config != NULL) {
+        ESP_LOGI(TAG, "Smoothing: %d classes, lag %d windows", config->num_classes, config->lag);
+    } else {
+        ESP_LOGI(TAG, "Smoothing disabled");
+    }
+    return ESP_OK;
+}
+
+esp_err_t pose_set_tuning(const pose_tuning_t *tuning)
+{
+    if (!s_initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    pose_smoother_config_t smoothing;
+    bool smoothing_on = tuning != NULL && smoothing_config(tuning, &smoothing);
+    if (tuning == NULL || !(tuning->empty_amp_std > 0.0f) || !(tuning->moving_phase_var > 0.0f) ||
+        !(tuning->moving_level >= 0.0f && tuning->moving_level <= 1.0f) ||
+        tuning->smoothing_lag > POSE_SMOOTHER_MAX_LAG ||
+        (smoothing_on && !pose_smoother_config_valid(&smoothing)) ||
+        tuning->gate_refresh < 1 || !(tuning->event_threshold > 0.0f)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    if (tuning->smoothing_lag != s_tuning_next.smoothing_lag ||
+        tuning->smoothing_stay_permille != s_tuning_next.smoothing_stay_permille) {
+        stage_smoothing(smoothing_on ? &smoothing : NULL);
     }
+    s_tuning_next = *tuning;
+    __atomic_store_n(&s_tuning_reconfigure, true, __ATOMIC_RELEASE);
+    xSemaphoreGive(s_mutex);
+    return ESP_OK;
+}
 
-    // Run inference when buffer is ready
-    if (s_buffer_ready && s_buffer_index == 0) {
-        run_inference();
+esp_err_t pose_get_tuning(pose_tuning_t *tuning)
+{
+    if (!s_initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (tuning == NULL) {
+        return ESP_ERR_INVALID_ARG;
     }
 
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    *tuning = s_tuning_next;
+    xSemaphoreGive(s_mutex);
     return ESP_OK;
 }
 
@@ -438,17 +1065,55 @@ esp_err_t pose_get_latest_result(pose_result_t *result)
         return ESP_ERR_INVALID_ARG;
     }
 
-    if (s_inferences_count == 0) {
+    // The arena zeroes the ring, so it reads as empty until pose_init()
+    if (s_results == NULL) {
         return ESP_ERR_NOT_FOUND;
     }
+    return result_ring_latest(s_results, result) ? ESP_OK : ESP_ERR_NOT_FOUND;
+}
 
-    if (xSemaphoreTake(s_mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-        memcpy(result, &s_latest_result, sizeof(pose_result_t));
-        xSemaphoreGive(s_mutex);
-        return ESP_OK;
+esp_err_t pose_get_results_since(uint32_t since_seq, pose_result_t *results, int max_results,
+                                 int *num_results, uint32_t *lost)
+{
+    if (results == NULL || num_results == NULL || lost == NULL || max_results <= 0) {
+        return ESP_ERR_INVALID_ARG;
     }
 
-    return ESP_ERR_TIMEOUT;
+    if (s_results == NULL) {
+        *num_results = 0;
+        *lost = 0;
+        return ESP_ERR_NOT_FOUND;
+    }
+    *num_results = result_ring_read_since(s_results, since_seq, results, max_results, lost);
+    return *num_results > 0 ? ESP_OK : ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t pose_read_history(int num_windows, float *amplitude, float *phase, int *windows_read)
+{
+    if (!s_initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (amplitude == NULL || phase == NULL || windows_read == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (xSemaphoreTake(s_mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+        return ESP_ERR_TIMEOUT;
+    }
+    *windows_read = csi_history_read(&s_amplitude_history, num_windows, amplitude);
+    csi_history_read(&s_phase_history, num_windows, phase);
+    xSemaphoreGive(s_mutex);
+
+#if POSE_FIXED_POINT
+    // Widen in place, from the end so no sample is overwritten before it is read
+    for (int i = *windows_read * TEMPORAL_BUFFER_SIZE * POSE_NUM_SUBCARRIERS - 1; i >= 0; i--) {
+        int16_t amplitude_q = ((const int16_t *)amplitude)[i];
+        int16_t phase_q = ((const int16_t *)phase)[i];
+        csi_fixed_to_float(&amplitude_q, &phase_q, 1, &amplitude[i], &phase[i]);
+    }
+#endif
+
+    return *windows_read > 0 ? ESP_OK : ESP_ERR_NOT_FOUND;
 }
 
 bool pose_is_active(void)
@@ -469,3 +1134,68 @@ void pose_get_stats(uint32_t *num_inferences, float *avg_latency_ms)
         }
     }
 }
+
+void pose_get_histograms(pose_histograms_t *histograms)
+{
+    if (histograms != NULL) {
+        memcpy(histograms, &s_histograms, sizeof(*histograms));
+    }
+}
+
+esp_err_t pose_read_spectrogram(float *spectrogram, int *columns, int *subcarriers, int *bins)
+{
+    if (!s_spectrogram_ready) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    if (spectrogram == NULL || columns == NULL || subcarriers == NULL || bins == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *columns = spectrogram_read(&s_spectrogram, spectrogram);
+    *subcarriers = SPECTROGRAM_SUBS;
+    *bins = SPECTROGRAM_BINS;
+    return *columns > 0 ? ESP_OK : ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t pose_get_presence(pose_presence_t *presence)
+{
+    if (presence == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (PRESENCE_HOP_SAMPLES == 0) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    // Only fails if the CSI task laps all the slots during one copy
+    for (int attempt = 0; attempt < PRESENCE_SLOTS; attempt++) {
+        uint32_t seq = __atomic_load_n(&s_presence_published, __ATOMIC_ACQUIRE);
+        if (seq == 0) {
+            memset(presence, 0, sizeof(*presence));
+            return ESP_ERR_NOT_FOUND;
+        }
+        const presence_slot_t *slot = &s_presence[seq % PRESENCE_SLOTS];
+        uint32_t words[PRESENCE_WORDS];
+        if (__atomic_load_n(&slot->stamp, __ATOMIC_ACQUIRE) != seq * 2) {
+            continue;
+        }
+        for (size_t i = 0; i < PRESENCE_WORDS; i++) {
+            words[i] = __atomic_load_n(&slot->words[i], __ATOMIC_RELAXED);
+        }
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&slot->stamp, __ATOMIC_RELAXED) == seq * 2) {
+            memcpy(presence, words, sizeof(*presence));
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_TIMEOUT;
+}
+
+int pose_get_model_stats(model_sched_stats_t *stats, int max_models)
+{
+    if (stats == NULL || !s_initialized) {
+        return 0;
+    }
+    int count = s_models.count < max_models ? s_models.count : max_models;
+    for (int i = 0; i < count; i++) {
+        model_sched_get_stats(&s_models, i, POSE_SAMPLE_RATE_HZ, &stats[i]);
+    }
+    return count;
+}
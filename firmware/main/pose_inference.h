@@ -19,6 +19,8 @@
  * -----------------
  * - Internal SRAM: 512KB (use for model weights and active buffers)
  * - PSRAM: 2MB (use for CSI history and temporary tensors)
+ * The window being filled and scanned is the hot set and is placed in
+ * internal SRAM; completed windows are spilled to a PSRAM history ring.
  * - Flash: 4MB (store model weights)
  */
 
@@ -26,6 +28,11 @@
 #define POSE_INFERENCE_H
 
 #include "esp_err.h"
+#include "deadline_sched.h"
+#include "event_detector.h"
+#include "mem_arena.h"
+#include "model_sched.h"
+#include "zone_locator.h"
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -59,6 +66,45 @@ typedef enum {
     POSE_UNKNOWN = 255     // Unable to classify
 } pose_class_t;
 
+// Keypoints of the optional regression head (COCO order)
+#define POSE_NUM_KEYPOINTS 17
+
+/**
+ * @brief Skeleton keypoints (COCO order)
+ */
+typedef enum {
+    POSE_KP_NOSE = 0,
+    POSE_KP_LEFT_EYE,
+    POSE_KP_RIGHT_EYE,
+    POSE_KP_LEFT_EAR,
+    POSE_KP_RIGHT_EAR,
+    POSE_KP_LEFT_SHOULDER,
+    POSE_KP_RIGHT_SHOULDER,
+    POSE_KP_LEFT_ELBOW,
+    POSE_KP_RIGHT_ELBOW,
+    POSE_KP_LEFT_WRIST,
+    POSE_KP_RIGHT_WRIST,
+    POSE_KP_LEFT_HIP,
+    POSE_KP_RIGHT_HIP,
+    POSE_KP_LEFT_KNEE,
+    POSE_KP_RIGHT_KNEE,
+    POSE_KP_LEFT_ANKLE,
+    POSE_KP_RIGHT_ANKLE,
+} pose_keypoint_t;
+
+/**
+ * @brief Compact fixed-point skeleton (86 bytes)
+ *
+ * Coordinates are fractions of the sensing area in Q0.16 (0 = left/top,
+ * 65535 = right/bottom); confidence is Q0.8 (255 = 1.0).
+ */
+typedef struct {
+    uint16_t x[POSE_NUM_KEYPOINTS];          // Horizontal position, Q0.16
+    uint16_t y[POSE_NUM_KEYPOINTS];          // Vertical position, Q0.16
+    uint8_t confidence[POSE_NUM_KEYPOINTS];  // Keypoint confidence, Q0.8
+    uint8_t num_keypoints;                   // POSE_NUM_KEYPOINTS, or 0 if no skeleton
+} pose_skeleton_t;
+
 /**
  * @brief Inference result structure
  */
@@ -67,6 +113,12 @@ typedef struct {
     pose_class_t pose_class;   // Classified pose/activity
     float confidence;          // Confidence score [0.0, 1.0]
     float motion_level;        // Motion intensity [0.0, 1.0]
+    float breathing_rate_bpm;  // Breathing rate (breaths/min), 0 if not estimated
+    float breathing_quality;   // Breathing estimate quality [0.0, 1.0]
+    uint8_t occupancy;         // People in the room, 0..OCCUPANCY_MAX_COUNT (saturates)
+    float occupancy_confidence;  // Confidence of the count [0.5, 1.0]
+    int8_t zone;               // Most likely zone of the calibration grid, -1 if not localized
+    uint8_t zone_prob[ZONE_MAX_ZONES];  // Zone probability grid, Q0.8, row-major
 
     // Feature statistics (for debugging/analysis)
     float amplitude_mean;
@@ -74,9 +126,61 @@ typedef struct {
     float phase_variance;
 
     uint32_t inference_time_ms;  // Time taken for inference
+    bool reused;                 // Copied from the last computed window (static scene)
     uint32_t timestamp;          // Timestamp of result
+    uint32_t sequence;           // Publication sequence number (1, 2, ...)
+
+    pose_skeleton_t skeleton;    // Keypoints, if the model has a keypoint head
 } pose_result_t;
 
+/**
+ * @brief Pipeline settings that can change while running (pose_set_tuning())
+ */
+typedef struct {
+    float empty_amp_std;       // Amplitude std below which the room is empty
+    float moving_phase_var;    // Phase variance of full motion (motion level 1.0)
+    float moving_level;        // Motion level above which a person is moving
+    int smoothing_lag;         // Smoother lag in windows, -1 disables smoothing
+    int smoothing_stay_permille;  // Probability that the class stays, per mille
+    int gate_refresh;          // Recompute at least every N windows, 1 disables gating
+    float event_threshold;     // CUSUM threshold of the event detector
+} pose_tuning_t;
+
+// Window latency histogram: bucket b counts latencies below 128us << b,
+// the last bucket everything slower
+#define POSE_LATENCY_BUCKETS 10
+
+// Class histogram bins: POSE_EMPTY..POSE_STANDING, then POSE_UNKNOWN
+#define POSE_CLASS_BINS 7
+
+/**
+ * @brief Counters and histograms since pose_init()
+ */
+typedef struct {
+    uint32_t windows;                         // Windows processed
+    uint32_t reused;                          // Windows that reused the last result
+    uint32_t events;                          // Motion events fired
+    uint32_t deadline_misses;                 // Computed windows over the time budget
+    uint8_t degrade_level;                    // deadline_level_t of the next window
+    uint32_t level_windows[DEADLINE_LEVELS];  // Computed windows per degradation level
+    uint32_t latency[POSE_LATENCY_BUCKETS];   // Window latency histogram
+    uint32_t classes[POSE_CLASS_BINS];        // Classes of the published results
+} pose_histograms_t;
+
+/**
+ * @brief Output of the presence model, refreshed every presence hop
+ */
+typedef struct {
+    bool human_detected;       // Presence over the last window
+    float confidence;          // Confidence score [0.0, 1.0]
+    float motion_level;        // Motion intensity [0.0, 1.0]
+    uint32_t timestamp;        // Time of the update (ms)
+    uint32_t updates;          // Updates since pose_init()
+} pose_presence_t;
+
+// Temporal smoothing configuration (defined in pose_smoother.h)
+typedef struct pose_smoother_config pose_smoother_config_t;
+
 /**
  * @brief Callback function type for pose detection results
  *
@@ -85,12 +189,21 @@ typedef struct {
  */
 typedef void (*pose_callback_t)(const pose_result_t *result, void *user_ctx);
 
+/**
+ * @brief Callback function type for motion events (falls, sudden motion)
+ *
+ * @param event Detected event
+ * @param user_ctx User context passed during registration
+ */
+typedef void (*pose_event_callback_t)(const motion_event_t *event, void *user_ctx);
+
 /**
  * @brief Initialize pose estimation module
  *
  * Sets up the inference pipeline with default configuration optimized for ESP32-S3.
  * This includes:
- * - Allocating buffers in PSRAM for CSI history
+ * - Resetting the CSI history buffers (carved from the memory arena, so
+ *   mem_arena_init() must have been called with pose_get_memory_budget())
  * - Loading model weights from flash
  * - Initializing the ML interpreter
  *
@@ -99,10 +212,21 @@ typedef void (*pose_callback_t)(const pose_result_t *result, void *user_ctx);
  */
 esp_err_t pose_init(const pose_config_t *config);
 
+/**
+ * @brief Get the memory budget of the pose module
+ *
+ * Lists the module's long-lived buffers for mem_arena_init(). Sizes are
+ * fixed at compile time, so this can be called before pose_init().
+ *
+ * @return Budget table (static storage)
+ */
+mem_budget_t pose_get_memory_budget(void);
+
 /**
  * @brief Deinitialize pose estimation module
  *
- * Frees resources and stops inference.
+ * Stops inference and frees the mutex. CSI buffers stay owned by the
+ * memory arena.
  *
  * @return ESP_OK on success
  */
@@ -119,6 +243,20 @@ esp_err_t pose_deinit(void);
  */
 esp_err_t pose_register_callback(pose_callback_t callback, void *user_ctx);
 
+/**
+ * @brief Register callback for motion events
+ *
+ * Events are detected per sample (event_detector.h), not per window: the
+ * callback runs from pose_process_csi() on the sample that fires the
+ * event, before that sample is buffered or a window is classified. Keep it
+ * short; it delays the CSI path. No-op without CONFIG_POSE_EVENTS.
+ *
+ * @param callback Function to call with events
+ * @param user_ctx User context passed to callback
+ * @return ESP_OK on success
+ */
+esp_err_t pose_register_event_callback(pose_event_callback_t callback, void *user_ctx);
+
 /**
  * @brief Process CSI data for pose estimation
  *
@@ -139,17 +277,129 @@ esp_err_t pose_register_callback(pose_callback_t callback, void *user_ctx);
 esp_err_t pose_process_csi(const float *amplitude, const float *phase,
                            int num_subcarriers, int8_t rssi);
 
+/**
+ * @brief pose_process_csi() for fixed-point samples (csi_fixed.h)
+ *
+ * Buffered as is with CONFIG_POSE_FIXED_POINT, so CSI records go from
+ * csi_fixed_iq() to the window without a float conversion. Either entry
+ * point works in either build; the other one converts each sample.
+ *
+ * @param amplitude Amplitudes, Q8.7
+ * @param phase     Phases, Q15 fraction of π
+ */
+esp_err_t pose_process_csi_q(const int16_t *amplitude, const int16_t *phase,
+                             int num_subcarriers, int8_t rssi);
+
+/**
+ * @brief Add a CSI packet to the per-link motion energy (zone localization)
+ *
+ * Call for every packet, before pose_process_csi(), from the same task.
+ * Links are identified by transmitter MAC: those of the calibration table,
+ * or the first ZONE_MAX_LINKS seen while the table is empty. Packets of
+ * other transmitters are ignored. No-op without CONFIG_POSE_ZONES.
+ *
+ * @param mac             Transmitter MAC address (6 bytes)
+ * @param amplitude       Subcarrier amplitudes
+ * @param num_subcarriers Number of subcarriers
+ * @return ESP_OK on success
+ */
+esp_err_t pose_process_link(const uint8_t *mac, const float *amplitude, int num_subcarriers);
+
+/**
+ * @brief Get the last window's zone fingerprint (for calibration)
+ *
+ * Valid in the result callback; tools/zone_calibrate.py builds the
+ * calibration table from these.
+ *
+ * @param energy    Output: ZONE_MAX_LINKS quantized per-link energies
+ * @param macs      Output: ZONE_MAX_LINKS transmitter MACs
+ * @param num_links Output: links in use
+ * @return ESP_OK, or ESP_ERR_NOT_SUPPORTED without CONFIG_POSE_ZONES
+ */
+esp_err_t pose_get_zone_fingerprint(uint8_t *energy, uint8_t (*macs)[6], int *num_links);
+
+/**
+ * @brief Replace the temporal smoothing configuration
+ *
+ * Takes effect at the next window; results still waiting for their lag are
+ * dropped. The default comes from Kconfig (POSE_SMOOTHING_*).
+ *
+ * @param config Transition matrix and lag (NULL disables smoothing)
+ * @return ESP_OK, ESP_ERR_INVALID_ARG if the config is not valid, or
+ *         ESP_ERR_INVALID_STATE before pose_init()
+ */
+esp_err_t pose_set_smoothing(const pose_smoother_config_t *config);
+
+/**
+ * @brief Change the pipeline tuning while running
+ *
+ * Every field takes effect together at the start of the next window, so a
+ * window never sees half of an update. Changing the gate refresh restarts
+ * the gate; changing the smoothing drops results still waiting for their
+ * lag, as with pose_set_smoothing().
+ *
+ * @param tuning New tuning
+ * @return ESP_OK, ESP_ERR_INVALID_ARG if a field is out of range, or
+ *         ESP_ERR_INVALID_STATE before pose_init()
+ */
+esp_err_t pose_set_tuning(const pose_tuning_t *tuning);
+
+/**
+ * @brief Get the tuning in effect (or pending for the next window)
+ *
+ * Right after pose_init() this is the Kconfig default.
+ *
+ * @return ESP_OK, or ESP_ERR_INVALID_STATE before pose_init()
+ */
+esp_err_t pose_get_tuning(pose_tuning_t *tuning);
+
 /**
  * @brief Get the latest inference result
  *
  * Copies the most recent pose detection result into the provided buffer.
- * Use this for polling instead of callbacks.
+ * Use this for polling instead of callbacks. Lock-free: never blocks and
+ * never delays inference. Pollers that must not miss short-lived results
+ * should use pose_get_results_since() instead.
  *
  * @param result Buffer to store result
  * @return ESP_OK if result available, ESP_ERR_NOT_FOUND if no inference yet
  */
 esp_err_t pose_get_latest_result(pose_result_t *result);
 
+/**
+ * @brief Get every result published after a sequence number
+ *
+ * The last RESULT_RING_CAPACITY results are kept. Pass the sequence of the
+ * last result already handled (0 the first time) and continue from
+ * since_seq + num_results + lost. Lock-free, like pose_get_latest_result().
+ *
+ * @param since_seq   Sequence of the last result already seen
+ * @param results     Output array, oldest first
+ * @param max_results Capacity of results
+ * @param num_results Output: number of results copied
+ * @param lost        Output: results overwritten before they were read
+ * @return ESP_OK if at least one result was copied, ESP_ERR_NOT_FOUND if
+ *         nothing new, ESP_ERR_INVALID_ARG for bad arguments
+ */
+esp_err_t pose_get_results_since(uint32_t since_seq, pose_result_t *results, int max_results,
+                                 int *num_results, uint32_t *lost);
+
+/**
+ * @brief Copy recent temporal windows out of the PSRAM history ring
+ *
+ * Windows are written oldest first, each one window_size * subcarriers
+ * floats in the same sample-major layout as the live buffers (converted
+ * from fixed point with CONFIG_POSE_FIXED_POINT).
+ *
+ * @param num_windows  Number of most recent windows wanted
+ * @param amplitude    Output, num_windows windows of amplitude
+ * @param phase        Output, num_windows windows of phase
+ * @param windows_read Number of windows actually copied
+ * @return ESP_OK, ESP_ERR_NOT_FOUND if no window has completed yet,
+ *         ESP_ERR_TIMEOUT if the history is busy
+ */
+esp_err_t pose_read_history(int num_windows, float *amplitude, float *phase, int *windows_read);
+
 /**
  * @brief Check if pose inference is active
  *
@@ -165,6 +415,56 @@ bool pose_is_active(void);
  */
 void pose_get_stats(uint32_t *num_inferences, float *avg_latency_ms);
 
+/**
+ * @brief Get the counters and histograms
+ *
+ * Read without locking while inference runs, so counters of the window in
+ * progress may be off by one from each other.
+ *
+ * @param histograms Output
+ */
+void pose_get_histograms(pose_histograms_t *histograms);
+
+/**
+ * @brief Copy the rolling amplitude spectrogram, oldest column first
+ *
+ * One column per CONFIG_POSE_SPECTROGRAM_HOP_MS over the last window: the
+ * Hann-windowed magnitudes of DFT bins 1.. over the last 128 samples of
+ * each selected subcarrier. Updated by the CSI task, so call it from
+ * there (e.g. in the pose callback) to read whole columns.
+ *
+ * @param spectrogram Output [columns][subcarriers][bins], room for one window
+ * @param columns     Columns copied (fewer until a window has passed)
+ * @param subcarriers CONFIG_POSE_SPECTROGRAM_SUBCARRIERS
+ * @param bins        CONFIG_POSE_SPECTROGRAM_BINS
+ * @return ESP_OK, ESP_ERR_NOT_FOUND before the first column,
+ *         ESP_ERR_NOT_SUPPORTED without CONFIG_POSE_SPECTROGRAM
+ */
+esp_err_t pose_read_spectrogram(float *spectrogram, int *columns, int *subcarriers, int *bins);
+
+/**
+ * @brief Get the latest output of the presence model
+ *
+ * Refreshed every CONFIG_POSE_PRESENCE_HOP_MS from the last window of
+ * samples, without waiting for the window to complete. Lock-free like
+ * pose_get_latest_result(): the copy is always one whole update.
+ *
+ * @param presence Output
+ * @return ESP_OK, ESP_ERR_NOT_FOUND before the first update,
+ *         ESP_ERR_TIMEOUT if the model overtook the copy several times,
+ *         ESP_ERR_NOT_SUPPORTED if the presence model is disabled
+ */
+esp_err_t pose_get_presence(pose_presence_t *presence);
+
+/**
+ * @brief Get the cadence, latency and CPU share of each scheduled model
+ *
+ * @param stats      Output, one entry per model ("pose", then "presence")
+ * @param max_models Capacity of stats
+ * @return Number of entries written
+ */
+int pose_get_model_stats(model_sched_stats_t *stats, int max_models);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,147 @@
+/**
+ * @file pose_pipeline.c
+ * @brief Portable classification stages of the pose pipeline
+ *
+ * Nothing in this file may depend on ESP-IDF or FreeRTOS: tools/host builds
+ * it unchanged to evaluate models on recorded data.
+ */
+
+#include "pose_pipeline.h"
+#include "csi_kernels.h"
+#include "pose_dims.h"
+#include <math.h>
+#include <stddef.h>
+
+/**
+ * This is a simplified detection algorithm based on the paper's insights:
+ * - Human presence increases CSI variance
+ * - Amplitude_std and phase_variance are key indicators
+ * - RSSI changes can also indicate presence
+ */
+void pose_detect_presence(const csi_window_stats_t *stats, pose_result_t *result)
+{
+    const pose_tuning_t tuning = {
+        .empty_amp_std = POSE_DEFAULT_EMPTY_AMP_STD,
+        .moving_phase_var = POSE_DEFAULT_MOVING_PHASE_VAR,
+        .moving_level = POSE_DEFAULT_MOVING_LEVEL,
+    };
+    pose_detect_presence_tuned(stats, &tuning, result);
+}
+
+void pose_detect_presence_tuned(const csi_window_stats_t *stats, const pose_tuning_t *tuning,
+                                pose_result_t *result)
+{
+    result->amplitude_mean = stats->amplitude_mean;
+    result->amplitude_std = stats->amplitude_std;
+    result->phase_variance = stats->phase_variance;
+
+    // Basic presence detection
+    if (stats->amplitude_std < tuning->empty_amp_std) {
+        result->human_detected = false;
+        result->pose_class = POSE_EMPTY;
+        result->confidence = 0.9f;
+        result->motion_level = 0.0f;
+    } else {
+        result->human_detected = true;
+
+        // Calculate motion level from phase variance
+        result->motion_level = fminf(stats->phase_variance / tuning->moving_phase_var, 1.0f);
+
+        // Classify activity based on motion level and amplitude variance
+        if (result->motion_level < tuning->moving_level) {
+            result->pose_class = POSE_PRESENT;  // Static human
+            result->confidence = 0.7f;
+        } else {
+            result->pose_class = POSE_MOVING;   // Moving human
+            result->confidence = 0.6f;
+
+            // TODO: More sophisticated classification for walking/sitting/standing
+            // This would require a trained ML model
+        }
+    }
+}
+
+/**
+ * @brief Shared body of the model input builders; constant dimensions inline
+ */
+static inline void prepare_input(const float *amplitude, const float *phase, int num_samples,
+                                 int num_subcarriers, float scale, int zero_point, int8_t *out)
+{
+    // One normalized row at a time keeps the float scratch on the stack small
+    float row[2 * 64];
+    int row_len = 2 * num_subcarriers;
+
+    for (int t = 0; t < num_samples; t++) {
+        csi_kernel_normalize_row(&amplitude[t * num_subcarriers], &phase[t * num_subcarriers],
+                                 num_subcarriers, row);
+        csi_kernel_quantize_int8(row, row_len, scale, zero_point, &out[t * row_len]);
+    }
+}
+
+void pose_model_prepare_input(const float *amplitude, const float *phase, int num_samples,
+                              int num_subcarriers, float scale, int zero_point, int8_t *out)
+{
+    prepare_input(amplitude, phase, num_samples, num_subcarriers, scale, zero_point, out);
+}
+
+void pose_model_prepare_window(const float *amplitude, const float *phase, float scale,
+                               int zero_point, int8_t *out)
+{
+    prepare_input(amplitude, phase, POSE_WINDOW_SAMPLES, POSE_NUM_SUBCARRIERS, scale, zero_point,
+                  out);
+}
+
+void pose_model_decode_output(const int8_t *scores, int num_classes, float scale,
+                              int zero_point, const csi_window_stats_t *stats,
+                              pose_result_t *result)
+{
+    int best = 0;
+    float best_score = -INFINITY;
+    float total = 0.0f;
+
+    // Model output is softmax, so dequantized scores are probabilities
+    for (int i = 0; i < num_classes; i++) {
+        float p = (float)(scores[i] - zero_point) * scale;
+        if (p < 0.0f) p = 0.0f;
+        total += p;
+        if (p > best_score) {
+            best_score = p;
+            best = i;
+        }
+    }
+
+    result->pose_class = (pose_class_t)best;
+    result->confidence = total > 0.0f ? best_score / total : 0.0f;
+    result->human_detected = result->pose_class != POSE_EMPTY;
+
+    if (stats != NULL) {
+        result->amplitude_mean = stats->amplitude_mean;
+        result->amplitude_std = stats->amplitude_std;
+        result->phase_variance = stats->phase_variance;
+        result->motion_level = result->human_detected
+            ? fminf(stats->phase_variance / POSE_DEFAULT_MOVING_PHASE_VAR, 1.0f)
+            : 0.0f;
+    }
+}
+
+void pose_keypoint_lut_init(pose_keypoint_lut_t *lut, float scale, int zero_point)
+{
+    for (int i = 0; i < 256; i++) {
+        float v = (float)((int8_t)i - zero_point) * scale;
+        v = fminf(fmaxf(v, 0.0f), 1.0f);
+        lut->coord[i] = (uint16_t)(v * 65535.0f + 0.5f);
+        lut->confidence[i] = (uint8_t)(v * 255.0f + 0.5f);
+    }
+}
+
+void pose_model_decode_keypoints(const int8_t *head, const pose_keypoint_lut_t *lut,
+                                 pose_skeleton_t *skeleton)
+{
+    for (int k = 0; k < POSE_NUM_KEYPOINTS; k++) {
+        const int8_t *kp = &head[3 * k];
+        skeleton->x[k] = lut->coord[(uint8_t)kp[0]];
+        skeleton->y[k] = lut->coord[(uint8_t)kp[1]];
+        skeleton->confidence[k] = lut->confidence[(uint8_t)kp[2]];
+    }
+    skeleton->num_keypoints = POSE_NUM_KEYPOINTS;
+}
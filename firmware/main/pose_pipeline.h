@@ -0,0 +1,136 @@
+/**
+ * @file pose_pipeline.h
+ * @brief Portable classification stages of the pose pipeline
+ *
+ * run_inference() in pose_inference.c is built from these stages:
+ *
+ *   temporal window -> csi_window_stats() -> pose_detect_presence()
+ *
+ * and, once a trained model is integrated through tflite_classifier.h:
+ *
+ *   temporal window -> pose_model_prepare_window() -> tflite_classifier_run()
+ *                   -> pose_model_decode_output()
+ *
+ * Models with a keypoint head use tflite_classifier_run_keypoints() instead
+ * and also pass the head through pose_model_decode_keypoints().
+ */
+
+#ifndef POSE_PIPELINE_H
+#define POSE_PIPELINE_H
+
+#include "pose_inference.h"
+#include "csi_features.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Default detection thresholds (tune these based on empirical data)
+#define POSE_DEFAULT_EMPTY_AMP_STD 2.0f
+#define POSE_DEFAULT_MOVING_PHASE_VAR 0.5f
+#define POSE_DEFAULT_MOVING_LEVEL 0.3f
+
+/**
+ * @brief Threshold-based presence and motion detection
+ *
+ * Fills every field of result except inference_time_ms and timestamp,
+ * which belong to the caller. Uses the POSE_DEFAULT_* thresholds.
+ *
+ * @param stats  Window statistics from csi_window_stats()
+ * @param result Output result
+ */
+void pose_detect_presence(const csi_window_stats_t *stats, pose_result_t *result);
+
+/**
+ * @brief pose_detect_presence() with the thresholds of a tuning
+ *
+ * Only empty_amp_std, moving_phase_var and moving_level are used.
+ */
+void pose_detect_presence_tuned(const csi_window_stats_t *stats, const pose_tuning_t *tuning,
+                                pose_result_t *result);
+
+/**
+ * @brief Build the int8 model input tensor from a temporal window
+ *
+ * Each sample is normalized with csi_normalize_sample() (the same
+ * preprocessing train_pose_model.py uses) and quantized with the input
+ * tensor's parameters.
+ *
+ * @param amplitude Amplitude window, num_samples * num_subcarriers floats
+ * @param phase     Phase window, num_samples * num_subcarriers floats
+ * @param num_samples     Samples in the window
+ * @param num_subcarriers Subcarriers per sample
+ * @param scale      Input tensor quantization scale
+ * @param zero_point Input tensor quantization zero point
+ * @param out        Output tensor, num_samples * 2 * num_subcarriers bytes
+ */
+void pose_model_prepare_input(const float *amplitude, const float *phase, int num_samples,
+                              int num_subcarriers, float scale, int zero_point, int8_t *out);
+
+/**
+ * @brief pose_model_prepare_input() over one window of the build's dimensions
+ *
+ * Same output for a POSE_WINDOW_SAMPLES x POSE_NUM_SUBCARRIERS window
+ * (pose_dims.h), with every loop bound a compile-time constant.
+ *
+ * @param out Output tensor, POSE_WINDOW_SAMPLES * POSE_MODEL_FEATURES bytes
+ */
+void pose_model_prepare_window(const float *amplitude, const float *phase, float scale,
+                               int zero_point, int8_t *out);
+
+/**
+ * @brief Turn int8 class scores into a pose result
+ *
+ * Dequantizes the scores, picks the most likely class and uses its
+ * probability as confidence. Window statistics are copied into the result
+ * for debugging, and motion level is derived from phase variance like
+ * pose_detect_presence() does.
+ *
+ * @param scores      Output tensor, num_classes int8 scores
+ * @param num_classes Number of classes (pose_class_t values 0..num_classes-1)
+ * @param scale       Output tensor quantization scale
+ * @param zero_point  Output tensor quantization zero point
+ * @param stats       Window statistics (may be NULL)
+ * @param result      Output result
+ */
+void pose_model_decode_output(const int8_t *scores, int num_classes, float scale,
+                              int zero_point, const csi_window_stats_t *stats,
+                              pose_result_t *result);
+
+/**
+ * @brief Lookup tables from int8 keypoint outputs to fixed point
+ *
+ * The keypoint head ends in a sigmoid, so every output is in [0, 1] and one
+ * quantized int8 value maps to exactly one Q0.16 coordinate and one Q0.8
+ * confidence. Building the 768-byte tables once per model makes decoding a
+ * table lookup per value, with no float math per window.
+ */
+typedef struct {
+    uint16_t coord[256];       // Q0.16 coordinate, indexed by (uint8_t)q
+    uint8_t confidence[256];   // Q0.8 confidence, indexed by (uint8_t)q
+} pose_keypoint_lut_t;
+
+/**
+ * @brief Build the lookup tables for a keypoint output tensor
+ *
+ * @param lut        Output tables
+ * @param scale      Keypoint tensor quantization scale
+ * @param zero_point Keypoint tensor quantization zero point
+ */
+void pose_keypoint_lut_init(pose_keypoint_lut_t *lut, float scale, int zero_point);
+
+/**
+ * @brief Turn the int8 keypoint head output into a skeleton
+ *
+ * @param head     Output tensor, POSE_NUM_KEYPOINTS x (x, y, confidence)
+ * @param lut      Tables from pose_keypoint_lut_init()
+ * @param skeleton Output skeleton (num_keypoints = POSE_NUM_KEYPOINTS)
+ */
+void pose_model_decode_keypoints(const int8_t *head, const pose_keypoint_lut_t *lut,
+                                 pose_skeleton_t *skeleton);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POSE_PIPELINE_H
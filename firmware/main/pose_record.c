@@ -0,0 +1,185 @@
+/**
+ * @file pose_record.c
+ * @brief Compact binary records of pose results
+ */
+
+#include "pose_record.h"
+#include <math.h>
+#include <string.h>
+
+static void put_u16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t *p, uint32_t v)
+{
+    put_u16(p, (uint16_t)v);
+    put_u16(p + 2, (uint16_t)(v >> 16));
+}
+
+static uint16_t get_u16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t *p)
+{
+    return get_u16(p) | ((uint32_t)get_u16(p + 2) << 16);
+}
+
+static uint8_t to_q0_8(float value)
+{
+    return (uint8_t)(fminf(fmaxf(value, 0.0f), 1.0f) * 255.0f + 0.5f);
+}
+
+// CRC-16/CCITT-FALSE of every 4-bit value: two lookups per byte, and only
+// 32 bytes of table (UV map records are over 1KB, bitwise CRC dominated)
+static const uint16_t s_crc_nibble[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+};
+
+uint16_t pose_record_crc16(const uint8_t *data, size_t len)
+{
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc = (uint16_t)((crc << 4) ^ s_crc_nibble[(crc >> 12) ^ (data[i] >> 4)]);
+        crc = (uint16_t)((crc << 4) ^ s_crc_nibble[(crc >> 12) ^ (data[i] & 0x0F)]);
+    }
+    return crc;
+}
+
+uint8_t *pose_record_begin(uint8_t *buf, size_t capacity, pose_record_type_t type,
+                           size_t payload_len)
+{
+    if (payload_len > POSE_RECORD_MAX_PAYLOAD ||
+        capacity < POSE_RECORD_HEADER_BYTES + payload_len + POSE_RECORD_CRC_BYTES) {
+        return NULL;
+    }
+    buf[0] = POSE_RECORD_SYNC0;
+    buf[1] = POSE_RECORD_SYNC1;
+    buf[2] = POSE_RECORD_VERSION;
+    buf[3] = (uint8_t)type;
+    put_u16(&buf[4], (uint16_t)payload_len);
+    return &buf[POSE_RECORD_HEADER_BYTES];
+}
+
+size_t pose_record_finish(uint8_t *buf)
+{
+    size_t body = POSE_RECORD_HEADER_BYTES + get_u16(&buf[4]);
+    put_u16(&buf[body], pose_record_crc16(buf, body));
+    return body + POSE_RECORD_CRC_BYTES;
+}
+
+esp_err_t pose_record_parse(const uint8_t *buf, size_t len, pose_record_type_t *type,
+                            const uint8_t **payload, size_t *payload_len, size_t *consumed)
+{
+    if (len < 2) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (buf[0] != POSE_RECORD_SYNC0 || buf[1] != POSE_RECORD_SYNC1) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (len < POSE_RECORD_HEADER_BYTES) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    size_t body = get_u16(&buf[4]);
+    if (body > POSE_RECORD_MAX_PAYLOAD) {
+        return ESP_ERR_INVALID_ARG;  // Not a record (sync bytes in other data)
+    }
+    size_t size = POSE_RECORD_HEADER_BYTES + body + POSE_RECORD_CRC_BYTES;
+    if (len < size) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (get_u16(&buf[size - POSE_RECORD_CRC_BYTES]) !=
+        pose_record_crc16(buf, size - POSE_RECORD_CRC_BYTES)) {
+        return ESP_ERR_INVALID_CRC;
+    }
+    if (buf[2] != POSE_RECORD_VERSION) {
+        return ESP_ERR_INVALID_VERSION;
+    }
+
+    *type = (pose_record_type_t)buf[3];
+    *payload = &buf[POSE_RECORD_HEADER_BYTES];
+    *payload_len = body;
+    *consumed = size;
+    return ESP_OK;
+}
+
+size_t pose_record_encode(const pose_result_t *result, uint8_t *buf, size_t capacity)
+{
+    const pose_skeleton_t *sk = &result->skeleton;
+    int keypoints = sk->num_keypoints == POSE_NUM_KEYPOINTS ? POSE_NUM_KEYPOINTS : 0;
+    size_t payload = POSE_RECORD_POSE_BYTES + (size_t)keypoints * POSE_RECORD_KEYPOINT_BYTES;
+    uint8_t *p = pose_record_begin(buf, capacity, POSE_RECORD_TYPE_POSE, payload);
+    if (p == NULL) {
+        return 0;
+    }
+
+    put_u32(&p[0], result->sequence);
+    put_u32(&p[4], result->timestamp);
+    p[8] = (uint8_t)result->pose_class;
+    p[9] = result->human_detected ? 0x01 : 0x00;
+    p[10] = to_q0_8(result->confidence);
+    p[11] = to_q0_8(result->motion_level);
+    float bpm_tenths = fminf(fmaxf(result->breathing_rate_bpm * 10.0f + 0.5f, 0.0f), 65535.0f);
+    put_u16(&p[12], (uint16_t)bpm_tenths);
+    p[14] = to_q0_8(result->breathing_quality);
+    p[15] = (uint8_t)keypoints;
+    p[16] = result->occupancy;
+    p[17] = to_q0_8(result->occupancy_confidence);
+
+    p += POSE_RECORD_POSE_BYTES;
+    for (int k = 0; k < keypoints; k++, p += POSE_RECORD_KEYPOINT_BYTES) {
+        put_u16(&p[0], sk->x[k]);
+        put_u16(&p[2], sk->y[k]);
+        p[4] = sk->confidence[k];
+    }
+    return pose_record_finish(buf);
+}
+
+esp_err_t pose_record_decode(const uint8_t *buf, size_t len, pose_result_t *result,
+                             size_t *consumed)
+{
+    pose_record_type_t type;
+    const uint8_t *p;
+    size_t payload;
+    esp_err_t err = pose_record_parse(buf, len, &type, &p, &payload, consumed);
+    if (err != ESP_OK) {
+        return err;
+    }
+    if (type != POSE_RECORD_TYPE_POSE) {
+        return ESP_ERR_INVALID_VERSION;
+    }
+
+    int keypoints = payload >= POSE_RECORD_POSE_BYTES ? p[15] : -1;
+    if ((keypoints != 0 && keypoints != POSE_NUM_KEYPOINTS) ||
+        payload != POSE_RECORD_POSE_BYTES + (size_t)keypoints * POSE_RECORD_KEYPOINT_BYTES) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(result, 0, sizeof(*result));
+    result->sequence = get_u32(&p[0]);
+    result->timestamp = get_u32(&p[4]);
+    result->pose_class = (pose_class_t)p[8];
+    result->human_detected = (p[9] & 0x01) != 0;
+    result->confidence = p[10] / 255.0f;
+    result->motion_level = p[11] / 255.0f;
+    result->breathing_rate_bpm = get_u16(&p[12]) / 10.0f;
+    result->breathing_quality = p[14] / 255.0f;
+    result->occupancy = p[16];
+    result->occupancy_confidence = p[17] / 255.0f;
+    result->zone = -1;  // Not part of the record
+
+    pose_skeleton_t *sk = &result->skeleton;
+    sk->num_keypoints = (uint8_t)keypoints;
+    p += POSE_RECORD_POSE_BYTES;
+    for (int k = 0; k < keypoints; k++, p += POSE_RECORD_KEYPOINT_BYTES) {
+        sk->x[k] = get_u16(&p[0]);
+        sk->y[k] = get_u16(&p[2]);
+        sk->confidence[k] = p[4];
+    }
+    return ESP_OK;
+}
@@ -0,0 +1,156 @@
+/**
+ * @file pose_record.h
+ * @brief Compact binary records of pose results
+ *
+ * The JSON line printed per result has no room for a skeleton (17 keypoints
+ * as text would be ~700 bytes). A binary record carries the whole result,
+ * skeleton included, in at most POSE_RECORD_MAX_BYTES:
+ *
+ *   offset size  field
+ *        0    2  sync 0xA5 0x5A
+ *        2    1  version (POSE_RECORD_VERSION)
+ *        3    1  type (pose_record_type_t)
+ *        4    2  payload length
+ *        6    n  payload
+ *      6+n    2  CRC-16/CCITT-FALSE of bytes 0..6+n-1
+ *
+ * Pose payload (POSE_RECORD_TYPE_POSE):
+ *
+ *        0    4  sequence
+ *        4    4  timestamp (ms)
+ *        8    1  pose class
+ *        9    1  flags (bit 0: human detected)
+ *       10    1  confidence, Q0.8
+ *       11    1  motion level, Q0.8
+ *       12    2  breathing rate, 0.1 bpm
+ *       14    1  breathing quality, Q0.8
+ *       15    1  keypoint count k (0 or POSE_NUM_KEYPOINTS)
+ *       16    1  people count (occupancy)
+ *       17    1  people count confidence, Q0.8
+ *       18   5k  per keypoint: x (Q0.16), y (Q0.16), confidence (Q0.8)
+ *
+ * Other record types (uv_map.h, event_detector.h) use the same framing through
+ * pose_record_begin() / pose_record_finish() and pose_record_parse(). Any
+ * record fits one unfragmented UDP datagram (POSE_RECORD_MAX_PAYLOAD).
+ *
+ * All multi-byte fields are little-endian. The sync bytes and CRC let a
+ * reader pick records out of a serial stream shared with log text;
+ * tools/pose_record.py is the host decoder.
+ */
+
+#ifndef POSE_RECORD_H
+#define POSE_RECORD_H
+
+#include "pose_inference.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define POSE_RECORD_SYNC0 0xA5
+#define POSE_RECORD_SYNC1 0x5A
+// 2: people count added to the pose payload
+#define POSE_RECORD_VERSION 2
+
+// Header and CRC around every payload
+#define POSE_RECORD_HEADER_BYTES 6
+#define POSE_RECORD_CRC_BYTES 2
+
+// Pose payload without and with a skeleton
+#define POSE_RECORD_POSE_BYTES 18
+#define POSE_RECORD_KEYPOINT_BYTES 5
+
+// Largest payload of any record type: header, payload and CRC fit the
+// 1472-byte UDP payload of a 1500-byte MTU
+#define POSE_RECORD_MAX_PAYLOAD 1464
+
+// Largest pose record (pose with skeleton)
+#define POSE_RECORD_MAX_BYTES (POSE_RECORD_HEADER_BYTES + POSE_RECORD_POSE_BYTES + \
+                               POSE_NUM_KEYPOINTS * POSE_RECORD_KEYPOINT_BYTES + \
+                               POSE_RECORD_CRC_BYTES)
+
+/**
+ * @brief Record types
+ */
+typedef enum {
+    POSE_RECORD_TYPE_POSE = 1,     // pose_result_t
+    POSE_RECORD_TYPE_UV_MAP = 2,   // uv_map_t (uv_map.h)
+    POSE_RECORD_TYPE_EVENT = 3,    // motion_event_t (event_detector.h)
+} pose_record_type_t;
+
+/**
+ * @brief Encode a pose result
+ *
+ * Fields are rounded to the record's fixed-point formats; fields without a
+ * place in the record (window statistics, inference time) are dropped.
+ *
+ * @param result   Result to encode
+ * @param buf      Output buffer
+ * @param capacity Size of buf (POSE_RECORD_MAX_BYTES always fits)
+ * @return Record size in bytes, or 0 if buf is too small
+ */
+size_t pose_record_encode(const pose_result_t *result, uint8_t *buf, size_t capacity);
+
+/**
+ * @brief Decode one pose record from the start of a buffer
+ *
+ * @param buf      Input bytes, starting at the sync bytes
+ * @param len      Bytes available
+ * @param result   Output result (fields not in the record are zeroed)
+ * @param consumed Output: record size, valid on ESP_OK
+ * @return ESP_OK, ESP_ERR_INVALID_SIZE if len is short of a whole record,
+ *         ESP_ERR_INVALID_VERSION for an unknown version or type,
+ *         ESP_ERR_INVALID_CRC on a checksum mismatch, ESP_ERR_INVALID_ARG
+ *         if buf does not start with the sync bytes or the payload is malformed
+ */
+esp_err_t pose_record_decode(const uint8_t *buf, size_t len, pose_result_t *result,
+                             size_t *consumed);
+
+/**
+ * @brief Start a record: write the header
+ *
+ * @param buf         Output buffer
+ * @param capacity    Size of buf
+ * @param type        Record type
+ * @param payload_len Payload size (<= POSE_RECORD_MAX_PAYLOAD)
+ * @return Where the payload goes, or NULL if the record does not fit
+ */
+uint8_t *pose_record_begin(uint8_t *buf, size_t capacity, pose_record_type_t type,
+                           size_t payload_len);
+
+/**
+ * @brief Finish a record started with pose_record_begin(): append the CRC
+ *
+ * @return Record size in bytes
+ */
+size_t pose_record_finish(uint8_t *buf);
+
+/**
+ * @brief Check the framing of one record at the start of a buffer
+ *
+ * @param buf         Input bytes, starting at the sync bytes
+ * @param len         Bytes available
+ * @param type        Output: record type
+ * @param payload     Output: payload, inside buf
+ * @param payload_len Output: payload size
+ * @param consumed    Output: record size
+ * @return ESP_OK, ESP_ERR_INVALID_SIZE if len is short of a whole record,
+ *         ESP_ERR_INVALID_VERSION for an unknown version, ESP_ERR_INVALID_CRC
+ *         on a checksum mismatch, ESP_ERR_INVALID_ARG if buf does not start
+ *         with a record header
+ */
+esp_err_t pose_record_parse(const uint8_t *buf, size_t len, pose_record_type_t *type,
+                            const uint8_t **payload, size_t *payload_len, size_t *consumed);
+
+/**
+ * @brief CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF)
+ */
+uint16_t pose_record_crc16(const uint8_t *data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POSE_RECORD_H
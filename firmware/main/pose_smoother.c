@@ -0,0 +1,240 @@
+/**
+ * @file pose_smoother.c
+ * @brief Temporal smoothing of pose classes with a small HMM
+ *
+ * Nothing in this file may depend on ESP-IDF or FreeRTOS: tools/host builds
+ * it unchanged to evaluate smoothing on recorded data.
+ */
+
+#include "pose_smoother.h"
+#include <math.h>
+#include <string.h>
+
+// Tolerance on transition row sums
+#define ROW_SUM_TOLERANCE 1e-3f
+
+// Log of probabilities that are exactly zero (forbidden transitions)
+#define LOG_ZERO -1e30f
+
+static float safe_log(float p)
+{
+    return p > 0.0f ? logf(p) : LOG_ZERO;
+}
+
+static void normalize(float *v, int n)
+{
+    float total = 0.0f;
+    for (int i = 0; i < n; i++) {
+        total += v[i];
+    }
+    for (int i = 0; i < n; i++) {
+        v[i] = total > 0.0f ? v[i] / total : 1.0f / n;
+    }
+}
+
+static int argmax(const float *v, int n)
+{
+    int best = 0;
+    for (int i = 1; i < n; i++) {
+        if (v[i] > v[best]) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+void pose_smoother_default_config(pose_smoother_config_t *config, int num_classes,
+                                  float stay_prob, int lag)
+{
+    memset(config, 0, sizeof(*config));
+    config->num_classes = num_classes;
+    config->lag = lag;
+    config->emission_floor = 0.02f;
+
+    float move_prob = num_classes > 1 ? (1.0f - stay_prob) / (num_classes - 1) : 0.0f;
+    for (int i = 0; i < num_classes && i < POSE_SMOOTHER_MAX_CLASSES; i++) {
+        for (int j = 0; j < num_classes && j < POSE_SMOOTHER_MAX_CLASSES; j++) {
+            config->transition[i][j] = i == j ? stay_prob : move_prob;
+        }
+    }
+}
+
+bool pose_smoother_config_valid(const pose_smoother_config_t *config)
+{
+    if (config == NULL || config->num_classes < 1 ||
+        config->num_classes > POSE_SMOOTHER_MAX_CLASSES || config->lag < 0 ||
+        config->lag > POSE_SMOOTHER_MAX_LAG || config->emission_floor < 0.0f ||
+        config->emission_floor >= 1.0f) {
+        return false;
+    }
+
+    for (int i = 0; i < config->num_classes; i++) {
+        float total = 0.0f;
+        for (int j = 0; j < config->num_classes; j++) {
+            if (config->transition[i][j] < 0.0f) {
+                return false;
+            }
+            total += config->transition[i][j];
+        }
+        if (fabsf(total - 1.0f) > ROW_SUM_TOLERANCE) {
+            return false;
+        }
+    }
+    return true;
+}
+
+esp_err_t pose_smoother_init(pose_smoother_t *smoother, const pose_smoother_config_t *config)
+{
+    if (smoother == NULL || !pose_smoother_config_valid(config)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(smoother, 0, sizeof(*smoother));
+    memcpy(&smoother->config, config, sizeof(*config));
+    for (int i = 0; i < config->num_classes; i++) {
+        for (int j = 0; j < config->num_classes; j++) {
+            smoother->log_transition[i][j] = safe_log(config->transition[i][j]);
+        }
+    }
+    return ESP_OK;
+}
+
+void pose_smoother_class_probs(const pose_result_t *result, int num_classes, float *probs)
+{
+    int cls = (int)result->pose_class;
+    if (cls < 0 || cls >= num_classes || num_classes == 1) {
+        for (int i = 0; i < num_classes; i++) {
+            probs[i] = 1.0f / num_classes;
+        }
+        return;
+    }
+
+    float conf = fminf(fmaxf(result->confidence, 0.0f), 1.0f);
+    float rest = (1.0f - conf) / (num_classes - 1);
+    for (int i = 0; i < num_classes; i++) {
+        probs[i] = i == cls ? conf : rest;
+    }
+}
+
+/**
+ * @brief Fixed-lag smoothed posterior of the window lag steps back
+ *
+ * Runs the backward recursion over the stored emissions of the last lag
+ * windows and combines it with the filtered posterior of the lagged window.
+ */
+static void smoothed_posterior(const pose_smoother_t *sm, uint32_t newest, float *gamma)
+{
+    const int n = sm->config.num_classes;
+    const int lag = sm->config.lag;
+    const int ring = lag + 1;
+    float beta[POSE_SMOOTHER_MAX_CLASSES];
+    float next[POSE_SMOOTHER_MAX_CLASSES];
+
+    for (int i = 0; i < n; i++) {
+        beta[i] = 1.0f;
+    }
+    for (uint32_t k = newest; k > newest - lag; k--) {
+        const float *e = sm->emission[k % ring];
+        for (int i = 0; i < n; i++) {
+            float sum = 0.0f;
+            for (int j = 0; j < n; j++) {
+                sum += sm->config.transition[i][j] * e[j] * beta[j];
+            }
+            next[i] = sum;
+        }
+        normalize(next, n);
+        memcpy(beta, next, n * sizeof(float));
+    }
+
+    const float *alpha = sm->alpha[(newest - lag) % ring];
+    for (int i = 0; i < n; i++) {
+        gamma[i] = alpha[i] * beta[i];
+    }
+    normalize(gamma, n);
+}
+
+bool pose_smoother_update(pose_smoother_t *smoother, const float *probs,
+                          const pose_result_t *raw, pose_result_t *out)
+{
+    pose_smoother_t *sm = smoother;
+    const int n = sm->config.num_classes;
+    const int lag = sm->config.lag;
+    const int ring = lag + 1;
+    const uint32_t t = sm->steps;
+    const int slot = t % ring;
+
+    // Observation likelihood: the classifier posterior over a uniform prior,
+    // floored so one overconfident window cannot rule a class out
+    float *e = sm->emission[slot];
+    for (int j = 0; j < n; j++) {
+        e[j] = fmaxf(probs[j], sm->config.emission_floor);
+    }
+    normalize(e, n);
+
+    float *alpha = sm->alpha[slot];
+    uint8_t *bp = sm->backptr[slot];
+    float delta[POSE_SMOOTHER_MAX_CLASSES];
+
+    if (t == 0) {
+        for (int j = 0; j < n; j++) {
+            alpha[j] = e[j];
+            delta[j] = logf(e[j]);
+            bp[j] = (uint8_t)j;
+        }
+    } else {
+        const float *prev = sm->alpha[(t - 1) % ring];
+        for (int j = 0; j < n; j++) {
+            // Forward filter: predict with the transition matrix, then update
+            float predicted = 0.0f;
+            // Viterbi: best predecessor of class j
+            float best = LOG_ZERO * 2.0f;
+            int best_i = 0;
+            for (int i = 0; i < n; i++) {
+                predicted += prev[i] * sm->config.transition[i][j];
+                float score = sm->delta[i] + sm->log_transition[i][j];
+                if (score > best) {
+                    best = score;
+                    best_i = i;
+                }
+            }
+            alpha[j] = predicted * e[j];
+            delta[j] = best + logf(e[j]);
+            bp[j] = (uint8_t)best_i;
+        }
+    }
+    normalize(alpha, n);
+
+    // Keep Viterbi scores near zero so they never lose precision
+    float top = delta[argmax(delta, n)];
+    for (int j = 0; j < n; j++) {
+        sm->delta[j] = delta[j] - top;
+    }
+
+    memcpy(&sm->pending[slot], raw, sizeof(pose_result_t));
+    sm->steps++;
+    if (sm->steps <= (uint32_t)lag) {
+        return false;
+    }
+
+    int cls;
+    float confidence;
+    if (lag == 0) {
+        cls = argmax(alpha, n);
+        confidence = alpha[cls];
+    } else {
+        // Trace the best path back from the newest window to window t - lag
+        cls = argmax(sm->delta, n);
+        for (uint32_t k = t; k > t - lag; k--) {
+            cls = sm->backptr[k % ring][cls];
+        }
+        float gamma[POSE_SMOOTHER_MAX_CLASSES];
+        smoothed_posterior(sm, t, gamma);
+        confidence = gamma[cls];
+    }
+
+    memcpy(out, &sm->pending[(t - lag) % ring], sizeof(pose_result_t));
+    out->pose_class = (pose_class_t)cls;
+    out->confidence = confidence;
+    out->human_detected = out->pose_class != POSE_EMPTY;
+    return true;
+}
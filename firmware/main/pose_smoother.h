@@ -0,0 +1,127 @@
+/**
+ * @file pose_smoother.h
+ * @brief Temporal smoothing of pose classes with a small HMM
+ *
+ * Per-window classification flickers (e.g. present/moving/present) because
+ * each window is classified on its own. This stage treats the true class as
+ * the hidden state of a hidden Markov model: the transition matrix says how
+ * likely the class is to change between consecutive windows, and the
+ * classifier's class probabilities are the observations.
+ *
+ * Two outputs, chosen by the lag:
+ *
+ * - lag 0: forward filter. The class with the highest filtered posterior
+ *   P(class_t | windows 1..t), available immediately.
+ * - lag L > 0: fixed-lag Viterbi. The class of window t - L on the most
+ *   likely class path through window t, so a single-window blip is only
+ *   reported if the next L windows support it. Confidence is the fixed-lag
+ *   smoothed posterior P(class_{t-L} | windows 1..t) of that class.
+ *
+ * Either way the confidence is a posterior probability, not the classifier's
+ * raw score. The added latency is exactly L windows (L x 500ms on the
+ * device).
+ */
+
+#ifndef POSE_SMOOTHER_H
+#define POSE_SMOOTHER_H
+
+#include "pose_inference.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Classes the smoother can track (POSE_EMPTY .. POSE_STANDING)
+#define POSE_SMOOTHER_MAX_CLASSES 6
+
+// Longest supported fixed lag (windows)
+#define POSE_SMOOTHER_MAX_LAG 8
+
+/**
+ * @brief Smoother configuration
+ */
+typedef struct pose_smoother_config {
+    int num_classes;           // Classes 0..num_classes-1 (<= POSE_SMOOTHER_MAX_CLASSES)
+    int lag;                   // Windows of added latency (0 = forward filter only)
+    float emission_floor;      // Lowest class probability trusted from the classifier
+    // transition[i][j] = P(class j in the next window | class i), rows sum to 1
+    float transition[POSE_SMOOTHER_MAX_CLASSES][POSE_SMOOTHER_MAX_CLASSES];
+} pose_smoother_config_t;
+
+/**
+ * @brief Smoother state (treat as opaque)
+ */
+typedef struct {
+    pose_smoother_config_t config;
+    float log_transition[POSE_SMOOTHER_MAX_CLASSES][POSE_SMOOTHER_MAX_CLASSES];
+    uint32_t steps;            // Windows seen since init
+
+    // Last lag + 1 windows, indexed by step % (lag + 1)
+    float emission[POSE_SMOOTHER_MAX_LAG + 1][POSE_SMOOTHER_MAX_CLASSES];
+    float alpha[POSE_SMOOTHER_MAX_LAG + 1][POSE_SMOOTHER_MAX_CLASSES];     // Filtered posterior
+    uint8_t backptr[POSE_SMOOTHER_MAX_LAG + 1][POSE_SMOOTHER_MAX_CLASSES]; // Viterbi
+    pose_result_t pending[POSE_SMOOTHER_MAX_LAG + 1];                    // Raw results
+
+    float delta[POSE_SMOOTHER_MAX_CLASSES]; // Viterbi log score of the newest window
+} pose_smoother_t;
+
+/**
+ * @brief Fill a config with a "sticky" transition matrix
+ *
+ * The class stays the same with probability stay_prob; the rest is spread
+ * evenly over the other classes.
+ *
+ * @param config      Output config
+ * @param num_classes Number of classes
+ * @param stay_prob   Probability of keeping the class between windows (0..1)
+ * @param lag         Fixed lag in windows (0 = forward filter)
+ */
+void pose_smoother_default_config(pose_smoother_config_t *config, int num_classes,
+                                  float stay_prob, int lag);
+
+/**
+ * @brief Check a config: sizes in range and every transition row sums to 1
+ */
+bool pose_smoother_config_valid(const pose_smoother_config_t *config);
+
+/**
+ * @brief Reset the smoother with a config
+ *
+ * @return ESP_OK, or ESP_ERR_INVALID_ARG if the config is not valid
+ */
+esp_err_t pose_smoother_init(pose_smoother_t *smoother, const pose_smoother_config_t *config);
+
+/**
+ * @brief Class probabilities from a hard decision
+ *
+ * For classifiers that only report a class and a confidence (like
+ * pose_detect_presence()): the class gets the confidence and the remainder
+ * is spread evenly over the other classes. POSE_UNKNOWN gives a uniform
+ * distribution.
+ *
+ * @param result      Classifier result
+ * @param num_classes Number of classes
+ * @param probs       Output, num_classes probabilities
+ */
+void pose_smoother_class_probs(const pose_result_t *result, int num_classes, float *probs);
+
+/**
+ * @brief Add one window and get the smoothed result lag windows back
+ *
+ * @param smoother Smoother
+ * @param probs    Classifier class probabilities for the new window
+ * @param raw      Raw result of the new window (kept until it is output)
+ * @param out      Output: raw result of window t - lag with pose_class,
+ *                 confidence and human_detected replaced by the smoothed ones
+ * @return false while the first lag windows fill up (out untouched)
+ */
+bool pose_smoother_update(pose_smoother_t *smoother, const float *probs,
+                          const pose_result_t *raw, pose_result_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POSE_SMOOTHER_H
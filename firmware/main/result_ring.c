@@ -0,0 +1,117 @@
+/**
+ * @file result_ring.c
+ * @brief Lock-free publication of pose results with a history ring
+ */
+
+#include "result_ring.h"
+#include <string.h>
+
+_Static_assert((RESULT_RING_CAPACITY & (RESULT_RING_CAPACITY - 1)) == 0,
+               "RESULT_RING_CAPACITY must be a power of two");
+_Static_assert(RESULT_RING_CAPACITY >= 3, "need at least three slots");
+
+static result_ring_slot_t *slot_for(result_ring_t *ring, uint32_t seq)
+{
+    return &ring->slots[seq & (RESULT_RING_CAPACITY - 1)];
+}
+
+/**
+ * @brief Copy the result with sequence seq out of its slot
+ *
+ * @return false if the slot holds another sequence or was rewritten meanwhile
+ */
+static bool read_slot(const result_ring_t *ring, uint32_t seq, pose_result_t *out)
+{
+    const result_ring_slot_t *slot = &ring->slots[seq & (RESULT_RING_CAPACITY - 1)];
+    uint32_t expected = seq * 2;
+    uint32_t words[RESULT_RING_WORDS];
+
+    if (__atomic_load_n(&slot->stamp, __ATOMIC_ACQUIRE) != expected) {
+        return false;
+    }
+    for (size_t i = 0; i < RESULT_RING_WORDS; i++) {
+        words[i] = __atomic_load_n(&slot->words[i], __ATOMIC_RELAXED);
+    }
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (__atomic_load_n(&slot->stamp, __ATOMIC_RELAXED) != expected) {
+        return false;
+    }
+
+    memcpy(out, words, sizeof(pose_result_t));
+    return true;
+}
+
+void result_ring_init(result_ring_t *ring)
+{
+    memset(ring, 0, sizeof(*ring));
+}
+
+uint32_t result_ring_publish(result_ring_t *ring, const pose_result_t *result)
+{
+    uint32_t seq = __atomic_load_n(&ring->published, __ATOMIC_RELAXED) + 1;
+    result_ring_slot_t *slot = slot_for(ring, seq);
+
+    pose_result_t stored = *result;
+    stored.sequence = seq;
+    uint32_t words[RESULT_RING_WORDS] = {0};
+    memcpy(words, &stored, sizeof(pose_result_t));
+
+    // Odd stamp: readers that race with the copy below discard what they read
+    __atomic_store_n(&slot->stamp, seq * 2 - 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    for (size_t i = 0; i < RESULT_RING_WORDS; i++) {
+        __atomic_store_n(&slot->words[i], words[i], __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&slot->stamp, seq * 2, __ATOMIC_RELEASE);
+    __atomic_store_n(&ring->published, seq, __ATOMIC_RELEASE);
+    return seq;
+}
+
+uint32_t result_ring_sequence(const result_ring_t *ring)
+{
+    return __atomic_load_n(&ring->published, __ATOMIC_ACQUIRE);
+}
+
+bool result_ring_latest(const result_ring_t *ring, pose_result_t *out)
+{
+    // Only fails if the writer laps the whole ring during one copy
+    for (int attempt = 0; attempt < RESULT_RING_CAPACITY; attempt++) {
+        uint32_t seq = __atomic_load_n(&ring->published, __ATOMIC_ACQUIRE);
+        if (seq == 0) {
+            return false;
+        }
+        if (read_slot(ring, seq, out)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int result_ring_read_since(const result_ring_t *ring, uint32_t since_seq,
+                           pose_result_t *out, int max_results, uint32_t *lost)
+{
+    uint32_t newest = __atomic_load_n(&ring->published, __ATOMIC_ACQUIRE);
+    uint32_t skipped = 0;
+    int count = 0;
+
+    if (since_seq < newest) {
+        uint32_t first = since_seq + 1;
+        uint32_t oldest = newest >= RESULT_RING_CAPACITY ? newest - RESULT_RING_CAPACITY + 1 : 1;
+        if (first < oldest) {
+            skipped += oldest - first;
+            first = oldest;
+        }
+        for (uint32_t seq = first; seq <= newest && count < max_results; seq++) {
+            if (read_slot(ring, seq, &out[count])) {
+                count++;
+            } else {
+                skipped++;  // Overwritten while we were reading
+            }
+        }
+    }
+
+    if (lost != NULL) {
+        *lost = skipped;
+    }
+    return count;
+}
@@ -0,0 +1,106 @@
+/**
+ * @file result_ring.h
+ * @brief Lock-free publication of pose results with a history ring
+ *
+ * Inference publishes every result into a fixed ring of the last
+ * RESULT_RING_CAPACITY results, each tagged with a sequence number.
+ * Consumers either read the latest result or fetch everything published
+ * since the last sequence they saw, so a slow poller no longer misses short
+ * transitions (e.g. a brief "moving" between two "present" windows).
+ *
+ * Concurrency:
+ * -----------
+ * One writer, any number of readers, no locks. Each slot is a seqlock: the
+ * writer marks the slot busy, copies the result and stamps it with its
+ * sequence number; a reader copies the slot and keeps the copy only if the
+ * stamp was the expected one before and after. The writer never waits, and
+ * with at least three slots it never touches the slot readers are most
+ * likely copying (the latest), which is what a triple buffer guarantees.
+ * Readers retry or report results as lost only when they fall a whole ring
+ * behind.
+ *
+ * Payloads are copied word by word with relaxed atomics, so concurrent
+ * reads are well defined C11 (and clean under ThreadSanitizer on the host).
+ */
+
+#ifndef RESULT_RING_H
+#define RESULT_RING_H
+
+#include "pose_inference.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Results kept (power of two)
+#define RESULT_RING_CAPACITY 32
+
+#define RESULT_RING_WORDS ((sizeof(pose_result_t) + 3) / 4)
+
+/**
+ * @brief One ring slot
+ */
+typedef struct {
+    uint32_t stamp;                    // 2*seq while valid, odd while being written
+    uint32_t words[RESULT_RING_WORDS]; // pose_result_t payload
+} result_ring_slot_t;
+
+/**
+ * @brief Ring state (treat as opaque)
+ */
+typedef struct {
+    uint32_t published;                // Sequence of the newest complete result (0 = none)
+    result_ring_slot_t slots[RESULT_RING_CAPACITY];
+} result_ring_t;
+
+/**
+ * @brief Reset the ring (not thread safe)
+ */
+void result_ring_init(result_ring_t *ring);
+
+/**
+ * @brief Publish a result (single writer)
+ *
+ * Sets result->sequence in the stored copy.
+ *
+ * @return Sequence number assigned to the result
+ */
+uint32_t result_ring_publish(result_ring_t *ring, const pose_result_t *result);
+
+/**
+ * @brief Sequence number of the newest published result (0 = none yet)
+ */
+uint32_t result_ring_sequence(const result_ring_t *ring);
+
+/**
+ * @brief Copy the newest result
+ *
+ * @return false if nothing has been published yet
+ */
+bool result_ring_latest(const result_ring_t *ring, pose_result_t *out);
+
+/**
+ * @brief Copy every result published after since_seq, oldest first
+ *
+ * Pass the sequence of the last result already seen (0 for everything
+ * still in the ring). Results that were overwritten before they could be
+ * read are skipped and counted in *lost. Every sequence from since_seq + 1
+ * to since_seq + count + lost is accounted for, so continue from there.
+ *
+ * @param ring        Ring
+ * @param since_seq   Last sequence already seen
+ * @param out         Output array
+ * @param max_results Capacity of out
+ * @param lost        Output: results skipped because they were overwritten (may be NULL)
+ * @return Number of results copied
+ */
+int result_ring_read_since(const result_ring_t *ring, uint32_t since_seq,
+                           pose_result_t *out, int max_results, uint32_t *lost);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RESULT_RING_H
@@ -0,0 +1,309 @@
+/**
+ * @file serial_console.c
+ * @brief Command console on the serial port
+ */
+
+#include "serial_console.h"
+#include "pose_inference.h"
+#include "wifi_csi.h"
+#include "mem_metrics.h"
+#include "esp_log.h"
+#include "esp_system.h"
+#include "driver/uart.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "nvs.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char *TAG = "serial_console";
+
+// NVS location of the saved settings
+#define NVS_NAMESPACE "pose"
+#define NVS_KEY "console"
+
+// Saved settings text ("key=value" lines)
+#define SAVED_MAX 512
+
+// Below the WiFi, CSI and traffic tasks: commands can wait
+#define CONSOLE_TASK_PRIORITY 1
+#define CONSOLE_TASK_STACK 4096
+
+// Receive buffer of the UART driver, and how long a read waits
+#define UART_RX_BUFFER 256
+#define UART_READ_MS 100
+
+static const char *const s_class_names[POSE_CLASS_BINS] = {
+    "empty", "present", "moving", "walking", "sitting", "standing", "unknown",
+};
+
+// Owned by the console task once it runs
+static console_settings_t s_defaults;
+static console_settings_t s_settings;
+static serial_console_apply_t s_apply = NULL;
+static console_line_t s_line;
+
+/**
+ * @brief Read the saved settings on top of settings
+ */
+static esp_err_t load_saved(console_settings_t *settings)
+{
+    nvs_handle_t nvs;
+    esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READONLY, &nvs);
+    if (err != ESP_OK) {
+        return err;
+    }
+    char text[SAVED_MAX];
+    size_t len = sizeof(text);
+    err = nvs_get_str(nvs, NVS_KEY, text, &len);
+    nvs_close(nvs);
+    if (err != ESP_OK) {
+        return err;
+    }
+    return console_settings_load(settings, text);
+}
+
+static esp_err_t save_settings(const console_settings_t *settings)
+{
+    char text[SAVED_MAX];
+    if (console_settings_save(settings, text, sizeof(text)) == 0) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    nvs_handle_t nvs;
+    esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs);
+    if (err != ESP_OK) {
+        return err;
+    }
+    err = nvs_set_str(nvs, NVS_KEY, text);
+    if (err == ESP_OK) {
+        err = nvs_commit(nvs);
+    }
+    nvs_close(nvs);
+    return err;
+}
+
+/**
+ * @brief Apply settings and make them current, or keep the current ones
+ */
+static esp_err_t switch_to(const console_settings_t *settings)
+{
+    esp_err_t err = s_apply(settings);
+    if (err == ESP_OK) {
+        s_settings = *settings;
+    }
+    return err;
+}
+
+static void reply_error(const char *message, const char *detail)
+{
+    printf("{\"console\":\"error\",\"message\":\"%s%s\"}\n", message, detail);
+}
+
+static void reply_settings(const char *status, int key)
+{
+    char fields[512];
+    console_settings_json(&s_settings, key, fields, sizeof(fields));
+    printf("{\"console\":\"%s\",%s}\n", status, fields);
+}
+
+static void print_help(void)
+{
+    printf("{\"console\":\"help\",\"commands\":[\"help\",\"get [key]\",\"set <key> <value>\","
+           "\"save\",\"load\",\"defaults\",\"stats\",\"hist\"]}\n");
+    for (int k = 0; k < console_key_count(); k++) {
+        printf("{\"console\":\"help\",\"key\":\"%s\",\"help\":\"%s\"}\n", console_key_name(k),
+               console_key_help(k));
+    }
+}
+
+static void print_stats(void)
+{
+    pose_histograms_t hist;
+    uint32_t inferences;
+    float avg_latency_ms;
+    uint32_t received, processed;
+    csi_pool_stats_t pool;
+
+    pose_get_histograms(&hist);
+    pose_get_stats(&inferences, &avg_latency_ms);
+    wifi_csi_get_stats(&received, &processed);
+    wifi_csi_get_pool_stats(&pool);
+
+    printf("{\"console\":\"stats\",\"windows\":%lu,\"reused\":%lu,\"events\":%lu,"
+           "\"avg_latency_ms\":%.2f,\"deadline_misses\":%lu,\"degrade_level\":%u,"
+           "\"csi_received\":%lu,\"csi_processed\":%lu,"
+           "\"pool_in_use\":%lu,\"pool_peak\":%lu,\"pool_exhausted\":%lu,"
+           "\"free_heap\":%lu,\"min_free_heap\":%lu,\"models\":[",
+           hist.windows, hist.reused, hist.events, avg_latency_ms, hist.deadline_misses,
+           hist.degrade_level, received, processed,
+           pool.in_use, pool.peak_in_use, pool.exhausted, esp_get_free_heap_size(),
+           esp_get_minimum_free_heap_size());
+
+    // Cadence, latency and CPU share of each model on the window ring
+    model_sched_stats_t models[MODEL_SCHED_MAX_TASKS];
+    int num_models = pose_get_model_stats(models, MODEL_SCHED_MAX_TASKS);
+    for (int m = 0; m < num_models; m++) {
+        printf("%s{\"name\":\"%s\",\"runs\":%lu,\"interval_ms\":%.1f,\"avg_us\":%.0f,"
+               "\"max_us\":%lu,\"cpu_pct\":%.2f}",
+               m > 0 ? "," : "", models[m].name, models[m].runs, models[m].interval_ms,
+               models[m].avg_us, models[m].max_us, models[m].cpu_share * 100.0f);
+    }
+    printf("]}\n");
+
+    // Heaps by capability, task stack high-water marks and arena usage per
+    // module, ending with its own mem_stats JSON line
+    mem_metrics_print();
+}
+
+static void print_histograms(void)
+{
+    pose_histograms_t hist;
+    pose_get_histograms(&hist);
+
+    // Bucket b counts latencies below 128us << b; the last one has no bound
+    printf("{\"console\":\"hist\",\"latency_below_us\":[");
+    for (int b = 0; b < POSE_LATENCY_BUCKETS - 1; b++) {
+        printf("%s%lu", b > 0 ? "," : "", 128UL << b);
+    }
+    printf("],\"latency\":[");
+    for (int b = 0; b < POSE_LATENCY_BUCKETS; b++) {
+        printf("%s%lu", b > 0 ? "," : "", hist.latency[b]);
+    }
+    printf("],\"classes\":{");
+    for (int c = 0; c < POSE_CLASS_BINS; c++) {
+        printf("%s\"%s\":%lu", c > 0 ? "," : "", s_class_names[c], hist.classes[c]);
+    }
+    printf("},\"level_windows\":[");
+    for (int l = 0; l < DEADLINE_LEVELS; l++) {
+        printf("%s%lu", l > 0 ? "," : "", hist.level_windows[l]);
+    }
+    printf("]}\n");
+}
+
+static void run_command(char *line)
+{
+    console_command_t cmd;
+    esp_err_t err = console_parse(line, &cmd);
+    if (err == ESP_ERR_INVALID_ARG) {
+        reply_error("wrong arguments, try help", "");
+        return;
+    }
+    if (err != ESP_OK) {
+        reply_error("unknown command or key, try help", "");
+        return;
+    }
+
+    switch (cmd.cmd) {
+        case CONSOLE_CMD_HELP:
+            print_help();
+            break;
+        case CONSOLE_CMD_GET:
+            reply_settings("settings", cmd.key);
+            break;
+        case CONSOLE_CMD_SET: {
+            console_settings_t next = s_settings;
+            if (console_settings_set(&next, cmd.key, cmd.value) != ESP_OK) {
+                reply_error("bad value for ", console_key_name(cmd.key));
+            } else if (switch_to(&next) != ESP_OK) {
+                reply_error("rejected by the pipeline: ", console_key_name(cmd.key));
+            } else {
+                reply_settings("ok", cmd.key);
+            }
+            break;
+        }
+        case CONSOLE_CMD_SAVE:
+            err = save_settings(&s_settings);
+            if (err != ESP_OK) {
+                reply_error("save failed: ", esp_err_to_name(err));
+            } else {
+                printf("{\"console\":\"ok\",\"saved\":true}\n");
+            }
+            break;
+        case CONSOLE_CMD_LOAD: {
+            console_settings_t next = s_defaults;
+            err = load_saved(&next);
+            if (err != ESP_OK) {
+                reply_error("nothing saved: ", esp_err_to_name(err));
+            } else if (switch_to(&next) != ESP_OK) {
+                reply_error("saved settings rejected by the pipeline", "");
+            } else {
+                reply_settings("settings", -1);
+            }
+            break;
+        }
+        case CONSOLE_CMD_DEFAULTS:
+            switch_to(&s_defaults);
+            reply_settings("settings", -1);
+            break;
+        case CONSOLE_CMD_STATS:
+            print_stats();
+            break;
+        case CONSOLE_CMD_HIST:
+            print_histograms();
+            break;
+    }
+    fflush(stdout);
+}
+
+#ifdef CONFIG_ESP_CONSOLE_UART
+static void console_task(void *arg)
+{
+    uint8_t buf[64];
+
+    while (1) {
+        // Returns what arrived within UART_READ_MS, so a command never waits for a full buffer
+        int n = uart_read_bytes(CONFIG_ESP_CONSOLE_UART_NUM, buf, sizeof(buf),
+                                pdMS_TO_TICKS(UART_READ_MS));
+        for (int i = 0; i < n; i++) {
+            if (!console_line_push(&s_line, (char)buf[i])) {
+                continue;
+            }
+            if (s_line.overflow) {
+                reply_error("line too long", "");
+                fflush(stdout);
+            } else {
+                run_command(s_line.buf);
+            }
+        }
+    }
+}
+#endif
+
+esp_err_t serial_console_start(const console_settings_t *defaults, serial_console_apply_t apply)
+{
+    s_defaults = *defaults;
+    s_apply = apply;
+    memset(&s_line, 0, sizeof(s_line));
+
+    console_settings_t saved = s_defaults;
+    esp_err_t err = load_saved(&saved);
+    if (err == ESP_OK && switch_to(&saved) == ESP_OK) {
+        ESP_LOGI(TAG, "Loaded saved settings");
+    } else {
+        if (err == ESP_OK) {
+            ESP_LOGW(TAG, "Saved settings rejected, using defaults");
+        }
+        switch_to(&s_defaults);
+    }
+
+#ifdef CONFIG_ESP_CONSOLE_UART
+    if (!uart_is_driver_installed(CONFIG_ESP_CONSOLE_UART_NUM)) {
+        err = uart_driver_install(CONFIG_ESP_CONSOLE_UART_NUM, UART_RX_BUFFER, 0, 0, NULL, 0);
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "UART driver install failed: %s", esp_err_to_name(err));
+            return err;
+        }
+    }
+    TaskHandle_t task = NULL;
+    xTaskCreate(console_task, "console", CONSOLE_TASK_STACK, NULL, CONSOLE_TASK_PRIORITY, &task);
+    if (task == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    mem_metrics_watch_task(task, "console");
+    ESP_LOGI(TAG, "Console on UART%d, type help", CONFIG_ESP_CONSOLE_UART_NUM);
+    return ESP_OK;
+#else
+    ESP_LOGW(TAG, "Console is not on a UART, commands unavailable");
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
@@ -0,0 +1,56 @@
+/**
+ * @file serial_console.h
+ * @brief Command console on the serial port
+ *
+ * A low-priority task reads the console UART without blocking the CSI
+ * path, assembles lines and runs the commands of console_cmd.h. Every
+ * reply is one JSON line tagged "console", so it can be picked out of the
+ * result stream:
+ *
+ *   > set decimation 5
+ *   {"console":"ok","decimation":5}
+ *   > set smoothing_lag 12
+ *   {"console":"error","message":"bad value for smoothing_lag"}
+ *
+ * A change is made on a copy of the settings and handed to the apply
+ * callback as a whole; pipeline tuning then takes effect together at the
+ * next window (pose_set_tuning()). "save" stores the settings in NVS and
+ * serial_console_start() loads them again at boot.
+ */
+
+#ifndef SERIAL_CONSOLE_H
+#define SERIAL_CONSOLE_H
+
+#include "esp_err.h"
+#include "console_cmd.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Apply a complete set of settings to the running firmware
+ *
+ * @return ESP_OK, or an error if the settings were rejected (nothing applied)
+ */
+typedef esp_err_t (*serial_console_apply_t)(const console_settings_t *settings);
+
+/**
+ * @brief Load the saved settings, apply them and start the console task
+ *
+ * Settings saved in NVS override defaults; if there are none, or they
+ * cannot be applied, defaults are applied instead. NVS must be initialized.
+ *
+ * @param defaults Boot defaults (also what "defaults" goes back to)
+ * @param apply    Applies settings; called from this function and then
+ *                 from the console task
+ * @return ESP_OK, ESP_ERR_NOT_SUPPORTED if the console is not on a UART
+ *         (settings are still applied), or an error from the UART driver
+ */
+esp_err_t serial_console_start(const console_settings_t *defaults, serial_console_apply_t apply);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SERIAL_CONSOLE_H
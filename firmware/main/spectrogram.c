@@ -0,0 +1,153 @@
+/**
+ * @file spectrogram.c
+ * @brief Rolling CSI amplitude spectrogram from a sliding DFT
+ */
+
+#include "spectrogram.h"
+#include <math.h>
+#include <string.h>
+
+// Bins tracked per subcarrier: the K output bins and one on either side
+#define TRACKED(config) ((config)->num_bins + 2)
+
+bool spectrogram_config_valid(const spectrogram_config_t *config)
+{
+    return config->dft_len >= 8 && config->dft_len % 4 == 0 && config->first_bin >= 1 &&
+           config->num_bins >= 1 && config->first_bin + config->num_bins < config->dft_len / 2 &&
+           config->num_subcarriers >= 1 && config->hop >= 1 && config->columns >= 1 &&
+           config->anchor_interval >= 0;
+}
+
+bool spectrogram_init(spectrogram_t *sg, const spectrogram_config_t *config, void *storage)
+{
+    if (!spectrogram_config_valid(config) || storage == NULL) {
+        return false;
+    }
+    memset(sg, 0, sizeof(*sg));
+    sg->config = *config;
+
+    const int n = config->dft_len;
+    const int subs = config->num_subcarriers;
+    memset(storage, 0, SPECTROGRAM_STORAGE_BYTES(n, config->num_bins, subs, config->columns));
+    sg->history = storage;
+    sg->bins = sg->history + (size_t)subs * n;
+    sg->step = sg->bins + (size_t)subs * TRACKED(config) * 2;
+    sg->cos_table = sg->step + TRACKED(config) * 2;
+    sg->ring = sg->cos_table + n;
+    for (int m = 0; m < n; m++) {
+        sg->cos_table[m] = cosf(2.0f * (float)M_PI * m / n);
+    }
+    for (int b = 0; b < TRACKED(config); b++) {
+        int k = config->first_bin - 1 + b;
+        sg->step[2 * b] = sg->cos_table[k];
+        sg->step[2 * b + 1] = sg->cos_table[(k + 3 * n / 4) % n];  // sin(x) = cos(x - π/2)
+    }
+    return true;
+}
+
+void spectrogram_reanchor(spectrogram_t *sg, int sub)
+{
+    const spectrogram_config_t *c = &sg->config;
+    const int n = c->dft_len;
+    const float *x = &sg->history[(size_t)sub * n];
+    float *bins = &sg->bins[(size_t)sub * TRACKED(c) * 2];
+
+    // X_k = sum over m of x(oldest + m) e^(-j2πkm/N)
+    for (int b = 0; b < TRACKED(c); b++) {
+        int k = c->first_bin - 1 + b;
+        float re = 0.0f, im = 0.0f;
+        int slot = sg->pos;
+        int km = 0;                    // k * m mod N
+        for (int m = 0; m < n; m++) {
+            re += x[slot] * sg->cos_table[km];
+            im -= x[slot] * sg->cos_table[(km + 3 * n / 4) % n];
+            if (++slot == n) {
+                slot = 0;
+            }
+            km += k;
+            if (km >= n) {
+                km -= n;
+            }
+        }
+        bins[2 * b] = re;
+        bins[2 * b + 1] = im;
+    }
+    sg->anchors++;
+}
+
+void spectrogram_magnitudes(const spectrogram_t *sg, int sub, float *out)
+{
+    const spectrogram_config_t *c = &sg->config;
+    const float *bins = &sg->bins[(size_t)sub * TRACKED(c) * 2];
+    const float scale = 1.0f / c->dft_len;
+    for (int k = 0; k < c->num_bins; k++) {
+        const float *x = &bins[2 * (k + 1)];
+        float re = x[0], im = x[1];
+        if (c->hann) {
+            re = 0.5f * re - 0.25f * (x[-2] + x[2]);
+            im = 0.5f * im - 0.25f * (x[-1] + x[3]);
+        }
+        out[k] = sqrtf(re * re + im * im) * scale;
+    }
+}
+
+bool spectrogram_push(spectrogram_t *sg, const float *amplitude, int num_subcarriers)
+{
+    const spectrogram_config_t *c = &sg->config;
+    const int n = c->dft_len;
+    const int subs = c->num_subcarriers;
+    const int tracked = TRACKED(c);
+
+    for (int s = 0; s < subs; s++) {
+        float *x = &sg->history[(size_t)s * n];
+        float sample = amplitude[s * num_subcarriers / subs];
+        float delta = sample - x[sg->pos];
+        x[sg->pos] = sample;
+
+        // X_k = e^(j2πk/N) * (X_k + x(n) - x(n-N))
+        float *bins = &sg->bins[(size_t)s * tracked * 2];
+        for (int b = 0; b < tracked; b++) {
+            float wr = sg->step[2 * b], wi = sg->step[2 * b + 1];
+            float re = bins[2 * b] + delta;
+            float im = bins[2 * b + 1];
+            bins[2 * b] = re * wr - im * wi;
+            bins[2 * b + 1] = re * wi + im * wr;
+        }
+    }
+    if (++sg->pos == n) {
+        sg->pos = 0;
+    }
+    sg->samples++;
+
+    if (c->anchor_interval > 0 && ++sg->anchor_phase >= c->anchor_interval) {
+        sg->anchor_phase = 0;
+        spectrogram_reanchor(sg, sg->anchor_next);
+        sg->anchor_next = (sg->anchor_next + 1) % subs;
+    }
+
+    // Columns start once the DFT spans N real samples
+    if (sg->samples < (uint32_t)n || ++sg->hop_phase < c->hop) {
+        return false;
+    }
+    sg->hop_phase = 0;
+    float *column = &sg->ring[(size_t)sg->head * subs * c->num_bins];
+    for (int s = 0; s < subs; s++) {
+        spectrogram_magnitudes(sg, s, &column[(size_t)s * c->num_bins]);
+    }
+    sg->head = (sg->head + 1) % c->columns;
+    if (sg->count < c->columns) {
+        sg->count++;
+    }
+    return true;
+}
+
+int spectrogram_read(const spectrogram_t *sg, float *out)
+{
+    const size_t column = (size_t)sg->config.num_subcarriers * sg->config.num_bins;
+    int oldest = (sg->head - sg->count + sg->config.columns) % sg->config.columns;
+    for (int i = 0; i < sg->count; i++) {
+        int col = (oldest + i) % sg->config.columns;
+        memcpy(&out[i * column], &sg->ring[col * column], column * sizeof(float));
+    }
+    return sg->count;
+}
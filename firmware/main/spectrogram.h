@@ -0,0 +1,131 @@
+/**
+ * @file spectrogram.h
+ * @brief Rolling CSI amplitude spectrogram from a sliding DFT
+ *
+ * Motion shows up in CSI amplitude as frequencies of a few Hz. A
+ * spectrogram exposes them directly, but an STFT recomputed every hop
+ * costs a full FFT per subcarrier per hop. Here K bins of an N-point DFT
+ * over the last N samples are kept for S selected subcarriers and
+ * updated per sample in O(K):
+ *
+ *   X_k(n) = e^(j2πk/N) * (X_k(n-1) + x(n) - x(n-N))
+ *
+ * which needs the last N samples of each subcarrier. Every hop samples,
+ * the K magnitudes of each subcarrier are written as one column of a
+ * ring, so the ring always holds the last `columns` hops, oldest first
+ * in spectrogram_read(): a [columns][S][K] model input.
+ *
+ * In float the recursion drifts: rounding in the twiddle and in the
+ * adds is never forgotten. Every anchor_interval samples one subcarrier's
+ * bins are recomputed directly from its N samples (O(N*K)), in turn, so
+ * each subcarrier is re-anchored every S * anchor_interval samples and
+ * the error stays at single-sweep rounding.
+ *
+ * With hann set, two more bins are tracked and the Hann window is applied
+ * in frequency (X[k]/2 - X[k-1]/4 - X[k+1]/4), which equals windowing the
+ * samples before the DFT.
+ *
+ * tools/host/spectrogram_bench compares it with an FFT per hop.
+ */
+
+#ifndef SPECTROGRAM_H
+#define SPECTROGRAM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Storage for a configuration (constant expression)
+ *
+ * History [subs][dft_len], bins [subs][bins + 2][2], update twiddles
+ * [bins + 2][2], cosine table [dft_len], ring [columns][subs][bins], all
+ * float.
+ */
+#define SPECTROGRAM_STORAGE_BYTES(dft_len, bins, subs, columns) \
+    (((size_t)((subs) + 1) * ((bins) + 2) * 2 + (size_t)((subs) + 1) * (dft_len) + \
+      (size_t)(columns) * (subs) * (bins)) * sizeof(float))
+
+/**
+ * @brief Spectrogram configuration
+ */
+typedef struct {
+    int dft_len;               // N, samples per transform (multiple of 4)
+    int first_bin;             // Lowest bin k0 (>= 1; bin k is k * rate / N Hz)
+    int num_bins;              // K, bins k0 .. k0 + K - 1 (below N / 2)
+    int num_subcarriers;       // S, spread evenly over the input
+    int hop;                   // Samples per column
+    int columns;               // Columns kept in the ring
+    int anchor_interval;       // Samples between re-anchors, 0 never re-anchors
+    bool hann;                 // Hann window instead of rectangular
+} spectrogram_config_t;
+
+/**
+ * @brief Spectrogram state
+ */
+typedef struct {
+    spectrogram_config_t config;
+    float *history;            // [S][N] last N samples, slot `pos` is the oldest
+    float *bins;               // [S][K + 2] complex bins k0 - 1 .. k0 + K
+    float *step;               // [K + 2] complex e^(j2πk/N) of the tracked bins
+    float *cos_table;          // cos(2πm/N), m = 0 .. N - 1
+    float *ring;               // [columns][S][K] magnitudes
+    int pos;                   // Next history slot
+    uint32_t samples;          // Samples pushed
+    int hop_phase;             // Samples since the last column
+    int head;                  // Next ring column
+    int count;                 // Valid ring columns
+    int anchor_phase;          // Samples since the last re-anchor
+    int anchor_next;           // Subcarrier re-anchored next
+    uint32_t anchors;          // Re-anchors done
+} spectrogram_t;
+
+/**
+ * @brief Check a configuration
+ */
+bool spectrogram_config_valid(const spectrogram_config_t *config);
+
+/**
+ * @brief Initialize over caller storage
+ *
+ * @param storage SPECTROGRAM_STORAGE_BYTES() bytes, float aligned
+ * @return false if the configuration is invalid
+ */
+bool spectrogram_init(spectrogram_t *sg, const spectrogram_config_t *config, void *storage);
+
+/**
+ * @brief Push one sample of every subcarrier
+ *
+ * @param amplitude       Amplitude of each subcarrier
+ * @param num_subcarriers Subcarriers in amplitude (>= S)
+ * @return true if a column was written
+ */
+bool spectrogram_push(spectrogram_t *sg, const float *amplitude, int num_subcarriers);
+
+/**
+ * @brief Recompute one subcarrier's bins from its last N samples
+ */
+void spectrogram_reanchor(spectrogram_t *sg, int sub);
+
+/**
+ * @brief Current magnitudes of one subcarrier, K values (not yet in the ring)
+ */
+void spectrogram_magnitudes(const spectrogram_t *sg, int sub, float *out);
+
+/**
+ * @brief Copy the ring, oldest column first
+ *
+ * @param out Output [count][S][K]
+ * @return Columns copied (less than `columns` until the ring has filled)
+ */
+int spectrogram_read(const spectrogram_t *sg, float *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SPECTROGRAM_H
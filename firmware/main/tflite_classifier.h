@@ -24,14 +24,26 @@ extern "C" {
 #endif
 
 #include "esp_err.h"
+#include "pose_dims.h"
 #include <stdint.h>
 #include <stddef.h>
+#include <stdbool.h>
 
-// Model input/output dimensions
-#define TFLITE_INPUT_SAMPLES 50      // Temporal window size
-#define TFLITE_INPUT_FEATURES 104    // 52 amplitude + 52 phase
+// Model input/output dimensions (input from the build's pose_dims.h)
+#define TFLITE_INPUT_SAMPLES POSE_WINDOW_SAMPLES     // Temporal window size
+#define TFLITE_INPUT_FEATURES POSE_MODEL_FEATURES    // Amplitude + phase per subcarrier
 #define TFLITE_NUM_CLASSES 6         // Number of pose classes
 
+// Optional keypoint regression head: (x, y, confidence) per keypoint
+#define TFLITE_NUM_KEYPOINTS 17
+#define TFLITE_KEYPOINT_OUTPUTS (TFLITE_NUM_KEYPOINTS * 3)
+
+// Optional coarse DensePose head (uv_map.h): per pixel of a 24x24 map,
+// background + 24 part scores and (U, V)
+#define TFLITE_UV_MAP_SIZE 24
+#define TFLITE_UV_PART_OUTPUTS (TFLITE_UV_MAP_SIZE * TFLITE_UV_MAP_SIZE * 25)
+#define TFLITE_UV_COORD_OUTPUTS (TFLITE_UV_MAP_SIZE * TFLITE_UV_MAP_SIZE * 2)
+
 /**
  * @brief Initialize TFLite Micro classifier
  *
@@ -83,6 +95,69 @@ esp_err_t tflite_classifier_get_output_details(size_t *out_size,
                                                 float *out_scale,
                                                 int *out_zero_point);
 
+/**
+ * @brief Check if the loaded model has a keypoint regression head
+ *
+ * Models trained with train_pose_model.py --keypoints have a second output
+ * tensor of TFLITE_KEYPOINT_OUTPUTS int8 values.
+ *
+ * @return true if tflite_classifier_run_keypoints() can be used
+ */
+bool tflite_classifier_has_keypoints(void);
+
+/**
+ * @brief Run inference and read both output heads
+ *
+ * @param input           Input tensor, as for tflite_classifier_run()
+ * @param class_output    Output: TFLITE_NUM_CLASSES int8 class scores
+ * @param keypoint_output Output: TFLITE_KEYPOINT_OUTPUTS int8 values,
+ *                        (x, y, confidence) per keypoint in COCO order
+ *
+ * @return ESP_OK on success, ESP_ERR_NOT_SUPPORTED if the model has no
+ *         keypoint head
+ */
+esp_err_t tflite_classifier_run_keypoints(const int8_t *input, int8_t *class_output,
+                                          int8_t *keypoint_output);
+
+/**
+ * @brief Get keypoint output tensor details
+ *
+ * @param out_size  Output: total size of keypoint tensor in bytes
+ * @param out_scale Output: quantization scale
+ * @param out_zero_point Output: quantization zero point
+ *
+ * @return ESP_OK on success, ESP_ERR_NOT_SUPPORTED if the model has no
+ *         keypoint head
+ */
+esp_err_t tflite_classifier_get_keypoint_details(size_t *out_size,
+                                                  float *out_scale,
+                                                  int *out_zero_point);
+
+/**
+ * @brief Check if the loaded model has a coarse DensePose (part/UV) head
+ *
+ * @return true if tflite_classifier_get_uv_map() can be used
+ */
+bool tflite_classifier_has_uv_map(void);
+
+/**
+ * @brief Get the part/UV outputs of the most recent inference
+ *
+ * Points into the tensor arena (15KB of part scores are not copied), so
+ * the data is only valid until the next tflite_classifier_run*() call.
+ *
+ * @param part_scores    Output: TFLITE_UV_PART_OUTPUTS int8 scores,
+ *                       [pixel][background + 24 parts]
+ * @param uv             Output: TFLITE_UV_COORD_OUTPUTS int8 values, [pixel][U, V]
+ * @param uv_scale       Output: UV tensor quantization scale
+ * @param uv_zero_point  Output: UV tensor quantization zero point
+ *
+ * @return ESP_OK on success, ESP_ERR_NOT_SUPPORTED if the model has no
+ *         part/UV head, ESP_ERR_INVALID_STATE before the first inference
+ */
+esp_err_t tflite_classifier_get_uv_map(const int8_t **part_scores, const int8_t **uv,
+                                       float *uv_scale, int *uv_zero_point);
+
 /**
  * @brief Clean up TFLite resources
  *
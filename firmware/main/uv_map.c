@@ -0,0 +1,215 @@
+/**
+ * @file uv_map.c
+ * @brief Coarse DensePose part/UV maps and their sparse encoding
+ */
+
+#include "uv_map.h"
+#include "pose_record.h"
+#include <math.h>
+#include <stdbool.h>
+#include <string.h>
+
+#define MASK_BITMAP 0
+#define MASK_RUNS 1
+
+// Run lengths below this take one byte
+#define SHORT_RUN 128
+
+void uv_map_lut_init(uv_map_lut_t *lut, float scale, int zero_point)
+{
+    for (int i = 0; i < 256; i++) {
+        float v = fminf(fmaxf((float)((int8_t)i - zero_point) * scale, 0.0f), 1.0f);
+        int level = (int)(v * UV_MAP_UV_LEVELS);
+        lut->level[i] = (uint8_t)(level < UV_MAP_UV_LEVELS ? level : UV_MAP_UV_LEVELS - 1);
+    }
+}
+
+int uv_map_decode_head(const int8_t *part_scores, const int8_t *uv, const uv_map_lut_t *lut,
+                       uv_map_t *map)
+{
+    int foreground = 0;
+    for (int i = 0; i < UV_MAP_PIXELS; i++) {
+        const int8_t *scores = &part_scores[i * (UV_MAP_PARTS + 1)];
+        int best = 0;
+        for (int p = 1; p <= UV_MAP_PARTS; p++) {
+            if (scores[p] > scores[best]) {
+                best = p;
+            }
+        }
+        map->part[i] = (uint8_t)best;
+        if (best != 0) {
+            map->u[i] = lut->level[(uint8_t)uv[2 * i]];
+            map->v[i] = lut->level[(uint8_t)uv[2 * i + 1]];
+            foreground++;
+        } else {
+            map->u[i] = 0;
+            map->v[i] = 0;
+        }
+    }
+    return foreground;
+}
+
+static size_t run_bytes(int run)
+{
+    return run < SHORT_RUN ? 1 : 2;
+}
+
+static uint8_t *put_run(uint8_t *p, int run)
+{
+    if (run < SHORT_RUN) {
+        *p++ = (uint8_t)run;
+    } else {
+        *p++ = (uint8_t)(0x80 | (run >> 8));
+        *p++ = (uint8_t)run;
+    }
+    return p;
+}
+
+/**
+ * @brief Foreground count and size of the run-length mask
+ */
+static size_t measure_runs(const uv_map_t *map, int *foreground)
+{
+    size_t bytes = 0;
+    int run = 0, count = 0;
+    bool fg = false;
+    for (int i = 0; i < UV_MAP_PIXELS; i++) {
+        bool pixel_fg = map->part[i] != 0;
+        count += pixel_fg;
+        if (pixel_fg != fg) {
+            bytes += run_bytes(run);
+            run = 0;
+            fg = pixel_fg;
+        }
+        run++;
+    }
+    *foreground = count;
+    return bytes + run_bytes(run);
+}
+
+size_t uv_map_encode(const uv_map_t *map, uint32_t sequence, uint8_t *buf, size_t capacity)
+{
+    int foreground;
+    size_t runs = measure_runs(map, &foreground);
+    int encoding = runs < UV_MAP_BITMAP_BYTES ? MASK_RUNS : MASK_BITMAP;
+    size_t mask = encoding == MASK_RUNS ? runs : UV_MAP_BITMAP_BYTES;
+    size_t payload = UV_MAP_HEADER_BYTES + mask + 2 * (size_t)foreground;
+
+    uint8_t *p = pose_record_begin(buf, capacity, POSE_RECORD_TYPE_UV_MAP, payload);
+    if (p == NULL) {
+        return 0;
+    }
+    p[0] = (uint8_t)sequence;
+    p[1] = (uint8_t)(sequence >> 8);
+    p[2] = (uint8_t)(sequence >> 16);
+    p[3] = (uint8_t)(sequence >> 24);
+    p[4] = UV_MAP_SIZE;
+    p[5] = (uint8_t)encoding;
+    p[6] = (uint8_t)foreground;
+    p[7] = (uint8_t)(foreground >> 8);
+    p += UV_MAP_HEADER_BYTES;
+
+    if (encoding == MASK_RUNS) {
+        int run = 0;
+        bool fg = false;
+        for (int i = 0; i < UV_MAP_PIXELS; i++) {
+            bool pixel_fg = map->part[i] != 0;
+            if (pixel_fg != fg) {
+                p = put_run(p, run);
+                run = 0;
+                fg = pixel_fg;
+            }
+            run++;
+        }
+        p = put_run(p, run);
+    } else {
+        memset(p, 0, UV_MAP_BITMAP_BYTES);
+        for (int i = 0; i < UV_MAP_PIXELS; i++) {
+            if (map->part[i] != 0) {
+                p[i >> 3] |= (uint8_t)(1u << (i & 7));
+            }
+        }
+        p += UV_MAP_BITMAP_BYTES;
+    }
+
+    for (int i = 0; i < UV_MAP_PIXELS; i++) {
+        if (map->part[i] != 0) {
+            uint16_t packed = (uint16_t)((map->part[i] & 0x1F) | ((map->u[i] & 0x1F) << 5) |
+                                         ((map->v[i] & 0x1F) << 10));
+            *p++ = (uint8_t)packed;
+            *p++ = (uint8_t)(packed >> 8);
+        }
+    }
+    return pose_record_finish(buf);
+}
+
+esp_err_t uv_map_decode(const uint8_t *payload, size_t len, uv_map_t *map, uint32_t *sequence)
+{
+    if (len < UV_MAP_HEADER_BYTES || payload[4] != UV_MAP_SIZE) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *sequence = payload[0] | (payload[1] << 8) | (payload[2] << 16) | ((uint32_t)payload[3] << 24);
+    int encoding = payload[5];
+    int foreground = payload[6] | (payload[7] << 8);
+    const uint8_t *p = payload + UV_MAP_HEADER_BYTES;
+    const uint8_t *end = payload + len;
+
+    // Mask: part 1 marks foreground until the pixel data fills it in
+    memset(map, 0, sizeof(*map));
+    if (encoding == MASK_RUNS) {
+        int pixel = 0;
+        bool fg = false;
+        while (pixel < UV_MAP_PIXELS) {
+            if (p >= end) {
+                return ESP_ERR_INVALID_ARG;
+            }
+            int run = *p++;
+            if (run >= SHORT_RUN) {
+                if (p >= end) {
+                    return ESP_ERR_INVALID_ARG;
+                }
+                run = ((run & 0x7F) << 8) | *p++;
+            }
+            if (run > UV_MAP_PIXELS - pixel) {
+                return ESP_ERR_INVALID_ARG;
+            }
+            if (fg) {
+                memset(&map->part[pixel], 1, run);
+            }
+            pixel += run;
+            fg = !fg;
+        }
+    } else if (encoding == MASK_BITMAP) {
+        if ((size_t)(end - p) < UV_MAP_BITMAP_BYTES) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        for (int i = 0; i < UV_MAP_PIXELS; i++) {
+            map->part[i] = (p[i >> 3] >> (i & 7)) & 1;
+        }
+        p += UV_MAP_BITMAP_BYTES;
+    } else {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (end - p != 2 * foreground) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    int seen = 0;
+    for (int i = 0; i < UV_MAP_PIXELS; i++) {
+        if (map->part[i] == 0) {
+            continue;
+        }
+        if (++seen > foreground) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        uint16_t packed = (uint16_t)(p[0] | (p[1] << 8));
+        p += 2;
+        map->part[i] = packed & 0x1F;
+        map->u[i] = (packed >> 5) & 0x1F;
+        map->v[i] = (packed >> 10) & 0x1F;
+        if (map->part[i] == 0 || map->part[i] > UV_MAP_PARTS) {
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+    return seen == foreground ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
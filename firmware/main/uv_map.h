@@ -0,0 +1,130 @@
+/**
+ * @file uv_map.h
+ * @brief Coarse DensePose part/UV maps and their sparse encoding
+ *
+ * DensePose from WiFi predicts, per image pixel, a body part index and the
+ * (U, V) position on that part's surface. At full resolution that is far too
+ * much for an ESP32 to emit, so the optional model head predicts a coarse
+ * UV_MAP_SIZE x UV_MAP_SIZE map:
+ *
+ *   part scores [pixel][UV_MAP_PARTS + 1]  (int8, index 0 = background)
+ *   UV          [pixel][2]                 (int8 sigmoid outputs)
+ *
+ * uv_map_decode_head() reduces that to a uv_map_t of part indices and 5-bit
+ * U/V levels. uv_map_encode() then writes a POSE_RECORD_TYPE_UV_MAP record
+ * (pose_record.h) holding only the foreground:
+ *
+ *   offset size  field
+ *        0    4  sequence of the pose result the map belongs to
+ *        4    1  map size (UV_MAP_SIZE)
+ *        5    1  mask encoding: 0 = bitmap, 1 = run lengths
+ *        6    2  foreground pixel count n
+ *        8    m  foreground mask, raster order:
+ *                  bitmap: UV_MAP_PIXELS bits, LSB first
+ *                  run lengths: alternating background / foreground run
+ *                  lengths starting with background, each 1 byte (< 128)
+ *                  or 2 bytes (0x80 | high bits, low byte)
+ *      8+m   2n  per foreground pixel, little-endian:
+ *                  part (bits 0-4) | U (bits 5-9) | V (bits 10-14)
+ *
+ * The shorter mask encoding is used, so a person-sized blob costs a few
+ * dozen mask bytes. The worst case (every pixel foreground) is
+ * 8 + 72 + 1152 bytes, still one record and one UDP datagram.
+ * tools/pose_record.py decodes and renders these records.
+ */
+
+#ifndef UV_MAP_H
+#define UV_MAP_H
+
+#include "esp_err.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Map resolution (pixels per side)
+#define UV_MAP_SIZE 24
+#define UV_MAP_PIXELS (UV_MAP_SIZE * UV_MAP_SIZE)
+
+// DensePose body parts (1..UV_MAP_PARTS; 0 = background)
+#define UV_MAP_PARTS 24
+
+// U/V quantization levels (5 bits)
+#define UV_MAP_UV_LEVELS 32
+
+// Fixed part of the record payload and its largest size
+#define UV_MAP_HEADER_BYTES 8
+#define UV_MAP_BITMAP_BYTES ((UV_MAP_PIXELS + 7) / 8)
+#define UV_MAP_MAX_PAYLOAD (UV_MAP_HEADER_BYTES + UV_MAP_BITMAP_BYTES + 2 * UV_MAP_PIXELS)
+
+/**
+ * @brief Coarse part/UV map (1728 bytes)
+ */
+typedef struct {
+    uint8_t part[UV_MAP_PIXELS];   // Body part, 0 = background
+    uint8_t u[UV_MAP_PIXELS];      // U level, 0..UV_MAP_UV_LEVELS-1
+    uint8_t v[UV_MAP_PIXELS];      // V level, 0..UV_MAP_UV_LEVELS-1
+} uv_map_t;
+
+/**
+ * @brief Lookup table from int8 UV outputs to U/V levels
+ */
+typedef struct {
+    uint8_t level[256];            // Indexed by (uint8_t)q
+} uv_map_lut_t;
+
+/**
+ * @brief Build the UV lookup table for the UV output tensor
+ *
+ * @param lut        Output table
+ * @param scale      UV tensor quantization scale
+ * @param zero_point UV tensor quantization zero point
+ */
+void uv_map_lut_init(uv_map_lut_t *lut, float scale, int zero_point);
+
+/**
+ * @brief Turn the int8 head outputs into a map
+ *
+ * The part is the highest-scoring class of each pixel (quantization keeps
+ * the order, so no dequantization is needed); U/V are kept for foreground
+ * pixels only.
+ *
+ * @param part_scores [UV_MAP_PIXELS][UV_MAP_PARTS + 1] int8 scores
+ * @param uv          [UV_MAP_PIXELS][2] int8 U, V
+ * @param lut         Table from uv_map_lut_init()
+ * @param map         Output map
+ * @return Number of foreground pixels
+ */
+int uv_map_decode_head(const int8_t *part_scores, const int8_t *uv, const uv_map_lut_t *lut,
+                       uv_map_t *map);
+
+/**
+ * @brief Encode a map as a complete POSE_RECORD_TYPE_UV_MAP record
+ *
+ * @param map      Map to encode (U/V of background pixels are ignored)
+ * @param sequence Sequence of the pose result it belongs to
+ * @param buf      Output buffer
+ * @param capacity Size of buf (POSE_RECORD_HEADER_BYTES + UV_MAP_MAX_PAYLOAD
+ *                 + POSE_RECORD_CRC_BYTES always fits)
+ * @return Record size in bytes, or 0 if buf is too small
+ */
+size_t uv_map_encode(const uv_map_t *map, uint32_t sequence, uint8_t *buf, size_t capacity);
+
+/**
+ * @brief Decode the payload of a POSE_RECORD_TYPE_UV_MAP record
+ *
+ * @param payload  Payload from pose_record_parse()
+ * @param len      Payload size
+ * @param map      Output map (U/V of background pixels zeroed)
+ * @param sequence Output: sequence of the pose result
+ * @return ESP_OK, or ESP_ERR_INVALID_ARG if the payload is malformed
+ */
+esp_err_t uv_map_decode(const uint8_t *payload, size_t len, uv_map_t *map, uint32_t *sequence);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UV_MAP_H
@@ -17,10 +17,21 @@
  * - Amplitude = sqrt(I² + Q²)  -- signal strength
  * - Phase = atan2(Q, I)        -- signal timing
  *
+ * With CONFIG_POSE_FIXED_POINT both come from an integer CORDIC instead
+ * (csi_fixed_iq()), as int16 that pose_process_csi_q() buffers directly.
+ *
  * Human bodies affect both amplitude (absorption) and phase (reflection/delay).
+ *
+ * Record Flow:
+ * -----------
+ * Processed records come from a lock-free pool carved from the memory arena.
+ * The receive callback fills a record in place and passes it by pointer to
+ * the latest-record slot and the user callback, so nothing the size of a
+ * csi_data_t is ever on the WiFi task stack or copied.
  */
 
 #include "wifi_csi.h"
+#include "csi_fixed.h"
 #include "esp_wifi.h"
 #include "esp_log.h"
 #include "esp_timer.h"
@@ -32,6 +43,9 @@
 
 static const char *TAG = "wifi_csi";
 
+// Records in flight: latest slot + user callback + retained by consumers
+#define CSI_POOL_RECORDS 8
+
 // CSI configuration
 // These settings control what CSI data we receive
 static wifi_csi_config_t csi_config = {
@@ -47,7 +61,9 @@ static wifi_csi_config_t csi_config = {
 
 // State variables
 static bool s_csi_active = false;
-static csi_data_t s_latest_csi;
+static csi_data_t *s_latest_csi = NULL;
+static csi_pool_t s_pool;
+static csi_data_t *s_pool_records = NULL;
 static SemaphoreHandle_t s_csi_mutex = NULL;
 static csi_callback_t s_user_callback = NULL;
 static void *s_user_ctx = NULL;
@@ -56,6 +72,19 @@ static void *s_user_ctx = NULL;
 static uint32_t s_packets_received = 0;
 static uint32_t s_packets_processed = 0;
 
+// Raw CSI JSON lines on serial (wifi_csi_set_streaming)
+static bool s_streaming = true;
+
+/**
+ * @brief Long-lived buffers of this module
+ *
+ * Records are touched on every packet, so the pool stays in internal SRAM.
+ */
+static const mem_budget_entry_t s_memory_budget[] = {
+    { "csi.records", CSI_POOL_RECORDS * sizeof(csi_data_t), 0, MEM_REGION_INTERNAL,
+      (void **)&s_pool_records },
+};
+
 /**
  * @brief Process raw CSI buffer into amplitude/phase
  *
@@ -76,6 +105,11 @@ static void process_csi_data(const int8_t *raw_buf, uint16_t len, csi_data_t *ou
 
     out->num_subcarriers = num_subcarriers;
 
+#if POSE_FIXED_POINT
+    csi_fixed_iq(raw_buf, num_subcarriers, out->amplitude_q, out->phase_q);
+    csi_fixed_to_float(out->amplitude_q, out->phase_q, num_subcarriers, out->amplitude,
+                       out->phase);
+#else
     for (int i = 0; i < num_subcarriers; i++) {
         // Extract I and Q components
         // Note: These are signed 8-bit values (-128 to 127)
@@ -83,13 +117,14 @@ static void process_csi_data(const int8_t *raw_buf, uint16_t len, csi_data_t *ou
         int8_t Q = raw_buf[i * 2 + 1];
 
         // Calculate amplitude: |H| = sqrt(I² + Q²)
-        // Using float for simplicity; could optimize with fixed-point later
+        // (CONFIG_POSE_FIXED_POINT uses csi_fixed_iq() instead)
         out->amplitude[i] = sqrtf((float)(I * I + Q * Q));
 
         // Calculate phase: angle = atan2(Q, I)
         // Result is in radians, range [-π, π]
         out->phase[i] = atan2f((float)Q, (float)I);
     }
+#endif
 }
 
 /**
@@ -110,55 +145,71 @@ static void wifi_csi_rx_cb(void *ctx, wifi_csi_info_t *info)
         return;
     }
 
-    // Process the CSI data
-    csi_data_t processed;
-    process_csi_data(info->buf, info->len, &processed);
+    // Take a record; if consumers still hold all of them, drop the packet
+    csi_data_t *processed = csi_pool_alloc(&s_pool);
+    if (processed == NULL) {
+        return;
+    }
+
+    // Process the CSI data in place
+    process_csi_data(info->buf, info->len, processed);
 
     // Add metadata
-    processed.rssi = info->rx_ctrl.rssi;
-    processed.timestamp = (uint32_t)(esp_timer_get_time() / 1000);  // Convert to ms
+    processed->rssi = info->rx_ctrl.rssi;
+    memcpy(processed->mac, info->mac, sizeof(processed->mac));
+    processed->timestamp = (uint32_t)(esp_timer_get_time() / 1000);  // Convert to ms
 
-    // Store as latest (thread-safe)
+    // Publish as latest (thread-safe): the slot takes its own reference
     if (xSemaphoreTake(s_csi_mutex, 0) == pdTRUE) {
-        memcpy(&s_latest_csi, &processed, sizeof(csi_data_t));
+        csi_data_t *previous = s_latest_csi;
+        csi_pool_retain(&s_pool, processed);
+        s_latest_csi = processed;
         xSemaphoreGive(s_csi_mutex);
+        if (previous != NULL) {
+            csi_pool_release(&s_pool, previous);
+        }
         s_packets_processed++;
     }
 
     // Call user callback if registered
     if (s_user_callback != NULL) {
-        s_user_callback(&processed, s_user_ctx);
+        s_user_callback(processed, s_user_ctx);
     }
 
     // Stream CSI data over serial in JSON format
     // This allows real-time visualization and analysis on the laptop
     // Format: {"ts":12345,"rssi":-45,"num":64,"amp":[...],"phase":[...]}
-    printf("{\"ts\":%lu,\"rssi\":%d,\"num\":%d,\"amp\":[",
-           processed.timestamp, processed.rssi, processed.num_subcarriers);
-
-    for (int i = 0; i < processed.num_subcarriers; i++) {
-        printf("%.2f%s", processed.amplitude[i],
-               (i < processed.num_subcarriers - 1) ? "," : "");
-    }
-
-    printf("],\"phase\":[");
-    for (int i = 0; i < processed.num_subcarriers; i++) {
-        printf("%.4f%s", processed.phase[i],
-               (i < processed.num_subcarriers - 1) ? "," : "");
+    if (__atomic_load_n(&s_streaming, __ATOMIC_RELAXED)) {
+        printf("{\"ts\":%lu,\"rssi\":%d,\"num\":%d,\"amp\":[",
+               processed->timestamp, processed->rssi, processed->num_subcarriers);
+
+        for (int i = 0; i < processed->num_subcarriers; i++) {
+            printf("%.2f%s", processed->amplitude[i],
+                   (i < processed->num_subcarriers - 1) ? "," : "");
+        }
+
+        printf("],\"phase\":[");
+        for (int i = 0; i < processed->num_subcarriers; i++) {
+            printf("%.4f%s", processed->phase[i],
+                   (i < processed->num_subcarriers - 1) ? "," : "");
+        }
+        printf("]}\n");
     }
-    printf("]}\n");
 
     // Log occasionally for debugging (every 100 packets)
     if (s_packets_received % 100 == 0) {
         ESP_LOGD(TAG, "CSI packet #%lu: %d subcarriers, RSSI=%d dBm",
-                 s_packets_received, processed.num_subcarriers, processed.rssi);
+                 s_packets_received, processed->num_subcarriers, processed->rssi);
 
         // Print first few amplitude values for debugging
         ESP_LOGD(TAG, "Amplitudes[0-4]: %.1f, %.1f, %.1f, %.1f, %.1f",
-                 processed.amplitude[0], processed.amplitude[1],
-                 processed.amplitude[2], processed.amplitude[3],
-                 processed.amplitude[4]);
+                 processed->amplitude[0], processed->amplitude[1],
+                 processed->amplitude[2], processed->amplitude[3],
+                 processed->amplitude[4]);
     }
+
+    // Drop the callback's reference; the latest slot or consumers may still hold it
+    csi_pool_release(&s_pool, processed);
 }
 
 esp_err_t wifi_csi_init(void)
@@ -167,6 +218,14 @@ esp_err_t wifi_csi_init(void)
 
     ESP_LOGI(TAG, "Initializing WiFi CSI collection...");
 
+    // Record pool comes from the memory arena (see wifi_csi_get_memory_budget)
+    ret = csi_pool_init(&s_pool, s_pool_records, CSI_POOL_RECORDS);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "CSI records missing: add wifi_csi_get_memory_budget() to mem_arena_init()");
+        return ESP_ERR_INVALID_STATE;
+    }
+    s_latest_csi = NULL;
+
     // Create mutex for thread-safe access to latest CSI data
     s_csi_mutex = xSemaphoreCreateMutex();
     if (s_csi_mutex == NULL) {
@@ -211,6 +270,12 @@ esp_err_t wifi_csi_deinit(void)
     esp_wifi_set_csi(false);
     esp_wifi_set_csi_rx_cb(NULL, NULL);
 
+    // Return the latest record to the pool
+    if (s_latest_csi != NULL) {
+        csi_pool_release(&s_pool, s_latest_csi);
+        s_latest_csi = NULL;
+    }
+
     // Clean up mutex
     if (s_csi_mutex != NULL) {
         vSemaphoreDelete(s_csi_mutex);
@@ -238,19 +303,51 @@ esp_err_t wifi_csi_get_latest(csi_data_t *data)
         return ESP_ERR_INVALID_ARG;
     }
 
-    if (s_packets_processed == 0) {
+    // Not initialized (or deinitialized): no record to copy
+    if (s_csi_mutex == NULL) {
         return ESP_ERR_NOT_FOUND;
     }
 
     if (xSemaphoreTake(s_csi_mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-        memcpy(data, &s_latest_csi, sizeof(csi_data_t));
+        // The slot is empty until the first packet after wifi_csi_init()
+        esp_err_t ret = ESP_ERR_NOT_FOUND;
+        if (s_latest_csi != NULL) {
+            memcpy(data, s_latest_csi, sizeof(csi_data_t));
+            ret = ESP_OK;
+        }
         xSemaphoreGive(s_csi_mutex);
-        return ESP_OK;
+        return ret;
     }
 
     return ESP_ERR_TIMEOUT;
 }
 
+mem_budget_t wifi_csi_get_memory_budget(void)
+{
+    mem_budget_t budget = {
+        .entries = s_memory_budget,
+        .count = sizeof(s_memory_budget) / sizeof(s_memory_budget[0]),
+    };
+    return budget;
+}
+
+esp_err_t wifi_csi_retain(const csi_data_t *data)
+{
+    return csi_pool_retain(&s_pool, data);
+}
+
+esp_err_t wifi_csi_release(const csi_data_t *data)
+{
+    return csi_pool_release(&s_pool, data);
+}
+
+void wifi_csi_get_pool_stats(csi_pool_stats_t *stats)
+{
+    if (stats != NULL) {
+        csi_pool_get_stats(&s_pool, stats);
+    }
+}
+
 bool wifi_csi_is_active(void)
 {
     return s_csi_active;
@@ -265,3 +362,8 @@ void wifi_csi_get_stats(uint32_t *packets_received, uint32_t *packets_processed)
         *packets_processed = s_packets_processed;
     }
 }
+
+void wifi_csi_set_streaming(bool enable)
+{
+    __atomic_store_n(&s_streaming, enable, __ATOMIC_RELAXED);
+}
@@ -18,6 +18,9 @@
 #define WIFI_CSI_H
 
 #include "esp_err.h"
+#include "csi_pool.h"
+#include "mem_arena.h"
+#include "pose_dims.h"
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -30,14 +33,25 @@ extern "C" {
  *
  * Raw CSI comes as interleaved I/Q values. This structure holds
  * the processed amplitude and phase for each subcarrier.
+ *
+ * Records live in a fixed pool (see csi_pool.h) and are passed by pointer.
+ *
+ * With CONFIG_POSE_FIXED_POINT the I/Q are converted to the fixed-point
+ * fields, and amplitude/phase are scaled copies of them for the consumers
+ * that want float (streaming, zone links).
  */
-typedef struct {
+struct csi_data {
     float amplitude[64];    // Amplitude for each subcarrier
     float phase[64];        // Phase (radians) for each subcarrier
+#if POSE_FIXED_POINT
+    int16_t amplitude_q[64]; // Amplitude, Q8.7 (csi_fixed.h)
+    int16_t phase_q[64];    // Phase, Q15 fraction of π
+#endif
     uint8_t num_subcarriers; // Actual number of valid subcarriers
     int8_t rssi;            // Received Signal Strength Indicator
+    uint8_t mac[6];         // Transmitter MAC address (identifies the link)
     uint32_t timestamp;     // Timestamp in microseconds
-} csi_data_t;
+};
 
 /**
  * @brief Callback function type for processed CSI data
@@ -45,7 +59,11 @@ typedef struct {
  * Register a callback to receive processed CSI data.
  * Called from the CSI processing task, not from interrupt context.
  *
- * @param data Pointer to processed CSI data (valid only during callback)
+ * The record belongs to the CSI pool. It is valid during the callback; to
+ * keep it longer (e.g. to queue it for another task) take a reference with
+ * wifi_csi_retain() and drop it with wifi_csi_release() when done.
+ *
+ * @param data Pointer to processed CSI data
  * @param user_ctx User context passed during registration
  */
 typedef void (*csi_callback_t)(const csi_data_t *data, void *user_ctx);
@@ -60,6 +78,16 @@ typedef void (*csi_callback_t)(const csi_data_t *data, void *user_ctx);
  */
 esp_err_t wifi_csi_init(void);
 
+/**
+ * @brief Get the memory budget of the CSI module
+ *
+ * Lists the record pool for mem_arena_init(), which must run before
+ * wifi_csi_init().
+ *
+ * @return Budget table (static storage)
+ */
+mem_budget_t wifi_csi_get_memory_budget(void);
+
 /**
  * @brief Deinitialize WiFi CSI collection
  *
@@ -85,10 +113,38 @@ esp_err_t wifi_csi_register_callback(csi_callback_t callback, void *user_ctx);
  * Use this for polling instead of callbacks.
  *
  * @param data Buffer to store CSI data
- * @return ESP_OK if data available, ESP_ERR_NOT_FOUND if no data yet
+ * @return ESP_OK if data available, ESP_ERR_NOT_FOUND if no packet has
+ *         arrived since wifi_csi_init() (or CSI is not initialized),
+ *         ESP_ERR_TIMEOUT if the latest record stayed locked
  */
 esp_err_t wifi_csi_get_latest(csi_data_t *data);
 
+/**
+ * @brief Take a reference to a CSI record handed to a callback
+ *
+ * @param data Record passed to a csi_callback_t
+ * @return ESP_OK, or ESP_ERR_INVALID_ARG / ESP_ERR_INVALID_STATE if data is
+ *         not a live pool record
+ */
+esp_err_t wifi_csi_retain(const csi_data_t *data);
+
+/**
+ * @brief Drop a reference taken with wifi_csi_retain()
+ *
+ * @param data Retained record
+ * @return ESP_OK, or an error for records that are not held (see csi_pool_release)
+ */
+esp_err_t wifi_csi_release(const csi_data_t *data);
+
+/**
+ * @brief Get CSI record pool usage
+ *
+ * exhausted counts packets dropped because every record was still held.
+ *
+ * @param stats Output counters
+ */
+void wifi_csi_get_pool_stats(csi_pool_stats_t *stats);
+
 /**
  * @brief Check if CSI collection is active
  *
@@ -104,6 +160,15 @@ bool wifi_csi_is_active(void);
  */
 void wifi_csi_get_stats(uint32_t *packets_received, uint32_t *packets_processed);
 
+/**
+ * @brief Turn the raw CSI JSON lines on serial on or off
+ *
+ * On by default. Callbacks receive CSI either way.
+ *
+ * @param enable Print a JSON line per packet
+ */
+void wifi_csi_set_streaming(bool enable);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,90 @@
+/**
+ * @file window_gate.c
+ * @brief Change-detection gating: skip inference when the scene is static
+ */
+
+#include "window_gate.h"
+#include <math.h>
+#include <string.h>
+
+// Keeps the dB ratios finite for an all-zero band or a motionless window
+#define SKETCH_FLOOR 1e-6f
+
+void window_gate_default_config(window_gate_config_t *config, int refresh)
+{
+    config->amp_db = 0.5f;
+    config->motion_db = 1.5f;
+    config->refresh = refresh < 1 ? 1 : refresh;
+}
+
+void window_gate_init(window_gate_t *gate, const window_gate_config_t *config)
+{
+    memset(gate, 0, sizeof(*gate));
+    gate->config = *config;
+}
+
+void window_sketch_reset(window_sketch_t *sketch)
+{
+    memset(sketch, 0, sizeof(*sketch));
+}
+
+void window_sketch_push(window_sketch_t *sketch, const float *amplitude, int num_subcarriers)
+{
+    if (num_subcarriers < WINDOW_SKETCH_BANDS) {
+        return;
+    }
+    float motion = 0.0f;
+    int start = 0;
+    for (int b = 0; b < WINDOW_SKETCH_BANDS; b++) {
+        int end = (b + 1) * num_subcarriers / WINDOW_SKETCH_BANDS;
+        float sum = 0.0f;
+        for (int s = start; s < end; s++) {
+            sum += amplitude[s];
+        }
+        float mean = sum / (end - start);
+        float d = mean - sketch->band_prev[b];
+        motion += d * d;
+        sketch->band_prev[b] = mean;
+        sketch->band_sum[b] += mean;
+        start = end;
+    }
+    if (sketch->samples > 0) {
+        sketch->motion_sum += motion / WINDOW_SKETCH_BANDS;
+    }
+    if (sketch->samples < UINT16_MAX) {
+        sketch->samples++;
+    }
+}
+
+bool window_gate_check(window_gate_t *gate, const window_sketch_t *sketch)
+{
+    gate->windows++;
+    if (sketch->samples < 2) {
+        return false;
+    }
+
+    float band[WINDOW_SKETCH_BANDS];
+    for (int b = 0; b < WINDOW_SKETCH_BANDS; b++) {
+        band[b] = sketch->band_sum[b] / sketch->samples;
+    }
+    float motion = sketch->motion_sum / (sketch->samples - 1);
+
+    bool same = gate->valid && gate->reused + 1 < gate->config.refresh &&
+                fabsf(10.0f * log10f((motion + SKETCH_FLOOR) / (gate->ref_motion + SKETCH_FLOOR))) <=
+                    gate->config.motion_db;
+    for (int b = 0; same && b < WINDOW_SKETCH_BANDS; b++) {
+        float db = 20.0f * log10f((band[b] + SKETCH_FLOOR) / (gate->ref_band[b] + SKETCH_FLOOR));
+        same = fabsf(db) <= gate->config.amp_db;
+    }
+
+    if (same) {
+        gate->reused++;
+        gate->skipped++;
+        return true;
+    }
+    memcpy(gate->ref_band, band, sizeof(band));
+    gate->ref_motion = motion;
+    gate->valid = true;
+    gate->reused = 0;
+    return false;
+}
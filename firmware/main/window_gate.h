@@ -0,0 +1,109 @@
+/**
+ * @file window_gate.h
+ * @brief Change-detection gating: skip inference when the scene is static
+ *
+ * When nothing changes in the room, consecutive windows give nearly the
+ * same features and the same result, yet every window pays for the full
+ * window statistics, the classifier and the occupancy estimate. The gate
+ * compares a compact sketch of each window with the sketch of the last
+ * window that was actually computed:
+ *
+ *   sketch = mean amplitude in WINDOW_SKETCH_BANDS subcarrier bands
+ *            + motion energy (mean squared change of the band means
+ *              between consecutive samples)
+ *
+ * built incrementally as samples arrive (one add per subcarrier). If no
+ * band mean moved by more than amp_db and the motion energy by no more
+ * than motion_db, the previous result is reused. Every refresh windows
+ * the window is computed anyway, which bounds how stale a reused result
+ * can get. Comparing against the last computed window, not the previous
+ * one, keeps slow drift from accumulating unnoticed.
+ */
+
+#ifndef WINDOW_GATE_H
+#define WINDOW_GATE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Subcarrier bands of the sketch
+#define WINDOW_SKETCH_BANDS 8
+
+/**
+ * @brief Sketch of one window, built sample by sample
+ */
+typedef struct {
+    float band_sum[WINDOW_SKETCH_BANDS];   // Sum of band means over the window
+    float band_prev[WINDOW_SKETCH_BANDS];  // Band means of the last sample
+    float motion_sum;                      // Sum of squared band mean changes
+    uint16_t samples;                      // Samples in the window
+} window_sketch_t;
+
+/**
+ * @brief Gate configuration
+ */
+typedef struct {
+    float amp_db;              // Largest band amplitude change of a static scene
+    float motion_db;           // Largest motion energy change of a static scene
+    int refresh;               // Compute at least every refresh windows (1 = never reuse)
+} window_gate_config_t;
+
+/**
+ * @brief Gate state
+ */
+typedef struct {
+    window_gate_config_t config;
+    float ref_band[WINDOW_SKETCH_BANDS];   // Band means of the last computed window
+    float ref_motion;                      // Its motion energy
+    bool valid;                            // A window has been computed
+    int reused;                            // Windows reused since it was computed
+    uint32_t windows;                      // Windows checked
+    uint32_t skipped;                      // Windows reused
+} window_gate_t;
+
+/**
+ * @brief Default configuration: 0.5dB amplitude, 1.5dB motion, given refresh
+ */
+void window_gate_default_config(window_gate_config_t *config, int refresh);
+
+/**
+ * @brief Initialize (or reset) a gate; the next window is always computed
+ */
+void window_gate_init(window_gate_t *gate, const window_gate_config_t *config);
+
+/**
+ * @brief Start the sketch of a new window
+ */
+void window_sketch_reset(window_sketch_t *sketch);
+
+/**
+ * @brief Add one sample to the sketch
+ *
+ * @param sketch          Sketch
+ * @param amplitude       Subcarrier amplitudes
+ * @param num_subcarriers Subcarriers (at least WINDOW_SKETCH_BANDS)
+ */
+void window_sketch_push(window_sketch_t *sketch, const float *amplitude, int num_subcarriers);
+
+/**
+ * @brief Decide whether a window can reuse the previous result
+ *
+ * Returns false (compute) for the first window, after refresh - 1
+ * consecutive reuses, or when the sketch moved past the thresholds; the
+ * sketch then becomes the new reference.
+ *
+ * @param gate   Gate
+ * @param sketch Sketch of the completed window
+ * @return true to reuse the last computed result
+ */
+bool window_gate_check(window_gate_t *gate, const window_sketch_t *sketch);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // WINDOW_GATE_H
@@ -0,0 +1,26 @@
+/**
+ * @file zone_calibration.h
+ * @brief Zone calibration table (empty placeholder)
+ *
+ * Generated by tools/zone_calibrate.py from fingerprints captured with
+ * someone moving in each zone; this placeholder has no entries, so results
+ * carry no zone. Included by pose_inference.c only.
+ */
+
+#ifndef ZONE_CALIBRATION_H
+#define ZONE_CALIBRATION_H
+
+#include "zone_locator.h"
+
+#define ZONE_CALIBRATION_COUNT 0
+#define ZONE_CALIBRATION_LINKS 0
+#define ZONE_CALIBRATION_COLS 1
+#define ZONE_CALIBRATION_ROWS 1
+
+// Transmitter MAC of each link, in fingerprint order
+static const uint8_t s_zone_calibration_macs[ZONE_MAX_LINKS][6] = { { 0 } };
+
+// Fingerprints in k-d order (zone_table_index)
+static const zone_fingerprint_t s_zone_calibration[1] = { { { 0 }, 0, 0 } };
+
+#endif // ZONE_CALIBRATION_H
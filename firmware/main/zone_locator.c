@@ -0,0 +1,302 @@
+/**
+ * @file zone_locator.c
+ * @brief Zone localization from per-link motion energy (fingerprint k-NN)
+ */
+
+#include "zone_locator.h"
+#include <math.h>
+#include <string.h>
+
+/**
+ * @brief k best entries so far, nearest first
+ */
+typedef struct {
+    const zone_fingerprint_t *entries;
+    const uint8_t *query;
+    int num_links;
+    int k;
+    int found;
+    uint32_t dist[ZONE_MAX_K];
+    uint16_t index[ZONE_MAX_K];
+    uint16_t visited;
+} knn_search_t;
+
+uint8_t zone_energy_quantize(float energy)
+{
+    if (!(energy > ZONE_ENERGY_FLOOR)) {
+        return 0;  // Also NaN
+    }
+    float q = ZONE_ENERGY_STEPS_PER_DB * 10.0f * log10f(energy / ZONE_ENERGY_FLOOR) + 0.5f;
+    return q >= 255.0f ? 255 : (uint8_t)q;
+}
+
+void zone_link_energy_reset(zone_link_energy_t *acc)
+{
+    memset(acc, 0, sizeof(*acc));
+}
+
+void zone_link_energy_push(zone_link_energy_t *acc, int link, const float *amplitude,
+                           int num_subcarriers)
+{
+    if (link < 0 || link >= ZONE_MAX_LINKS || num_subcarriers <= 0) {
+        return;
+    }
+    float mean = 0.0f;
+    for (int s = 0; s < num_subcarriers; s++) {
+        mean += amplitude[s];
+    }
+    mean /= num_subcarriers;
+
+    if (acc->seen[link]) {
+        float d = mean - acc->prev_mean[link];
+        acc->sum_sq[link] += d * d;
+        if (acc->diffs[link] < UINT16_MAX) {
+            acc->diffs[link]++;
+        }
+    }
+    acc->prev_mean[link] = mean;
+    acc->seen[link] = true;
+}
+
+int zone_link_energy_read(zone_link_energy_t *acc, int num_links, uint8_t *energy)
+{
+    int active = 0;
+    for (int l = 0; l < num_links && l < ZONE_MAX_LINKS; l++) {
+        if (acc->diffs[l] > 0) {
+            energy[l] = zone_energy_quantize(acc->sum_sq[l] / acc->diffs[l]);
+            active++;
+        } else {
+            energy[l] = 0;
+        }
+        acc->sum_sq[l] = 0.0f;
+        acc->diffs[l] = 0;
+    }
+    return active;
+}
+
+static void swap_entries(zone_fingerprint_t *a, zone_fingerprint_t *b)
+{
+    zone_fingerprint_t t = *a;
+    *a = *b;
+    *b = t;
+}
+
+static uint8_t median3(uint8_t a, uint8_t b, uint8_t c)
+{
+    if (a > b) {
+        uint8_t t = a;
+        a = b;
+        b = t;
+    }
+    return c < a ? a : (c > b ? b : c);
+}
+
+/**
+ * @brief Partial sort of [lo, hi) so that nth holds its sorted element along dim
+ *
+ * Three-way partitions: quantized energies have many duplicates.
+ */
+static void select_nth(zone_fingerprint_t *e, int lo, int hi, int nth, int dim)
+{
+    while (hi - lo > 1) {
+        uint8_t pivot = median3(e[lo].energy[dim], e[lo + (hi - lo) / 2].energy[dim],
+                                e[hi - 1].energy[dim]);
+        int lt = lo, i = lo, gt = hi;
+        while (i < gt) {
+            uint8_t v = e[i].energy[dim];
+            if (v < pivot) {
+                swap_entries(&e[lt++], &e[i++]);
+            } else if (v > pivot) {
+                swap_entries(&e[i], &e[--gt]);
+            } else {
+                i++;
+            }
+        }
+        if (nth < lt) {
+            hi = lt;
+        } else if (nth >= gt) {
+            lo = gt;
+        } else {
+            return;
+        }
+    }
+}
+
+static void index_range(zone_fingerprint_t *e, int lo, int hi, int num_links)
+{
+    while (hi - lo > 0) {
+        // Split along the dimension of widest spread
+        int dim = 0, widest = -1;
+        for (int d = 0; d < num_links; d++) {
+            uint8_t min = 255, max = 0;
+            for (int i = lo; i < hi; i++) {
+                uint8_t v = e[i].energy[d];
+                min = v < min ? v : min;
+                max = v > max ? v : max;
+            }
+            if (max - min > widest) {
+                widest = max - min;
+                dim = d;
+            }
+        }
+
+        int mid = lo + (hi - lo) / 2;
+        select_nth(e, lo, hi, mid, dim);
+        e[mid].split = (uint8_t)dim;
+
+        // Recurse into the smaller half, loop on the larger
+        if (mid - lo < hi - mid - 1) {
+            index_range(e, lo, mid, num_links);
+            lo = mid + 1;
+        } else {
+            index_range(e, mid + 1, hi, num_links);
+            hi = mid;
+        }
+    }
+}
+
+void zone_table_index(zone_fingerprint_t *entries, int count, int num_links)
+{
+    if (count > ZONE_MAX_ENTRIES) {
+        count = ZONE_MAX_ENTRIES;
+    }
+    if (num_links > ZONE_MAX_LINKS) {
+        num_links = ZONE_MAX_LINKS;
+    }
+    index_range(entries, 0, count, num_links);
+}
+
+static bool range_valid(const zone_fingerprint_t *e, int lo, int hi, int num_links)
+{
+    if (hi - lo <= 0) {
+        return true;
+    }
+    int mid = lo + (hi - lo) / 2;
+    int dim = e[mid].split;
+    if (dim >= num_links) {
+        return false;
+    }
+    uint8_t v = e[mid].energy[dim];
+    for (int i = lo; i < mid; i++) {
+        if (e[i].energy[dim] > v) {
+            return false;
+        }
+    }
+    for (int i = mid + 1; i < hi; i++) {
+        if (e[i].energy[dim] < v) {
+            return false;
+        }
+    }
+    return range_valid(e, lo, mid, num_links) && range_valid(e, mid + 1, hi, num_links);
+}
+
+bool zone_table_valid(const zone_table_t *table)
+{
+    int zones = table->grid_cols * table->grid_rows;
+    if (table->num_links == 0 || table->num_links > ZONE_MAX_LINKS || zones == 0 ||
+        zones > ZONE_MAX_ZONES || (table->count > 0 && table->entries == NULL)) {
+        return false;
+    }
+    for (int i = 0; i < table->count; i++) {
+        if (table->entries[i].zone >= zones) {
+            return false;
+        }
+    }
+    return range_valid(table->entries, 0, table->count, table->num_links);
+}
+
+static void consider(knn_search_t *s, int index)
+{
+    const uint8_t *e = s->entries[index].energy;
+    uint32_t dist = 0;
+    for (int d = 0; d < s->num_links; d++) {
+        int diff = (int)s->query[d] - e[d];
+        dist += (uint32_t)(diff * diff);
+    }
+    s->visited++;
+
+    if (s->found == s->k && dist >= s->dist[s->k - 1]) {
+        return;
+    }
+    int pos = s->found < s->k ? s->found++ : s->k - 1;
+    for (; pos > 0 && s->dist[pos - 1] > dist; pos--) {
+        s->dist[pos] = s->dist[pos - 1];
+        s->index[pos] = s->index[pos - 1];
+    }
+    s->dist[pos] = dist;
+    s->index[pos] = (uint16_t)index;
+}
+
+static void search_range(knn_search_t *s, int lo, int hi)
+{
+    while (hi - lo > 0) {
+        int mid = lo + (hi - lo) / 2;
+        const zone_fingerprint_t *node = &s->entries[mid];
+        consider(s, mid);
+
+        int diff = (int)s->query[node->split] - node->energy[node->split];
+        if (diff < 0) {
+            search_range(s, lo, mid);
+        } else {
+            search_range(s, mid + 1, hi);
+        }
+
+        // The other side is at least |diff| away along the split dimension
+        if (s->found == s->k && (uint32_t)(diff * diff) >= s->dist[s->k - 1]) {
+            return;
+        }
+        if (diff < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+}
+
+int zone_table_nearest(const zone_table_t *table, const uint8_t *energy, int k,
+                       uint16_t *index, uint32_t *dist, uint16_t *visited)
+{
+    knn_search_t s = {
+        .entries = table->entries,
+        .query = energy,
+        .num_links = table->num_links,
+        .k = k < 1 ? 1 : (k > ZONE_MAX_K ? ZONE_MAX_K : k),
+    };
+    search_range(&s, 0, table->count);
+    memcpy(index, s.index, s.found * sizeof(uint16_t));
+    memcpy(dist, s.dist, s.found * sizeof(uint32_t));
+    if (visited != NULL) {
+        *visited = s.visited;
+    }
+    return s.found;
+}
+
+void zone_locate(const zone_table_t *table, const uint8_t *energy, int k,
+                 zone_estimate_t *out)
+{
+    memset(out, 0, sizeof(*out));
+    out->zone = -1;
+    if (table->count == 0) {
+        return;
+    }
+
+    uint16_t index[ZONE_MAX_K];
+    uint32_t dist[ZONE_MAX_K];
+    int found = zone_table_nearest(table, energy, k, index, dist, &out->visited);
+
+    // Inverse-distance vote (distances in quantization steps)
+    float total = 0.0f;
+    for (int i = 0; i < found; i++) {
+        float w = 1.0f / (1.0f + sqrtf((float)dist[i]));
+        out->prob[table->entries[index[i]].zone] += w;
+        total += w;
+    }
+    int zones = table->grid_cols * table->grid_rows;
+    for (int z = 0; z < zones; z++) {
+        out->prob[z] /= total;
+        if (out->zone < 0 || out->prob[z] > out->prob[out->zone]) {
+            out->zone = (int8_t)z;
+        }
+    }
+    out->confidence = out->prob[out->zone];
+}
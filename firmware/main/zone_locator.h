@@ -0,0 +1,178 @@
+/**
+ * @file zone_locator.h
+ * @brief Zone localization from per-link motion energy (fingerprint k-NN)
+ *
+ * With several transmitters in a room, a moving person disturbs the links
+ * whose paths pass near them far more than the others. The vector of
+ * per-link motion energies is therefore a fingerprint of where in the room
+ * the motion is. A calibration pass records fingerprints with someone
+ * moving in each zone of a grid; at run time the k nearest calibration
+ * fingerprints vote for their zones:
+ *
+ *   CSI packets, tagged with their link (transmitter)
+ *     -> zone_link_energy_push(): mean-amplitude first differences per link
+ *     -> zone_link_energy_read(): per-window energy, quantized log scale
+ *     -> zone_locate(): k nearest calibration fingerprints (k-d tree)
+ *     -> inverse-distance vote -> zone probability grid
+ *
+ * The calibration table is a const array (so it stays in flash) generated
+ * by tools/zone_calibrate.py into zone_calibration.h. Its entries are
+ * stored in implicit k-d tree order: the root of a range of entries is its
+ * middle element, which also records the dimension the range was split
+ * on. No index is built at run time and no RAM is needed besides the
+ * query; zone_table_index() puts an entry array in that order (host tools,
+ * tables built at run time).
+ */
+
+#ifndef ZONE_LOCATOR_H
+#define ZONE_LOCATOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Largest number of links (transmitters) in a fingerprint
+#define ZONE_MAX_LINKS 8
+
+// Largest zone grid (cols x rows)
+#define ZONE_MAX_ZONES 16
+
+// Largest number of neighbors a lookup can use
+#define ZONE_MAX_K 8
+
+// Largest calibration table (entry indices are 16-bit)
+#define ZONE_MAX_ENTRIES 65535
+
+// Quantized energy: 4 steps per dB above ZONE_ENERGY_FLOOR (~64 dB range)
+#define ZONE_ENERGY_STEPS_PER_DB 4
+#define ZONE_ENERGY_FLOOR 1e-4f
+
+/**
+ * @brief One calibration fingerprint (10 bytes)
+ */
+typedef struct {
+    uint8_t energy[ZONE_MAX_LINKS];  // Per-link motion energy (zone_energy_quantize)
+    uint8_t zone;                    // Zone index, row-major on the grid
+    uint8_t split;                   // k-d split dimension (set by zone_table_index)
+} zone_fingerprint_t;
+
+/**
+ * @brief Calibration table
+ */
+typedef struct {
+    const zone_fingerprint_t *entries;  // In k-d order (zone_table_index)
+    uint16_t count;                     // Entries
+    uint8_t num_links;                  // Links used per fingerprint
+    uint8_t grid_cols;                  // Zone grid width
+    uint8_t grid_rows;                  // Zone grid height
+} zone_table_t;
+
+/**
+ * @brief Result of one lookup
+ */
+typedef struct {
+    float prob[ZONE_MAX_ZONES];  // Zone probability grid, row-major
+    int8_t zone;                 // Most likely zone, -1 if the table is empty
+    float confidence;            // Probability of that zone
+    uint16_t visited;            // Entries compared (search cost)
+} zone_estimate_t;
+
+/**
+ * @brief Per-link motion energy over the current window
+ */
+typedef struct {
+    float prev_mean[ZONE_MAX_LINKS];  // Mean amplitude of the link's last packet
+    float sum_sq[ZONE_MAX_LINKS];     // Sum of squared first differences
+    uint16_t diffs[ZONE_MAX_LINKS];   // First differences summed
+    bool seen[ZONE_MAX_LINKS];        // prev_mean is valid
+} zone_link_energy_t;
+
+/**
+ * @brief Quantize a motion energy to the fingerprint's log scale
+ */
+uint8_t zone_energy_quantize(float energy);
+
+/**
+ * @brief Clear the accumulated energies (packet history is forgotten too)
+ */
+void zone_link_energy_reset(zone_link_energy_t *acc);
+
+/**
+ * @brief Add one CSI packet of a link
+ *
+ * @param acc             Accumulator
+ * @param link            Link index (0..ZONE_MAX_LINKS-1; others are ignored)
+ * @param amplitude       Subcarrier amplitudes of the packet
+ * @param num_subcarriers Subcarriers in amplitude
+ */
+void zone_link_energy_push(zone_link_energy_t *acc, int link, const float *amplitude,
+                           int num_subcarriers);
+
+/**
+ * @brief Read the window's fingerprint and start a new window
+ *
+ * Mean squared first difference of each link's mean amplitude, quantized.
+ * Links without packets in the window read as 0. The last packet of each
+ * link is kept, so the next window's first difference spans the boundary.
+ *
+ * @param acc       Accumulator
+ * @param num_links Links to read (<= ZONE_MAX_LINKS)
+ * @param energy    Output: num_links quantized energies
+ * @return Links that had packets in the window
+ */
+int zone_link_energy_read(zone_link_energy_t *acc, int num_links, uint8_t *energy);
+
+/**
+ * @brief Put an entry array in the k-d order zone_locate() expects
+ *
+ * Splits every range at its median along the dimension of widest spread.
+ * O(n log n) expected time, no extra memory.
+ *
+ * @param entries   Entries, reordered in place; split fields are set
+ * @param count     Number of entries (<= ZONE_MAX_ENTRIES)
+ * @param num_links Dimensions used (<= ZONE_MAX_LINKS)
+ */
+void zone_table_index(zone_fingerprint_t *entries, int count, int num_links);
+
+/**
+ * @brief Check a table: dimensions, zone indices and k-d order
+ *
+ * O(n log n); meant for start-up and host tools, not per lookup.
+ *
+ * @return true if zone_locate() can use the table
+ */
+bool zone_table_valid(const zone_table_t *table);
+
+/**
+ * @brief k nearest calibration entries of a fingerprint (k-d search)
+ *
+ * @param table   Calibration table (zone_table_valid)
+ * @param energy  Query fingerprint, table->num_links quantized energies
+ * @param k       Neighbors wanted (1..ZONE_MAX_K)
+ * @param index   Output: entry indices, nearest first
+ * @param dist    Output: squared distances in quantization steps, ascending
+ * @param visited Output (optional): entries compared
+ * @return Neighbors found (k, or fewer if the table is smaller)
+ */
+int zone_table_nearest(const zone_table_t *table, const uint8_t *energy, int k,
+                       uint16_t *index, uint32_t *dist, uint16_t *visited);
+
+/**
+ * @brief Zone probabilities for one fingerprint
+ *
+ * @param table  Calibration table (zone_table_valid)
+ * @param energy Query fingerprint, table->num_links quantized energies
+ * @param k      Neighbors that vote (1..ZONE_MAX_K)
+ * @param out    Output estimate
+ */
+void zone_locate(const zone_table_t *table, const uint8_t *energy, int k,
+                 zone_estimate_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ZONE_LOCATOR_H
@@ -8,6 +8,8 @@ following the "DensePose From WiFi" paper approach, simplified for ESP32 constra
 The model uses temporal CSI windows to predict:
 1. Human presence (binary classification)
 2. Basic pose classes (empty, present, moving, walking, sitting, standing)
+3. Optionally (--keypoints), 17 COCO keypoints (x, y, confidence) from a
+   regression head sharing the convolutional trunk
 
 Usage:
     python3 train_pose_model.py datasets/csi_dataset_20240103_120000.json
@@ -26,6 +28,17 @@ import tensorflow as tf
 from tensorflow import keras
 from tensorflow.keras import layers
 
+# Shared firmware preprocessing (firmware/main/csi_features.c)
+sys.path.insert(0, str(Path(__file__).resolve().parents[2] / 'tools'))
+import csi_features
+
+# Keypoints of the regression head (firmware POSE_NUM_KEYPOINTS, COCO order)
+NUM_KEYPOINTS = 17
+
+# Coarse DensePose head (firmware uv_map.h): map size and body parts
+UV_MAP_SIZE = 24
+UV_MAP_PARTS = 24
+
 # Set random seeds for reproducibility
 np.random.seed(42)
 tf.random.set_seed(42)
@@ -42,33 +55,73 @@ class CSIDataPreprocessor:
     - Input shape: (50, 104)
     """
 
-    def __init__(self, window_size=50, num_subcarriers=52):
+    def __init__(self, window_size=50, num_subcarriers=52, keypoints=False, uv_map=False):
         self.window_size = window_size
         self.num_subcarriers = num_subcarriers
         self.feature_dim = num_subcarriers * 2  # amplitude + phase
+        self.keypoints = keypoints
+        self.uv_map = uv_map
 
     def parse_sample(self, sample):
-        """Parse a single CSI sample into features"""
-        amp = np.array(sample['amp'], dtype=np.float32)
-        phase = np.array(sample.get('phase', [0] * len(amp)), dtype=np.float32)
-
-        # Pad or truncate to fixed size
-        if len(amp) < self.num_subcarriers:
-            amp = np.pad(amp, (0, self.num_subcarriers - len(amp)), 'constant')
-            phase = np.pad(phase, (0, self.num_subcarriers - len(phase)), 'constant')
-        else:
-            amp = amp[:self.num_subcarriers]
-            phase = phase[:self.num_subcarriers]
-
-        # Normalize amplitude
-        amp = (amp - np.mean(amp)) / (np.std(amp) + 1e-6)
+        """
+        Parse a single CSI sample into features.
 
-        # Normalize phase to [-1, 1]
-        phase = phase / np.pi
+        Amplitude is z-score normalized and phase scaled to [-1, 1] by the
+        firmware's csi_normalize_sample(), padded/truncated to num_subcarriers.
+        """
+        amp, phase, _ = csi_features.pad_samples([sample], self.num_subcarriers)
+        return csi_features.normalize(amp, phase)[0]
 
-        # Concatenate amplitude and phase
-        features = np.concatenate([amp, phase])
-        return features
+    @staticmethod
+    def sample_keypoints(sample):
+        """
+        Keypoint target of one sample: (NUM_KEYPOINTS, 3) of x, y in [0, 1]
+        and visibility (0/1). Samples without a 'keypoints' field (e.g. an
+        empty room) have every keypoint invisible.
+        """
+        kp = np.zeros((NUM_KEYPOINTS, 3), dtype=np.float32)
+        if sample.get('keypoints'):
+            values = np.asarray(sample['keypoints'], dtype=np.float32)[:NUM_KEYPOINTS, :3]
+            kp[:len(values)] = values
+        return kp
+
+    @staticmethod
+    def sample_uv_map(sample):
+        """
+        UV map targets of one sample from a 'uv_map' field
+        {"part": [[...]], "u": [[...]], "v": [[...]]} of UV_MAP_SIZE rows:
+        part indices (UV_MAP_SIZE, UV_MAP_SIZE), 0 = background, and
+        (UV_MAP_SIZE, UV_MAP_SIZE, 3) of U, V in [0, 1] plus a foreground
+        mask for the loss. Samples without it are all background.
+        """
+        part = np.zeros((UV_MAP_SIZE, UV_MAP_SIZE), dtype=np.int32)
+        uv = np.zeros((UV_MAP_SIZE, UV_MAP_SIZE, 3), dtype=np.float32)
+        if sample.get('uv_map'):
+            m = sample['uv_map']
+            part[:] = np.asarray(m['part'], dtype=np.int32)
+            uv[..., 0] = np.asarray(m['u'], dtype=np.float32)
+            uv[..., 1] = np.asarray(m['v'], dtype=np.float32)
+            uv[..., 2] = part > 0
+        return part, uv
+
+    def window_targets(self, samples, count):
+        """
+        Targets of the optional heads for count windows over samples. The
+        device reports the pose at the end of the window, so each window
+        takes the targets of its last sample.
+        """
+        last = samples[self.window_size - 1:][:count]
+        targets = {}
+        if self.keypoints:
+            kp = [self.sample_keypoints(s) for s in last]
+            targets['keypoints'] = np.array(kp, dtype=np.float32).reshape(-1, NUM_KEYPOINTS, 3)
+        if self.uv_map:
+            maps = [self.sample_uv_map(s) for s in last]
+            targets['uv_parts'] = np.array([m[0] for m in maps], dtype=np.int32).reshape(
+                -1, UV_MAP_SIZE, UV_MAP_SIZE)
+            targets['uv_coords'] = np.array([m[1] for m in maps], dtype=np.float32).reshape(
+                -1, UV_MAP_SIZE, UV_MAP_SIZE, 3)
+        return targets
 
     def create_windows(self, samples, labels):
         """
@@ -77,9 +130,14 @@ class CSIDataPreprocessor:
         Returns:
             X: (num_windows, window_size, feature_dim)
             y: (num_windows,) labels
+            targets: dict of per-window targets of the optional heads
+                     ('keypoints', 'uv_parts', 'uv_coords'), only returned
+                     if a head is enabled
         """
         X = []
         y = []
+        targets = []
+        heads = self.keypoints or self.uv_map
 
         label_map = {
             'empty': 0,
@@ -99,16 +157,24 @@ class CSIDataPreprocessor:
 
         # Create windows for each label
         for label, label_samples in by_label.items():
-            features = [self.parse_sample(s) for s in label_samples]
-            features = np.array(features)
-
-            # Create sliding windows
-            for i in range(len(features) - self.window_size + 1):
-                window = features[i:i + self.window_size]
-                X.append(window)
-                y.append(label_map.get(label, 0))
-
-        return np.array(X), np.array(y)
+            amp, phase, _ = csi_features.pad_samples(label_samples, self.num_subcarriers)
+            features = csi_features.normalize(amp, phase)
+
+            # Sliding windows are views into features; copied once below
+            windows = csi_features.sliding_windows(features, self.window_size)
+            X.append(windows)
+            y.append(np.full(len(windows), label_map.get(label, 0)))
+            if heads:
+                targets.append(self.window_targets(label_samples, len(windows)))
+
+        if not X:
+            X = np.empty((0, self.window_size, self.feature_dim), dtype=np.float32)
+            y = np.array([])
+            targets = [self.window_targets([], 0)] if heads else []
+        if heads:
+            merged = {key: np.concatenate([t[key] for t in targets]) for key in targets[0]}
+            return np.concatenate(X), np.concatenate(y), merged
+        return np.concatenate(X), np.concatenate(y)
 
     def load_dataset(self, dataset_file):
         """Load and preprocess dataset from JSON file"""
@@ -131,10 +197,16 @@ class CSIDataPreprocessor:
         print(f"  Labeled samples: {len(samples)}")
 
         # Create windows
-        X, y = self.create_windows(samples, labels)
-        print(f"  Created {len(X)} temporal windows (size={self.window_size})")
+        windows = self.create_windows(samples, labels)
+        print(f"  Created {len(windows[0])} temporal windows (size={self.window_size})")
+        if self.keypoints:
+            with_pose = int((windows[2]['keypoints'][:, :, 2].max(axis=1) > 0).sum())
+            print(f"  Windows with keypoint labels: {with_pose}")
+        if self.uv_map:
+            with_map = int((windows[2]['uv_parts'].reshape(len(windows[0]), -1).max(axis=1) > 0).sum())
+            print(f"  Windows with UV map labels: {with_map}")
 
-        return X, y
+        return windows
 
 
 class LightweightPoseModel:
@@ -146,12 +218,20 @@ class LightweightPoseModel:
 
     Model size target: <500KB
     Input: (window_size, num_subcarriers * 2)
-    Output: 6 pose classes
+    Output: 6 pose classes, plus with keypoints=True a second output of
+            (NUM_KEYPOINTS, 3) sigmoid values: x, y, confidence per keypoint.
+            The head branches off the pooled features (~8KB of int8 weights)
+            and is read on the device with tflite_classifier_run_keypoints().
+            With uv_map=True, a coarse DensePose head: per pixel of a
+            UV_MAP_SIZE x UV_MAP_SIZE map, softmax scores of background +
+            UV_MAP_PARTS parts ('uv_parts') and sigmoid U, V ('uv_coords').
     """
 
-    def __init__(self, input_shape, num_classes=6):
+    def __init__(self, input_shape, num_classes=6, keypoints=False, uv_map=False):
         self.input_shape = input_shape
         self.num_classes = num_classes
+        self.keypoints = keypoints
+        self.uv_map = uv_map
 
     def build_model(self):
         """Build lightweight CNN model"""
@@ -169,10 +249,10 @@ class LightweightPoseModel:
 
         x = layers.Conv1D(64, 3, activation='relu', padding='same')(x)
         x = layers.BatchNormalization()(x)
-        x = layers.GlobalAveragePooling1D()(x)
+        features = layers.GlobalAveragePooling1D()(x)
 
         # Dense layers
-        x = layers.Dense(64, activation='relu')(x)
+        x = layers.Dense(64, activation='relu')(features)
         x = layers.Dropout(0.3)(x)
 
         x = layers.Dense(32, activation='relu')(x)
@@ -180,17 +260,74 @@ class LightweightPoseModel:
 
         # Output layer
         if self.num_classes == 2:
-            outputs = layers.Dense(1, activation='sigmoid')(x)
+            outputs = layers.Dense(1, activation='sigmoid', name='pose_class')(x)
         else:
-            outputs = layers.Dense(self.num_classes, activation='softmax')(x)
+            outputs = layers.Dense(self.num_classes, activation='softmax', name='pose_class')(x)
+
+        # Keypoint regression head: sigmoid keeps every value in [0, 1], so
+        # the firmware dequantizes it with a lookup table straight into the
+        # Q0.16/Q0.8 skeleton
+        if self.keypoints:
+            k = layers.Dense(64, activation='relu')(features)
+            k = layers.Dense(NUM_KEYPOINTS * 3, activation='sigmoid')(k)
+            k = layers.Reshape((NUM_KEYPOINTS, 3), name='keypoints')(k)
+            outputs = {'pose_class': outputs, 'keypoints': k}
+
+        # Coarse DensePose head: a 6x6 seed from the pooled features,
+        # upsampled twice to the map size. Kept narrow (16 channels, ~45KB
+        # of int8 weights) since every layer runs on 576 pixels at the end
+        if self.uv_map:
+            seed = UV_MAP_SIZE // 4
+            m = layers.Dense(seed * seed * 16, activation='relu')(features)
+            m = layers.Reshape((seed, seed, 16))(m)
+            m = layers.Conv2DTranspose(16, 3, strides=2, padding='same', activation='relu')(m)
+            m = layers.Conv2DTranspose(16, 3, strides=2, padding='same', activation='relu')(m)
+            parts = layers.Conv2D(UV_MAP_PARTS + 1, 1, activation='softmax', name='uv_parts')(m)
+            coords = layers.Conv2D(2, 1, activation='sigmoid', name='uv_coords')(m)
+            if not isinstance(outputs, dict):
+                outputs = {'pose_class': outputs}
+            outputs.update({'uv_parts': parts, 'uv_coords': coords})
 
         model = keras.Model(inputs=inputs, outputs=outputs, name='LightweightPoseModel')
 
         return model
 
 
-def train_model(X_train, y_train, X_val, y_val, num_classes=6, epochs=50, batch_size=32):
-    """Train the pose estimation model"""
+def keypoint_loss(y_true, y_pred):
+    """
+    Loss of the keypoint head.
+
+    y_true holds (x, y, visibility) per keypoint. Coordinates are only
+    penalized for visible keypoints; the confidence output learns the
+    visibility.
+    """
+    visible = y_true[..., 2]
+    coord_err = tf.reduce_sum(tf.square(y_true[..., :2] - y_pred[..., :2]), axis=-1)
+    coord = tf.reduce_sum(visible * coord_err, axis=-1) / tf.maximum(
+        tf.reduce_sum(visible, axis=-1), 1.0)
+    conf = keras.losses.binary_crossentropy(visible[..., None], y_pred[..., 2:3])
+    return 10.0 * coord + tf.reduce_mean(conf, axis=-1)
+
+
+def uv_coords_loss(y_true, y_pred):
+    """
+    Loss of the UV output: squared U/V error over foreground pixels only
+    (y_true channel 2 is the foreground mask).
+    """
+    mask = y_true[..., 2]
+    err = tf.reduce_sum(tf.square(y_true[..., :2] - y_pred), axis=-1)
+    return tf.reduce_sum(mask * err, axis=[1, 2]) / tf.maximum(
+        tf.reduce_sum(mask, axis=[1, 2]), 1.0)
+
+
+def train_model(X_train, y_train, X_val, y_val, num_classes=6, epochs=50, batch_size=32,
+                targets_train=None, targets_val=None):
+    """
+    Train the pose estimation model.
+
+    targets_train/targets_val hold the targets of the optional heads
+    ('keypoints', 'uv_parts', 'uv_coords'); a head is built for each key.
+    """
 
     print("\n" + "="*60)
     print("TRAINING MODEL")
@@ -198,7 +335,9 @@ def train_model(X_train, y_train, X_val, y_val, num_classes=6, epochs=50, batch_
 
     input_shape = (X_train.shape[1], X_train.shape[2])
 
-    builder = LightweightPoseModel(input_shape, num_classes)
+    heads = targets_train or {}
+    builder = LightweightPoseModel(input_shape, num_classes,
+                                   keypoints='keypoints' in heads, uv_map='uv_parts' in heads)
     model = builder.build_model()
 
     model.summary()
@@ -211,6 +350,17 @@ def train_model(X_train, y_train, X_val, y_val, num_classes=6, epochs=50, batch_
         loss = 'sparse_categorical_crossentropy'
         metrics = ['accuracy']
 
+    if heads:
+        head_losses = {
+            'keypoints': keypoint_loss,
+            'uv_parts': 'sparse_categorical_crossentropy',
+            'uv_coords': uv_coords_loss,
+        }
+        loss = {'pose_class': loss, **{key: head_losses[key] for key in heads}}
+        metrics = {'pose_class': metrics}
+        y_train = {'pose_class': y_train, **targets_train}
+        y_val = {'pose_class': y_val, **targets_val}
+
     model.compile(
         optimizer=keras.optimizers.Adam(learning_rate=0.001),
         loss=loss,
@@ -247,11 +397,15 @@ def train_model(X_train, y_train, X_val, y_val, num_classes=6, epochs=50, batch_
     print("EVALUATION")
     print("="*60)
 
-    train_loss, train_acc = model.evaluate(X_train, y_train, verbose=0)
-    val_loss, val_acc = model.evaluate(X_val, y_val, verbose=0)
+    train = model.evaluate(X_train, y_train, verbose=0, return_dict=True)
+    val = model.evaluate(X_val, y_val, verbose=0, return_dict=True)
+    acc_key = 'pose_class_accuracy' if heads else 'accuracy'
 
-    print(f"Train Accuracy: {train_acc:.4f}")
-    print(f"Val Accuracy:   {val_acc:.4f}")
+    print(f"Train Accuracy: {train[acc_key]:.4f}")
+    print(f"Val Accuracy:   {val[acc_key]:.4f}")
+    for key in heads:
+        print(f"Train {key} loss: {train[key + '_loss']:.4f}")
+        print(f"Val {key} loss:   {val[key + '_loss']:.4f}")
 
     return model, history
 
@@ -330,12 +484,19 @@ Example:
     parser.add_argument('--epochs', type=int, default=50, help='Number of training epochs')
     parser.add_argument('--batch-size', type=int, default=32, help='Batch size')
     parser.add_argument('--output-dir', default='models/training/output', help='Output directory')
+    parser.add_argument('--keypoints', action='store_true',
+                        help='Add the 17-keypoint regression head (needs "keypoints" in samples)')
+    parser.add_argument('--uv-map', action='store_true',
+                        help='Add the coarse 24x24 DensePose part/UV head (needs "uv_map" in samples)')
 
     args = parser.parse_args()
 
     # Load and preprocess data
-    preprocessor = CSIDataPreprocessor(args.window_size, args.num_subcarriers)
-    X, y = preprocessor.load_dataset(args.dataset)
+    preprocessor = CSIDataPreprocessor(args.window_size, args.num_subcarriers,
+                                       keypoints=args.keypoints, uv_map=args.uv_map)
+    windows = preprocessor.load_dataset(args.dataset)
+    X, y = windows[0], windows[1]
+    targets = windows[2] if len(windows) > 2 else {}
 
     if len(X) == 0:
         print("✗ No valid data found in dataset")
@@ -345,6 +506,8 @@ Example:
     split_idx = int(len(X) * args.train_split)
     X_train, X_val = X[:split_idx], X[split_idx:]
     y_train, y_val = y[:split_idx], y[split_idx:]
+    targets_train = {key: t[:split_idx] for key, t in targets.items()}
+    targets_val = {key: t[split_idx:] for key, t in targets.items()}
 
     print(f"\nData split:")
     print(f"  Train: {len(X_train)} samples")
@@ -360,7 +523,9 @@ Example:
         X_val, y_val,
         num_classes=num_classes,
         epochs=args.epochs,
-        batch_size=args.batch_size
+        batch_size=args.batch_size,
+        targets_train=targets_train,
+        targets_val=targets_val
     )
 
     # Save model
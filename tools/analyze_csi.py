@@ -15,10 +15,13 @@ import numpy as np
 from pathlib import Path
 import matplotlib.pyplot as plt
 
+import csi_features
+
 
 class CSIAnalyzer:
-    def __init__(self, dataset_file):
+    def __init__(self, dataset_file, num_subcarriers=52):
         self.dataset_file = Path(dataset_file)
+        self.num_subcarriers = num_subcarriers
         self.data = None
         self.metadata = None
 
@@ -104,32 +107,31 @@ class CSIAnalyzer:
             label = sample.get('label', 'unknown')
             if label not in label_groups:
                 label_groups[label] = []
-
-            features = self.compute_features(sample)
-            label_groups[label].append(features)
+            label_groups[label].append(sample)
 
         # Compute temporal variance for each label
-        for label, features_list in sorted(label_groups.items()):
-            if len(features_list) < window_size:
+        for label, samples in sorted(label_groups.items()):
+            if len(samples) < window_size:
                 print(f"\n[{label}] - Not enough samples for temporal analysis")
                 continue
 
             print(f"\n[{label.upper()}]")
 
-            # Compute sliding window statistics
-            amp_std_variance = []
-            phase_std_variance = []
-
-            for i in range(len(features_list) - window_size + 1):
-                window = features_list[i:i+window_size]
+            # Per-sample std over subcarriers, then its spread over sliding windows
+            amp, phase, rssi = csi_features.pad_samples(samples, self.num_subcarriers)
+            amp_stds = np.array([np.std(s['amp']) for s in samples])
+            phase_stds = np.array([np.std(s['phase']) if s.get('phase') else 0.0 for s in samples])
+            amp_std_variance = csi_features.sliding_windows(amp_stds[:, None], window_size).std(axis=(1, 2))
+            phase_std_variance = csi_features.sliding_windows(phase_stds[:, None], window_size).std(axis=(1, 2))
 
-                # Variance of amplitude std within window
-                amp_std_variance.append(np.std([f['amp_std'] for f in window]))
-                phase_std_variance.append(np.std([f['phase_std'] for f in window]))
+            # Window statistics exactly as run_inference() computes them on the device
+            stats = csi_features.window_stats(amp, phase, rssi, window_size)
 
             print(f"  Amplitude Std Variance: {np.mean(amp_std_variance):.4f}")
             print(f"  Phase Std Variance:     {np.mean(phase_std_variance):.4f}")
             print(f"  Temporal Stability:     {np.mean(amp_std_variance) < 5.0}")
+            print(f"  Firmware amp_std:       {np.mean(stats[:, 1]):.4f} ± {np.std(stats[:, 1]):.4f}")
+            print(f"  Firmware phase_var:     {np.mean(stats[:, 2]):.4f} ± {np.std(stats[:, 2]):.4f}")
 
     def visualize(self, output_dir=None):
         """Generate visualizations of the dataset"""
@@ -275,12 +277,14 @@ def main():
     parser.add_argument('--visualize', action='store_true', help='Generate visualizations')
     parser.add_argument('--output-dir', help='Output directory for visualizations')
     parser.add_argument('--export-features', action='store_true', help='Export computed features')
+    parser.add_argument('--num-subcarriers', type=int, default=52, help='Subcarriers used by the firmware')
+    parser.add_argument('--window-size', type=int, default=10, help='Temporal analysis window (samples)')
 
     args = parser.parse_args()
 
-    analyzer = CSIAnalyzer(args.dataset).load()
+    analyzer = CSIAnalyzer(args.dataset, args.num_subcarriers).load()
     analyzer.analyze_by_label()
-    analyzer.compute_temporal_features()
+    analyzer.compute_temporal_features(args.window_size)
 
     if args.visualize:
         analyzer.visualize(args.output_dir)
@@ -13,6 +13,11 @@ The output will be a header file with:
 - Model data as a byte array
 - Model size constant
 - Include guards for C/C++
+- The model's input shape and class count, with static asserts that they
+  match the firmware build (pose_dims.h, from Kconfig)
+
+The shape is read with TensorFlow when it is installed, or given with
+--input-shape SAMPLES FEATURES and --num-classes.
 """
 
 import sys
@@ -20,7 +25,23 @@ import argparse
 from pathlib import Path
 
 
-def convert_tflite_to_header(tflite_path, output_path, array_name='g_model_data'):
+def read_model_shape(tflite_path):
+    """
+    Input shape (samples, features) and class count of a TFLite model.
+
+    Returns None if TensorFlow is not installed.
+    """
+    try:
+        import tensorflow as tf
+    except ImportError:
+        return None
+    interpreter = tf.lite.Interpreter(model_path=str(tflite_path))
+    input_shape = interpreter.get_input_details()[0]['shape']
+    output_shape = interpreter.get_output_details()[0]['shape']
+    return int(input_shape[-2]), int(input_shape[-1]), int(output_shape[-1])
+
+
+def convert_tflite_to_header(tflite_path, output_path, array_name='g_model_data', shape=None):
     """
     Convert TFLite model to C header file.
 
@@ -28,6 +49,8 @@ def convert_tflite_to_header(tflite_path, output_path, array_name='g_model_data'
         tflite_path: Path to .tflite file
         output_path: Path to output .h file
         array_name: Name for the byte array (default: g_model_data)
+        shape: (input samples, input features, classes), or None to leave
+               out the shape checks
     """
     tflite_path = Path(tflite_path)
     output_path = Path(output_path)
@@ -74,7 +97,10 @@ def convert_tflite_to_header(tflite_path, output_path, array_name='g_model_data'
         f.write("#endif\n\n")
 
         # Write model data as hex array
-        f.write(f"#include <stdint.h>\n\n")
+        f.write(f"#include <stdint.h>\n")
+        if shape is not None:
+            f.write("#include \"tflite_classifier.h\"\n")
+        f.write("\n")
         f.write(f"// TFLite model data ({model_size} bytes)\n")
         f.write(f"const uint8_t {array_name}[] = {{\n")
 
@@ -93,6 +119,22 @@ def convert_tflite_to_header(tflite_path, output_path, array_name='g_model_data'
         size_name = array_name.replace('g_', '').replace('_data', '_len')
         f.write(f"const unsigned int {size_name} = {model_size};\n\n")
 
+        # Shape the model was trained with, checked against the build
+        if shape is not None:
+            prefix = array_name.upper()
+            samples, features, classes = shape
+            f.write("// Model shape, checked against pose_dims.h (Kconfig)\n")
+            f.write(f"#define {prefix}_INPUT_SAMPLES {samples}\n")
+            f.write(f"#define {prefix}_INPUT_FEATURES {features}\n")
+            f.write(f"#define {prefix}_NUM_CLASSES {classes}\n\n")
+            f.write(f"POSE_STATIC_ASSERT({prefix}_INPUT_SAMPLES == TFLITE_INPUT_SAMPLES,\n"
+                    f"                   \"model window length does not match "
+                    f"POSE_WINDOW_MS x POSE_SAMPLE_RATE_HZ\");\n")
+            f.write(f"POSE_STATIC_ASSERT({prefix}_INPUT_FEATURES == TFLITE_INPUT_FEATURES,\n"
+                    f"                   \"model features do not match 2 x POSE_NUM_SUBCARRIERS\");\n")
+            f.write(f"POSE_STATIC_ASSERT({prefix}_NUM_CLASSES == TFLITE_NUM_CLASSES,\n"
+                    f"                   \"model classes do not match TFLITE_NUM_CLASSES\");\n\n")
+
         # End C++ guard
         f.write("#ifdef __cplusplus\n")
         f.write("}\n")
@@ -105,6 +147,10 @@ def convert_tflite_to_header(tflite_path, output_path, array_name='g_model_data'
     print(f"  Array name: {array_name}")
     print(f"  Size constant: {size_name}")
     print(f"  Model size: {model_size} bytes")
+    if shape is not None:
+        print(f"  Input: {shape[0]} samples x {shape[1]} features, {shape[2]} classes")
+    else:
+        print("  Shape unknown (no TensorFlow, no --input-shape): not checked at build time")
 
     return True
 
@@ -140,13 +186,24 @@ Integration in firmware:
     parser.add_argument('--array-name', default='g_model_data',
                        help='Name for the byte array (default: g_model_data)')
 
+    parser.add_argument('--input-shape', type=int, nargs=2, metavar=('SAMPLES', 'FEATURES'),
+                       help='Model input shape (default: read with TensorFlow)')
+    parser.add_argument('--num-classes', type=int, default=6,
+                       help='Model output classes, with --input-shape (default: 6)')
+
     args = parser.parse_args()
 
+    if args.input_shape is not None:
+        shape = (args.input_shape[0], args.input_shape[1], args.num_classes)
+    else:
+        shape = read_model_shape(args.tflite) if Path(args.tflite).exists() else None
+
     # Convert the model
     success = convert_tflite_to_header(
         args.tflite,
         args.output,
-        args.array_name
+        args.array_name,
+        shape
     )
 
     if not success:
@@ -0,0 +1,184 @@
+#!/usr/bin/env python3
+"""
+Python bindings for the firmware's CSI feature library
+
+Loads libcsi_features (firmware/main/csi_features.c built by tools/host) via
+ctypes so training and analysis run the exact preprocessing code the ESP32
+runs. If the library has not been built, a NumPy implementation of the same
+math is used instead and `NATIVE` is False.
+
+Build the library:
+    cmake -S tools/host -B build/host && cmake --build build/host
+
+The library is searched for in $CSI_FEATURES_LIB, build/host/ and
+tools/host/build/.
+
+All arrays are sample-major float32: amplitude/phase have shape
+(num_samples, num_subcarriers), like the firmware temporal buffers.
+"""
+
+import ctypes
+import os
+from pathlib import Path
+
+import numpy as np
+
+REPO_ROOT = Path(__file__).resolve().parents[1]
+
+# Row layout of window_stats(); matches CSI_NUM_WINDOW_STATS in csi_features.h
+WINDOW_STAT_NAMES = ('amp_mean', 'amp_std', 'phase_variance', 'rssi_mean')
+
+_F32 = np.ctypeslib.ndpointer(dtype=np.float32, flags='C_CONTIGUOUS')
+_I8 = np.ctypeslib.ndpointer(dtype=np.int8, flags='C_CONTIGUOUS')
+
+
+def _load_library():
+    candidates = []
+    if os.environ.get('CSI_FEATURES_LIB'):
+        candidates.append(Path(os.environ['CSI_FEATURES_LIB']))
+    for build_dir in (REPO_ROOT / 'build' / 'host', REPO_ROOT / 'tools' / 'host' / 'build'):
+        candidates += [build_dir / 'libcsi_features.so', build_dir / 'libcsi_features.dylib']
+
+    for path in candidates:
+        if path.exists():
+            lib = ctypes.CDLL(str(path))
+            lib.csi_normalize_batch.argtypes = [_F32, _F32, ctypes.c_int, ctypes.c_int, _F32]
+            lib.csi_normalize_batch.restype = None
+            lib.csi_num_windows.argtypes = [ctypes.c_int] * 3
+            lib.csi_num_windows.restype = ctypes.c_int
+            lib.csi_window_stats_sliding.argtypes = [_F32, _F32, _I8, ctypes.c_int, ctypes.c_int,
+                                                     ctypes.c_int, ctypes.c_int, _F32]
+            lib.csi_window_stats_sliding.restype = ctypes.c_int
+            lib.csi_quantize_int8.argtypes = [_F32, ctypes.c_int, ctypes.c_float, ctypes.c_int, _I8]
+            lib.csi_quantize_int8.restype = None
+            lib.csi_dequantize_int8.argtypes = [_I8, ctypes.c_int, ctypes.c_float, ctypes.c_int, _F32]
+            lib.csi_dequantize_int8.restype = None
+            return lib
+    return None
+
+
+_lib = _load_library()
+NATIVE = _lib is not None
+
+
+def pad_samples(samples, num_subcarriers):
+    """
+    Stack dataset samples into padded arrays.
+
+    Returns:
+        amplitude: (N, num_subcarriers) float32, zero-padded/truncated
+        phase:     (N, num_subcarriers) float32, zeros when missing
+        rssi:      (N,) int8
+    """
+    n = len(samples)
+    amp = np.zeros((n, num_subcarriers), dtype=np.float32)
+    phase = np.zeros((n, num_subcarriers), dtype=np.float32)
+    rssi = np.zeros(n, dtype=np.int8)
+    for i, s in enumerate(samples):
+        a = s['amp'][:num_subcarriers]
+        amp[i, :len(a)] = a
+        p = s.get('phase', [])[:num_subcarriers]
+        phase[i, :len(p)] = p
+        rssi[i] = np.clip(round(s.get('rssi', 0)), -128, 127)
+    return amp, phase, rssi
+
+
+def normalize(amplitude, phase):
+    """
+    Normalize samples into model input rows: [amp z-score, phase / pi].
+
+    Args:
+        amplitude, phase: (N, S) arrays
+    Returns:
+        (N, 2 * S) float32
+    """
+    amplitude = np.ascontiguousarray(amplitude, dtype=np.float32)
+    phase = np.ascontiguousarray(phase, dtype=np.float32)
+    n, s = amplitude.shape
+    out = np.empty((n, 2 * s), dtype=np.float32)
+    if NATIVE:
+        _lib.csi_normalize_batch(amplitude, phase, n, s, out)
+        return out
+
+    mean = amplitude.mean(axis=1, keepdims=True)
+    std = amplitude.std(axis=1, keepdims=True)
+    out[:, :s] = (amplitude - mean) / (std + 1e-6)
+    out[:, s:] = phase / np.float32(np.pi)
+    return out
+
+
+def num_windows(num_samples, window_size, stride=1):
+    """Number of sliding windows of window_size samples every stride samples"""
+    if num_samples < window_size:
+        return 0
+    return (num_samples - window_size) // stride + 1
+
+
+def sliding_windows(rows, window_size, stride=1):
+    """
+    View (N, F) rows as (num_windows, window_size, F) without copying.
+
+    The result is read-only and shares memory with rows; overlapping windows
+    do not duplicate data until the caller copies them.
+    """
+    count = num_windows(len(rows), window_size, stride)
+    if count == 0:
+        return np.empty((0, window_size) + rows.shape[1:], dtype=rows.dtype)
+    view = np.lib.stride_tricks.sliding_window_view(rows, window_size, axis=0)
+    # sliding_window_view puts the window axis last: (N', F, W) -> (N', W, F)
+    return np.moveaxis(view[::stride][:count], -1, 1)
+
+
+def window_stats(amplitude, phase, rssi, window_size, stride=1):
+    """
+    Firmware window statistics over every sliding window.
+
+    Returns:
+        (num_windows, 4) float32 with columns WINDOW_STAT_NAMES
+    """
+    amplitude = np.ascontiguousarray(amplitude, dtype=np.float32)
+    phase = np.ascontiguousarray(phase, dtype=np.float32)
+    rssi = np.ascontiguousarray(rssi, dtype=np.int8)
+    n, s = amplitude.shape
+    count = num_windows(n, window_size, stride)
+    out = np.empty((count, len(WINDOW_STAT_NAMES)), dtype=np.float32)
+    if count == 0:
+        return out
+    if NATIVE:
+        _lib.csi_window_stats_sliding(amplitude, phase, rssi, n, s, window_size, stride, out)
+        return out
+
+    amp_w = sliding_windows(amplitude, window_size, stride)
+    phase_w = sliding_windows(phase, window_size, stride)
+    out[:, 0] = amp_w.mean(axis=(1, 2))
+    out[:, 1] = amp_w.std(axis=(1, 2))
+    out[:, 2] = np.sqrt((phase_w.std(axis=1) ** 2).mean(axis=1))
+    # Integer division truncates toward zero, like the firmware
+    sums = sliding_windows(rssi.astype(np.int32)[:, None], window_size, stride).sum(axis=(1, 2))
+    out[:, 3] = np.trunc(sums / window_size)
+    return out
+
+
+def quantize(values, scale, zero_point):
+    """Quantize to int8 like the TFLite input tensor (round half away from zero)"""
+    values = np.ascontiguousarray(values, dtype=np.float32)
+    out = np.empty(values.shape, dtype=np.int8)
+    if NATIVE:
+        _lib.csi_quantize_int8(values.reshape(-1), values.size, scale, zero_point, out.reshape(-1))
+        return out
+    # float32 division like the C code, then lroundf() in float64, where +0.5 is exact
+    scaled = (values / np.float32(scale)).astype(np.float64)
+    q = np.sign(scaled) * np.floor(np.abs(scaled) + 0.5) + zero_point
+    out[...] = np.clip(q, -128, 127)
+    return out
+
+
+def dequantize(values, scale, zero_point):
+    """Inverse of quantize()"""
+    values = np.ascontiguousarray(values, dtype=np.int8)
+    out = np.empty(values.shape, dtype=np.float32)
+    if NATIVE:
+        _lib.csi_dequantize_int8(values.reshape(-1), values.size, scale, zero_point, out.reshape(-1))
+        return out
+    out[...] = (values.astype(np.float32) - zero_point) * np.float32(scale)
+    return out
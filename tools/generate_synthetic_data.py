@@ -58,6 +58,7 @@ class SyntheticCSIGenerator:
                 'amp': amp.tolist(),
                 'phase': phase.tolist(),
                 'label': 'empty',
+                'people': 0,
                 'description': 'Empty room - no person present'
             }
             samples.append(sample)
@@ -89,6 +90,7 @@ class SyntheticCSIGenerator:
                 'amp': amp.tolist(),
                 'phase': phase.tolist(),
                 'label': 'present',
+                'people': 1,
                 'description': 'Person present, sitting or standing still'
             }
             samples.append(sample)
@@ -126,6 +128,7 @@ class SyntheticCSIGenerator:
                 'amp': amp.tolist(),
                 'phase': phase.tolist(),
                 'label': 'moving',
+                'people': 1,
                 'description': 'Person moving around'
             }
             samples.append(sample)
@@ -163,6 +166,7 @@ class SyntheticCSIGenerator:
                 'amp': amp.tolist(),
                 'phase': phase.tolist(),
                 'label': 'walking',
+                'people': 1,
                 'description': 'Person walking back and forth'
             }
             samples.append(sample)
@@ -196,6 +200,7 @@ class SyntheticCSIGenerator:
                 'amp': amp.tolist(),
                 'phase': phase.tolist(),
                 'label': 'sitting',
+                'people': 1,
                 'description': 'Person sitting still'
             }
             samples.append(sample)
@@ -228,12 +233,121 @@ class SyntheticCSIGenerator:
                 'amp': amp.tolist(),
                 'phase': phase.tolist(),
                 'label': 'standing',
+                'people': 1,
                 'description': 'Person standing still'
             }
             samples.append(sample)
 
         return samples
 
+    def generate_group(self, num_people, num_samples=100):
+        """
+        Generate CSI data for several people moving independently.
+
+        Characteristics:
+        - Each person modulates the amplitude with their own motion signal
+          (gait plus irregular limb motion)
+        - Each person has their own pattern across subcarriers (their own
+          position in the multipath field), so the variations span about
+          one dimension per person
+        - High phase variance, fluctuating RSSI
+        """
+        n = self.num_subcarriers
+        index = np.arange(n)
+        patterns = []
+        people = []
+        for _ in range(num_people):
+            # Smooth random frequency response: a few cosines across subcarriers
+            pattern = sum(np.cos(2 * np.pi * np.random.uniform(0.2, 3.0) * index / n
+                                 + np.random.uniform(0, 2 * np.pi)) for _ in range(3))
+            patterns.append(pattern / np.sqrt(np.mean(pattern ** 2)))
+            people.append({
+                'strength': np.random.uniform(3.0, 7.0),   # Nearer people modulate more
+                'step_hz': np.random.uniform(1.5, 2.5),
+                'phase': np.random.uniform(0, 2 * np.pi),
+                'limb': 0.0,
+            })
+
+        samples = []
+        for i in range(num_samples):
+            t = i / self.sampling_rate
+            amp = np.random.normal(25.0, 2.0, n)
+            for person, pattern in zip(people, patterns):
+                # Irregular limb motion: smoothed noise, independent per person
+                person['limb'] = 0.8 * person['limb'] + np.random.normal(0, 0.6)
+                motion = np.sin(2 * np.pi * person['step_hz'] * t + person['phase']) + person['limb']
+                amp += person['strength'] * motion * pattern
+            amp = np.clip(amp, 0, None)
+
+            phase = np.random.normal(0, 0.3, n)
+            phase = np.clip(phase, -np.pi, np.pi)
+
+            sample = {
+                'ts': np.random.randint(100000, 999999),
+                'rssi': np.random.normal(-38, 5),
+                'num': n,
+                'amp': amp.tolist(),
+                'phase': phase.tolist(),
+                'label': 'moving',
+                'people': num_people,
+                'description': f'{num_people} people moving independently'
+            }
+            samples.append(sample)
+
+        return samples
+
+    def generate_fall(self, num_samples=100):
+        """
+        Generate CSI data for a fall: a short burst of violent motion, then
+        the person lying still for the rest of the segment.
+
+        Characteristics:
+        - Burst (0.3-0.6s): large, fast amplitude swings, more violent than
+          walking, with a body-sized pattern across subcarriers, high phase
+          variance
+        - Lying still: lower amplitude (body near the floor), low variance
+        - The first burst sample carries 'event': 'fall' (ground truth for
+          tools/host/event_replay)
+        """
+        n = self.num_subcarriers
+        index = np.arange(n)
+        pattern = np.cos(2 * np.pi * np.random.uniform(0.3, 2.0) * index / n
+                         + np.random.uniform(0, 2 * np.pi))
+        burst = min(num_samples, int(np.random.uniform(0.3, 0.6) * self.sampling_rate))
+        strength = np.random.uniform(10.0, 18.0)
+
+        samples = []
+        for i in range(num_samples):
+            if i < burst:
+                # Accelerating drop, then impact
+                x = i / burst
+                swing = strength * np.sin(np.pi * x) * np.sin(2 * np.pi * 3.0 * x * x)
+                amp = np.random.normal(25.0, 4.0 + 10.0 * np.sin(np.pi * x), n) + swing * pattern
+                phase = np.random.normal(0, 0.5, n)
+                rssi = np.random.normal(-40, 6)
+                label = 'moving'
+            else:
+                amp = np.random.normal(18.0, 1.8, n)
+                phase = np.random.normal(0, 0.1, n)
+                rssi = np.random.normal(-47, 2)
+                label = 'present'
+
+            sample = {
+                'ts': np.random.randint(100000, 999999),
+                'rssi': rssi,
+                'num': n,
+                'amp': np.clip(amp, 0, None).tolist(),
+                'phase': np.clip(phase, -np.pi, np.pi).tolist(),
+                'label': label,
+                'people': 1,
+                'description': 'Person falling, then lying still'
+            }
+            if i == 0:
+                sample['event'] = 'fall'
+            samples.append(sample)
+
+        return samples
+
     def generate_dataset(self, samples_per_class=100):
         """Generate complete synthetic dataset"""
         print("Generating synthetic CSI dataset...")
@@ -276,6 +390,71 @@ class SyntheticCSIGenerator:
 
         return dataset
 
+    def generate_session(self, duration_s=600, min_segment_s=3, max_segment_s=20,
+                         max_people=1, falls=False):
+        """
+        Generate a continuous recording: segments of one activity each, in
+        time order, the way the device would see a person come and go.
+
+        Unlike generate_dataset() the samples are not shuffled, so windows
+        cut from the recording are mostly single-label (useful for temporal
+        smoothing evaluation with tools/host/pose_eval).
+
+        With max_people > 1 some segments have 2..max_people people moving
+        at once (label 'moving', 'people' set to the count), for occupancy
+        evaluation.
+
+        With falls, fall segments (generate_fall()) follow segments with
+        someone in the room.
+        """
+        print(f"Generating synthetic CSI session ({duration_s}s)...")
+
+        generators = {
+            'empty': self.generate_empty_room,
+            'present': self.generate_person_present,
+            'moving': self.generate_moving,
+            'walking': self.generate_walking,
+            'sitting': self.generate_sitting,
+            'standing': self.generate_standing,
+        }
+        for people in range(2, max_people + 1):
+            generators[f'group{people}'] = (
+                lambda n, people=people: self.generate_group(people, n))
+        if falls:
+            generators['fall'] = self.generate_fall
+        labels = list(generators)
+
+        all_samples = []
+        remaining = duration_s * self.sampling_rate
+        label = 'empty'
+        while remaining > 0:
+            n = min(remaining, int(np.random.uniform(min_segment_s, max_segment_s)
+                                   * self.sampling_rate))
+            all_samples.extend(generators[label](n))
+            remaining -= n
+            # Nobody can fall in an empty room
+            label = np.random.choice([l for l in labels if l != label
+                                      and not (label == 'empty' and l == 'fall')])
+
+        # Timestamps in microseconds, one sample period apart
+        period_us = 1000000 // self.sampling_rate
+        for i, sample in enumerate(all_samples):
+            sample['ts'] = i * period_us
+
+        return {
+            'metadata': {
+                'generated_at': datetime.now().isoformat(),
+                'total_packets': len(all_samples),
+                'labels': list(set(s['label'] for s in all_samples)),
+                'synthetic': True,
+                'session_seconds': duration_s,
+                'max_people': max_people,
+                'falls': sum(1 for s in all_samples if s.get('event') == 'fall'),
+                'description': 'Synthetic continuous CSI session for ML pipeline testing'
+            },
+            'data': all_samples
+        }
+
 
 def main():
     parser = argparse.ArgumentParser(
@@ -295,6 +474,18 @@ Examples:
   # Generate with different subcarrier count
   python3 generate_synthetic_data.py --num-subcarriers 64
 
+  # Generate a 10-minute continuous session (time-ordered, not shuffled)
+  python3 generate_synthetic_data.py --session 600 --output datasets/session.json
+
+  # Session with up to 4 people at once (occupancy counting)
+  python3 generate_synthetic_data.py --session 600 --max-people 4 --output datasets/group.json
+
+  # An hour of long, mostly static segments (inference gating evaluation)
+  python3 generate_synthetic_data.py --session 3600 --segment-seconds 60 900 --output datasets/hour.json
+
+  # Session with falls (event detector evaluation)
+  python3 generate_synthetic_data.py --session 1200 --falls --output datasets/falls.json
+
 The synthetic data mimics real CSI statistical properties:
 - Empty room: Low variance
 - Person present: Medium variance
@@ -310,6 +501,20 @@ The synthetic data mimics real CSI statistical properties:
                        help='Number of WiFi subcarriers (default: 52)')
     parser.add_argument('--sampling-rate', type=int, default=100,
                        help='Sampling rate in Hz (default: 100)')
+    parser.add_argument('--session', type=int, metavar='SECONDS',
+                       help='Generate a continuous session of this length instead '
+                            'of shuffled per-class samples')
+    parser.add_argument('--max-people', type=int, default=1,
+                       help='With --session: also generate segments with up to this '
+                            'many people moving at once (default: 1)')
+    parser.add_argument('--segment-seconds', type=float, nargs=2, default=[3, 20],
+                       metavar=('MIN', 'MAX'),
+                       help='With --session: length range of the activity segments '
+                            '(default: 3 20; long segments resemble a day of mostly '
+                            'static scenes)')
+    parser.add_argument('--falls', action='store_true',
+                       help='With --session: also generate falls (a burst of motion, '
+                            'then lying still), marked with "event": "fall"')
 
     args = parser.parse_args()
 
@@ -320,7 +525,11 @@ The synthetic data mimics real CSI statistical properties:
     )
 
     # Generate dataset
-    dataset = generator.generate_dataset(args.samples_per_class)
+    if args.session:
+        dataset = generator.generate_session(args.session, *args.segment_seconds,
+                                             max_people=args.max_people, falls=args.falls)
+    else:
+        dataset = generator.generate_dataset(args.samples_per_class)
 
     # Create output directory
     output_path = Path(args.output)
@@ -346,6 +555,16 @@ The synthetic data mimics real CSI statistical properties:
     for label, count in sorted(label_counts.items()):
         print(f"  {label:15s}: {count:4d} samples")
 
+    if args.session and args.max_people > 1:
+        people_counts = {}
+        for sample in dataset['data']:
+            people_counts[sample['people']] = people_counts.get(sample['people'], 0) + 1
+        for people, count in sorted(people_counts.items()):
+            print(f"  {people} people      : {count:4d} samples")
+
+    if args.session and args.falls:
+        print(f"  Falls          : {dataset['metadata']['falls']:4d}")
+
     print("\nNext steps:")
     print("1. Analyze the synthetic data:")
     print("   python3 ../tools/analyze_csi.py", args.output)
@@ -0,0 +1,223 @@
+/**
+ * @file batch_infer_bench.c
+ * @brief Batched classifier (model_net.h) against one call per link
+ *
+ * Runs model_net.c and model_layers.c, compiled unchanged from
+ * firmware/main, on LightweightPoseModel with random weights over the
+ * build's window (pose_dims.h). Checks that:
+ *
+ *   - model_net_invoke() matches a plain reference forward pass (every
+ *     tap bounds-checked, pools into separate buffers) for each window
+ *   - every window of a batch of 1..MODEL_NET_MAX_BATCH gets the logits
+ *     of a batch of one, on one core and with the layers split
+ *
+ * Then, for B = 1..MODEL_NET_MAX_BATCH links completing a window in the
+ * same hop, times B calls of one window against one call of B windows.
+ * "Cold" evicts the caches before each hop, as when the weights come
+ * from flash/PSRAM; "warm" repeats the hop with everything cached. Every
+ * window of the hop is ready when the hop's last call returns, so the
+ * hop time is each window's latency. Prints the memory of each batch
+ * size. Exits non-zero if a check fails.
+ *
+ * Usage:
+ *   batch_infer_bench [--iterations 300]
+ */
+
+#include "bench_util.h"
+#include "model_net.h"
+#include "pose_dims.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define STEPS POSE_WINDOW_SAMPLES
+#define FEATURES POSE_MODEL_FEATURES
+#define NUM_CLASSES 6
+#define EVICT_BYTES (32u << 20)
+
+static uint8_t *s_evict;
+
+static int reference_pool(const int8_t *in, int steps, int ch, int8_t *out)
+{
+    for (int t = 0; t < steps / 2; t++) {
+        for (int c = 0; c < ch; c++) {
+            int8_t u = in[2 * t * ch + c], v = in[(2 * t + 1) * ch + c];
+            out[t * ch + c] = u > v ? u : v;
+        }
+    }
+    return steps / 2;
+}
+
+/**
+ * @brief One window through the stack, each activation in its own buffer
+ */
+static void reference_forward(const model_net_t *net, const int8_t *in, int8_t *logits)
+{
+    const model_layer_t *l = net->layers;
+    static int8_t c1[STEPS * 64], p1[STEPS * 64], c2[STEPS * 64], p2[STEPS * 64], c3[STEPS * 64];
+    int8_t gap[64], d1[64], d2[64];
+    int steps = STEPS;
+    bench_reference_conv1d(&l[MODEL_NET_CONV1], in, steps, true, c1);
+    steps = reference_pool(c1, steps, l[MODEL_NET_CONV1].out_ch, p1);
+    bench_reference_conv1d(&l[MODEL_NET_CONV2], p1, steps, true, c2);
+    steps = reference_pool(c2, steps, l[MODEL_NET_CONV2].out_ch, p2);
+    bench_reference_conv1d(&l[MODEL_NET_CONV3], p2, steps, true, c3);
+    for (int c = 0; c < l[MODEL_NET_CONV3].out_ch; c++) {
+        int32_t sum = 0;
+        for (int t = 0; t < steps; t++) {
+            sum += c3[t * l[MODEL_NET_CONV3].out_ch + c];
+        }
+        gap[c] = (int8_t)lround((double)sum / steps);
+    }
+    bench_reference_conv1d(&l[MODEL_NET_DENSE1], gap, 1, true, d1);
+    bench_reference_conv1d(&l[MODEL_NET_DENSE2], d1, 1, true, d2);
+    bench_reference_conv1d(&l[MODEL_NET_CLASSES], d2, 1, false, logits);
+}
+
+/* ---- Split backend that runs the other half at once, to exercise the split ---- */
+
+static bool inline_start(void *ctx, model_range_fn_t fn, void *arg, int ch_begin, int ch_end)
+{
+    (void)ctx;
+    fn(arg, ch_begin, ch_end);
+    return true;
+}
+
+static void inline_wait(void *ctx)
+{
+    (void)ctx;
+}
+
+/**
+ * @brief Touch a buffer larger than the caches, so the weights are cold
+ */
+static void evict_caches(void)
+{
+    for (size_t i = 0; i < EVICT_BYTES; i += 64) {
+        s_evict[i]++;
+    }
+}
+
+/**
+ * @brief Microseconds per hop of `links` windows, batched or one call per link
+ */
+static double time_hop(const model_net_t *net, const int8_t *in, int links, bool batched,
+                       bool cold, int iterations, int8_t *scratch, int8_t *logits)
+{
+    const size_t window = (size_t)STEPS * FEATURES;
+    double total = 0.0;
+    for (int it = 0; it < iterations; it++) {
+        if (cold) {
+            evict_caches();
+        }
+        double t0 = bench_now_s();
+        if (batched) {
+            model_net_invoke(net, NULL, in, links, scratch, logits);
+        } else {
+            for (int b = 0; b < links; b++) {
+                model_net_invoke(net, NULL, &in[b * window], 1, scratch, &logits[b * NUM_CLASSES]);
+            }
+        }
+        total += bench_now_s() - t0;
+    }
+    return total * 1e6 / iterations;
+}
+
+int main(int argc, char **argv)
+{
+    int iterations = 300;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "Usage: %s [--iterations N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (iterations <= 0) {
+        fprintf(stderr, "Iterations must be positive\n");
+        return 2;
+    }
+
+    model_net_t net = {
+        .layers = {
+            [MODEL_NET_CONV1] = bench_make_layer(FEATURES, 32, 5),
+            [MODEL_NET_CONV2] = bench_make_layer(32, 64, 5),
+            [MODEL_NET_CONV3] = bench_make_layer(64, 64, 3),
+            [MODEL_NET_DENSE1] = bench_make_layer(64, 64, 1),
+            [MODEL_NET_DENSE2] = bench_make_layer(64, 32, 1),
+            [MODEL_NET_CLASSES] = bench_make_layer(32, NUM_CLASSES, 1),
+        },
+        .steps = STEPS,
+    };
+    if (!model_net_valid(&net)) {
+        FAIL("the reference model's shapes are rejected");
+        return 1;
+    }
+    model_net_t broken = net;
+    broken.layers[MODEL_NET_CONV2].in_ch++;
+    CHECK(!model_net_valid(&broken), "layers that do not chain are accepted");
+
+    const size_t window = (size_t)STEPS * FEATURES;
+    int8_t *in = bench_random_int8(window * MODEL_NET_MAX_BATCH);
+    int8_t *scratch = malloc(model_net_scratch_bytes(&net, MODEL_NET_MAX_BATCH));
+    int8_t expected[MODEL_NET_MAX_BATCH][NUM_CLASSES];
+    int8_t logits[MODEL_NET_MAX_BATCH * NUM_CLASSES];
+
+    // Each window against the reference, then every batch size against it
+    for (int b = 0; b < MODEL_NET_MAX_BATCH; b++) {
+        int8_t ref[NUM_CLASSES];
+        reference_forward(&net, &in[b * window], ref);
+        model_net_invoke(&net, NULL, &in[b * window], 1, scratch, expected[b]);
+        CHECK(memcmp(ref, expected[b], NUM_CLASSES) == 0,
+              "window %d differs from the reference forward pass", b);
+    }
+    model_split_t split = { inline_start, inline_wait, NULL, 0 };
+    for (int batch = 1; batch <= MODEL_NET_MAX_BATCH; batch++) {
+        for (int s = 0; s < 2; s++) {
+            memset(logits, 0, sizeof(logits));
+            model_net_invoke(&net, s ? &split : NULL, in, batch, scratch, logits);
+            CHECK(memcmp(logits, expected, (size_t)batch * NUM_CLASSES) == 0,
+                  "batch of %d%s differs from one window at a time", batch, s ? " (split)" : "");
+        }
+    }
+
+    size_t weight_bytes = 0;
+    for (int i = 0; i < MODEL_NET_LAYERS; i++) {
+        weight_bytes += bench_layer_bytes(&net.layers[i]);
+    }
+    printf("Window %d samples x %d features, %zu bytes of weights, %d iterations\n",
+           STEPS, FEATURES, weight_bytes, iterations);
+
+    // Latency is the hop time; weights are the bytes read from flash/PSRAM
+    // per hop when they do not stay cached between calls, as on the device
+    s_evict = calloc(EVICT_BYTES, 1);
+    time_hop(&net, in, MODEL_NET_MAX_BATCH, true, false, iterations, scratch, logits);
+    for (int cold = 1; cold >= 0; cold--) {
+        printf("\n%s caches\n", cold ? "Cold" : "Warm");
+        printf("  %2s %11s %11s %8s %11s %10s %14s %10s\n", "B", "per-link us", "batched us",
+               "speedup", "us/window", "windows/s", "weights KB", "memory");
+        for (int links = 1; links <= MODEL_NET_MAX_BATCH; links++) {
+            double per_link = time_hop(&net, in, links, false, cold, iterations, scratch, logits);
+            double batched = time_hop(&net, in, links, true, cold, iterations, scratch, logits);
+            size_t memory = model_net_scratch_bytes(&net, links) + links * window +
+                            (size_t)links * NUM_CLASSES;
+            printf("  %2d %11.1f %11.1f %7.2fx %11.1f %10.0f %6.1f -> %4.1f %9zuB\n", links,
+                   per_link, batched, per_link / batched, batched / links, links * 1e6 / batched,
+                   links * weight_bytes / 1024.0, weight_bytes / 1024.0, memory);
+        }
+    }
+    printf("\n");
+
+    for (int i = 0; i < MODEL_NET_LAYERS; i++) {
+        bench_free_layer(&net.layers[i]);
+    }
+    free(in);
+    free(scratch);
+    free(s_evict);
+
+    printf("%s\n", bench_failures() == 0 ? "PASS" : "FAILED");
+    return bench_failures() == 0 ? 0 : 1;
+}
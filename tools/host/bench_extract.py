@@ -0,0 +1,93 @@
+#!/usr/bin/env python3
+"""
+Benchmark csi_extract against the Python windowing path
+
+Runs CSIDataPreprocessor.load_dataset() from train_pose_model.py and the
+csi_extract CLI on the same dataset, each in its own process, and reports
+windows/s and peak resident memory for both.
+
+Usage:
+    python3 tools/host/bench_extract.py datasets/synthetic_csi.json \
+        --cli build/host/csi_extract --threads 8
+
+Requires the training requirements (models/training/requirements.txt)
+for the Python path.
+"""
+
+import argparse
+import re
+import subprocess
+import sys
+import tempfile
+from pathlib import Path
+
+REPO_ROOT = Path(__file__).resolve().parents[2]
+
+PYTHON_PATH_SCRIPT = r"""
+import resource, sys, time
+sys.path.insert(0, {training_dir!r})
+from train_pose_model import CSIDataPreprocessor
+start = time.perf_counter()
+X, y = CSIDataPreprocessor({window}, {subcarriers}).load_dataset({dataset!r})
+elapsed = time.perf_counter() - start
+peak_kb = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+print(f"RESULT windows={{len(X)}} seconds={{elapsed:.6f}} peak_kb={{peak_kb}}")
+"""
+
+
+def run_python_path(dataset, window, subcarriers):
+    script = PYTHON_PATH_SCRIPT.format(
+        training_dir=str(REPO_ROOT / 'models' / 'training'),
+        window=window, subcarriers=subcarriers, dataset=str(dataset))
+    out = subprocess.run([sys.executable, '-c', script], capture_output=True, text=True)
+    if out.returncode != 0:
+        print(out.stderr, file=sys.stderr)
+        raise RuntimeError('Python path failed')
+    m = re.search(r'RESULT windows=(\d+) seconds=([\d.]+) peak_kb=(\d+)', out.stdout)
+    return int(m.group(1)), float(m.group(2)), int(m.group(3)) / 1024.0
+
+
+def run_cli(cli, dataset, window, subcarriers, threads, write_windows):
+    with tempfile.TemporaryDirectory() as out_dir:
+        cmd = [str(cli), str(dataset), '--out', out_dir,
+               '--window', str(window), '--subcarriers', str(subcarriers)]
+        if threads:
+            cmd += ['--threads', str(threads)]
+        if not write_windows:
+            cmd.append('--no-windows')
+        out = subprocess.run(cmd, capture_output=True, text=True, check=True).stdout
+    windows = int(re.search(r'(\d+) windows', out).group(1))
+    seconds = float(re.search(r'Time:\s+([\d.]+)', out).group(1))
+    peak_mb = float(re.search(r'Peak RSS:\s+([\d.]+)', out).group(1))
+    return windows, seconds, peak_mb
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Benchmark csi_extract vs the Python path')
+    parser.add_argument('dataset', help='Dataset JSON file')
+    parser.add_argument('--cli', default='build/host/csi_extract', help='Path to csi_extract')
+    parser.add_argument('--window-size', type=int, default=50)
+    parser.add_argument('--num-subcarriers', type=int, default=52)
+    parser.add_argument('--threads', type=int, default=0, help='csi_extract threads (0 = all)')
+    parser.add_argument('--skip-python', action='store_true', help='Only benchmark the CLI')
+    args = parser.parse_args()
+
+    rows = []
+    if not args.skip_python:
+        rows.append(('python create_windows',)
+                    + run_python_path(args.dataset, args.window_size, args.num_subcarriers))
+    rows.append(('csi_extract (windows)',)
+                + run_cli(args.cli, args.dataset, args.window_size, args.num_subcarriers,
+                          args.threads, True))
+    rows.append(('csi_extract (stats only)',)
+                + run_cli(args.cli, args.dataset, args.window_size, args.num_subcarriers,
+                          args.threads, False))
+
+    print(f"\n{'path':28s} {'windows':>9s} {'seconds':>9s} {'windows/s':>11s} {'peak MB':>9s}")
+    for name, windows, seconds, peak_mb in rows:
+        rate = windows / seconds if seconds > 0 else 0.0
+        print(f"{name:28s} {windows:9d} {seconds:9.3f} {rate:11.0f} {peak_mb:9.1f}")
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,132 @@
+#!/usr/bin/env python3
+"""
+Parity check and benchmark for the csi_features Python bindings
+
+Feeds the same synthetic CSI through three paths and compares them:
+  reference  - the original per-sample NumPy code from train_pose_model.py
+               (parse_sample) and the firmware's run_inference() math
+  native     - csi_features.py backed by libcsi_features (firmware C code)
+  fallback   - csi_features.py NumPy implementation (library not built)
+
+Exits non-zero if any path disagrees with the reference beyond tolerance.
+
+Usage:
+    cmake -S tools/host -B build/host && cmake --build build/host
+    python3 tools/host/bench_features.py --samples 20000
+"""
+
+import argparse
+import sys
+import time
+from pathlib import Path
+
+import numpy as np
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[1]))
+import csi_features  # noqa: E402
+
+TOLERANCE = 1e-4
+
+
+def reference_normalize(samples, num_subcarriers):
+    """parse_sample() as it was written in train_pose_model.py"""
+    rows = []
+    for sample in samples:
+        amp = np.array(sample['amp'], dtype=np.float32)[:num_subcarriers]
+        phase = np.array(sample['phase'], dtype=np.float32)[:num_subcarriers]
+        amp = (amp - np.mean(amp)) / (np.std(amp) + 1e-6)
+        rows.append(np.concatenate([amp, phase / np.pi]))
+    return np.array(rows, dtype=np.float32)
+
+
+def reference_window_stats(amp, phase, rssi, window_size):
+    """run_inference() statistics, one window at a time"""
+    out = []
+    for i in range(len(amp) - window_size + 1):
+        a = amp[i:i + window_size]
+        p = phase[i:i + window_size]
+        out.append([a.mean(), a.std(), np.sqrt((p.std(axis=0) ** 2).mean()),
+                    int(np.sum(rssi[i:i + window_size], dtype=np.int32) / window_size)])
+    return np.array(out, dtype=np.float32)
+
+
+def reference_quantize(values, scale, zero_point):
+    """csi_quantize_int8(): lroundf() of the float32 quotient x / scale"""
+    scaled = (np.asarray(values, dtype=np.float32) / np.float32(scale)).astype(np.float64)
+    q = np.sign(scaled) * np.floor(np.abs(scaled) + 0.5) + zero_point
+    return np.clip(q, -128, 127).astype(np.int8)
+
+
+def timed(fn, repeat):
+    best = float('inf')
+    result = None
+    for _ in range(repeat):
+        start = time.perf_counter()
+        result = fn()
+        best = min(best, time.perf_counter() - start)
+    return result, best
+
+
+def main():
+    parser = argparse.ArgumentParser(description='csi_features parity check and benchmark')
+    parser.add_argument('--samples', type=int, default=5000)
+    parser.add_argument('--num-subcarriers', type=int, default=52)
+    parser.add_argument('--window-size', type=int, default=50)
+    parser.add_argument('--repeat', type=int, default=3)
+    args = parser.parse_args()
+
+    rng = np.random.default_rng(0)
+    n, s = args.samples, args.num_subcarriers
+    samples = [{
+        'amp': np.abs(rng.normal(25.0, 4.0, s)).tolist(),
+        'phase': rng.uniform(-np.pi, np.pi, s).tolist(),
+        'rssi': float(rng.normal(-50, 3)),
+    } for _ in range(n)]
+
+    amp, phase, rssi = csi_features.pad_samples(samples, s)
+    ref_norm, t_ref_norm = timed(lambda: reference_normalize(samples, s), args.repeat)
+    ref_stats, t_ref_stats = timed(
+        lambda: reference_window_stats(amp, phase, rssi, args.window_size), 1)
+    q_scale, q_zero = 0.02, -3
+    ties = ((np.arange(-150, 150) + 0.5) * np.float32(q_scale)).astype(np.float32)
+
+    native = csi_features.NATIVE
+    paths = (['native'] if native else []) + ['fallback']
+    results = []
+    failed = False
+    for path in paths:
+        csi_features.NATIVE = path == 'native'
+        norm, t_norm = timed(lambda: csi_features.normalize(amp, phase), args.repeat)
+        stats, t_stats = timed(
+            lambda: csi_features.window_stats(amp, phase, rssi, args.window_size), args.repeat)
+        quant, t_quant = timed(lambda: csi_features.quantize(norm, q_scale, q_zero), args.repeat)
+
+        err_norm = float(np.abs(norm - ref_norm).max())
+        err_stats = float(np.abs(stats - ref_stats).max())
+        # The values plus exact .5 ties, which a reciprocal multiply rounds differently
+        err_quant = max(
+            int(np.abs(quant.astype(int) - reference_quantize(norm, q_scale, q_zero)).max()),
+            int(np.abs(csi_features.quantize(ties, q_scale, q_zero).astype(int) -
+                       reference_quantize(ties, q_scale, q_zero)).max()))
+        ok = err_norm < TOLERANCE and err_stats < TOLERANCE * 100 and err_quant == 0
+        failed |= not ok
+        results.append((path, t_norm, t_stats, t_quant, err_norm, err_stats, err_quant, ok))
+    csi_features.NATIVE = native
+
+    print(f"{n} samples x {s} subcarriers, window={args.window_size}")
+    print(f"  reference normalize:    {t_ref_norm * 1e3:9.2f} ms")
+    print(f"  reference window stats: {t_ref_stats * 1e3:9.2f} ms\n")
+    print(f"{'path':10s} {'normalize':>11s} {'speedup':>8s} {'stats':>11s} {'speedup':>8s} "
+          f"{'quantize':>10s} {'max err':>10s} {'parity':>7s}")
+    for path, t_norm, t_stats, t_quant, e_norm, e_stats, e_quant, ok in results:
+        print(f"{path:10s} {t_norm * 1e3:9.2f}ms {t_ref_norm / t_norm:7.1f}x "
+              f"{t_stats * 1e3:9.2f}ms {t_ref_stats / t_stats:7.1f}x {t_quant * 1e3:8.2f}ms "
+              f"{max(e_norm, e_stats):10.2e} {'OK' if ok else 'FAIL':>7s}")
+    if not native:
+        print("\nNote: libcsi_features not found, native path skipped (build tools/host first)")
+
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == '__main__':
+    main()
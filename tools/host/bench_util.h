@@ -0,0 +1,182 @@
+/**
+ * @file bench_util.h
+ * @brief Fixtures shared by the host benches and checks
+ *
+ * - bench_now_s(): monotonic time
+ * - A fixed-seed xorshift generator, so every run sees the same data
+ * - CHECK()/FAIL(): print a failure and count it; bench_checks() and
+ *   bench_failures() for the summary and exit status
+ * - Random int8 layers for model_layers.h, and a plain reference Conv1D
+ *   that bounds-checks every tap, to compare the kernels against
+ *
+ * Header-only: each bench is a single translation unit.
+ */
+
+#ifndef BENCH_UTIL_H
+#define BENCH_UTIL_H
+
+#include "model_layers.h"
+
+#include <math.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static inline double bench_now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* ---- Random numbers ---- */
+
+static inline uint64_t *bench_rng(void)
+{
+    static uint64_t state = 0x9E3779B97F4A7C15ull;
+    return &state;
+}
+
+static inline uint32_t bench_random(void)
+{
+    uint64_t *s = bench_rng();
+    *s ^= *s << 13;
+    *s ^= *s >> 7;
+    *s ^= *s << 17;
+    return (uint32_t)(*s >> 32);
+}
+
+/**
+ * @brief Uniform in (0, 1), never 0, so it can go through logf()
+ */
+static inline float bench_uniform(void)
+{
+    return ((bench_random() >> 8) + 0.5f) / (float)(1 << 24);
+}
+
+static inline float bench_gaussian(void)
+{
+    return sqrtf(-2.0f * logf(bench_uniform())) * cosf(2.0f * (float)M_PI * bench_uniform());
+}
+
+static inline int8_t *bench_random_int8(size_t n)
+{
+    int8_t *p = malloc(n);
+    for (size_t i = 0; i < n; i++) {
+        p[i] = (int8_t)(bench_random() >> 24);
+    }
+    return p;
+}
+
+/* ---- Pass/fail tally ---- */
+
+// Atomic, so the stress tests can fail from any thread
+typedef struct {
+    atomic_int checks;
+    atomic_int failures;
+} bench_tally_t;
+
+static inline bench_tally_t *bench_tally(void)
+{
+    static bench_tally_t tally;
+    return &tally;
+}
+
+static inline int bench_checks(void)
+{
+    return bench_tally()->checks;
+}
+
+static inline int bench_failures(void)
+{
+    return bench_tally()->failures;
+}
+
+// Print "FAIL: <message>" and count it
+#define FAIL(...) do { \
+        fprintf(stderr, "FAIL: " __VA_ARGS__); \
+        fputc('\n', stderr); \
+        bench_tally()->failures++; \
+    } while (0)
+
+// Count a check; FAIL() with the message if cond is false
+#define CHECK(cond, ...) do { \
+        bench_tally()->checks++; \
+        if (!(cond)) { \
+            FAIL(__VA_ARGS__); \
+        } \
+    } while (0)
+
+/* ---- Model layers ---- */
+
+/**
+ * @brief A random-weight layer, requantized to keep ~3 sigma in range
+ *
+ * Free it with bench_free_layer().
+ */
+static inline model_layer_t bench_make_layer(int in_ch, int out_ch, int kernel)
+{
+    double scale = 127.0 / (3.0 * 74.0 * 74.0 * sqrt((double)in_ch * kernel));
+    int shift = 30;
+    while (scale < 0.5) {
+        scale *= 2.0;
+        shift++;
+    }
+    int32_t *bias = malloc((size_t)out_ch * sizeof(int32_t));
+    for (int o = 0; o < out_ch; o++) {
+        bias[o] = (int32_t)(bench_random() % 2001) - 1000;
+    }
+    model_layer_t l = { in_ch, out_ch, kernel, bench_random_int8((size_t)out_ch * kernel * in_ch),
+                        bias, (int32_t)(scale * (1 << 30)), shift };
+    if (!model_layer_valid(&l)) {
+        FAIL("random layer %dx%dx%d is invalid", out_ch, kernel, in_ch);
+    }
+    return l;
+}
+
+static inline void bench_free_layer(model_layer_t *l)
+{
+    free((void *)l->weights);
+    free((void *)l->bias);
+}
+
+/**
+ * @brief Weights plus bias, in bytes
+ */
+static inline size_t bench_layer_bytes(const model_layer_t *l)
+{
+    return (size_t)l->out_ch * l->kernel * l->in_ch + (size_t)l->out_ch * sizeof(int32_t);
+}
+
+/**
+ * @brief Plain Conv1D, 'same' padding, every tap bounds-checked
+ */
+static inline void bench_reference_conv1d(const model_layer_t *l, const int8_t *in, int steps,
+                                          bool relu, int8_t *out)
+{
+    const int pad = l->kernel / 2;
+    for (int t = 0; t < steps; t++) {
+        for (int o = 0; o < l->out_ch; o++) {
+            int32_t acc = l->bias[o];
+            for (int k = 0; k < l->kernel; k++) {
+                int src = t + k - pad;
+                if (src < 0 || src >= steps) {
+                    continue;
+                }
+                for (int c = 0; c < l->in_ch; c++) {
+                    acc += in[(size_t)src * l->in_ch + c] *
+                           l->weights[((size_t)o * l->kernel + k) * l->in_ch + c];
+                }
+            }
+            out[(size_t)t * l->out_ch + o] = model_requantize(acc, l->multiplier, l->shift, relu);
+        }
+    }
+}
+
+#endif // BENCH_UTIL_H
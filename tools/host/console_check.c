@@ -0,0 +1,324 @@
+/**
+ * @file console_check.c
+ * @brief Checks of the serial console's parser, setters and saved format
+ *
+ * Runs console_cmd.c, compiled unchanged from firmware/main, through the
+ * cases the device sees on its UART: line assembly (CR, LF, CRLF,
+ * backspace, overlong lines), command parsing, every setting with valid,
+ * out-of-range and malformed values, JSON replies, and the "key=value"
+ * text saved in NVS (round trip, unknown keys, rejected values, short
+ * buffers). Also checks that the tuned detector follows its thresholds.
+ *
+ * Prints each failed check and exits non-zero if there is any.
+ *
+ * Usage:
+ *   console_check
+ */
+
+#include "bench_util.h"
+#include "console_cmd.h"
+#include "pose_pipeline.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+
+static void default_settings(console_settings_t *s)
+{
+    memset(s, 0, sizeof(*s));
+    s->tuning = (pose_tuning_t){
+        .empty_amp_std = POSE_DEFAULT_EMPTY_AMP_STD,
+        .moving_phase_var = POSE_DEFAULT_MOVING_PHASE_VAR,
+        .moving_level = POSE_DEFAULT_MOVING_LEVEL,
+        .smoothing_lag = 2,
+        .smoothing_stay_permille = 900,
+        .gate_refresh = 10,
+        .event_threshold = 12.0f,
+    };
+    s->output = CONSOLE_OUTPUT_CSI | CONSOLE_OUTPUT_JSON;
+    s->decimation = 1;
+    s->traffic_hz = 100;
+}
+
+static int key_index(const char *name)
+{
+    for (int k = 0; k < console_key_count(); k++) {
+        if (strcmp(console_key_name(k), name) == 0) {
+            return k;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Feed text to a line assembler, collecting completed lines
+ *
+ * Overflowed lines are collected as "!".
+ */
+static int feed(console_line_t *line, const char *text, char out[][CONSOLE_LINE_MAX + 1],
+                int max_lines)
+{
+    int n = 0;
+    for (const char *p = text; *p != '\0'; p++) {
+        if (console_line_push(line, *p) && n < max_lines) {
+            strcpy(out[n++], line->overflow ? "!" : line->buf);
+        }
+    }
+    return n;
+}
+
+static void check_lines(void)
+{
+    console_line_t line = {0};
+    char out[8][CONSOLE_LINE_MAX + 1];
+
+    int n = feed(&line, "get\r\nset decimation 5\n\n\r\nhelp\r", out, 8);
+    CHECK(n == 3 && strcmp(out[0], "get") == 0 && strcmp(out[1], "set decimation 5") == 0 &&
+              strcmp(out[2], "help") == 0,
+          "CR/LF/CRLF line ends: %d lines", n);
+
+    n = feed(&line, "gex\bt\x7f\x7ft decimation\n", out, 8);
+    CHECK(n == 1 && strcmp(out[0], "gt decimation") == 0, "backspace: '%s'", n ? out[0] : "");
+
+    char longline[CONSOLE_LINE_MAX + 40];
+    memset(longline, 'x', sizeof(longline) - 2);
+    longline[sizeof(longline) - 2] = '\n';
+    longline[sizeof(longline) - 1] = '\0';
+    n = feed(&line, longline, out, 8);
+    CHECK(n == 1 && strcmp(out[0], "!") == 0, "overlong line rejected");
+    n = feed(&line, "\nstats\n", out, 8);
+    CHECK(n == 1 && strcmp(out[0], "stats") == 0, "recovers after an overlong line");
+
+    memset(longline, 'y', CONSOLE_LINE_MAX);
+    longline[CONSOLE_LINE_MAX] = '\r';
+    longline[CONSOLE_LINE_MAX + 1] = '\0';
+    n = feed(&line, longline, out, 8);
+    CHECK(n == 1 && strlen(out[0]) == CONSOLE_LINE_MAX, "line of exactly CONSOLE_LINE_MAX");
+}
+
+static void check_parse(void)
+{
+    static const struct {
+        const char *line;
+        esp_err_t err;
+        console_cmd_t cmd;
+        const char *key;
+        const char *value;
+    } cases[] = {
+        { "help", ESP_OK, CONSOLE_CMD_HELP, NULL, NULL },
+        { "  get  ", ESP_OK, CONSOLE_CMD_GET, NULL, NULL },
+        { "get decimation", ESP_OK, CONSOLE_CMD_GET, "decimation", NULL },
+        { "set\ttraffic_hz   50", ESP_OK, CONSOLE_CMD_SET, "traffic_hz", "50" },
+        { "set output json,binary", ESP_OK, CONSOLE_CMD_SET, "output", "json,binary" },
+        { "save", ESP_OK, CONSOLE_CMD_SAVE, NULL, NULL },
+        { "load", ESP_OK, CONSOLE_CMD_LOAD, NULL, NULL },
+        { "defaults", ESP_OK, CONSOLE_CMD_DEFAULTS, NULL, NULL },
+        { "stats", ESP_OK, CONSOLE_CMD_STATS, NULL, NULL },
+        { "hist", ESP_OK, CONSOLE_CMD_HIST, NULL, NULL },
+        { "", ESP_ERR_NOT_FOUND, 0, NULL, NULL },
+        { "reboot", ESP_ERR_NOT_FOUND, 0, NULL, NULL },
+        { "GET", ESP_ERR_NOT_FOUND, 0, NULL, NULL },
+        { "get window", ESP_ERR_NOT_FOUND, 0, NULL, NULL },
+        { "set window 5", ESP_ERR_NOT_FOUND, 0, NULL, NULL },
+        { "set decimation", ESP_ERR_INVALID_ARG, 0, NULL, NULL },
+        { "set decimation 5 6", ESP_ERR_INVALID_ARG, 0, NULL, NULL },
+        { "save now", ESP_ERR_INVALID_ARG, 0, NULL, NULL },
+        { "get a b c d e", ESP_ERR_INVALID_ARG, 0, NULL, NULL },
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        char line[CONSOLE_LINE_MAX + 1];
+        snprintf(line, sizeof(line), "%s", cases[i].line);
+        console_command_t cmd;
+        esp_err_t err = console_parse(line, &cmd);
+        CHECK(err == cases[i].err, "parse '%s': error 0x%x, expected 0x%x", cases[i].line, err,
+              cases[i].err);
+        if (err != ESP_OK || cases[i].err != ESP_OK) {
+            continue;
+        }
+        CHECK(cmd.cmd == cases[i].cmd, "parse '%s': command %d", cases[i].line, cmd.cmd);
+        int key = cases[i].key ? key_index(cases[i].key) : -1;
+        CHECK(cmd.key == key, "parse '%s': key %d, expected %d", cases[i].line, cmd.key, key);
+        CHECK((cmd.value == NULL) == (cases[i].value == NULL) &&
+                  (cmd.value == NULL || strcmp(cmd.value, cases[i].value) == 0),
+              "parse '%s': value '%s'", cases[i].line, cmd.value ? cmd.value : "(null)");
+    }
+}
+
+static void check_set(void)
+{
+    static const struct {
+        const char *key;
+        const char *value;
+        bool ok;
+    } cases[] = {
+        { "empty_amp_std", "3.5", true },
+        { "empty_amp_std", "0", false },
+        { "empty_amp_std", "1e3", false },
+        { "empty_amp_std", "nan", false },
+        { "empty_amp_std", "2.0x", false },
+        { "moving_phase_var", "0.25", true },
+        { "moving_level", "1", true },
+        { "moving_level", "-0.1", false },
+        { "smoothing_lag", "-1", true },
+        { "smoothing_lag", "8", true },
+        { "smoothing_lag", "9", false },
+        { "smoothing_lag", "2.5", false },
+        { "smoothing_stay", "999", true },
+        { "smoothing_stay", "1000", false },
+        { "gate_refresh", "1", true },
+        { "gate_refresh", "0", false },
+        { "event_threshold", "20", true },
+        { "event_threshold", "", false },
+        { "output", "none", true },
+        { "output", "binary,json", true },
+        { "output", "csi", true },
+        { "output", "json,", false },
+        { "output", "json,xml", false },
+        { "decimation", "100", true },
+        { "decimation", "101", false },
+        { "decimation", "99999999999999999999", false },
+        { "traffic_hz", "1", true },
+        { "traffic_hz", "0", false },
+        { "traffic_hz", "500", false },
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        console_settings_t before, s;
+        default_settings(&before);
+        s = before;
+        int key = key_index(cases[i].key);
+        CHECK(key >= 0, "key %s exists", cases[i].key);
+        esp_err_t err = console_settings_set(&s, key, cases[i].value);
+        CHECK((err == ESP_OK) == cases[i].ok, "set %s '%s': 0x%x", cases[i].key, cases[i].value,
+              err);
+        if (err != ESP_OK) {
+            CHECK(memcmp(&s, &before, sizeof(s)) == 0, "set %s '%s' failed but changed settings",
+                  cases[i].key, cases[i].value);
+        }
+    }
+
+    console_settings_t s;
+    default_settings(&s);
+    CHECK(console_settings_set(&s, console_key_count(), "1") == ESP_ERR_NOT_FOUND, "bad key index");
+    console_settings_set(&s, key_index("output"), "binary,json");
+    CHECK(s.output == (CONSOLE_OUTPUT_JSON | CONSOLE_OUTPUT_BINARY), "output bits %d", s.output);
+    console_settings_set(&s, key_index("moving_phase_var"), "0.25");
+    CHECK(s.tuning.moving_phase_var == 0.25f, "tuning field set");
+
+    for (int k = 0; k < console_key_count(); k++) {
+        CHECK(console_key_help(k) != NULL && strlen(console_key_help(k)) > 0, "help of %s",
+              console_key_name(k));
+    }
+    CHECK(console_key_name(-1) == NULL && console_key_name(console_key_count()) == NULL,
+          "key name out of range");
+}
+
+static void check_json(void)
+{
+    console_settings_t s;
+    default_settings(&s);
+    char buf[512];
+
+    size_t len = console_settings_json(&s, key_index("output"), buf, sizeof(buf));
+    CHECK(strcmp(buf, "\"output\":\"csi,json\"") == 0 && len == strlen(buf), "one key: %s", buf);
+
+    s.output = 0;
+    console_settings_json(&s, key_index("output"), buf, sizeof(buf));
+    CHECK(strcmp(buf, "\"output\":\"none\"") == 0, "no output: %s", buf);
+
+    len = console_settings_json(&s, -1, buf, sizeof(buf));
+    CHECK(strstr(buf, "\"decimation\":1") != NULL && strstr(buf, "\"empty_amp_std\":2") != NULL &&
+              strstr(buf, "\"event_threshold\":12") != NULL && buf[len - 1] != ',',
+          "all keys: %s", buf);
+
+    char small[16];
+    len = console_settings_json(&s, -1, small, sizeof(small));
+    CHECK(len == sizeof(small) - 1 && strlen(small) == len, "truncated JSON terminated");
+}
+
+static void check_saved(void)
+{
+    console_settings_t s, loaded;
+    default_settings(&s);
+    s.tuning.empty_amp_std = 3.25f;
+    s.tuning.moving_level = 0.45f;
+    s.tuning.smoothing_lag = -1;
+    s.tuning.gate_refresh = 1;
+    s.tuning.event_threshold = 17.5f;
+    s.output = CONSOLE_OUTPUT_BINARY;
+    s.decimation = 4;
+    s.traffic_hz = 50;
+
+    char text[512];
+    size_t len = console_settings_save(&s, text, sizeof(text));
+    CHECK(len > 0 && len == strlen(text), "save length %zu", len);
+    default_settings(&loaded);
+    CHECK(console_settings_load(&loaded, text) == ESP_OK, "load saved text");
+    CHECK(memcmp(&loaded, &s, sizeof(s)) == 0, "round trip changes settings:\n%s", text);
+
+    char small[32];
+    CHECK(console_settings_save(&s, small, sizeof(small)) == 0, "save into a short buffer");
+
+    // Older or newer firmware: unknown keys skipped, missing keys untouched
+    default_settings(&loaded);
+    CHECK(console_settings_load(&loaded, "decimation=3\nwindow_ms=250\n\ntraffic_hz=20") ==
+              ESP_OK && loaded.decimation == 3 && loaded.traffic_hz == 20 &&
+              loaded.tuning.gate_refresh == 10,
+          "partial text with an unknown key");
+
+    // One bad value rejects everything
+    default_settings(&loaded);
+    console_settings_t before = loaded;
+    CHECK(console_settings_load(&loaded, "decimation=3\ntraffic_hz=900\n") == ESP_ERR_INVALID_ARG &&
+              memcmp(&loaded, &before, sizeof(before)) == 0,
+          "out-of-range value rejects the text");
+    CHECK(console_settings_load(&loaded, "decimation 3\n") == ESP_ERR_INVALID_ARG,
+          "line without '='");
+    CHECK(console_settings_load(&loaded, "") == ESP_OK, "empty text");
+}
+
+static void check_thresholds(void)
+{
+    csi_window_stats_t stats = {
+        .amplitude_mean = 20.0f,
+        .amplitude_std = 3.0f,
+        .phase_variance = 0.2f,
+    };
+    pose_tuning_t tuning = {
+        .empty_amp_std = POSE_DEFAULT_EMPTY_AMP_STD,
+        .moving_phase_var = POSE_DEFAULT_MOVING_PHASE_VAR,
+        .moving_level = POSE_DEFAULT_MOVING_LEVEL,
+    };
+    pose_result_t a = {0}, b = {0};
+
+    pose_detect_presence(&stats, &a);
+    pose_detect_presence_tuned(&stats, &tuning, &b);
+    CHECK(memcmp(&a, &b, sizeof(a)) == 0, "default tuning matches pose_detect_presence()");
+    CHECK(a.pose_class == POSE_MOVING, "phase variance 0.2 is moving by default");
+
+    tuning.moving_phase_var = 1.0f;
+    pose_detect_presence_tuned(&stats, &tuning, &b);
+    CHECK(b.pose_class == POSE_PRESENT && fabsf(b.motion_level - 0.2f) < 1e-6f,
+          "higher moving_phase_var: class %d, motion %.2f", b.pose_class, b.motion_level);
+
+    tuning.empty_amp_std = 4.0f;
+    pose_detect_presence_tuned(&stats, &tuning, &b);
+    CHECK(b.pose_class == POSE_EMPTY && !b.human_detected, "higher empty_amp_std: class %d",
+          b.pose_class);
+}
+
+int main(void)
+{
+    check_lines();
+    check_parse();
+    check_set();
+    check_json();
+    check_saved();
+    check_thresholds();
+
+    printf("%d checks, %d failed\n", bench_checks(), bench_failures());
+    printf("%s\n", bench_failures() == 0 ? "PASS" : "FAILED");
+    return bench_failures() == 0 ? 0 : 1;
+}
@@ -0,0 +1,311 @@
+/**
+ * @file csi_dataset.cpp
+ * @brief Streaming reader for recorded CSI datasets
+ *
+ * A small hand-written JSON scanner rather than a DOM parser: datasets are
+ * routinely several GB and only a handful of keys per record matter.
+ */
+
+#include "csi_dataset.hpp"
+
+#include <cmath>
+#include <cstdlib>
+
+namespace csi {
+
+static constexpr size_t kReadChunk = 1 << 20;
+
+DatasetReader::DatasetReader(const std::string &path)
+    : file_(std::fopen(path.c_str(), "rb")), buffer_(kReadChunk)
+{
+}
+
+DatasetReader::~DatasetReader()
+{
+    if (file_ != nullptr) {
+        std::fclose(file_);
+    }
+}
+
+int DatasetReader::peek()
+{
+    if (pos_ >= len_) {
+        len_ = std::fread(buffer_.data(), 1, buffer_.size(), file_);
+        pos_ = 0;
+        if (len_ == 0) {
+            return EOF;
+        }
+    }
+    return static_cast<unsigned char>(buffer_[pos_]);
+}
+
+int DatasetReader::get()
+{
+    int c = peek();
+    if (c != EOF) {
+        pos_++;
+    }
+    return c;
+}
+
+void DatasetReader::skip_ws()
+{
+    for (int c = peek(); c == ' ' || c == '\n' || c == '\r' || c == '\t'; c = peek()) {
+        pos_++;
+    }
+}
+
+void DatasetReader::skip_line()
+{
+    for (int c = get(); c != EOF && c != '\n'; c = get()) {
+    }
+}
+
+bool DatasetReader::expect(char c)
+{
+    skip_ws();
+    if (peek() != c) {
+        return false;
+    }
+    pos_++;
+    return true;
+}
+
+bool DatasetReader::parse_string(std::string &out)
+{
+    out.clear();
+    if (!expect('"')) {
+        return false;
+    }
+    for (int c = get(); c != EOF; c = get()) {
+        if (c == '"') {
+            return true;
+        }
+        if (c == '\\') {
+            c = get();
+            if (c == 'u') {
+                // Labels are ASCII; keep escaped code points as '?'
+                for (int i = 0; i < 4; i++) get();
+                c = '?';
+            } else if (c == 'n') {
+                c = '\n';
+            } else if (c == 't') {
+                c = '\t';
+            }
+        }
+        out.push_back(static_cast<char>(c));
+    }
+    return false;
+}
+
+bool DatasetReader::parse_number(double &out)
+{
+    skip_ws();
+    scratch_.clear();
+    for (int c = peek(); c != EOF; c = peek()) {
+        if ((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E') {
+            scratch_.push_back(static_cast<char>(c));
+            pos_++;
+        } else {
+            break;
+        }
+    }
+    if (scratch_.empty()) {
+        // json.dump writes NaN for numpy NaNs
+        if (peek() == 'N') {
+            get(); get(); get();
+            out = NAN;
+            return true;
+        }
+        return false;
+    }
+    out = std::strtod(scratch_.c_str(), nullptr);
+    return true;
+}
+
+bool DatasetReader::parse_float_array(std::vector<float> &out)
+{
+    out.clear();
+    if (!expect('[')) {
+        return false;
+    }
+    if (expect(']')) {
+        return true;
+    }
+    do {
+        double v;
+        if (!parse_number(v)) {
+            return false;
+        }
+        out.push_back(static_cast<float>(v));
+    } while (expect(','));
+    return expect(']');
+}
+
+bool DatasetReader::skip_value()
+{
+    skip_ws();
+    int c = peek();
+    if (c == '"') {
+        return parse_string(scratch_);
+    }
+    if (c == '{' || c == '[') {
+        // Skip a nested container, honoring strings
+        int depth = 0;
+        bool in_string = false;
+        for (c = get(); c != EOF; c = get()) {
+            if (in_string) {
+                if (c == '\\') get();
+                else if (c == '"') in_string = false;
+            } else if (c == '"') {
+                in_string = true;
+            } else if (c == '{' || c == '[') {
+                depth++;
+            } else if (c == '}' || c == ']') {
+                if (--depth == 0) return true;
+            }
+        }
+        return false;
+    }
+    // Literal: number, true, false, null
+    bool any = false;
+    for (c = peek(); c != EOF && c != ',' && c != '}' && c != ']' && c != '\n'; c = peek()) {
+        pos_++;
+        any = true;
+    }
+    return any;
+}
+
+bool DatasetReader::parse_sample_array(const SampleCallback &callback, size_t &count)
+{
+    if (!expect('[')) {
+        return false;
+    }
+    if (expect(']')) {
+        return true;
+    }
+    Sample sample;
+    do {
+        bool has_sample = false;
+        skip_ws();
+        if (peek() != '{' || !parse_object(sample, has_sample, callback, count)) {
+            return false;
+        }
+        if (has_sample) {
+            callback(sample);
+            count++;
+        } else {
+            skipped_++;
+        }
+    } while (expect(','));
+    return expect(']');
+}
+
+bool DatasetReader::parse_object(Sample &sample, bool &has_sample,
+                                 const SampleCallback &callback, size_t &count)
+{
+    std::string key;
+    bool has_phase = false;
+    has_sample = false;
+    sample.label.clear();
+    sample.people = -1;
+    sample.event.clear();
+    sample.timestamp = 0;
+    sample.rssi = 0;
+
+    if (!expect('{')) {
+        return false;
+    }
+    if (expect('}')) {
+        return true;
+    }
+    do {
+        if (!parse_string(key) || !expect(':')) {
+            return false;
+        }
+        bool ok = true;
+        double v;
+        if (key == "data") {
+            ok = parse_sample_array(callback, count);
+        } else if (key == "amp") {
+            ok = parse_float_array(sample.amplitude);
+            has_sample = ok;
+        } else if (key == "phase") {
+            ok = parse_float_array(sample.phase);
+            has_phase = ok;
+        } else if (key == "ts") {
+            ok = parse_number(v);
+            sample.timestamp = static_cast<uint32_t>(v);
+        } else if (key == "rssi") {
+            ok = parse_number(v);
+            long r = std::lround(std::isnan(v) ? 0.0 : v);
+            sample.rssi = static_cast<int8_t>(r < -128 ? -128 : (r > 127 ? 127 : r));
+        } else if (key == "people") {
+            ok = parse_number(v);
+            sample.people = std::isnan(v) || v < 0.0 ? -1 : static_cast<int>(v > 255.0 ? 255.0 : v);
+        } else if (key == "label") {
+            skip_ws();
+            ok = peek() == '"' ? parse_string(sample.label) : skip_value();
+        } else if (key == "event") {
+            skip_ws();
+            ok = peek() == '"' ? parse_string(sample.event) : skip_value();
+        } else {
+            ok = skip_value();
+        }
+        if (!ok) {
+            return false;
+        }
+    } while (expect(','));
+
+    if (has_sample && !has_phase) {
+        // Same default as parse_sample(): missing phase is all zeros
+        sample.phase.assign(sample.amplitude.size(), 0.0f);
+    }
+    return expect('}');
+}
+
+size_t DatasetReader::for_each(const SampleCallback &callback)
+{
+    size_t count = 0;
+    Sample sample;
+
+    while (true) {
+        skip_ws();
+        int c = peek();
+        if (c == EOF) {
+            break;
+        }
+        if (c != '{') {
+            // ESP-IDF log line or other noise in a serial capture
+            skip_line();
+            continue;
+        }
+        bool has_sample = false;
+        if (!parse_object(sample, has_sample, callback, count)) {
+            // Truncated or corrupt record; resynchronize on the next line
+            skipped_++;
+            skip_line();
+            continue;
+        }
+        if (has_sample) {
+            callback(sample);
+            count++;
+        }
+    }
+    return count;
+}
+
+int label_to_class(const std::string &label)
+{
+    static const char *const kLabels[] = {
+        "empty", "present", "moving", "walking", "sitting", "standing",
+    };
+    for (int i = 0; i < static_cast<int>(sizeof(kLabels) / sizeof(kLabels[0])); i++) {
+        if (label == kLabels[i]) {
+            return i;
+        }
+    }
+    return 0;
+}
+
+}  // namespace csi
@@ -0,0 +1,95 @@
+/**
+ * @file csi_dataset.hpp
+ * @brief Streaming reader for recorded CSI datasets
+ *
+ * Understands both formats the Python tools produce:
+ * - Dataset files from collect_csi_dataset.py / generate_synthetic_data.py:
+ *   {"metadata": {...}, "data": [{"ts":..,"rssi":..,"amp":[..],"phase":[..],"label":".."}, ...]}
+ *   (samples may also carry "people", the number of people in the room, and
+ *   "event", e.g. "fall" on the first sample of a fall)
+ * - Raw serial captures: one {"ts":..,"rssi":..,"num":..,"amp":[..],"phase":[..]}
+ *   object per line, interleaved with ESP-IDF log lines (which are skipped).
+ *
+ * Samples are delivered one at a time through a callback, so memory use
+ * does not depend on the size of the dataset.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace csi {
+
+/**
+ * @brief One CSI packet as recorded by the tools
+ */
+struct Sample {
+    uint32_t timestamp = 0;
+    int8_t rssi = 0;
+    std::vector<float> amplitude;
+    std::vector<float> phase;
+    std::string label;          // Empty for unlabeled serial captures
+    int people = -1;            // People in the room, -1 if not recorded
+    std::string event;          // Event starting at this sample ("fall"), usually empty
+};
+
+/**
+ * @brief Pull-based JSON reader that emits dataset samples
+ */
+class DatasetReader {
+public:
+    using SampleCallback = std::function<void(const Sample &)>;
+
+    explicit DatasetReader(const std::string &path);
+    ~DatasetReader();
+
+    DatasetReader(const DatasetReader &) = delete;
+    DatasetReader &operator=(const DatasetReader &) = delete;
+
+    bool is_open() const { return file_ != nullptr; }
+
+    /**
+     * @brief Read the whole file, invoking callback for every sample
+     *
+     * @return Number of samples delivered
+     */
+    size_t for_each(const SampleCallback &callback);
+
+    /** Number of malformed records that were skipped */
+    size_t skipped() const { return skipped_; }
+
+private:
+    int peek();
+    int get();
+    void skip_ws();
+    void skip_line();
+    bool expect(char c);
+    bool parse_string(std::string &out);
+    bool parse_number(double &out);
+    bool parse_float_array(std::vector<float> &out);
+    bool skip_value();
+    bool parse_object(Sample &sample, bool &has_sample, const SampleCallback &callback,
+                      size_t &count);
+    bool parse_sample_array(const SampleCallback &callback, size_t &count);
+
+    std::FILE *file_ = nullptr;
+    std::vector<char> buffer_;
+    size_t pos_ = 0;
+    size_t len_ = 0;
+    size_t skipped_ = 0;
+    std::string scratch_;
+};
+
+/**
+ * @brief Map a dataset label to its class index
+ *
+ * Uses the same mapping as create_windows() in train_pose_model.py;
+ * unknown labels map to 0 (empty) just like label_map.get(label, 0).
+ */
+int label_to_class(const std::string &label);
+
+}  // namespace csi
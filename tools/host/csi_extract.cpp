@@ -0,0 +1,384 @@
+/**
+ * @file csi_extract.cpp
+ * @brief Parallel offline feature extraction over recorded CSI datasets
+ *
+ * Replaces the single-threaded loops in analyze_csi.py and
+ * train_pose_model.py's create_windows() for large captures. Window
+ * statistics come from firmware/main/csi_features.c, so the numbers are
+ * the same ones run_inference() computes on the device.
+ *
+ * Windowing follows create_windows(): samples are grouped per label (in
+ * recording order) and sliced into windows of --window samples every
+ * --stride samples. Windows never straddle two labels. Instead of
+ * materializing every window, samples are batched into blocks that are
+ * processed on a thread pool and streamed to disk in order, so memory is
+ * bounded by (threads x block size) regardless of dataset size.
+ *
+ * Outputs (in --out, created if missing):
+ *   features.npy   (N, 4) float32: amp_mean, amp_std, phase_variance, rssi_mean
+ *   labels.npy     (N,)   int32:   class index, -1 for unlabeled samples
+ *   timestamps.npy (N,)   uint32:  timestamp of the first sample in the window
+ *   windows.npy    (N, window, 2 * subcarriers) float32 normalized model input
+ *                  (skipped with --no-windows)
+ *
+ * Usage:
+ *   csi_extract datasets/capture.json --out features/ --threads 8
+ */
+
+#include "csi_dataset.hpp"
+#include "npy_writer.hpp"
+#include "thread_pool.hpp"
+
+extern "C" {
+#include "csi_features.h"
+}
+
+#include <sys/resource.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr int kNumStats = CSI_NUM_WINDOW_STATS;
+
+struct Options {
+    std::vector<std::string> inputs;
+    std::string out_dir = ".";
+    int window = 50;
+    int stride = 1;
+    int subcarriers = 52;
+    unsigned threads = 0;
+    int block_windows = 256;
+    bool write_windows = true;
+};
+
+/**
+ * @brief Contiguous run of samples from one label stream
+ *
+ * Layout matches the firmware temporal buffers ([t * subcarriers + s]).
+ */
+struct Block {
+    std::vector<float> amplitude;
+    std::vector<float> phase;
+    std::vector<int8_t> rssi;
+    std::vector<uint32_t> timestamp;
+    size_t size() const { return rssi.size(); }
+};
+
+struct BlockResult {
+    std::vector<float> stats;          // num_windows * kNumStats
+    std::vector<int32_t> labels;       // num_windows
+    std::vector<uint32_t> timestamps;  // num_windows
+    std::vector<float> normalized;     // block samples * 2 * subcarriers
+    std::vector<uint32_t> offsets;     // window start within block
+};
+
+/**
+ * @brief Per-label windowing state
+ *
+ * Positions are counted in samples of this label since the start of the
+ * dataset, so windowing across interruptions (label A, B, A again) matches
+ * create_windows(), which concatenates all samples of a label.
+ */
+struct LabelStream {
+    int32_t label = -1;
+    Block pending;
+    uint64_t begin_pos = 0;    // Position of pending[0]
+    uint64_t end_pos = 0;      // Position one past the last sample seen
+    uint64_t next_window = 0;  // Start position of the next window to emit
+};
+
+BlockResult process_block(const Block &block, std::vector<uint32_t> offsets, int32_t label,
+                          const Options &opt)
+{
+    const int subs = opt.subcarriers;
+    BlockResult r;
+    r.offsets = std::move(offsets);
+    r.stats.resize(r.offsets.size() * kNumStats);
+    r.labels.assign(r.offsets.size(), label);
+    r.timestamps.resize(r.offsets.size());
+
+    if (!r.offsets.empty()) {
+        // Offsets are evenly spaced by the stride, starting at offsets[0]
+        size_t t0 = r.offsets[0];
+        csi_window_stats_sliding(&block.amplitude[t0 * subs], &block.phase[t0 * subs],
+                                 &block.rssi[t0], static_cast<int>(block.size() - t0), subs,
+                                 opt.window, opt.stride, r.stats.data());
+        for (size_t w = 0; w < r.offsets.size(); w++) {
+            r.timestamps[w] = block.timestamp[r.offsets[w]];
+        }
+    }
+
+    if (opt.write_windows) {
+        // Normalize each sample once; overlapping windows share rows
+        r.normalized.resize(block.size() * 2 * subs);
+        for (size_t t = 0; t < block.size(); t++) {
+            csi_normalize_sample(&block.amplitude[t * subs], &block.phase[t * subs], subs, subs,
+                                 &r.normalized[t * 2 * subs]);
+        }
+    }
+    return r;
+}
+
+class Extractor {
+public:
+    explicit Extractor(const Options &opt)
+        : opt_(opt),
+          pool_(opt.threads ? opt.threads : std::thread::hardware_concurrency()),
+          max_in_flight_(2 * pool_.size()),
+          features_(opt.out_dir + "/features.npy", "<f4", {kNumStats}),
+          labels_(opt.out_dir + "/labels.npy", "<i4", {}),
+          timestamps_(opt.out_dir + "/timestamps.npy", "<u4", {})
+    {
+        if (opt.write_windows) {
+            windows_ = std::make_unique<csi::NpyWriter>(
+                opt.out_dir + "/windows.npy", "<f4",
+                std::vector<size_t>{static_cast<size_t>(opt.window),
+                                    static_cast<size_t>(2 * opt.subcarriers)});
+        }
+    }
+
+    bool ok() const
+    {
+        return features_.is_open() && labels_.is_open() && timestamps_.is_open() &&
+               (!windows_ || windows_->is_open());
+    }
+
+    void add(const csi::Sample &sample)
+    {
+        int32_t label = sample.label.empty() ? -1 : csi::label_to_class(sample.label);
+        LabelStream &ls = streams_[label];
+        ls.label = label;
+
+        // Keep output roughly chronological: flush the previous label's
+        // complete windows when the recording switches labels.
+        if (current_ != nullptr && current_ != &ls) {
+            flush(*current_);
+        }
+        current_ = &ls;
+
+        uint64_t pos = ls.end_pos++;
+        if (pos < ls.next_window) {
+            // Gap between windows when stride > window
+            ls.begin_pos = ls.end_pos;
+            return;
+        }
+
+        const int subs = opt_.subcarriers;
+        Block &b = ls.pending;
+        size_t n = sample.amplitude.size() < static_cast<size_t>(subs) ? sample.amplitude.size()
+                                                                        : static_cast<size_t>(subs);
+        size_t base = b.amplitude.size();
+        // Pad with zeros like parse_sample()
+        b.amplitude.resize(base + subs, 0.0f);
+        b.phase.resize(base + subs, 0.0f);
+        std::memcpy(&b.amplitude[base], sample.amplitude.data(), n * sizeof(float));
+        std::memcpy(&b.phase[base], sample.phase.data(),
+                    std::min(n, sample.phase.size()) * sizeof(float));
+        b.rssi.push_back(sample.rssi);
+        b.timestamp.push_back(sample.timestamp);
+
+        if (ls.end_pos >= ls.next_window + opt_.window +
+                              static_cast<uint64_t>(opt_.block_windows - 1) * opt_.stride) {
+            flush(ls);
+        }
+    }
+
+    bool finish()
+    {
+        for (auto &kv : streams_) {
+            flush(kv.second);
+        }
+        while (!in_flight_.empty()) {
+            write_front();
+        }
+        bool ok = features_.close() && labels_.close() && timestamps_.close();
+        if (windows_) {
+            ok = windows_->close() && ok;
+        }
+        return ok && write_ok_;
+    }
+
+    size_t windows() const { return features_.rows(); }
+
+private:
+    void flush(LabelStream &ls)
+    {
+        std::vector<uint32_t> offsets;
+        uint64_t start = ls.next_window;
+        while (start + opt_.window <= ls.end_pos) {
+            offsets.push_back(static_cast<uint32_t>(start - ls.begin_pos));
+            start += opt_.stride;
+        }
+        if (offsets.empty()) {
+            return;
+        }
+
+        // Carry the samples the next window still needs into a new block
+        Block carry;
+        const int subs = opt_.subcarriers;
+        if (start < ls.end_pos) {
+            size_t from = static_cast<size_t>(start - ls.begin_pos);
+            const Block &b = ls.pending;
+            carry.amplitude.assign(b.amplitude.begin() + from * subs, b.amplitude.end());
+            carry.phase.assign(b.phase.begin() + from * subs, b.phase.end());
+            carry.rssi.assign(b.rssi.begin() + from, b.rssi.end());
+            carry.timestamp.assign(b.timestamp.begin() + from, b.timestamp.end());
+        }
+
+        auto block = std::make_shared<Block>(std::move(ls.pending));
+        int32_t label = ls.label;
+        const Options &opt = opt_;
+        in_flight_.push_back(pool_.submit([block, offsets = std::move(offsets), label, &opt]() mutable {
+            return process_block(*block, std::move(offsets), label, opt);
+        }));
+
+        ls.pending = std::move(carry);
+        ls.next_window = start;
+        ls.begin_pos = start < ls.end_pos ? start : ls.end_pos;
+
+        while (in_flight_.size() > max_in_flight_) {
+            write_front();
+        }
+    }
+
+    void write_front()
+    {
+        BlockResult r = in_flight_.front().get();
+        in_flight_.pop_front();
+
+        size_t n = r.offsets.size();
+        write_ok_ &= features_.append(r.stats.data(), n);
+        write_ok_ &= labels_.append(r.labels.data(), n);
+        write_ok_ &= timestamps_.append(r.timestamps.data(), n);
+        if (windows_) {
+            size_t row = 2 * static_cast<size_t>(opt_.subcarriers);
+            for (uint32_t off : r.offsets) {
+                write_ok_ &= windows_->append(&r.normalized[off * row], 1);
+            }
+        }
+    }
+
+    const Options &opt_;
+    csi::ThreadPool pool_;
+    size_t max_in_flight_;
+    std::map<int32_t, LabelStream> streams_;
+    LabelStream *current_ = nullptr;
+    std::deque<std::future<BlockResult>> in_flight_;
+    csi::NpyWriter features_;
+    csi::NpyWriter labels_;
+    csi::NpyWriter timestamps_;
+    std::unique_ptr<csi::NpyWriter> windows_;
+    bool write_ok_ = true;
+};
+
+void usage(const char *prog)
+{
+    std::fprintf(stderr,
+                 "Usage: %s DATASET [DATASET...] [options]\n"
+                 "  --out DIR           Output directory, created if missing (default: .)\n"
+                 "  --window N          Samples per window (default: 50)\n"
+                 "  --stride N          Samples between window starts (default: 1)\n"
+                 "  --subcarriers N     Subcarriers per sample (default: 52)\n"
+                 "  --threads N         Worker threads (default: all cores)\n"
+                 "  --block N           Windows per work item (default: 256)\n"
+                 "  --no-windows        Only write statistics, not model input windows\n",
+                 prog);
+}
+
+bool parse_args(int argc, char **argv, Options &opt)
+{
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        auto next = [&]() -> const char * { return i + 1 < argc ? argv[++i] : nullptr; };
+        const char *v = nullptr;
+        if (a == "--out" && (v = next())) {
+            opt.out_dir = v;
+        } else if (a == "--window" && (v = next())) {
+            opt.window = std::atoi(v);
+        } else if (a == "--stride" && (v = next())) {
+            opt.stride = std::atoi(v);
+        } else if (a == "--subcarriers" && (v = next())) {
+            opt.subcarriers = std::atoi(v);
+        } else if (a == "--threads" && (v = next())) {
+            opt.threads = static_cast<unsigned>(std::atoi(v));
+        } else if (a == "--block" && (v = next())) {
+            opt.block_windows = std::atoi(v);
+        } else if (a == "--no-windows") {
+            opt.write_windows = false;
+        } else if (!a.empty() && a[0] != '-') {
+            opt.inputs.push_back(a);
+        } else {
+            return false;
+        }
+    }
+    return !opt.inputs.empty() && opt.window > 0 && opt.stride > 0 && opt.subcarriers > 0 &&
+           opt.subcarriers <= 64 && opt.block_windows > 0;
+}
+
+}  // namespace
+
+int main(int argc, char **argv)
+{
+    Options opt;
+    if (!parse_args(argc, argv, opt)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(opt.out_dir, ec);
+    if (ec) {
+        std::fprintf(stderr, "✗ Cannot create %s: %s\n", opt.out_dir.c_str(),
+                     ec.message().c_str());
+        return 1;
+    }
+
+    Extractor extractor(opt);
+    if (!extractor.ok()) {
+        std::fprintf(stderr, "✗ Cannot create output files in %s\n", opt.out_dir.c_str());
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    size_t samples = 0;
+    for (const auto &path : opt.inputs) {
+        csi::DatasetReader reader(path);
+        if (!reader.is_open()) {
+            std::fprintf(stderr, "✗ Cannot open %s\n", path.c_str());
+            return 1;
+        }
+        size_t n = reader.for_each([&](const csi::Sample &s) { extractor.add(s); });
+        std::printf("✓ %s: %zu samples", path.c_str(), n);
+        if (reader.skipped() > 0) {
+            std::printf(" (%zu malformed records skipped)", reader.skipped());
+        }
+        std::printf("\n");
+        samples += n;
+    }
+
+    if (!extractor.finish()) {
+        std::fprintf(stderr, "✗ Failed writing output files\n");
+        return 1;
+    }
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+    std::printf("✓ %zu windows (window=%d, stride=%d) from %zu samples\n", extractor.windows(),
+                opt.window, opt.stride, samples);
+    std::printf("  Time:       %.3f s\n", secs);
+    std::printf("  Throughput: %.0f windows/s\n", secs > 0 ? extractor.windows() / secs : 0.0);
+    std::printf("  Peak RSS:   %.1f MB\n", usage.ru_maxrss / 1024.0);
+    return 0;
+}
@@ -0,0 +1,301 @@
+/**
+ * @file csi_pool_stress.c
+ * @brief Host stress test for the lock-free CSI record pool (csi_pool.c)
+ *
+ * Hammers one small pool from many threads and checks that no record is
+ * ever handed to two owners, that data written by an owner survives until
+ * it is released, and that every record is back in the pool at the end.
+ *
+ *   phase 1  every thread allocates, fills, retains/releases extra
+ *            references, verifies and frees its own records
+ *   phase 2  producers fill records and hand them to consumers through a
+ *            queue (ownership transfer), consumers verify and release
+ *   phase 3  misuse (double release, foreign pointer) is rejected and
+ *            counted, and exactly capacity records can be allocated
+ *
+ * Exits non-zero on the first inconsistency.
+ *
+ * Usage:
+ *   csi_pool_stress [--threads 8] [--iterations 200000] [--capacity 8]
+ */
+
+#include "bench_util.h"
+#include "csi_pool.h"
+#include "wifi_csi.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define QUEUE_SIZE 4
+
+static csi_pool_t s_pool;
+static csi_data_t s_records[CSI_POOL_MAX_RECORDS];
+static atomic_int s_owner[CSI_POOL_MAX_RECORDS];
+static int s_iterations = 200000;
+
+// Phase 2 hand-off queue (the queue itself is not under test)
+static csi_data_t *s_queue[QUEUE_SIZE];
+static int s_queue_head, s_queue_count;
+static int s_producers_done;
+static pthread_mutex_t s_queue_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t s_queue_cond = PTHREAD_COND_INITIALIZER;
+
+static int index_of(const csi_data_t *rec)
+{
+    return (int)(rec - s_records);
+}
+
+/**
+ * @brief Claim exclusive ownership of a freshly allocated record
+ */
+static void claim(const csi_data_t *rec, int tid)
+{
+    int expected = -1;
+    if (!atomic_compare_exchange_strong(&s_owner[index_of(rec)], &expected, tid)) {
+        FAIL("record %d handed to thread %d while owned by %d", index_of(rec), tid, expected);
+    }
+}
+
+static void unclaim(const csi_data_t *rec)
+{
+    atomic_store(&s_owner[index_of(rec)], -1);
+}
+
+static void fill(csi_data_t *rec, int tid, int iteration)
+{
+    rec->num_subcarriers = (uint8_t)(tid + 1);
+    rec->rssi = (int8_t)(iteration & 0x7f);
+    rec->timestamp = (uint32_t)iteration;
+    for (int i = 0; i < 64; i++) {
+        rec->amplitude[i] = (float)(tid * 1000 + i);
+        rec->phase[i] = (float)iteration;
+    }
+}
+
+static int verify(const csi_data_t *rec, int tid, int iteration)
+{
+    if (rec->num_subcarriers != (uint8_t)(tid + 1) || rec->timestamp != (uint32_t)iteration) {
+        return 0;
+    }
+    for (int i = 0; i < 64; i++) {
+        if (rec->amplitude[i] != (float)(tid * 1000 + i) || rec->phase[i] != (float)iteration) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static void *private_worker(void *arg)
+{
+    int tid = (int)(intptr_t)arg;
+    unsigned seed = (unsigned)tid * 2654435761u;
+
+    for (int it = 0; it < s_iterations; it++) {
+        csi_data_t *rec = csi_pool_alloc(&s_pool);
+        if (rec == NULL) {
+            sched_yield();
+            continue;
+        }
+        claim(rec, tid);
+        fill(rec, tid, it);
+
+        // Extra references must not free the record early
+        int extra = rand_r(&seed) % 3;
+        for (int r = 0; r < extra; r++) {
+            if (csi_pool_retain(&s_pool, rec) != ESP_OK) {
+                FAIL("retain of a held record failed");
+            }
+        }
+        if (rand_r(&seed) % 8 == 0) {
+            sched_yield();
+        }
+        for (int r = 0; r < extra; r++) {
+            csi_pool_release(&s_pool, rec);
+        }
+
+        if (!verify(rec, tid, it)) {
+            FAIL("record %d overwritten while owned by thread %d", index_of(rec), tid);
+        }
+        unclaim(rec);
+        if (csi_pool_release(&s_pool, rec) != ESP_OK) {
+            FAIL("release of an owned record failed");
+        }
+    }
+    return NULL;
+}
+
+static void *producer(void *arg)
+{
+    int tid = (int)(intptr_t)arg;
+
+    for (int it = 0; it < s_iterations; it++) {
+        csi_data_t *rec = csi_pool_alloc(&s_pool);
+        if (rec == NULL) {
+            sched_yield();
+            continue;
+        }
+        claim(rec, tid);
+        fill(rec, tid, it);
+        unclaim(rec);
+
+        // Keep a reference while queueing, then drop it: the queue's
+        // reference is transferred to the consumer
+        csi_pool_retain(&s_pool, rec);
+        pthread_mutex_lock(&s_queue_lock);
+        while (s_queue_count == QUEUE_SIZE) {
+            pthread_cond_wait(&s_queue_cond, &s_queue_lock);
+        }
+        s_queue[(s_queue_head + s_queue_count) % QUEUE_SIZE] = rec;
+        s_queue_count++;
+        pthread_cond_broadcast(&s_queue_cond);
+        pthread_mutex_unlock(&s_queue_lock);
+        csi_pool_release(&s_pool, rec);
+    }
+
+    pthread_mutex_lock(&s_queue_lock);
+    s_producers_done++;
+    pthread_cond_broadcast(&s_queue_cond);
+    pthread_mutex_unlock(&s_queue_lock);
+    return NULL;
+}
+
+static void *consumer(void *arg)
+{
+    int producers = (int)(intptr_t)arg;
+
+    for (;;) {
+        pthread_mutex_lock(&s_queue_lock);
+        while (s_queue_count == 0 && s_producers_done < producers) {
+            pthread_cond_wait(&s_queue_cond, &s_queue_lock);
+        }
+        if (s_queue_count == 0) {
+            pthread_mutex_unlock(&s_queue_lock);
+            return NULL;
+        }
+        csi_data_t *rec = s_queue[s_queue_head];
+        s_queue_head = (s_queue_head + 1) % QUEUE_SIZE;
+        s_queue_count--;
+        pthread_cond_broadcast(&s_queue_cond);
+        pthread_mutex_unlock(&s_queue_lock);
+
+        int tid = rec->num_subcarriers - 1;
+        if (!verify(rec, tid, (int)rec->timestamp)) {
+            FAIL("handed-off record %d corrupted", index_of(rec));
+        }
+        if (csi_pool_release(&s_pool, rec) != ESP_OK) {
+            FAIL("consumer release failed");
+        }
+    }
+}
+
+static void check_drained(const char *phase)
+{
+    csi_pool_stats_t stats;
+    csi_pool_get_stats(&s_pool, &stats);
+    printf("  %-9s allocations=%u exhausted=%u peak=%u/%u in_use=%u misuse=%u\n", phase,
+           stats.allocations, stats.exhausted, stats.peak_in_use, stats.capacity, stats.in_use,
+           stats.misuse);
+    if (stats.in_use != 0) {
+        FAIL("%s: %u records still in use", phase, stats.in_use);
+    }
+    if (stats.misuse != 0) {
+        FAIL("%s: %u misuses", phase, stats.misuse);
+    }
+    if (stats.peak_in_use > stats.capacity) {
+        FAIL("%s: peak above capacity", phase);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int threads = 8;
+    int capacity = 8;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            s_iterations = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--capacity") == 0 && i + 1 < argc) {
+            capacity = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "Usage: %s [--threads N] [--iterations N] [--capacity N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (threads < 2 || s_iterations <= 0 || capacity < 1 || capacity > CSI_POOL_MAX_RECORDS) {
+        fprintf(stderr, "Invalid arguments\n");
+        return 2;
+    }
+
+    pthread_t *tids = calloc((size_t)threads, sizeof(pthread_t));
+    for (int i = 0; i < CSI_POOL_MAX_RECORDS; i++) {
+        atomic_init(&s_owner[i], -1);
+    }
+
+    printf("csi_pool stress: %d threads x %d iterations, capacity %d\n",
+           threads, s_iterations, capacity);
+
+    // Phase 1: private alloc/retain/release
+    csi_pool_init(&s_pool, s_records, (uint32_t)capacity);
+    double t0 = bench_now_s();
+    for (int i = 0; i < threads; i++) {
+        pthread_create(&tids[i], NULL, private_worker, (void *)(intptr_t)i);
+    }
+    for (int i = 0; i < threads; i++) {
+        pthread_join(tids[i], NULL);
+    }
+    double t1 = bench_now_s();
+    check_drained("private");
+    printf("            %.1f M alloc/release per second\n",
+           (double)threads * s_iterations / (t1 - t0) / 1e6);
+
+    // Phase 2: producer -> consumer hand-off
+    csi_pool_init(&s_pool, s_records, (uint32_t)capacity);
+    int producers = threads / 2;
+    for (int i = 0; i < threads; i++) {
+        if (i < producers) {
+            pthread_create(&tids[i], NULL, producer, (void *)(intptr_t)i);
+        } else {
+            pthread_create(&tids[i], NULL, consumer, (void *)(intptr_t)producers);
+        }
+    }
+    for (int i = 0; i < threads; i++) {
+        pthread_join(tids[i], NULL);
+    }
+    check_drained("hand-off");
+
+    // Phase 3: misuse is rejected, and the free list is intact
+    csi_data_t *rec = csi_pool_alloc(&s_pool);
+    csi_pool_release(&s_pool, rec);
+    csi_data_t foreign;
+    if (csi_pool_release(&s_pool, rec) != ESP_ERR_INVALID_STATE) {
+        FAIL("double release not detected");
+    }
+    if (csi_pool_release(&s_pool, &foreign) != ESP_ERR_INVALID_ARG) {
+        FAIL("foreign release not detected");
+    }
+    if (csi_pool_retain(&s_pool, rec) != ESP_ERR_INVALID_STATE) {
+        FAIL("retain of a free record not detected");
+    }
+    int allocated = 0;
+    while (csi_pool_alloc(&s_pool) != NULL) {
+        allocated++;
+    }
+    csi_pool_stats_t stats;
+    csi_pool_get_stats(&s_pool, &stats);
+    printf("  misuse    detected=%u, free list holds %d/%d records\n",
+           stats.misuse, allocated, capacity);
+    if (stats.misuse != 2 || allocated != capacity) {
+        FAIL("pool inconsistent after misuse");
+    }
+
+    free(tids);
+    int failures = bench_failures();
+    printf("%s\n", failures == 0 ? "PASS" : "FAILED");
+    return failures == 0 ? 0 : 1;
+}
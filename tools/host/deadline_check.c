@@ -0,0 +1,379 @@
+/**
+ * @file deadline_check.c
+ * @brief Deadline scheduler under artificial CPU load
+ *
+ * Runs the window stages of run_inference(), compiled unchanged from
+ * firmware/main, at the level deadline_begin() picks for each window:
+ *
+ *   statistics + presence    csi_window_stats(), pose_detect_presence()  always
+ *   people count             occupancy_estimate(), full or newest half   below THRESHOLD
+ *   breathing spectrum       breathing_estimate()                        at FULL
+ *
+ * CPU load is simulated by stretching every stage: each one spins until
+ * it has taken SLOWDOWN * load times its median cost, as if the core ran
+ * load times slower. SLOWDOWN brings the host to roughly the device's
+ * window cost and keeps host scheduling jitter small next to it. The load
+ * goes through phases (1x, 4x, 1x, 2.2x). The deadline is 2x the full
+ * pipeline's cost at 1x, from each stage's median cost, measured first.
+ * Checks that:
+ *
+ *   - at 1x the windows run FULL and the last one is FULL
+ *   - under load the scheduler degrades, but not past the dearest level
+ *     that leaves it room to step up again
+ *   - only the windows before it settles, and its probes of the level
+ *     above, miss (at most --max-transition-misses per phase)
+ *   - once the load is gone it returns to FULL
+ *   - windows reused by the change gate (deadline_begin() with no
+ *     deadline_end()) leave the levels of the computed ones unchanged
+ *
+ * Host timing jitter is tolerated: a phase may have up to 2% stray misses,
+ * and a 1x phase may lose a probe interval to a spike.
+ * Prints each failed check and exits non-zero if there is any.
+ *
+ * Usage:
+ *   deadline_check [--windows 300] [--max-transition-misses 3]
+ */
+
+#include "bench_util.h"
+#include "breathing.h"
+#include "deadline_sched.h"
+#include "occupancy.h"
+#include "pose_pipeline.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SAMPLES 100
+#define SUBCARRIERS 64
+#define WINDOW (SAMPLES * SUBCARRIERS)
+#define INPUT_RATE_HZ 100
+#define DECIMATION (INPUT_RATE_HZ / BREATHING_RATE_HZ)
+#define BREATHING_SECONDS 30
+#define CALIBRATION_WINDOWS 50
+#define DEADLINE_FACTOR 2.0f
+#define STRAY_MISS_FRACTION 0.02f
+#define SLOWDOWN 10.0f
+
+static double now_us(void)
+{
+    return bench_now_s() * 1e6;
+}
+
+/**
+ * @brief Spin until `until`, like a busier core would
+ */
+static void spin_until(double until)
+{
+    while (now_us() < until) {
+    }
+}
+
+// Window and stage state shared by every window
+static float s_amplitude[WINDOW];
+static float s_phase[WINDOW];
+static int8_t s_rssi[SAMPLES];
+static float s_scratch[OCCUPANCY_SCRATCH_BYTES(SUBCARRIERS) / sizeof(float)];
+static uint16_t s_breathing_ring[BREATHING_SECONDS * BREATHING_RATE_HZ];
+static breathing_estimator_t s_breathing;
+
+/**
+ * @brief Next window: static channel, two movers, a breathing component
+ */
+static void next_window(int index)
+{
+    for (int t = 0; t < SAMPLES; t++) {
+        float time_s = (float)(index * SAMPLES + t) / INPUT_RATE_HZ;
+        float breath = 0.8f * sinf(2.0f * (float)M_PI * 0.25f * time_s);
+        for (int s = 0; s < SUBCARRIERS; s++) {
+            float move = 3.0f * sinf(1.3f * time_s + 0.2f * s) +
+                         2.0f * sinf(2.9f * time_s - 0.1f * s);
+            s_amplitude[t * SUBCARRIERS + s] =
+                30.0f + 0.5f * s + move + breath + bench_uniform() - 0.5f;
+            s_phase[t * SUBCARRIERS + s] = 0.3f * sinf(0.7f * time_s + s) +
+                                           0.05f * (bench_uniform() - 0.5f);
+        }
+        s_rssi[t] = (int8_t)(-55 - t % 5);
+        breathing_push(&s_breathing, breathing_sample_mean(&s_amplitude[t * SUBCARRIERS],
+                                                           SUBCARRIERS));
+    }
+}
+
+/**
+ * @brief Stages of run_inference() that deadline levels shed
+ */
+typedef enum {
+    STAGE_STATS,              // Statistics and threshold detector
+    STAGE_OCCUPANCY,          // People count over the whole window
+    STAGE_OCCUPANCY_HALF,     // ... over the newest half
+    STAGE_BREATHING,          // Breathing spectrum
+    NUM_STAGES,
+} stage_t;
+
+// Median cost of each stage on the host, unstretched
+static double s_stage_us[NUM_STAGES];
+
+static void run_stage(stage_t stage)
+{
+    csi_window_stats_t stats;
+    pose_result_t result = {0};
+    occupancy_estimate_t occupancy;
+    breathing_estimate_t breathing;
+    switch (stage) {
+    case STAGE_STATS:
+        csi_window_stats(s_amplitude, s_phase, s_rssi, SAMPLES, SUBCARRIERS, &stats);
+        pose_detect_presence(&stats, &result);
+        break;
+    case STAGE_OCCUPANCY:
+        occupancy_estimate(s_amplitude, SAMPLES, SUBCARRIERS, true, s_scratch, &occupancy);
+        break;
+    case STAGE_OCCUPANCY_HALF:
+        occupancy_estimate(&s_amplitude[(SAMPLES / 2) * SUBCARRIERS], SAMPLES / 2, SUBCARRIERS,
+                           true, s_scratch, &occupancy);
+        break;
+    case STAGE_BREATHING:
+        breathing_estimate(&s_breathing, BREATHING_SECONDS * BREATHING_RATE_HZ / 2, &breathing);
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Run a stage, then spin out the rest of its cost under `load`
+ *
+ * The stretch is from the stage's median cost, so a host hiccup adds its
+ * own length once rather than SLOWDOWN * load times over.
+ */
+static void run_stretched(stage_t stage, float load)
+{
+    double t0 = now_us();
+    run_stage(stage);
+    spin_until(t0 + SLOWDOWN * load * s_stage_us[stage]);
+}
+
+/**
+ * @brief One window's stages at a level
+ *
+ * @return Cost in microseconds, including the stretch
+ */
+static uint32_t run_window(deadline_level_t level, float load)
+{
+    const double start = now_us();
+    run_stretched(STAGE_STATS, load);
+    if (level < DEADLINE_LEVEL_HALF_OCCUPANCY) {
+        run_stretched(STAGE_OCCUPANCY, load);
+    } else if (level < DEADLINE_LEVEL_THRESHOLD) {
+        run_stretched(STAGE_OCCUPANCY_HALF, load);
+    }
+    if (level < DEADLINE_LEVEL_NO_SPECTRAL) {
+        run_stretched(STAGE_BREATHING, load);
+    }
+    return (uint32_t)(now_us() - start);
+}
+
+/**
+ * @brief Cost of a level at 1x, from the stage medians
+ */
+static double level_cost_us(deadline_level_t level)
+{
+    double cost = s_stage_us[STAGE_STATS];
+    if (level < DEADLINE_LEVEL_HALF_OCCUPANCY) {
+        cost += s_stage_us[STAGE_OCCUPANCY];
+    } else if (level < DEADLINE_LEVEL_THRESHOLD) {
+        cost += s_stage_us[STAGE_OCCUPANCY_HALF];
+    }
+    if (level < DEADLINE_LEVEL_NO_SPECTRAL) {
+        cost += s_stage_us[STAGE_BREATHING];
+    }
+    return SLOWDOWN * cost;
+}
+
+static int compare_double(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return x < y ? -1 : x > y;
+}
+
+/**
+ * @brief Median unstretched cost of each stage
+ */
+static void calibrate_stages(int *window)
+{
+    double costs[NUM_STAGES][CALIBRATION_WINDOWS];
+    for (int i = 0; i < CALIBRATION_WINDOWS; i++) {
+        next_window((*window)++);
+        for (int stage = 0; stage < NUM_STAGES; stage++) {
+            double t0 = now_us();
+            run_stage((stage_t)stage);
+            costs[stage][i] = now_us() - t0;
+        }
+    }
+    for (int stage = 0; stage < NUM_STAGES; stage++) {
+        qsort(costs[stage], CALIBRATION_WINDOWS, sizeof(double), compare_double);
+        s_stage_us[stage] = costs[stage][CALIBRATION_WINDOWS / 2];
+    }
+}
+
+typedef struct {
+    float load;
+    uint32_t misses;
+    uint32_t level_windows[DEADLINE_LEVELS];
+    int first_miss_free;          // First window after which no window misses
+    deadline_level_t final_level;
+    double cost_sum_us;
+} phase_result_t;
+
+static void run_phase(deadline_sched_t *sched, float load, int windows, int *window,
+                      phase_result_t *out)
+{
+    memset(out, 0, sizeof(*out));
+    out->load = load;
+    for (int i = 0; i < windows; i++) {
+        next_window((*window)++);
+        deadline_level_t level = deadline_begin(sched);
+        uint32_t cost = run_window(level, load);
+        deadline_end(sched, level, cost);
+
+        out->level_windows[level]++;
+        out->cost_sum_us += cost;
+        if (cost > sched->config.deadline_us) {
+            out->misses++;
+            out->first_miss_free = i + 1;
+        }
+    }
+    out->final_level = sched->level;
+}
+
+/**
+ * @brief Windows reused by the change gate in between must not move the level
+ *
+ * Two schedulers see the same computed windows, with synthetic costs, under
+ * a 1x-4x-1x load. One also gets a deadline_begin() with no deadline_end()
+ * for each reused window (about 60% of them, as with gating). Both must
+ * pick the same level for every computed window.
+ */
+static void check_reused_windows(void)
+{
+    static const float cost_us[DEADLINE_LEVELS] = { 1000.0f, 700.0f, 450.0f, 150.0f };
+    deadline_config_t config;
+    deadline_default_config(&config, 2000);
+    deadline_sched_t computed, gated;
+    deadline_init(&computed, &config);
+    deadline_init(&gated, &config);
+
+    int first_diff = -1, degraded = 0;
+    for (int w = 0; w < 600; w++) {
+        while (bench_uniform() < 0.6f) {
+            deadline_begin(&gated);  // Reused window: not computed, not measured
+        }
+        float load = w >= 100 && w < 300 ? 4.0f : 1.0f;
+        deadline_level_t a = deadline_begin(&computed);
+        deadline_level_t b = deadline_begin(&gated);
+        if (a != b && first_diff < 0) {
+            first_diff = w;
+        }
+        degraded += a > DEADLINE_LEVEL_FULL;
+        deadline_end(&computed, a, (uint32_t)(load * cost_us[a]));
+        deadline_end(&gated, b, (uint32_t)(load * cost_us[b]));
+    }
+    CHECK(first_diff < 0, "reused windows change the level from computed window %d",
+          first_diff);
+    CHECK(degraded > 0 && computed.level == DEADLINE_LEVEL_FULL,
+          "synthetic load: %d degraded windows, ends at level %d", degraded,
+          (int)computed.level);
+}
+
+int main(int argc, char **argv)
+{
+    int windows = 300;
+    int max_transition_misses = 3;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--windows") == 0 && i + 1 < argc) {
+            windows = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--max-transition-misses") == 0 && i + 1 < argc) {
+            max_transition_misses = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "Usage: %s [--windows N] [--max-transition-misses N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (windows < 20) {
+        fprintf(stderr, "Need at least 20 windows per phase\n");
+        return 2;
+    }
+
+    breathing_init(&s_breathing, s_breathing_ring, BREATHING_SECONDS * BREATHING_RATE_HZ,
+                   INPUT_RATE_HZ, DECIMATION);
+    int window = 0;
+    while (breathing_history_seconds(&s_breathing) < BREATHING_SECONDS) {
+        next_window(window++);
+    }
+
+    // Cost of each level at 1x, and the deadline
+    calibrate_stages(&window);
+    double level_cost[DEADLINE_LEVELS];
+    for (int l = 0; l < DEADLINE_LEVELS; l++) {
+        level_cost[l] = level_cost_us((deadline_level_t)l);
+    }
+    const uint32_t deadline_us = (uint32_t)(DEADLINE_FACTOR * level_cost[DEADLINE_LEVEL_FULL]);
+    printf("%dx%d window, deadline %lu us\n", SAMPLES, SUBCARRIERS, (unsigned long)deadline_us);
+    printf("  level  cost at 1x\n");
+    for (int l = 0; l < DEADLINE_LEVELS; l++) {
+        printf("  %5d  %8.0f us (%.2f of FULL)\n", l, level_cost[l],
+               (float)level_cost[l] / level_cost[DEADLINE_LEVEL_FULL]);
+    }
+
+    deadline_config_t config;
+    deadline_default_config(&config, deadline_us);
+    deadline_sched_t sched;
+    deadline_init(&sched, &config);
+
+    static const float loads[] = {1.0f, 4.0f, 1.0f, 2.2f};
+    const int num_phases = (int)(sizeof(loads) / sizeof(loads[0]));
+    printf("\n  load  misses  settled  FULL  NO_SPEC  HALF_OCC  THRESH  final  mean us\n");
+    for (int p = 0; p < num_phases; p++) {
+        phase_result_t r;
+        run_phase(&sched, loads[p], windows, &window, &r);
+        printf("  %4.1fx %7lu %8d %5lu %8lu %9lu %7lu %6d %8.0f\n", r.load,
+               (unsigned long)r.misses, r.first_miss_free,
+               (unsigned long)r.level_windows[0], (unsigned long)r.level_windows[1],
+               (unsigned long)r.level_windows[2], (unsigned long)r.level_windows[3],
+               (int)r.final_level, r.cost_sum_us / windows);
+
+        // Misses before the level settles, plus stray host jitter
+        const uint32_t allowed = (uint32_t)max_transition_misses +
+                                 (uint32_t)(STRAY_MISS_FRACTION * windows);
+        CHECK(r.misses <= allowed, "%.1fx: %lu misses, at most %lu expected", r.load,
+              (unsigned long)r.misses, (unsigned long)allowed);
+
+        // Dearest level that fits this load with room to step up, from its
+        // cost at 1x; the scheduler settles there or, with less room, dearer
+        deadline_level_t fitting = DEADLINE_LEVEL_THRESHOLD;
+        for (int l = DEADLINE_LEVEL_THRESHOLD; l >= 0; l--) {
+            if (r.load * level_cost[l] <= config.recover_fraction * deadline_us) {
+                fitting = (deadline_level_t)l;
+            }
+        }
+        if (r.load == 1.0f) {
+            // Back at FULL: the first phase from the start, later ones once recovered
+            CHECK(r.final_level == DEADLINE_LEVEL_FULL, "%.1fx: ends at level %d", r.load,
+                  (int)r.final_level);
+            CHECK(r.level_windows[DEADLINE_LEVEL_FULL] >= (uint32_t)windows / 2,
+                  "%.1fx: only %lu of %d windows at FULL", r.load,
+                  (unsigned long)r.level_windows[DEADLINE_LEVEL_FULL], windows);
+        } else {
+            CHECK(r.final_level > DEADLINE_LEVEL_FULL, "%.1fx: did not degrade", r.load);
+            CHECK((int)r.final_level <= (int)fitting, "%.1fx: ends at level %d, %d fits",
+                  r.load, (int)r.final_level, (int)fitting);
+        }
+    }
+
+    check_reused_windows();
+
+    printf("\n%d checks, %d failed: %s\n", bench_checks(), bench_failures(),
+           bench_failures() == 0 ? "PASS" : "FAILED");
+    return bench_failures() == 0 ? 0 : 1;
+}
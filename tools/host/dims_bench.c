@@ -0,0 +1,176 @@
+/**
+ * @file dims_bench.c
+ * @brief Window kernels with build-time versus runtime dimensions
+ *
+ * Built once per dimension set of POSE_DIMS_MATRIX (tools/host/CMakeLists.txt),
+ * each executable against its own pose_dims.h. For that set it times the
+ * per-window kernels two ways:
+ *
+ *   runtime  csi_window_stats(), csi_fixed_window_stats(),
+ *            pose_model_prepare_input(): dimensions are arguments, as for
+ *            the host tools
+ *   fixed    csi_window_stats_dims_f32() and csi_window_stats_dims_i16()
+ *            (what pose_inference.c calls, float or CONFIG_POSE_FIXED_POINT),
+ *            csi_kernel_window_stats() with the pose_dims.h constants,
+ *            pose_model_prepare_window()
+ *
+ * Also checks that both give bit-identical results. Exits non-zero if a
+ * check fails.
+ *
+ * Usage:
+ *   dims_bench [--iterations 2000]
+ *   cmake --build build/host --target dims_matrix    (every set)
+ */
+
+#include "bench_util.h"
+#include "csi_fixed.h"
+#include "csi_kernels.h"
+#include "csi_window_kernels.h"
+#include "pose_dims.h"
+#include "pose_pipeline.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define WINDOW_FLOATS (POSE_WINDOW_SAMPLES * POSE_NUM_SUBCARRIERS)
+#define INPUT_BYTES (POSE_WINDOW_SAMPLES * POSE_MODEL_FEATURES)
+
+// Quantization of the model input (a typical int8 input tensor)
+#define INPUT_SCALE 0.03f
+#define INPUT_ZERO_POINT (-2)
+
+// Read at run time, so the runtime path cannot be specialized by the compiler
+static volatile int s_num_samples = POSE_WINDOW_SAMPLES;
+static volatile int s_num_subcarriers = POSE_NUM_SUBCARRIERS;
+
+static void print_row(const char *kernel, double runtime_us, double fixed_us)
+{
+    printf("%-22s %12.2f %12.2f %9.2fx\n", kernel, runtime_us, fixed_us, runtime_us / fixed_us);
+}
+
+int main(int argc, char **argv)
+{
+    int iterations = 2000;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "Usage: %s [--iterations N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (iterations <= 0) {
+        fprintf(stderr, "Iterations must be positive\n");
+        return 2;
+    }
+
+    static float amplitude[WINDOW_FLOATS];
+    static float phase[WINDOW_FLOATS];
+    static int16_t amplitude_q[WINDOW_FLOATS];
+    static int16_t phase_q[WINDOW_FLOATS];
+    static int8_t rssi[POSE_WINDOW_SAMPLES];
+    static int8_t input_runtime[INPUT_BYTES];
+    static int8_t input_fixed[INPUT_BYTES];
+    for (int i = 0; i < WINDOW_FLOATS; i++) {
+        amplitude[i] = 10.0f + 20.0f * bench_uniform();
+        phase[i] = (2.0f * bench_uniform() - 1.0f) * CSI_KERNEL_PI;
+    }
+    for (int t = 0; t < POSE_WINDOW_SAMPLES; t++) {
+        rssi[t] = (int8_t)(-70 + (int)(10.0f * bench_uniform()));
+    }
+    csi_fixed_from_float(amplitude, phase, WINDOW_FLOATS, amplitude_q, phase_q);
+
+    // Same results either way
+    csi_window_stats_t runtime_stats, fixed_stats;
+    csi_window_stats(amplitude, phase, rssi, s_num_samples, s_num_subcarriers, &runtime_stats);
+    csi_kernel_window_stats(amplitude, phase, rssi, POSE_WINDOW_SAMPLES, POSE_NUM_SUBCARRIERS,
+                            &fixed_stats);
+    if (memcmp(&runtime_stats, &fixed_stats, sizeof(runtime_stats)) != 0) {
+        FAIL("window statistics differ");
+    }
+    csi_window_stats_dims_f32(amplitude, phase, rssi, &fixed_stats);
+    if (memcmp(&runtime_stats, &fixed_stats, sizeof(runtime_stats)) != 0) {
+        FAIL("csi_window_stats_dims_f32() differs from csi_window_stats()");
+    }
+    csi_window_stats_t runtime_q, fixed_q;
+    csi_fixed_window_stats(amplitude_q, phase_q, rssi, s_num_samples, s_num_subcarriers,
+                           &runtime_q);
+    csi_window_stats_dims_i16(amplitude_q, phase_q, rssi, &fixed_q);
+    if (memcmp(&runtime_q, &fixed_q, sizeof(runtime_q)) != 0) {
+        FAIL("csi_window_stats_dims_i16() differs from csi_fixed_window_stats()");
+    }
+    pose_model_prepare_input(amplitude, phase, s_num_samples, s_num_subcarriers, INPUT_SCALE,
+                             INPUT_ZERO_POINT, input_runtime);
+    pose_model_prepare_window(amplitude, phase, INPUT_SCALE, INPUT_ZERO_POINT, input_fixed);
+    if (memcmp(input_runtime, input_fixed, sizeof(input_fixed)) != 0) {
+        FAIL("model inputs differ");
+    }
+
+    // Timing; the sink keeps the loops from being optimized away
+    float sink = 0.0f;
+    double t0 = bench_now_s();
+    for (int i = 0; i < iterations; i++) {
+        csi_window_stats(amplitude, phase, rssi, s_num_samples, s_num_subcarriers,
+                         &runtime_stats);
+        sink += runtime_stats.phase_variance;
+    }
+    double stats_runtime = (bench_now_s() - t0) * 1e6 / iterations;
+    t0 = bench_now_s();
+    for (int i = 0; i < iterations; i++) {
+        csi_kernel_window_stats(amplitude, phase, rssi, POSE_WINDOW_SAMPLES, POSE_NUM_SUBCARRIERS,
+                                &fixed_stats);
+        sink += fixed_stats.phase_variance;
+    }
+    double stats_fixed = (bench_now_s() - t0) * 1e6 / iterations;
+    t0 = bench_now_s();
+    for (int i = 0; i < iterations; i++) {
+        csi_window_stats_dims_f32(amplitude, phase, rssi, &fixed_stats);
+        sink += fixed_stats.phase_variance;
+    }
+    double stats_dims_f32 = (bench_now_s() - t0) * 1e6 / iterations;
+
+    t0 = bench_now_s();
+    for (int i = 0; i < iterations; i++) {
+        csi_fixed_window_stats(amplitude_q, phase_q, rssi, s_num_samples, s_num_subcarriers,
+                               &runtime_q);
+        sink += runtime_q.phase_variance;
+    }
+    double stats_q_runtime = (bench_now_s() - t0) * 1e6 / iterations;
+    t0 = bench_now_s();
+    for (int i = 0; i < iterations; i++) {
+        csi_window_stats_dims_i16(amplitude_q, phase_q, rssi, &fixed_q);
+        sink += fixed_q.phase_variance;
+    }
+    double stats_dims_i16 = (bench_now_s() - t0) * 1e6 / iterations;
+
+    t0 = bench_now_s();
+    for (int i = 0; i < iterations; i++) {
+        pose_model_prepare_input(amplitude, phase, s_num_samples, s_num_subcarriers, INPUT_SCALE,
+                                 INPUT_ZERO_POINT, input_runtime);
+        sink += input_runtime[i % INPUT_BYTES];
+    }
+    double prepare_runtime = (bench_now_s() - t0) * 1e6 / iterations;
+    t0 = bench_now_s();
+    for (int i = 0; i < iterations; i++) {
+        pose_model_prepare_window(amplitude, phase, INPUT_SCALE, INPUT_ZERO_POINT, input_fixed);
+        sink += input_fixed[i % INPUT_BYTES];
+    }
+    double prepare_fixed = (bench_now_s() - t0) * 1e6 / iterations;
+
+    printf("Dimensions: %d subcarriers, %d ms at %d Hz = %d samples, model input %d x %d\n",
+           POSE_NUM_SUBCARRIERS, POSE_WINDOW_MS, POSE_SAMPLE_RATE_HZ, POSE_WINDOW_SAMPLES,
+           POSE_WINDOW_SAMPLES, POSE_MODEL_FEATURES);
+    printf("%-22s %12s %12s %10s\n", "us per window (host)", "runtime", "fixed", "speedup");
+    print_row("window statistics", stats_runtime, stats_fixed);
+    print_row("  dims_f32", stats_runtime, stats_dims_f32);
+    print_row("  dims_i16 (Q8.7)", stats_q_runtime, stats_dims_i16);
+    print_row("model input", prepare_runtime, prepare_fixed);
+    if (isnan(sink)) {
+        printf("%f\n", sink);
+    }
+
+    printf("\n%s\n", bench_failures() == 0 ? "PASS" : "FAILED");
+    return bench_failures() == 0 ? 0 : 1;
+}
@@ -0,0 +1,332 @@
+/**
+ * @file event_replay.cpp
+ * @brief Replays recordings through the fall/sudden-event detector
+ *
+ * Feeds every sample of the recordings to event_detector.c (compiled
+ * unchanged from firmware/main), the way pose_process_csi() does on the
+ * device, and scores the events against the falls marked in the recording
+ * ("event": "fall" on the first sample of each, see
+ * generate_synthetic_data.py --session N --falls):
+ *
+ * - SUDDEN events: detection rate and latency distribution from the fall
+ *   onset, next to the latency of the 500ms window cadence
+ * - FALL confirmations: detection rate and latency
+ * - False positives per hour: FALL events away from any marked fall, and
+ *   SUDDEN events away from falls (someone walking in, sitting down, ...)
+ * - Detector cost per sample
+ *
+ * A SUDDEN event counts for a fall if it fires within --match-ms of the
+ * onset (100ms early is tolerated), a FALL event within 4s. Exits non-zero
+ * if falls are marked and FALL recall is below --min-recall or false FALL
+ * events exceed --max-false-per-hour.
+ *
+ * Usage:
+ *   event_replay datasets/falls.json [--rate 100] [--threshold 12]
+ *                [--fall-rise-db 6] [--events events.csv]
+ */
+
+#include "csi_dataset.hpp"
+
+extern "C" {
+#include "event_detector.h"
+}
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Tumbling window of the device's classifier (TEMPORAL_BUFFER_SIZE samples)
+constexpr int kWindowMs = 500;
+// A FALL confirmation counts for a fall this long after the onset
+constexpr int kFallMatchMs = 4000;
+// A SUDDEN event may fire this much before the marked onset
+constexpr int kEarlyMs = 100;
+
+struct Options {
+    std::vector<std::string> inputs;
+    float rate_hz = 100.0f;
+    int match_ms = 1000;
+    float min_recall = 0.9f;
+    float max_false_per_hour = 1.0f;
+    std::string events_csv;
+    event_detector_config_t config;
+};
+
+struct Event {
+    size_t file;
+    motion_event_t event;
+    bool matched = false;
+};
+
+void usage(const char *argv0)
+{
+    std::fprintf(stderr,
+                 "Usage: %s <recording.json>... [options]\n"
+                 "  --rate HZ               Sampling rate (default 100)\n"
+                 "  --threshold H           CUSUM threshold (default 12)\n"
+                 "  --drift K               CUSUM allowance per sample (default 1)\n"
+                 "  --fall-rise-db DB       Peak rise a fall needs (default 6)\n"
+                 "  --match-ms MS           SUDDEN event window after the onset (default 1000)\n"
+                 "  --min-recall R          Fail below this FALL recall (default 0.9)\n"
+                 "  --max-false-per-hour F  Fail above this false FALL rate (default 1)\n"
+                 "  --events FILE           Write every event as CSV\n",
+                 argv0);
+}
+
+bool parse_args(int argc, char **argv, Options &opt)
+{
+    // The rate scales the default durations, so read it first
+    for (int i = 1; i + 1 < argc; i++) {
+        if (std::strcmp(argv[i], "--rate") == 0) {
+            opt.rate_hz = std::strtof(argv[i + 1], nullptr);
+        }
+    }
+    if (!(opt.rate_hz > 0.0f)) {
+        return false;
+    }
+    event_detector_default_config(&opt.config, opt.rate_hz);
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--rate" && has_value) {
+            i++;
+        } else if (arg == "--threshold" && has_value) {
+            opt.config.threshold = std::strtof(argv[++i], nullptr);
+        } else if (arg == "--drift" && has_value) {
+            opt.config.drift = std::strtof(argv[++i], nullptr);
+        } else if (arg == "--fall-rise-db" && has_value) {
+            opt.config.fall_rise_db = std::strtof(argv[++i], nullptr);
+        } else if (arg == "--match-ms" && has_value) {
+            opt.match_ms = std::atoi(argv[++i]);
+        } else if (arg == "--min-recall" && has_value) {
+            opt.min_recall = std::strtof(argv[++i], nullptr);
+        } else if (arg == "--max-false-per-hour" && has_value) {
+            opt.max_false_per_hour = std::strtof(argv[++i], nullptr);
+        } else if (arg == "--events" && has_value) {
+            opt.events_csv = argv[++i];
+        } else if (!arg.empty() && arg[0] == '-') {
+            return false;
+        } else {
+            opt.inputs.push_back(arg);
+        }
+    }
+    return !opt.inputs.empty();
+}
+
+double percentile(std::vector<double> values, double p)
+{
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    size_t i = static_cast<size_t>(p * (values.size() - 1) + 0.5);
+    return values[i];
+}
+
+void print_latency(const char *name, const std::vector<double> &ms)
+{
+    if (ms.empty()) {
+        std::printf("  %-18s none detected\n", name);
+        return;
+    }
+    double sum = 0.0;
+    for (double v : ms) {
+        sum += v;
+    }
+    std::printf("  %-18s mean %6.0f  min %6.0f  p50 %6.0f  p90 %6.0f  p99 %6.0f  max %6.0f ms\n",
+                name, sum / ms.size(), percentile(ms, 0.0), percentile(ms, 0.5),
+                percentile(ms, 0.9), percentile(ms, 0.99), percentile(ms, 1.0));
+}
+
+void print_histogram(const std::vector<double> &ms, int bin_ms, int bins)
+{
+    std::vector<size_t> counts(bins + 1, 0);
+    for (double v : ms) {
+        int b = v < 0.0 ? 0 : static_cast<int>(v / bin_ms);
+        counts[std::min(b, bins)]++;
+    }
+    size_t most = *std::max_element(counts.begin(), counts.end());
+    for (int b = 0; b <= bins; b++) {
+        char range[32];
+        if (b < bins) {
+            std::snprintf(range, sizeof(range), "%4d-%4d ms", b * bin_ms, (b + 1) * bin_ms);
+        } else {
+            std::snprintf(range, sizeof(range), "   >=%4d ms", bins * bin_ms);
+        }
+        int bar = most > 0 ? static_cast<int>(40 * counts[b] / most) : 0;
+        std::printf("    %s %5zu %s\n", range, counts[b], std::string(bar, '#').c_str());
+    }
+}
+
+}  // namespace
+
+int main(int argc, char **argv)
+{
+    Options opt;
+    if (!parse_args(argc, argv, opt)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    event_detector_t det;
+    if (event_detector_init(&det, &opt.config) != ESP_OK) {
+        std::fprintf(stderr, "Invalid detector configuration\n");
+        return 2;
+    }
+
+    const double ms_per_sample = 1000.0 / opt.rate_hz;
+    std::vector<Event> events;
+    std::vector<std::pair<size_t, uint32_t>> falls;  // (file, onset sample)
+    size_t total_samples = 0;
+    double detector_ns = 0.0;
+
+    for (size_t f = 0; f < opt.inputs.size(); f++) {
+        csi::DatasetReader reader(opt.inputs[f]);
+        if (!reader.is_open()) {
+            std::fprintf(stderr, "Cannot open %s\n", opt.inputs[f].c_str());
+            return 1;
+        }
+        // Recordings are independent: start each with a fresh baseline
+        event_detector_init(&det, &opt.config);
+        uint32_t sample = 0;
+        reader.for_each([&](const csi::Sample &s) {
+            if (s.event == "fall") {
+                // The detector counts samples from the first difference on
+                falls.emplace_back(f, sample > 0 ? sample - 1 : 0);
+            }
+            motion_event_t event;
+            auto t0 = std::chrono::steady_clock::now();
+            bool fired = event_detector_push(&det, s.amplitude.data(),
+                                             static_cast<int>(s.amplitude.size()), &event);
+            detector_ns += std::chrono::duration<double, std::nano>(
+                               std::chrono::steady_clock::now() - t0).count();
+            if (fired) {
+                event.timestamp = static_cast<uint32_t>(event.sample * ms_per_sample);
+                events.push_back({ f, event });
+            }
+            sample++;
+        });
+        total_samples += sample;
+        if (reader.skipped() > 0) {
+            std::fprintf(stderr, "%s: %zu malformed records skipped\n", opt.inputs[f].c_str(),
+                         reader.skipped());
+        }
+    }
+    if (total_samples == 0) {
+        std::fprintf(stderr, "No samples\n");
+        return 1;
+    }
+    const double hours = total_samples * ms_per_sample / 3.6e6;
+
+    // Match events to falls: the first of each type inside the fall's window
+    std::vector<double> sudden_ms, fall_ms;
+    for (const auto &fall : falls) {
+        bool sudden_found = false, fall_found = false;
+        for (auto &e : events) {
+            if (e.file != fall.first) {
+                continue;
+            }
+            double dt = (static_cast<double>(e.event.sample) - fall.second) * ms_per_sample;
+            if (e.event.type == MOTION_EVENT_SUDDEN && !sudden_found && dt >= -kEarlyMs &&
+                dt <= opt.match_ms) {
+                sudden_found = e.matched = true;
+                sudden_ms.push_back(dt);
+            } else if (e.event.type == MOTION_EVENT_FALL && !fall_found && dt >= 0.0 &&
+                       dt <= kFallMatchMs) {
+                fall_found = e.matched = true;
+                fall_ms.push_back(dt);
+            }
+        }
+    }
+    size_t other_sudden = 0, false_falls = 0, total_sudden = 0;
+    for (const auto &e : events) {
+        if (e.event.type == MOTION_EVENT_SUDDEN) {
+            total_sudden++;
+            other_sudden += !e.matched;
+        } else {
+            false_falls += !e.matched;
+        }
+    }
+
+    std::printf("Event replay: %zu samples (%.1f min) from %zu recording(s), %.0f Hz\n",
+                total_samples, hours * 60.0, opt.inputs.size(), opt.rate_hz);
+    std::printf("Detector: threshold %.1f, drift %.2f, fall rise %.1f dB, %zu bytes of state, "
+                "%.0f ns/sample\n\n",
+                opt.config.threshold, opt.config.drift, opt.config.fall_rise_db,
+                sizeof(event_detector_t), detector_ns / total_samples);
+
+    std::printf("Events: %zu sudden (%.1f/hour), %zu falls\n", total_sudden,
+                total_sudden / hours, events.size() - total_sudden);
+
+    int status = 0;
+    if (falls.empty()) {
+        std::printf("No falls marked in the recording(s): rates only.\n");
+    } else {
+        double sudden_recall = static_cast<double>(sudden_ms.size()) / falls.size();
+        double fall_recall = static_cast<double>(fall_ms.size()) / falls.size();
+        double false_per_hour = false_falls / hours;
+
+        // The classifier would report at the end of the window holding the onset
+        std::vector<double> window_ms;
+        for (const auto &fall : falls) {
+            double onset = fall.second * ms_per_sample;
+            window_ms.push_back(kWindowMs - std::fmod(onset, static_cast<double>(kWindowMs)));
+        }
+
+        std::printf("Marked falls: %zu\n", falls.size());
+        std::printf("  SUDDEN detected    %zu/%zu (%.1f%%)\n", sudden_ms.size(), falls.size(),
+                    100.0 * sudden_recall);
+        std::printf("  FALL confirmed     %zu/%zu (%.1f%%)\n", fall_ms.size(), falls.size(),
+                    100.0 * fall_recall);
+        std::printf("\nLatency from the fall onset:\n");
+        print_latency("SUDDEN event", sudden_ms);
+        print_latency("FALL confirmation", fall_ms);
+        print_latency("500ms window end", window_ms);
+        std::printf("\n  SUDDEN latency histogram:\n");
+        print_histogram(sudden_ms, 20, 10);
+
+        std::printf("\nFalse positives:\n");
+        std::printf("  FALL away from a fall      %4zu  (%.2f/hour)\n", false_falls,
+                    false_per_hour);
+        std::printf("  SUDDEN away from a fall    %4zu  (%.1f/hour; activity onsets)\n",
+                    other_sudden, other_sudden / hours);
+
+        if (fall_recall < opt.min_recall) {
+            std::fprintf(stderr, "FAIL: FALL recall %.3f below %.3f\n", fall_recall,
+                         opt.min_recall);
+            status = 1;
+        }
+        if (false_per_hour > opt.max_false_per_hour) {
+            std::fprintf(stderr, "FAIL: %.2f false FALL events/hour, at most %.2f allowed\n",
+                         false_per_hour, opt.max_false_per_hour);
+            status = 1;
+        }
+    }
+
+    if (!opt.events_csv.empty()) {
+        std::FILE *out = std::fopen(opt.events_csv.c_str(), "w");
+        if (out == nullptr) {
+            std::fprintf(stderr, "Cannot write %s\n", opt.events_csv.c_str());
+            return 1;
+        }
+        std::fprintf(out, "file,id,type,sample,time_ms,score,rise_db,matched\n");
+        for (const auto &e : events) {
+            std::fprintf(out, "%s,%u,%s,%u,%u,%.1f,%.1f,%d\n", opt.inputs[e.file].c_str(),
+                         e.event.id, e.event.type == MOTION_EVENT_FALL ? "fall" : "sudden",
+                         e.event.sample, e.event.timestamp, e.event.score, e.event.rise_db,
+                         e.matched ? 1 : 0);
+        }
+        std::fclose(out);
+    }
+
+    std::printf("\n%s\n", status == 0 ? "PASS" : "FAILED");
+    return status;
+}
@@ -0,0 +1,341 @@
+/**
+ * @file fixed_point_check.c
+ * @brief Equivalence and cost of the fixed-point CSI path against the float path
+ *
+ * Runs csi_fixed.c and occupancy_estimate_q7(), compiled unchanged from
+ * firmware/main, next to the float functions they replace with
+ * CONFIG_POSE_FIXED_POINT:
+ *
+ *   I/Q -> amplitude/phase    csi_fixed_iq()            sqrtf()/atan2f()
+ *   window statistics         csi_fixed_window_stats()  csi_window_stats()
+ *   model input               csi_fixed_prepare_input() pose_model_prepare_input()
+ *   people count              occupancy_estimate_q7()   occupancy_estimate()
+ *
+ * The I/Q conversion is checked on every int8 pair. The window stages are
+ * checked on synthetic windows with 0 to 3 moving people: each path starts
+ * from the same raw I/Q, so the comparison covers the whole chain. Then
+ * both paths are timed per packet or per window.
+ *
+ * Prints each failed check and exits non-zero if there is any.
+ *
+ * Usage:
+ *   fixed_point_check [--windows 200] [--iterations 500]
+ */
+
+#include "bench_util.h"
+#include "csi_fixed.h"
+#include "occupancy.h"
+#include "pose_pipeline.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SAMPLES 50
+#define SUBCARRIERS 52
+#define WINDOW (SAMPLES * SUBCARRIERS)
+#define MAX_MOVERS 3
+
+// Quantization of the model input (a typical int8 input tensor)
+#define INPUT_SCALE 0.03f
+#define INPUT_ZERO_POINT (-2)
+
+// Tolerances of the fixed-point path
+#define TOL_IQ_AMPLITUDE (0.6f / CSI_FIXED_AMP_ONE)
+#define TOL_IQ_PHASE 2.0e-4f
+#define TOL_MEAN 1.0e-3f
+#define TOL_STD_REL 1.0e-2f
+#define TOL_PHASE_VAR_REL 1.0e-2f
+#define TOL_INPUT 1
+#define TOL_EIGEN_REL 2.0e-2f
+
+
+static int8_t clamp_iq(float v)
+{
+    long q = lroundf(v);
+    return (int8_t)(q < -128 ? -128 : q > 127 ? 127 : q);
+}
+
+static float wrapped_diff(float a, float b)
+{
+    float d = a - b;
+    while (d > (float)M_PI) d -= 2.0f * (float)M_PI;
+    while (d < -(float)M_PI) d += 2.0f * (float)M_PI;
+    return d;
+}
+
+/**
+ * @brief The float path's conversion (wifi_csi.c without CONFIG_POSE_FIXED_POINT)
+ */
+static void float_iq(const int8_t *iq, int n, float *amplitude, float *phase)
+{
+    for (int i = 0; i < n; i++) {
+        int8_t I = iq[2 * i];
+        int8_t Q = iq[2 * i + 1];
+        amplitude[i] = sqrtf((float)(I * I + Q * Q));
+        phase[i] = atan2f((float)Q, (float)I);
+    }
+}
+
+/**
+ * @brief Raw I/Q of a window: static channel, movers with their own
+ *        subcarrier pattern, and noise
+ */
+static void synthetic_window(int movers, int8_t *iq)
+{
+    float base_re[SUBCARRIERS], base_im[SUBCARRIERS];
+    float pattern[MAX_MOVERS][SUBCARRIERS];
+    float freq[MAX_MOVERS], offset[MAX_MOVERS];
+    for (int s = 0; s < SUBCARRIERS; s++) {
+        float amp = 20.0f + 40.0f * bench_uniform();
+        float angle = 2.0f * (float)M_PI * bench_uniform();
+        base_re[s] = amp * cosf(angle);
+        base_im[s] = amp * sinf(angle);
+    }
+    for (int k = 0; k < movers; k++) {
+        freq[k] = 0.5f + 2.0f * bench_uniform();
+        offset[k] = 2.0f * (float)M_PI * bench_uniform();
+        for (int s = 0; s < SUBCARRIERS; s++) {
+            pattern[k][s] = 0.4f * (2.0f * bench_uniform() - 1.0f);
+        }
+    }
+    for (int t = 0; t < SAMPLES; t++) {
+        for (int s = 0; s < SUBCARRIERS; s++) {
+            float gain = 1.0f;
+            for (int k = 0; k < movers; k++) {
+                gain += pattern[k][s] * sinf(2.0f * (float)M_PI * freq[k] * t / 100.0f + offset[k]);
+            }
+            int8_t *sample = &iq[2 * (t * SUBCARRIERS + s)];
+            sample[0] = clamp_iq(base_re[s] * gain + 2.0f * (bench_uniform() - 0.5f));
+            sample[1] = clamp_iq(base_im[s] * gain + 2.0f * (bench_uniform() - 0.5f));
+        }
+    }
+}
+
+static void check_iq(void)
+{
+    float max_amp = 0.0f, max_phase = 0.0f;
+    for (int I = -128; I < 128; I++) {
+        for (int Q = -128; Q < 128; Q++) {
+            int8_t iq[2] = { (int8_t)I, (int8_t)Q };
+            float amp, phase;
+            int16_t amp_q, phase_q;
+            float_iq(iq, 1, &amp, &phase);
+            csi_fixed_iq(iq, 1, &amp_q, &phase_q);
+            float amp_err = fabsf(amp_q * (1.0f / CSI_FIXED_AMP_ONE) - amp);
+            float phase_err = fabsf(wrapped_diff(phase_q * ((float)M_PI / CSI_FIXED_PHASE_ONE),
+                                                 phase));
+            if (amp_err > max_amp) max_amp = amp_err;
+            if (I != 0 || Q != 0) {
+                if (phase_err > max_phase) max_phase = phase_err;
+            }
+        }
+    }
+    CHECK(max_amp <= TOL_IQ_AMPLITUDE, "I/Q amplitude error %.2e", max_amp);
+    CHECK(max_phase <= TOL_IQ_PHASE, "I/Q phase error %.2e rad", max_phase);
+    printf("I/Q (all 65536 pairs): max amplitude error %.2e, max phase error %.2e rad\n",
+           max_amp, max_phase);
+
+    // Round trip through the float conversions
+    float amp = 181.02f, phase = -3.14159f;
+    int16_t amp_q, phase_q;
+    csi_fixed_from_float(&amp, &phase, 1, &amp_q, &phase_q);
+    CHECK(amp_q == 23171 && phase_q == -32768, "from_float %d %d", amp_q, phase_q);
+    float back_amp, back_phase;
+    csi_fixed_to_float(&amp_q, &phase_q, 1, &back_amp, &back_phase);
+    CHECK(fabsf(back_amp - amp) < 0.5f / CSI_FIXED_AMP_ONE &&
+          fabsf(back_phase - phase) < 1e-4f, "to_float %f %f", back_amp, back_phase);
+
+    CHECK(csi_fixed_isqrt64(0) == 0 && csi_fixed_isqrt64(15) == 3 && csi_fixed_isqrt64(16) == 4 &&
+          csi_fixed_isqrt64(UINT64_MAX) == UINT32_MAX, "isqrt64");
+}
+
+static void check_windows(int windows)
+{
+    static int8_t iq[2 * WINDOW];
+    static float amp[WINDOW], phase[WINDOW];
+    static int16_t amp_q[WINDOW], phase_q[WINDOW];
+    static int8_t input_float[SAMPLES * 2 * SUBCARRIERS], input_fixed[SAMPLES * 2 * SUBCARRIERS];
+    static float scratch[OCCUPANCY_SCRATCH_BYTES(SUBCARRIERS) / sizeof(float)];
+    int8_t rssi[SAMPLES];
+    for (int t = 0; t < SAMPLES; t++) {
+        rssi[t] = (int8_t)(-60 - t % 7);
+    }
+
+    float max_mean = 0.0f, max_std = 0.0f, max_phase_var = 0.0f, max_eigen = 0.0f;
+    int max_input = 0, input_mismatches = 0, count_mismatches = 0;
+    for (int w = 0; w < windows; w++) {
+        int movers = w % (MAX_MOVERS + 1);
+        synthetic_window(movers, iq);
+        float_iq(iq, WINDOW, amp, phase);
+        csi_fixed_iq(iq, WINDOW, amp_q, phase_q);
+
+        csi_window_stats_t fs, qs;
+        csi_window_stats(amp, phase, rssi, SAMPLES, SUBCARRIERS, &fs);
+        csi_fixed_window_stats(amp_q, phase_q, rssi, SAMPLES, SUBCARRIERS, &qs);
+        max_mean = fmaxf(max_mean, fabsf(qs.amplitude_mean - fs.amplitude_mean));
+        max_std = fmaxf(max_std, fabsf(qs.amplitude_std - fs.amplitude_std) / fs.amplitude_std);
+        max_phase_var = fmaxf(max_phase_var,
+                              fabsf(qs.phase_variance - fs.phase_variance) / fs.phase_variance);
+        CHECK(qs.rssi_mean == fs.rssi_mean, "window %d: rssi %d vs %d", w, qs.rssi_mean,
+              fs.rssi_mean);
+
+        pose_model_prepare_input(amp, phase, SAMPLES, SUBCARRIERS, INPUT_SCALE, INPUT_ZERO_POINT,
+                                 input_float);
+        csi_fixed_prepare_input(amp_q, phase_q, SAMPLES, SUBCARRIERS, INPUT_SCALE,
+                                INPUT_ZERO_POINT, input_fixed);
+        for (int i = 0; i < SAMPLES * 2 * SUBCARRIERS; i++) {
+            int d = abs(input_fixed[i] - input_float[i]);
+            if (d > max_input) max_input = d;
+            input_mismatches += d != 0;
+        }
+
+        occupancy_estimate_t fo, qo;
+        occupancy_estimate(amp, SAMPLES, SUBCARRIERS, false, scratch, &fo);
+        occupancy_estimate_q7(amp_q, SAMPLES, SUBCARRIERS, false, scratch, &qo);
+        count_mismatches += qo.count != fo.count;
+        for (int k = 0; k < OCCUPANCY_COMPONENTS; k++) {
+            if (fo.eigenvalues[k] > fo.noise * 4.0f) {
+                max_eigen = fmaxf(max_eigen, fabsf(qo.eigenvalues[k] - fo.eigenvalues[k]) /
+                                             fo.eigenvalues[k]);
+            }
+        }
+    }
+
+    CHECK(max_mean <= TOL_MEAN, "amplitude mean error %.2e", max_mean);
+    CHECK(max_std <= TOL_STD_REL, "amplitude std relative error %.2e", max_std);
+    CHECK(max_phase_var <= TOL_PHASE_VAR_REL, "phase variance relative error %.2e",
+          max_phase_var);
+    CHECK(max_input <= TOL_INPUT, "model input differs by %d", max_input);
+    CHECK(count_mismatches == 0, "%d windows counted differently", count_mismatches);
+    CHECK(max_eigen <= TOL_EIGEN_REL, "eigenvalue relative error %.2e", max_eigen);
+
+    printf("Windows (%d of %dx%d, I/Q to result on both paths):\n", windows, SAMPLES,
+           SUBCARRIERS);
+    printf("  amplitude mean      max error %.2e\n", max_mean);
+    printf("  amplitude std       max relative error %.2e\n", max_std);
+    printf("  phase variance      max relative error %.2e\n", max_phase_var);
+    printf("  model input         max difference %d, %.3f%% of values differ\n", max_input,
+           100.0 * input_mismatches / ((double)windows * SAMPLES * 2 * SUBCARRIERS));
+    printf("  people count        %d windows differ; signal eigenvalues max relative "
+           "error %.2e\n", count_mismatches, max_eigen);
+}
+
+static void print_row(const char *stage, double float_ns, double fixed_ns)
+{
+    printf("  %-26s %12.0f %12.0f %9.2fx\n", stage, float_ns, fixed_ns, float_ns / fixed_ns);
+}
+
+static void benchmark(int iterations)
+{
+    static int8_t iq[2 * WINDOW];
+    static float amp[WINDOW], phase[WINDOW];
+    static int16_t amp_q[WINDOW], phase_q[WINDOW];
+    static int8_t input[SAMPLES * 2 * SUBCARRIERS];
+    static float scratch[OCCUPANCY_SCRATCH_BYTES(SUBCARRIERS) / sizeof(float)];
+    int8_t rssi[SAMPLES] = { 0 };
+    synthetic_window(2, iq);
+    float_iq(iq, WINDOW, amp, phase);
+    csi_fixed_iq(iq, WINDOW, amp_q, phase_q);
+
+    float sink = 0.0f;
+    csi_window_stats_t stats;
+    occupancy_estimate_t occupancy;
+    double t0, per[2][4];
+
+    // Per packet: one row of SUBCARRIERS
+    t0 = bench_now_s();
+    for (int i = 0; i < iterations * SAMPLES; i++) {
+        int row = i % SAMPLES;
+        float_iq(&iq[2 * row * SUBCARRIERS], SUBCARRIERS, &amp[row * SUBCARRIERS],
+                 &phase[row * SUBCARRIERS]);
+    }
+    per[0][0] = (bench_now_s() - t0) * 1e9 / ((double)iterations * SAMPLES);
+    t0 = bench_now_s();
+    for (int i = 0; i < iterations * SAMPLES; i++) {
+        int row = i % SAMPLES;
+        csi_fixed_iq(&iq[2 * row * SUBCARRIERS], SUBCARRIERS, &amp_q[row * SUBCARRIERS],
+                     &phase_q[row * SUBCARRIERS]);
+    }
+    per[1][0] = (bench_now_s() - t0) * 1e9 / ((double)iterations * SAMPLES);
+
+    t0 = bench_now_s();
+    for (int i = 0; i < iterations; i++) {
+        csi_window_stats(amp, phase, rssi, SAMPLES, SUBCARRIERS, &stats);
+        sink += stats.amplitude_std;
+    }
+    per[0][1] = (bench_now_s() - t0) * 1e9 / iterations;
+    t0 = bench_now_s();
+    for (int i = 0; i < iterations; i++) {
+        csi_fixed_window_stats(amp_q, phase_q, rssi, SAMPLES, SUBCARRIERS, &stats);
+        sink += stats.amplitude_std;
+    }
+    per[1][1] = (bench_now_s() - t0) * 1e9 / iterations;
+
+    t0 = bench_now_s();
+    for (int i = 0; i < iterations; i++) {
+        pose_model_prepare_input(amp, phase, SAMPLES, SUBCARRIERS, INPUT_SCALE, INPUT_ZERO_POINT,
+                                 input);
+        sink += input[i % sizeof(input)];
+    }
+    per[0][2] = (bench_now_s() - t0) * 1e9 / iterations;
+    t0 = bench_now_s();
+    for (int i = 0; i < iterations; i++) {
+        csi_fixed_prepare_input(amp_q, phase_q, SAMPLES, SUBCARRIERS, INPUT_SCALE,
+                                INPUT_ZERO_POINT, input);
+        sink += input[i % sizeof(input)];
+    }
+    per[1][2] = (bench_now_s() - t0) * 1e9 / iterations;
+
+    t0 = bench_now_s();
+    for (int i = 0; i < iterations; i++) {
+        occupancy_estimate(amp, SAMPLES, SUBCARRIERS, false, scratch, &occupancy);
+        sink += occupancy.noise;
+    }
+    per[0][3] = (bench_now_s() - t0) * 1e9 / iterations;
+    t0 = bench_now_s();
+    for (int i = 0; i < iterations; i++) {
+        occupancy_estimate_q7(amp_q, SAMPLES, SUBCARRIERS, false, scratch, &occupancy);
+        sink += occupancy.noise;
+    }
+    per[1][3] = (bench_now_s() - t0) * 1e9 / iterations;
+
+    printf("\nCost (ns, host CPU; placement_bench has the device cycles):\n");
+    printf("  %-26s %12s %12s %10s\n", "", "float", "fixed", "speedup");
+    print_row("I/Q conversion per packet", per[0][0], per[1][0]);
+    print_row("window statistics", per[0][1], per[1][1]);
+    print_row("model input", per[0][2], per[1][2]);
+    print_row("people count", per[0][3], per[1][3]);
+    if (isnan(sink)) {
+        printf("%f\n", sink);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int windows = 200;
+    int iterations = 500;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--windows") == 0 && i + 1 < argc) {
+            windows = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "Usage: %s [--windows N] [--iterations N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (windows <= 0 || iterations <= 0) {
+        fprintf(stderr, "Windows and iterations must be positive\n");
+        return 2;
+    }
+
+    check_iq();
+    check_windows(windows);
+    benchmark(iterations);
+
+    printf("\n%d checks, %d failed\n%s\n", bench_checks(), bench_failures(),
+           bench_failures() == 0 ? "PASS" : "FAILED");
+    return bench_failures() == 0 ? 0 : 1;
+}
@@ -0,0 +1,23 @@
+/**
+ * @file esp_log.h
+ * @brief Host stand-in for ESP-IDF's esp_log.h
+ *
+ * Maps the ESP_LOGx macros to stderr with the same "L (tag) message" layout
+ * as the device console. Debug and verbose logs are compiled out.
+ */
+
+#ifndef HOST_ESP_LOG_H
+#define HOST_ESP_LOG_H
+
+#include <stdio.h>
+
+#define HOST_ESP_LOG(level, tag, format, ...) \
+    fprintf(stderr, level " (%s) " format "\n", tag, ##__VA_ARGS__)
+
+#define ESP_LOGE(tag, format, ...) HOST_ESP_LOG("E", tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) HOST_ESP_LOG("W", tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...) HOST_ESP_LOG("I", tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...) do { (void)(tag); } while (0)
+#define ESP_LOGV(tag, format, ...) do { (void)(tag); } while (0)
+
+#endif // HOST_ESP_LOG_H
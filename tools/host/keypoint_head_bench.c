@@ -0,0 +1,310 @@
+/**
+ * @file keypoint_head_bench.c
+ * @brief Cost of the keypoint regression head against the classification-only model
+ *
+ * The device runs models through TFLite Micro, which is not part of the host
+ * build, so this benchmark runs LightweightPoseModel (train_pose_model.py)
+ * with random weights on the int8 kernels of model_net.h and
+ * model_layers.h, compiled unchanged from firmware/main:
+ *
+ *   input 50 x 104 -> Conv1D 32 k5 -> pool 2 -> Conv1D 64 k5 -> pool 2
+ *     -> Conv1D 64 k3 -> global average pool (64 features)
+ *       -> Dense 64 -> Dense 32 -> Dense 6            class scores
+ *       -> Dense 64 -> Dense 51 (sigmoid)             keypoint head (--keypoints)
+ *
+ * Batch normalization is folded into the convolutions by the TFLite
+ * converter, and dropout is removed, so neither costs anything at inference.
+ * It reports, for both models, the multiply-accumulates, weight bytes, peak
+ * activation bytes and latency. It also covers what the head adds after
+ * inference: the decode tables, the skeleton in pose_result_t, the result
+ * history ring and the binary record. The absolute times are for the host
+ * CPU; the ratio between the two models is what carries over to the device.
+ *
+ * Also checks that the head matches a plain reference Dense and leaves the
+ * class scores unchanged, and that keypoint decoding and the binary record
+ * round-trip exactly. Exits non-zero if a check fails.
+ *
+ * Usage:
+ *   keypoint_head_bench [--iterations 2000]
+ */
+
+#include "bench_util.h"
+#include "model_net.h"
+#include "pose_pipeline.h"
+#include "pose_record.h"
+#include "result_ring.h"
+#include "tflite_classifier.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define KEYPOINT_HIDDEN 64
+
+/**
+ * @brief The reference model: the classifier plus the keypoint head
+ */
+typedef struct {
+    model_net_t net;
+    model_layer_t kp_hidden, kp_out;
+    int8_t sigmoid[256];               // int8 -> int8 sigmoid (output scale 1/256, zp -128)
+
+    int8_t *scratch;                   // model_net_scratch_bytes() for one window
+    int8_t features[64];               // Kept for the head while the class branch runs
+    int8_t hidden[KEYPOINT_HIDDEN];
+} model_t;
+
+static const int s_steps[3] = { TFLITE_INPUT_SAMPLES, TFLITE_INPUT_SAMPLES / 2,
+                                TFLITE_INPUT_SAMPLES / 4 };
+
+static void model_init(model_t *m)
+{
+    m->net = (model_net_t){
+        .layers = {
+            [MODEL_NET_CONV1] = bench_make_layer(TFLITE_INPUT_FEATURES, 32, 5),
+            [MODEL_NET_CONV2] = bench_make_layer(32, 64, 5),
+            [MODEL_NET_CONV3] = bench_make_layer(64, 64, 3),
+            [MODEL_NET_DENSE1] = bench_make_layer(64, 64, 1),
+            [MODEL_NET_DENSE2] = bench_make_layer(64, 32, 1),
+            [MODEL_NET_CLASSES] = bench_make_layer(32, TFLITE_NUM_CLASSES, 1),
+        },
+        .steps = TFLITE_INPUT_SAMPLES,
+    };
+    CHECK(model_net_valid(&m->net), "the reference model's shapes are rejected");
+    m->kp_hidden = bench_make_layer(64, KEYPOINT_HIDDEN, 1);
+    m->kp_out = bench_make_layer(KEYPOINT_HIDDEN, TFLITE_KEYPOINT_OUTPUTS, 1);
+    for (int i = 0; i < 256; i++) {
+        float x = (int8_t)i / 16.0f;
+        int q = (int)lroundf(256.0f / (1.0f + expf(-x))) - 128;
+        m->sigmoid[i] = (int8_t)(q > 127 ? 127 : q);
+    }
+    m->scratch = malloc(model_net_scratch_bytes(&m->net, 1));
+}
+
+static void model_free(model_t *m)
+{
+    for (int i = 0; i < MODEL_NET_LAYERS; i++) {
+        bench_free_layer(&m->net.layers[i]);
+    }
+    bench_free_layer(&m->kp_hidden);
+    bench_free_layer(&m->kp_out);
+    free(m->scratch);
+}
+
+static void model_run(model_t *m, const int8_t *input, int8_t *scores, int8_t *keypoints)
+{
+    const int8_t *features = model_net_features(&m->net, NULL, input, 1, m->scratch);
+    if (keypoints != NULL) {
+        memcpy(m->features, features, sizeof(m->features));
+    }
+    model_net_classify(&m->net, NULL, features, 1, m->scratch, scores);
+
+    if (keypoints != NULL) {
+        model_dense_split(NULL, &m->kp_hidden, m->features, true, m->hidden);
+        model_dense_split(NULL, &m->kp_out, m->hidden, false, keypoints);
+        for (int i = 0; i < TFLITE_KEYPOINT_OUTPUTS; i++) {
+            keypoints[i] = m->sigmoid[(uint8_t)keypoints[i]];
+        }
+    }
+}
+
+/**
+ * @brief The head against the reference Dense, and the scores with and without it
+ */
+static void check_head(model_t *m, const int8_t *input)
+{
+    int8_t scores[TFLITE_NUM_CLASSES], with_head[TFLITE_NUM_CLASSES];
+    int8_t keypoints[TFLITE_KEYPOINT_OUTPUTS], hidden[KEYPOINT_HIDDEN];
+    int8_t expected[TFLITE_KEYPOINT_OUTPUTS];
+    model_run(m, input, scores, NULL);
+    model_run(m, input, with_head, keypoints);
+    CHECK(memcmp(scores, with_head, sizeof(scores)) == 0,
+          "the keypoint head changes the class scores");
+
+    bench_reference_conv1d(&m->kp_hidden, m->features, 1, true, hidden);
+    bench_reference_conv1d(&m->kp_out, hidden, 1, false, expected);
+    for (int i = 0; i < TFLITE_KEYPOINT_OUTPUTS; i++) {
+        expected[i] = m->sigmoid[(uint8_t)expected[i]];
+    }
+    CHECK(memcmp(keypoints, expected, sizeof(keypoints)) == 0,
+          "keypoint head differs from the reference Dense");
+}
+
+static size_t trunk_weight_bytes(const model_t *m)
+{
+    size_t bytes = 0;
+    for (int i = 0; i < MODEL_NET_LAYERS; i++) {
+        bytes += bench_layer_bytes(&m->net.layers[i]);
+    }
+    return bytes;
+}
+
+static size_t trunk_macs(const model_t *m)
+{
+    size_t macs = 0;
+    for (int i = 0; i < MODEL_NET_LAYERS; i++) {
+        macs += model_layer_macs(&m->net.layers[i], i < MODEL_NET_DENSE1 ? s_steps[i] : 1);
+    }
+    return macs;
+}
+
+/**
+ * @brief Peak activation bytes of a sequential plan (input and output of
+ *        the largest layer live at once)
+ */
+static size_t peak_activation_bytes(int with_head)
+{
+    const size_t input = (size_t)TFLITE_INPUT_SAMPLES * TFLITE_INPUT_FEATURES;
+    size_t peak = input + (size_t)s_steps[0] * 32;
+    // The 64 pooled features stay live while the class branch runs, so the
+    // keypoint head can start from them afterwards
+    if (with_head) {
+        size_t dense_phase = 64 + 64 + 32;
+        peak = peak > dense_phase ? peak : dense_phase;
+    }
+    return peak;
+}
+
+static void check_decoding(void)
+{
+    // Sigmoid output quantization: scale 1/256, zero point -128
+    pose_keypoint_lut_t lut;
+    pose_keypoint_lut_init(&lut, 1.0f / 256.0f, -128);
+
+    CHECK(lut.coord[(uint8_t)-128] == 0 && lut.confidence[(uint8_t)-128] == 0,
+          "q=-128 should decode to 0");
+    for (int q = -127; q <= 127; q++) {
+        if (lut.coord[(uint8_t)q] < lut.coord[(uint8_t)(q - 1)]) {
+            FAIL("coordinate table not monotonic at q=%d", q);
+            break;
+        }
+    }
+    // Worst-case error against float dequantization
+    float max_err = 0.0f;
+    for (int q = -128; q <= 127; q++) {
+        float ref = (q + 128) / 256.0f;
+        max_err = fmaxf(max_err, fabsf(lut.coord[(uint8_t)q] / 65535.0f - ref));
+    }
+    CHECK(max_err <= 1.0f / 65535.0f, "coordinate error %.2e", max_err);
+
+    int8_t head[TFLITE_KEYPOINT_OUTPUTS];
+    for (int i = 0; i < TFLITE_KEYPOINT_OUTPUTS; i++) {
+        head[i] = (int8_t)(bench_random() >> 24);
+    }
+    pose_result_t result;
+    memset(&result, 0, sizeof(result));
+    result.human_detected = true;
+    result.pose_class = POSE_STANDING;
+    result.confidence = 0.8f;
+    result.sequence = 1234;
+    result.timestamp = 987654;
+    result.breathing_rate_bpm = 14.5f;
+    pose_model_decode_keypoints(head, &lut, &result.skeleton);
+
+    uint8_t record[POSE_RECORD_MAX_BYTES];
+    size_t len = pose_record_encode(&result, record, sizeof(record));
+    pose_result_t decoded;
+    size_t consumed = 0;
+    int failures = bench_failures();
+    CHECK(len == POSE_RECORD_MAX_BYTES &&
+          pose_record_decode(record, len, &decoded, &consumed) == ESP_OK && consumed == len &&
+          memcmp(&decoded.skeleton, &result.skeleton, sizeof(result.skeleton)) == 0 &&
+          decoded.sequence == result.sequence && decoded.pose_class == result.pose_class &&
+          fabsf(decoded.breathing_rate_bpm - result.breathing_rate_bpm) <= 0.05f,
+          "binary record does not round-trip");
+    record[20] ^= 0x01;
+    CHECK(pose_record_decode(record, len, &decoded, &consumed) == ESP_ERR_INVALID_CRC,
+          "corrupted record not rejected");
+    printf("Decoding: max coordinate error %.1e, record round-trip %s\n", max_err,
+           bench_failures() == failures ? "exact" : "BROKEN");
+}
+
+int main(int argc, char **argv)
+{
+    int iterations = 2000;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "Usage: %s [--iterations N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (iterations <= 0) {
+        fprintf(stderr, "Iterations must be positive\n");
+        return 2;
+    }
+
+    check_decoding();
+
+    model_t m;
+    model_init(&m);
+    int8_t *input = bench_random_int8((size_t)TFLITE_INPUT_SAMPLES * TFLITE_INPUT_FEATURES);
+    check_head(&m, input);
+    int8_t scores[TFLITE_NUM_CLASSES];
+    int8_t keypoints[TFLITE_KEYPOINT_OUTPUTS];
+
+    // Alternate the two variants so frequency scaling affects both alike
+    double t_class = 0.0, t_head = 0.0;
+    int checksum = 0;
+    for (int i = 0; i < iterations; i++) {
+        double t0 = bench_now_s();
+        model_run(&m, input, scores, NULL);
+        double t1 = bench_now_s();
+        model_run(&m, input, scores, keypoints);
+        double t2 = bench_now_s();
+        t_class += t1 - t0;
+        t_head += t2 - t1;
+        checksum += scores[0] + keypoints[0];
+    }
+    t_class = t_class / iterations * 1e6;
+    t_head = t_head / iterations * 1e6;
+
+    pose_keypoint_lut_t lut;
+    pose_keypoint_lut_init(&lut, 1.0f / 256.0f, -128);
+    pose_result_t result;
+    memset(&result, 0, sizeof(result));
+    uint8_t record[POSE_RECORD_MAX_BYTES];
+    const int decodes = 200000;
+    double t0 = bench_now_s();
+    for (int i = 0; i < decodes; i++) {
+        keypoints[i % TFLITE_KEYPOINT_OUTPUTS] = (int8_t)i;
+        pose_model_decode_keypoints(keypoints, &lut, &result.skeleton);
+        checksum += (int)pose_record_encode(&result, record, sizeof(record));
+    }
+    double decode_ns = (bench_now_s() - t0) / decodes * 1e9;
+
+    size_t head_weights = bench_layer_bytes(&m.kp_hidden) + bench_layer_bytes(&m.kp_out);
+    size_t head_macs = model_layer_macs(&m.kp_hidden, 1) + model_layer_macs(&m.kp_out, 1);
+    size_t class_weights = trunk_weight_bytes(&m);
+    size_t class_macs = trunk_macs(&m);
+    size_t result_without = sizeof(pose_result_t) - sizeof(pose_skeleton_t);
+
+    printf("\n%-28s %14s %14s %10s\n", "", "classification", "+ keypoints", "added");
+    printf("%-28s %14zu %14zu %9.1f%%\n", "MACs per window", class_macs,
+           class_macs + head_macs, 100.0 * head_macs / class_macs);
+    printf("%-28s %14zu %14zu %9.1f%%\n", "weight bytes (int8 + bias)", class_weights,
+           class_weights + head_weights, 100.0 * head_weights / class_weights);
+    printf("%-28s %14zu %14zu %10s\n", "peak activation bytes", peak_activation_bytes(0),
+           peak_activation_bytes(1), "");
+    printf("%-28s %14.1f %14.1f %9.1f%%\n", "latency (us, host)", t_class, t_head,
+           100.0 * (t_head - t_class) / t_class);
+    printf("%-28s %14zu %14zu %10s\n", "pose_result_t bytes", result_without,
+           sizeof(pose_result_t), "");
+    printf("%-28s %14zu %14zu %10s\n", "result ring bytes",
+           (size_t)RESULT_RING_CAPACITY * (4 + (result_without + 3) / 4 * 4) + 4, sizeof(result_ring_t), "");
+    printf("%-28s %14d %14d %10s\n", "binary record bytes",
+           POSE_RECORD_HEADER_BYTES + POSE_RECORD_POSE_BYTES + POSE_RECORD_CRC_BYTES,
+           POSE_RECORD_MAX_BYTES, "");
+    printf("\nKeypoint decode tables: %zu bytes; decode + encode: %.0f ns per window\n",
+           sizeof(pose_keypoint_lut_t), decode_ns);
+    if (checksum == 0x7fffffff) {
+        printf("%d\n", checksum);
+    }
+
+    free(input);
+    model_free(&m);
+    printf("\n%s\n", bench_failures() == 0 ? "PASS" : "FAILED");
+    return bench_failures() == 0 ? 0 : 1;
+}
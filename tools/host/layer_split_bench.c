@@ -0,0 +1,368 @@
+/**
+ * @file layer_split_bench.c
+ * @brief Model layers split by output channel across two threads
+ *
+ * Runs model_layers.c, compiled unchanged from firmware/main, with a
+ * pthread backend built like model_dual_core.c: a worker thread woken for
+ * the upper half of a layer's output channels. After computing the lower
+ * half the caller spins briefly, then takes the half back if the worker
+ * has not started, or blocks until it is done.
+ *
+ * Checks that:
+ *
+ *   - model_conv1d_s8() matches a plain reference Conv1D (every tap
+ *     bounds-checked) on the reference model's layers and on odd shapes
+ *   - the split output is bit-identical to one thread for every layer,
+ *     also when a stalled worker's halves are all taken back
+ *   - layers under min_macs never reach the worker
+ *   - model_requantize() is exact at both ends of the shift range, and
+ *     model_layer_valid() rejects shifts outside it
+ *
+ * Then times each Conv1D/Dense layer of LightweightPoseModel
+ * (train_pose_model.py) on one thread and split across two, and the whole
+ * layer stack with the split threshold applied. Exits non-zero if a check
+ * fails.
+ *
+ * Usage:
+ *   layer_split_bench [--iterations 2000] [--min-macs 4096]
+ */
+
+#include "bench_util.h"
+#include "model_layers.h"
+#include "tflite_classifier.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* ---- pthread backend, like model_dual_core.c ---- */
+
+// Same protocol as model_dual_core.c: whoever moves a range out of POSTED runs it
+enum { JOB_IDLE, JOB_POSTED, JOB_CLAIMED, JOB_DONE, JOB_CANCELLED };
+
+#define WAIT_SPIN_S 50e-6
+
+typedef struct {
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t wake;
+    pthread_cond_t finished;
+    bool pending;                      // A range is waiting for the worker
+    bool stalled;                      // Worker held off, like a busy core
+    bool quit;
+    model_range_fn_t fn;
+    void *arg;
+    int ch_begin, ch_end;
+    atomic_int state;
+    int started;                       // Ranges handed over
+    int taken_back;                    // Ranges the caller ran after the spin
+} worker_t;
+
+static void *worker_main(void *ctx)
+{
+    worker_t *w = ctx;
+    pthread_mutex_lock(&w->mutex);
+    while (1) {
+        while ((!w->pending || w->stalled) && !w->quit) {
+            pthread_cond_wait(&w->wake, &w->mutex);
+        }
+        if (w->quit) {
+            break;
+        }
+        w->pending = false;
+        pthread_mutex_unlock(&w->mutex);
+        int expected = JOB_POSTED;
+        if (atomic_compare_exchange_strong_explicit(&w->state, &expected, JOB_CLAIMED,
+                                                    memory_order_acquire,
+                                                    memory_order_relaxed)) {
+            w->fn(w->arg, w->ch_begin, w->ch_end);
+            atomic_store_explicit(&w->state, JOB_DONE, memory_order_release);
+            pthread_mutex_lock(&w->mutex);
+            pthread_cond_signal(&w->finished);
+            pthread_mutex_unlock(&w->mutex);
+        }
+        pthread_mutex_lock(&w->mutex);
+    }
+    pthread_mutex_unlock(&w->mutex);
+    return NULL;
+}
+
+static bool worker_start(void *ctx, model_range_fn_t fn, void *arg, int ch_begin, int ch_end)
+{
+    worker_t *w = ctx;
+    pthread_mutex_lock(&w->mutex);
+    w->fn = fn;
+    w->arg = arg;
+    w->ch_begin = ch_begin;
+    w->ch_end = ch_end;
+    atomic_store_explicit(&w->state, JOB_POSTED, memory_order_release);
+    w->pending = true;
+    w->started++;
+    pthread_cond_signal(&w->wake);
+    pthread_mutex_unlock(&w->mutex);
+    return true;
+}
+
+static void worker_wait(void *ctx)
+{
+    worker_t *w = ctx;
+    double spin_end = bench_now_s() + WAIT_SPIN_S;
+    while (atomic_load_explicit(&w->state, memory_order_acquire) != JOB_DONE &&
+           bench_now_s() < spin_end) {
+        // One CPU: let the worker run instead of spinning out the time slice
+        if (sysconf(_SC_NPROCESSORS_ONLN) < 2) {
+            sched_yield();
+        }
+    }
+    int expected = JOB_POSTED;
+    if (atomic_compare_exchange_strong_explicit(&w->state, &expected, JOB_CANCELLED,
+                                                memory_order_acquire, memory_order_relaxed)) {
+        w->fn(w->arg, w->ch_begin, w->ch_end);
+        w->taken_back++;
+        return;
+    }
+    pthread_mutex_lock(&w->mutex);
+    while (atomic_load_explicit(&w->state, memory_order_acquire) != JOB_DONE) {
+        pthread_cond_wait(&w->finished, &w->mutex);
+    }
+    pthread_mutex_unlock(&w->mutex);
+}
+
+static void worker_stall(worker_t *w, bool stalled)
+{
+    pthread_mutex_lock(&w->mutex);
+    w->stalled = stalled;
+    pthread_cond_signal(&w->wake);
+    pthread_mutex_unlock(&w->mutex);
+}
+
+static void worker_init(worker_t *w)
+{
+    memset(w, 0, sizeof(*w));
+    pthread_mutex_init(&w->mutex, NULL);
+    pthread_cond_init(&w->wake, NULL);
+    pthread_cond_init(&w->finished, NULL);
+    atomic_init(&w->state, JOB_IDLE);
+    pthread_create(&w->thread, NULL, worker_main, w);
+}
+
+static void worker_stop(worker_t *w)
+{
+    pthread_mutex_lock(&w->mutex);
+    w->quit = true;
+    pthread_cond_signal(&w->wake);
+    pthread_mutex_unlock(&w->mutex);
+    pthread_join(w->thread, NULL);
+    pthread_mutex_destroy(&w->mutex);
+    pthread_cond_destroy(&w->wake);
+    pthread_cond_destroy(&w->finished);
+}
+
+/* ---- Layers ---- */
+
+typedef struct {
+    const char *name;
+    int in_ch, out_ch, kernel, steps;
+} shape_t;
+
+// Conv1D/Dense layers of LightweightPoseModel and the steps they run over
+static const shape_t s_model[] = {
+    { "conv1", TFLITE_INPUT_FEATURES, 32, 5, TFLITE_INPUT_SAMPLES },
+    { "conv2", 32, 64, 5, TFLITE_INPUT_SAMPLES / 2 },
+    { "conv3", 64, 64, 3, TFLITE_INPUT_SAMPLES / 4 },
+    { "dense1", 64, 64, 1, 1 },
+    { "dense2", 64, 32, 1, 1 },
+    { "classes", 32, TFLITE_NUM_CLASSES, 1, 1 },
+};
+#define NUM_MODEL_LAYERS (int)(sizeof(s_model) / sizeof(s_model[0]))
+
+// Shapes that exercise the edges: odd channel counts, fewer steps than taps
+static const shape_t s_odd[] = {
+    { "1 out", 7, 1, 3, 9 },
+    { "3 out", 5, 3, 5, 4 },
+    { "51 out", 64, 51, 1, 1 },
+    { "k7 s3", 16, 33, 7, 3 },
+    { "k4 s6", 8, 40, 4, 6 },
+};
+
+static void check_shape(const shape_t *s, const model_split_t *split)
+{
+    model_layer_t l = bench_make_layer(s->in_ch, s->out_ch, s->kernel);
+    int8_t *in = bench_random_int8((size_t)s->steps * s->in_ch);
+    size_t out_bytes = (size_t)s->steps * s->out_ch;
+    int8_t *ref = malloc(out_bytes);
+    int8_t *one = malloc(out_bytes);
+    int8_t *two = malloc(out_bytes);
+
+    for (int relu = 0; relu <= 1; relu++) {
+        bench_reference_conv1d(&l, in, s->steps, relu, ref);
+        model_conv1d_split(NULL, &l, in, s->steps, relu, one);
+        model_conv1d_split(split, &l, in, s->steps, relu, two);
+        CHECK(memcmp(ref, one, out_bytes) == 0, "%s: model_conv1d_s8 differs from the reference",
+              s->name);
+        CHECK(memcmp(one, two, out_bytes) == 0, "%s: split output differs from one thread",
+              s->name);
+    }
+    bench_free_layer(&l);
+    free(in);
+    free(ref);
+    free(one);
+    free(two);
+}
+
+/**
+ * @brief model_requantize() at the ends of the shift range, against exact arithmetic
+ */
+static void check_requantize(void)
+{
+    static const struct {
+        int32_t acc, multiplier;
+        int shift;
+        int8_t expected;
+    } cases[] = {
+        { 100, 1, 0, 100 },                        // No shift, no rounding term
+        { -3, 1, 0, -3 },
+        { 5, 1, 1, 3 },                            // 2.5 rounds up
+        { -5, 1, 1, -2 },                          // -2.5 rounds up
+        { 3, 1, -4, 48 },                          // Left shift
+        { -3, 1, -4, -48 },
+        { INT32_MAX, INT32_MAX, MODEL_SHIFT_MIN, 127 },
+        { INT32_MIN, INT32_MAX, MODEL_SHIFT_MIN, -128 },
+        { INT32_MIN, INT32_MIN, MODEL_SHIFT_MAX, 1 },  // 2^62 >> 62
+        { INT32_MAX, 100, MODEL_SHIFT_MAX, 0 },
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        int8_t got = model_requantize(cases[i].acc, cases[i].multiplier, cases[i].shift, false);
+        CHECK(got == cases[i].expected, "requantize(%ld, %ld, %d) = %d, expected %d",
+              (long)cases[i].acc, (long)cases[i].multiplier, cases[i].shift, got,
+              cases[i].expected);
+    }
+    model_layer_t l = bench_make_layer(4, 4, 1);
+    l.shift = MODEL_SHIFT_MAX + 1;
+    bool over = model_layer_valid(&l);
+    l.shift = MODEL_SHIFT_MIN - 1;
+    CHECK(!over && !model_layer_valid(&l), "a layer with its shift out of range is accepted");
+    bench_free_layer(&l);
+}
+
+/**
+ * @brief Nanoseconds per layer call, one thread (split NULL) or split
+ */
+static double time_layer(const model_split_t *split, const model_layer_t *l, const int8_t *in,
+                         int steps, int8_t *out, int iterations)
+{
+    double t0 = bench_now_s();
+    for (int i = 0; i < iterations; i++) {
+        model_conv1d_split(split, l, in, steps, true, out);
+    }
+    return (bench_now_s() - t0) * 1e9 / iterations;
+}
+
+int main(int argc, char **argv)
+{
+    int iterations = 2000;
+    uint32_t min_macs = 4096;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--min-macs") == 0 && i + 1 < argc) {
+            min_macs = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else {
+            fprintf(stderr, "Usage: %s [--iterations N] [--min-macs N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (iterations <= 0) {
+        fprintf(stderr, "Iterations must be positive\n");
+        return 2;
+    }
+
+    worker_t worker;
+    worker_init(&worker);
+    model_split_t forced = { worker_start, worker_wait, &worker, 0 };
+    model_split_t threshold = forced;
+    threshold.min_macs = min_macs;
+
+    // Equivalence
+    check_requantize();
+    for (int i = 0; i < NUM_MODEL_LAYERS; i++) {
+        check_shape(&s_model[i], &forced);
+    }
+    for (size_t i = 0; i < sizeof(s_odd) / sizeof(s_odd[0]); i++) {
+        check_shape(&s_odd[i], &forced);
+    }
+
+    // A worker that never gets the CPU: every half is taken back, same output
+    worker_stall(&worker, true);
+    int taken_back = worker.taken_back;
+    for (int i = 0; i < NUM_MODEL_LAYERS; i++) {
+        check_shape(&s_model[i], &forced);
+    }
+    CHECK(worker.taken_back != taken_back, "a stalled worker's ranges were not taken back");
+    worker_stall(&worker, false);
+
+    // Small layers stay on the calling thread
+    model_layer_t small = bench_make_layer(8, 8, 1);
+    int8_t small_in[8] = { 0 }, small_out[8];
+    int started = worker.started;
+    model_split_t never = forced;
+    never.min_macs = model_layer_macs(&small, 1) + 1;
+    model_dense_split(&never, &small, small_in, true, small_out);
+    CHECK(worker.started == started, "a layer under min_macs was split");
+    bench_free_layer(&small);
+
+    // Cost per layer
+    model_layer_t layers[NUM_MODEL_LAYERS];
+    const size_t act_bytes = (size_t)TFLITE_INPUT_SAMPLES * TFLITE_INPUT_FEATURES;
+    int8_t *in = bench_random_int8(act_bytes);
+    int8_t *out = malloc(act_bytes);
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    printf("%ld CPU%s online, split threshold %lu MACs\n", cpus, cpus == 1 ? "" : "s",
+           (unsigned long)min_macs);
+    worker.started = worker.taken_back = 0;
+    printf("  %-8s %8s %10s %10s %8s %6s\n", "layer", "MACs", "1 thr ns", "2 thr ns", "speedup",
+           "split");
+    double total_one = 0.0, total_two = 0.0;
+    for (int i = 0; i < NUM_MODEL_LAYERS; i++) {
+        const shape_t *s = &s_model[i];
+        layers[i] = bench_make_layer(s->in_ch, s->out_ch, s->kernel);
+        uint32_t macs = model_layer_macs(&layers[i], s->steps);
+        double one = time_layer(NULL, &layers[i], in, s->steps, out, iterations);
+        double two = time_layer(&forced, &layers[i], in, s->steps, out, iterations);
+        printf("  %-8s %8lu %10.0f %10.0f %7.2fx %6s\n", s->name, (unsigned long)macs, one, two,
+               one / two, macs >= min_macs ? "yes" : "no");
+    }
+
+    // The whole stack, each layer split or not by the threshold
+    double t0 = bench_now_s();
+    for (int it = 0; it < iterations; it++) {
+        for (int i = 0; i < NUM_MODEL_LAYERS; i++) {
+            model_conv1d_split(NULL, &layers[i], in, s_model[i].steps, true, out);
+        }
+    }
+    total_one = (bench_now_s() - t0) * 1e9 / iterations;
+    t0 = bench_now_s();
+    for (int it = 0; it < iterations; it++) {
+        for (int i = 0; i < NUM_MODEL_LAYERS; i++) {
+            model_conv1d_split(&threshold, &layers[i], in, s_model[i].steps, true, out);
+        }
+    }
+    total_two = (bench_now_s() - t0) * 1e9 / iterations;
+    printf("  %-8s %8s %10.0f %10.0f %7.2fx\n", "all", "", total_one, total_two,
+           total_one / total_two);
+    printf("  %d of %d halves taken back by the caller after the spin\n", worker.taken_back,
+           worker.started);
+
+    for (int i = 0; i < NUM_MODEL_LAYERS; i++) {
+        bench_free_layer(&layers[i]);
+    }
+    free(in);
+    free(out);
+    worker_stop(&worker);
+
+    printf("\n%s\n", bench_failures() == 0 ? "PASS" : "FAILED");
+    return bench_failures() == 0 ? 0 : 1;
+}
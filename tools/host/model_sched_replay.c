@@ -0,0 +1,335 @@
+/**
+ * @file model_sched_replay.c
+ * @brief Multi-rate model scheduler (model_sched.h) over a synthetic CSI stream
+ *
+ * Replays a stream of empty and occupied stretches into a window ring
+ * the way buffer_sample() does, and ticks the scheduler compiled
+ * unchanged from firmware/main with the models pose_init() registers:
+ *
+ *   pose       csi_window_stats + detector   once per window, phase 0
+ *   presence   csi_window_stats + detector   every hop, phase picked
+ *   features   newest sample mean            every --aux-period samples, phase picked
+ *
+ * With the defaults the third task's period is coprime with the others,
+ * so it cannot avoid them. Checks that:
+ *
+ *   - each task runs exactly on the samples with n % period == phase
+ *     (n >= window) and its interval is period / sample rate
+ *   - the picked phases collide least with the tasks registered before,
+ *     and pose and presence never share a sample if the hop divides the
+ *     window
+ *   - the collisions counted match a brute-force count and the rate
+ *     model_sched_collision_rate() predicts
+ *   - statistics of the ring as it stands match those of the same window
+ *     in order
+ *   - presence reports a person entering sooner than pose, on average
+ *
+ * Prints the cadence, latency and CPU share of each model, and each
+ * failed check; exits non-zero if there is any.
+ *
+ * Usage:
+ *   model_sched_replay [--samples 20000] [--hop-ms 100] [--aux-period 7]
+ */
+
+#include "bench_util.h"
+#include "csi_window_kernels.h"
+#include "model_sched.h"
+#include "pose_dims.h"
+#include "pose_pipeline.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define WINDOW POSE_WINDOW_SAMPLES
+#define SUBCARRIERS POSE_NUM_SUBCARRIERS
+#define RATE_HZ POSE_SAMPLE_RATE_HZ
+#define STATS_TOLERANCE 1e-4f
+
+static int64_t now_us(void)
+{
+    return (int64_t)(bench_now_s() * 1e6);
+}
+
+/**
+ * @brief Window ring and the bookkeeping of the models reading it
+ */
+typedef struct {
+    float amplitude[WINDOW * SUBCARRIERS];
+    float phase[WINDOW * SUBCARRIERS];
+    int8_t rssi[WINDOW];
+    int index;                 // Oldest row
+    uint64_t sample;           // Samples buffered
+    pose_tuning_t tuning;
+
+    // Last onset of an occupied stretch, and whether each model has seen it
+    uint64_t onset;
+    bool onset_seen[2];
+    bool detected[2];
+    uint64_t latency_sum[2];
+    uint32_t latency_count[2];
+
+    float stats_error;         // Worst relative error, ring versus ordered window
+    bool rssi_mismatch;
+    float feature;             // Keeps the features task from being optimized out
+} replay_t;
+
+enum { MODEL_POSE = 0, MODEL_PRESENCE = 1 };
+
+static float relative_error(float a, float b)
+{
+    float scale = fmaxf(fabsf(a), fabsf(b));
+    return scale > 0.0f ? fabsf(a - b) / scale : 0.0f;
+}
+
+/**
+ * @brief Record a detection, and its latency if it follows an onset
+ */
+static void detect(replay_t *r, int model, const csi_window_stats_t *stats)
+{
+    pose_result_t result = {0};
+    pose_detect_presence_tuned(stats, &r->tuning, &result);
+    if (result.human_detected && !r->detected[model] && !r->onset_seen[model] && r->onset > 0) {
+        r->latency_sum[model] += r->sample - r->onset;
+        r->latency_count[model]++;
+        r->onset_seen[model] = true;
+    }
+    r->detected[model] = result.human_detected;
+}
+
+static void pose_model(void *ctx)
+{
+    replay_t *r = ctx;
+    csi_window_stats_t stats;
+    csi_window_stats_dims_f32(r->amplitude, r->phase, r->rssi, &stats);
+    detect(r, MODEL_POSE, &stats);
+}
+
+static void presence_model(void *ctx)
+{
+    replay_t *r = ctx;
+    csi_window_stats_t stats;
+    csi_window_stats_dims_f32(r->amplitude, r->phase, r->rssi, &stats);
+    detect(r, MODEL_PRESENCE, &stats);
+
+    // The same window in order, oldest row first
+    static float amplitude[WINDOW * SUBCARRIERS];
+    static float phase[WINDOW * SUBCARRIERS];
+    static int8_t rssi[WINDOW];
+    int head = WINDOW - r->index;
+    memcpy(amplitude, &r->amplitude[r->index * SUBCARRIERS], head * SUBCARRIERS * sizeof(float));
+    memcpy(&amplitude[head * SUBCARRIERS], r->amplitude, r->index * SUBCARRIERS * sizeof(float));
+    memcpy(phase, &r->phase[r->index * SUBCARRIERS], head * SUBCARRIERS * sizeof(float));
+    memcpy(&phase[head * SUBCARRIERS], r->phase, r->index * SUBCARRIERS * sizeof(float));
+    memcpy(rssi, &r->rssi[r->index], head);
+    memcpy(&rssi[head], r->rssi, r->index);
+    csi_window_stats_t ordered;
+    csi_window_stats_dims_f32(amplitude, phase, rssi, &ordered);
+
+    float error = fmaxf(relative_error(stats.amplitude_mean, ordered.amplitude_mean),
+                        fmaxf(relative_error(stats.amplitude_std, ordered.amplitude_std),
+                              relative_error(stats.phase_variance, ordered.phase_variance)));
+    r->stats_error = fmaxf(r->stats_error, error);
+    r->rssi_mismatch |= stats.rssi_mean != ordered.rssi_mean;
+}
+
+static void features_model(void *ctx)
+{
+    replay_t *r = ctx;
+    int newest = (r->index + WINDOW - 1) % WINDOW;
+    float sum = 0.0f;
+    for (int k = 0; k < SUBCARRIERS; k++) {
+        sum += r->amplitude[newest * SUBCARRIERS + k];
+    }
+    r->feature += sum / SUBCARRIERS;
+}
+
+/**
+ * @brief Buffer one sample of the stream, as buffer_sample() does
+ */
+static void push_sample(replay_t *r, bool occupied)
+{
+    int row = r->index * SUBCARRIERS;
+    float t = (float)r->sample / RATE_HZ;
+    for (int k = 0; k < SUBCARRIERS; k++) {
+        float noise = bench_uniform() - 0.5f;
+        float body = occupied ? 6.0f * sinf(2.0f * (float)M_PI * 0.7f * t + 0.3f * k) : 0.0f;
+        r->amplitude[row + k] = 20.0f + body + noise;
+        r->phase[row + k] = (occupied ? 0.8f : 0.1f) * (bench_uniform() - 0.5f);
+    }
+    r->rssi[r->index] = (int8_t)(-50 - (int)(bench_uniform() * 8.0f));
+    r->index = (r->index + 1) % WINDOW;
+    r->sample++;
+}
+
+/**
+ * @brief Collision rate of `phase` for a new task against the registered ones
+ */
+static float phase_rate(const model_sched_t *sched, int count, uint32_t period, uint32_t phase)
+{
+    model_sched_t trial = *sched;
+    trial.count = count;
+    trial.tasks[count].period = period;
+    trial.tasks[count].phase = phase;
+    trial.count++;
+    model_sched_t before = *sched;
+    before.count = count;
+    return model_sched_collision_rate(&trial) - model_sched_collision_rate(&before);
+}
+
+static uint32_t parse_arg(int argc, char **argv, const char *name, uint32_t fallback)
+{
+    for (int i = 1; i + 1 < argc; i++) {
+        if (strcmp(argv[i], name) == 0) {
+            return (uint32_t)strtoul(argv[i + 1], NULL, 10);
+        }
+    }
+    return fallback;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t samples = parse_arg(argc, argv, "--samples", 20000);
+    uint32_t hop_ms = parse_arg(argc, argv, "--hop-ms", 100);
+    uint32_t aux_period = parse_arg(argc, argv, "--aux-period", 7);
+    uint32_t hop = hop_ms * RATE_HZ / 1000;
+    if (hop == 0 || hop >= WINDOW || aux_period == 0 || samples < 2 * WINDOW) {
+        fprintf(stderr, "Hop must be 1..%d samples, the aux period > 0, samples >= %d\n",
+                WINDOW - 1, 2 * WINDOW);
+        return 2;
+    }
+
+    static replay_t replay;
+    replay.tuning = (pose_tuning_t){
+        .empty_amp_std = POSE_DEFAULT_EMPTY_AMP_STD,
+        .moving_phase_var = POSE_DEFAULT_MOVING_PHASE_VAR,
+        .moving_level = POSE_DEFAULT_MOVING_LEVEL,
+    };
+
+    // Registered as pose_init() does, plus the coprime task
+    model_sched_t sched;
+    model_sched_init(&sched, WINDOW, now_us);
+    int pose = model_sched_add(&sched, "pose", WINDOW, 0, pose_model, &replay);
+    int presence = model_sched_add(&sched, "presence", hop, MODEL_SCHED_AUTO_PHASE,
+                                   presence_model, &replay);
+    int features = model_sched_add(&sched, "features", aux_period, MODEL_SCHED_AUTO_PHASE,
+                                   features_model, &replay);
+    CHECK(pose == 0 && presence == 1 && features == 2, "registration failed");
+    CHECK(model_sched_add(&sched, "bad", WINDOW, WINDOW, pose_model, NULL) < 0,
+          "a phase of a whole period was accepted");
+    CHECK(model_sched_add(&sched, "bad", 0, 0, pose_model, NULL) < 0, "a period of 0 was accepted");
+    if (bench_failures() > 0) {
+        return 1;
+    }
+
+    // Each picked phase collides least with the tasks before it
+    for (int i = 1; i < sched.count; i++) {
+        const model_sched_task_t *t = &sched.tasks[i];
+        float picked = phase_rate(&sched, i, t->period, t->phase);
+        for (uint32_t p = 0; p < t->period; p++) {
+            CHECK(picked <= phase_rate(&sched, i, t->period, p) + 1e-9f,
+                  "%s: phase %u collides more than phase %u", t->name, t->phase, p);
+        }
+    }
+    if (WINDOW % hop == 0) {
+        model_sched_t pair = sched;
+        pair.count = 2;
+        CHECK(model_sched_collision_rate(&pair) == 0.0f,
+              "presence (phase %u) shares samples with pose", sched.tasks[presence].phase);
+    }
+
+    // Stream: empty and occupied stretches of 2-6 windows
+    uint32_t expected_runs[MODEL_SCHED_MAX_TASKS] = {0};
+    uint32_t expected_collisions = 0, pose_presence_collisions = 0;
+    bool occupied = false;
+    uint32_t stretch_end = 0;
+    uint32_t first_wrong = 0;
+    for (uint32_t n = 1; n <= samples; n++) {
+        if (n > stretch_end) {
+            occupied = !occupied;
+            stretch_end = n + (2 + (uint32_t)(bench_uniform() * 5.0f)) * WINDOW;
+            if (occupied) {
+                replay.onset = n;
+                replay.onset_seen[MODEL_POSE] = replay.onset_seen[MODEL_PRESENCE] = false;
+            }
+        }
+        push_sample(&replay, occupied);
+
+        int due = 0;
+        for (int i = 0; i < sched.count; i++) {
+            bool run = n >= WINDOW && n % sched.tasks[i].period == sched.tasks[i].phase;
+            expected_runs[i] += run ? 1 : 0;
+            due += run ? 1 : 0;
+        }
+        expected_collisions += due > 1 ? 1 : 0;
+        pose_presence_collisions += n >= WINDOW && n % WINDOW == 0 &&
+                                    n % hop == sched.tasks[presence].phase;
+
+        if (model_sched_tick(&sched) != due && first_wrong == 0) {
+            first_wrong = n;
+        }
+    }
+    CHECK(first_wrong == 0, "sample %u: the tasks run are not the ones due", first_wrong);
+
+    printf("Window %d samples x %d subcarriers at %d Hz, %u samples, hop %u samples\n\n",
+           WINDOW, SUBCARRIERS, RATE_HZ, samples, hop);
+    printf("%-10s %7s %6s %7s %12s %9s %9s %7s\n", "model", "period", "phase", "runs",
+           "interval_ms", "avg_us", "max_us", "cpu_%");
+    float cpu_total = 0.0f;
+    for (int i = 0; i < sched.count; i++) {
+        model_sched_stats_t stats;
+        model_sched_get_stats(&sched, i, RATE_HZ, &stats);
+        printf("%-10s %7u %6u %7u %12.1f %9.1f %9u %7.3f\n", stats.name, stats.period,
+               stats.phase, stats.runs, stats.interval_ms, stats.avg_us, stats.max_us,
+               stats.cpu_share * 100.0f);
+        cpu_total += stats.cpu_share;
+
+        float interval_ms = stats.period * 1000.0f / RATE_HZ;
+        CHECK(stats.runs == expected_runs[i], "%s: %u runs, expected %u", stats.name,
+              stats.runs, expected_runs[i]);
+        CHECK(stats.runs < 2 || fabsf(stats.interval_ms - interval_ms) <= 1e-3f * interval_ms,
+              "%s: interval %.2fms, expected %.2fms", stats.name, stats.interval_ms, interval_ms);
+        CHECK(stats.cpu_share >= 0.0f && stats.cpu_share < 1.0f, "%s: CPU share %.3f",
+              stats.name, stats.cpu_share);
+    }
+
+    float predicted = model_sched_collision_rate(&sched) * (samples - WINDOW + 1);
+    printf("\nCollisions: %u of %u samples (predicted %.1f), pose with presence: %u\n",
+           sched.collisions, samples - WINDOW + 1, predicted, pose_presence_collisions);
+    CHECK(sched.collisions == expected_collisions, "%u collisions counted, %u by brute force",
+          sched.collisions, expected_collisions);
+    CHECK(fabsf((float)sched.collisions - predicted) <= (float)(sched.count * sched.count),
+          "%u collisions, %.1f predicted", sched.collisions, predicted);
+    CHECK(WINDOW % hop != 0 || pose_presence_collisions == 0,
+          "pose and presence met on %u samples", pose_presence_collisions);
+
+    printf("Ring versus ordered window: worst relative error %.2g%s\n", replay.stats_error,
+           replay.rssi_mismatch ? ", RSSI mean differs" : "");
+    CHECK(replay.stats_error <= STATS_TOLERANCE, "ring statistics off by %.2g",
+          replay.stats_error);
+    CHECK(!replay.rssi_mismatch, "ring RSSI mean differs from the ordered window");
+
+    float latency_ms[2];
+    for (int m = 0; m < 2; m++) {
+        latency_ms[m] = replay.latency_count[m] > 0
+                        ? (float)replay.latency_sum[m] / replay.latency_count[m] * 1000.0f / RATE_HZ
+                        : 0.0f;
+    }
+    printf("Detection after a person enters: presence %.0fms (%u), pose %.0fms (%u)\n",
+           latency_ms[MODEL_PRESENCE], replay.latency_count[MODEL_PRESENCE],
+           latency_ms[MODEL_POSE], replay.latency_count[MODEL_POSE]);
+    CHECK(replay.latency_count[MODEL_PRESENCE] > 0 && replay.latency_count[MODEL_POSE] > 0,
+          "no entry detected");
+    CHECK(latency_ms[MODEL_PRESENCE] < latency_ms[MODEL_POSE],
+          "presence (%.0fms) is no faster than pose (%.0fms)", latency_ms[MODEL_PRESENCE],
+          latency_ms[MODEL_POSE]);
+    printf("Models' CPU share: %.3f%% (feature sum %.1f)\n", cpu_total * 100.0f, replay.feature);
+
+    if (bench_failures() > 0) {
+        printf("\nFAILED: %d of %d checks\n", bench_failures(), bench_checks());
+        return 1;
+    }
+    printf("\nPASS: %d checks\n", bench_checks());
+    return 0;
+}
@@ -0,0 +1,81 @@
+/**
+ * @file npy_writer.cpp
+ * @brief Append-only writer for NumPy .npy files (format version 1.0)
+ */
+
+#include "npy_writer.hpp"
+
+namespace csi {
+
+// Header is padded to this size so it can be rewritten in place on close()
+static constexpr size_t kHeaderSize = 128;
+
+NpyWriter::NpyWriter(const std::string &path, const std::string &dtype,
+                     const std::vector<size_t> &row_shape)
+    : file_(std::fopen(path.c_str(), "wb")), dtype_(dtype), row_shape_(row_shape)
+{
+    size_t item = static_cast<size_t>(std::stoul(dtype_.substr(2)));
+    row_bytes_ = item;
+    for (size_t d : row_shape_) {
+        row_bytes_ *= d;
+    }
+    if (file_ != nullptr) {
+        std::string h = header(0);
+        std::fwrite(h.data(), 1, h.size(), file_);
+    }
+}
+
+NpyWriter::~NpyWriter()
+{
+    close();
+}
+
+std::string NpyWriter::header(size_t rows) const
+{
+    std::string shape = "(" + std::to_string(rows) + ",";
+    for (size_t i = 0; i < row_shape_.size(); i++) {
+        shape += (i ? ", " : " ") + std::to_string(row_shape_[i]);
+    }
+    shape += ")";
+
+    std::string dict = "{'descr': '" + dtype_ + "', 'fortran_order': False, 'shape': " + shape + ", }";
+    std::string h = "\x93NUMPY";
+    h.push_back('\x01');
+    h.push_back('\x00');
+    size_t body = kHeaderSize - 10;
+    dict.resize(body - 1, ' ');
+    dict.push_back('\n');
+    h.push_back(static_cast<char>(body & 0xff));
+    h.push_back(static_cast<char>(body >> 8));
+    return h + dict;
+}
+
+bool NpyWriter::append(const void *data, size_t num_rows)
+{
+    if (file_ == nullptr) {
+        return false;
+    }
+    if (num_rows == 0) {
+        return true;
+    }
+    if (std::fwrite(data, row_bytes_, num_rows, file_) != num_rows) {
+        return false;
+    }
+    rows_ += num_rows;
+    return true;
+}
+
+bool NpyWriter::close()
+{
+    if (file_ == nullptr) {
+        return true;
+    }
+    std::string h = header(rows_);
+    bool ok = std::fseek(file_, 0, SEEK_SET) == 0 &&
+              std::fwrite(h.data(), 1, h.size(), file_) == h.size();
+    ok = (std::fclose(file_) == 0) && ok;
+    file_ = nullptr;
+    return ok;
+}
+
+}  // namespace csi
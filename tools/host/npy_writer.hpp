@@ -0,0 +1,55 @@
+/**
+ * @file npy_writer.hpp
+ * @brief Append-only writer for NumPy .npy files
+ *
+ * Rows are streamed to disk as they are produced; the leading dimension is
+ * patched into the header on close(), so the total number of rows does not
+ * have to be known (or held in memory) up front. Files load with np.load()
+ * and support mmap_mode='r' for datasets larger than RAM.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace csi {
+
+class NpyWriter {
+public:
+    /**
+     * @param path       Output file
+     * @param dtype      NumPy dtype descriptor, e.g. "<f4" or "<i4"
+     * @param row_shape  Shape of one row (trailing dimensions)
+     */
+    NpyWriter(const std::string &path, const std::string &dtype,
+              const std::vector<size_t> &row_shape);
+    ~NpyWriter();
+
+    NpyWriter(const NpyWriter &) = delete;
+    NpyWriter &operator=(const NpyWriter &) = delete;
+
+    bool is_open() const { return file_ != nullptr; }
+
+    /** Append num_rows rows of raw data (num_rows * row_bytes bytes) */
+    bool append(const void *data, size_t num_rows);
+
+    /** Finalize the header with the row count and close the file */
+    bool close();
+
+    size_t rows() const { return rows_; }
+    size_t row_bytes() const { return row_bytes_; }
+
+private:
+    std::string header(size_t rows) const;
+
+    std::FILE *file_ = nullptr;
+    std::string dtype_;
+    std::vector<size_t> row_shape_;
+    size_t row_bytes_ = 0;
+    size_t rows_ = 0;
+};
+
+}  // namespace csi
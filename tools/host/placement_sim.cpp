@@ -0,0 +1,387 @@
+/**
+ * @file placement_sim.cpp
+ * @brief Host simulation of temporal buffer placement on the ESP32-S3
+ *
+ * The host has no PSRAM, so instead of timing the kernels this replays the
+ * memory accesses one window of the pose pipeline makes and runs them
+ * through a model of the ESP32-S3 data cache in front of Quad SPI PSRAM:
+ *
+ *   fill   pose_process_csi() writing the window sample by sample
+ *   stats  csi_window_stats(): amplitude mean/std passes, strided phase
+ *          mean/std per subcarrier, RSSI sum
+ *   spill  csi_history_push() of amplitude and phase to the history ring
+ *
+ * Internal SRAM costs one cycle per access. PSRAM goes through a
+ * set-associative write-back LRU cache; a miss costs one line fill over SPI
+ * and evicting a dirty line costs one line write. By default the cache is
+ * emptied between samples (--warm disables this): samples arrive 10ms
+ * apart, and WiFi, lwIP and logging traffic in between leaves little of the
+ * window cached. Stats and spill run back to back and share the cache.
+ *
+ * The placements match placement_bench.c on the device, so the two can be
+ * compared directly:
+ *
+ *   internal  window and history in SRAM
+ *   psram     window and history in PSRAM (CONFIG_POSE_PLACEMENT_ALL_PSRAM)
+ *   hot/cold  window in SRAM, history in PSRAM (CONFIG_POSE_PLACEMENT_HOT_COLD)
+ *
+ * Usage:
+ *   placement_sim [--cache-kb 32] [--ways 8] [--line 32] [--windows 100]
+ */
+
+extern "C" {
+#include "csi_history.h"
+}
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+    int samples = 50;
+    int subcarriers = 52;
+    int windows = 100;
+    int history = 16;
+    int cache_kb = 32;
+    int ways = 8;
+    int line = CSI_HISTORY_LINE_BYTES;
+    int cpu_mhz = 240;
+    int spi_mhz = 80;
+    int spi_overhead_clocks = 14;  // QPI command, address and dummy cycles
+    double cycles_per_access = 3.0;  // Compute around each load/store
+    bool warm = false;
+};
+
+/**
+ * @brief Set-associative, write-back, write-allocate LRU cache
+ */
+class CacheModel {
+public:
+    CacheModel(int size_bytes, int ways, int line)
+        : ways_(ways), line_(line), sets_(size_bytes / (ways * line)),
+          tags_(static_cast<size_t>(sets_) * ways, kInvalid),
+          dirty_(tags_.size(), false), age_(tags_.size(), 0)
+    {
+    }
+
+    void access(uint64_t addr, bool write)
+    {
+        uint64_t line_addr = addr / line_;
+        int set = static_cast<int>(line_addr % sets_);
+        size_t base = static_cast<size_t>(set) * ways_;
+        clock_++;
+
+        size_t victim = base;
+        for (int w = 0; w < ways_; w++) {
+            size_t i = base + w;
+            if (tags_[i] == line_addr) {
+                age_[i] = clock_;
+                dirty_[i] = dirty_[i] || write;
+                return;
+            }
+            if (age_[i] < age_[victim]) {
+                victim = i;
+            }
+        }
+
+        misses++;
+        if (tags_[victim] != kInvalid && dirty_[victim]) {
+            writebacks++;
+        }
+        tags_[victim] = line_addr;
+        dirty_[victim] = write;
+        age_[victim] = clock_;
+    }
+
+    // Write back and drop everything, as other tasks' traffic would
+    void flush()
+    {
+        for (size_t i = 0; i < tags_.size(); i++) {
+            if (tags_[i] != kInvalid && dirty_[i]) {
+                writebacks++;
+            }
+            tags_[i] = kInvalid;
+            dirty_[i] = false;
+            age_[i] = 0;
+        }
+    }
+
+    uint64_t misses = 0;
+    uint64_t writebacks = 0;
+
+private:
+    static constexpr uint64_t kInvalid = ~0ull;
+    int ways_;
+    int line_;
+    int sets_;
+    std::vector<uint64_t> tags_;
+    std::vector<bool> dirty_;
+    std::vector<uint64_t> age_;
+    uint64_t clock_ = 0;
+};
+
+enum Region { kSram, kPsram };
+
+/**
+ * @brief A simulated buffer: a base address in one region
+ */
+struct Buffer {
+    Region region;
+    uint64_t base;
+};
+
+/**
+ * @brief Counts accesses per stage and feeds PSRAM ones to the cache
+ */
+class Tracer {
+public:
+    explicit Tracer(CacheModel &cache) : cache_(cache) {}
+
+    void read(const Buffer &b, size_t offset) { touch(b, offset, false); }
+    void write(const Buffer &b, size_t offset) { touch(b, offset, true); }
+
+    uint64_t accesses = 0;
+
+private:
+    void touch(const Buffer &b, size_t offset, bool write)
+    {
+        accesses++;
+        if (b.region == kPsram) {
+            cache_.access(b.base + offset, write);
+        }
+    }
+
+    CacheModel &cache_;
+};
+
+struct StageCost {
+    uint64_t accesses = 0;
+    uint64_t misses = 0;
+    uint64_t writebacks = 0;
+};
+
+struct Placement {
+    const char *name;
+    Region window;
+    Region history;
+};
+
+/**
+ * @brief Accesses of one window, in the order the firmware makes them
+ */
+class WindowTrace {
+public:
+    WindowTrace(const Options &opt, const Placement &p, uint64_t &next_addr)
+        : opt_(opt)
+    {
+        size_t window_bytes = static_cast<size_t>(opt.samples) * opt.subcarriers * sizeof(float);
+        size_t history_bytes = csi_history_storage_bytes(window_bytes, opt.history);
+        amp_ = alloc(p.window, window_bytes, next_addr);
+        phase_ = alloc(p.window, window_bytes, next_addr);
+        rssi_ = alloc(kSram, opt.samples, next_addr);
+        amp_history_ = alloc(p.history, history_bytes, next_addr);
+        phase_history_ = alloc(p.history, history_bytes, next_addr);
+        slot_bytes_ = csi_history_slot_bytes(window_bytes);
+        window_bytes_ = window_bytes;
+    }
+
+    // pose_process_csi(), one call per sample
+    void fill(Tracer &t, CacheModel &cache)
+    {
+        for (int i = 0; i < opt_.samples; i++) {
+            if (!opt_.warm) {
+                cache.flush();
+            }
+            for (int s = 0; s < opt_.subcarriers; s++) {
+                size_t off = (static_cast<size_t>(i) * opt_.subcarriers + s) * sizeof(float);
+                t.write(amp_, off);
+                t.write(phase_, off);
+            }
+            t.write(rssi_, i);
+        }
+    }
+
+    // csi_window_stats()
+    void stats(Tracer &t)
+    {
+        size_t total = static_cast<size_t>(opt_.samples) * opt_.subcarriers;
+        for (int pass = 0; pass < 2; pass++) {  // mean, then std
+            for (size_t i = 0; i < total; i++) {
+                t.read(amp_, i * sizeof(float));
+            }
+        }
+        for (int s = 0; s < opt_.subcarriers; s++) {
+            for (int pass = 0; pass < 2; pass++) {
+                for (int i = 0; i < opt_.samples; i++) {
+                    size_t off = (static_cast<size_t>(i) * opt_.subcarriers + s) * sizeof(float);
+                    t.read(phase_, off);
+                }
+            }
+        }
+        for (int i = 0; i < opt_.samples; i++) {
+            t.read(rssi_, i);
+        }
+    }
+
+    // csi_history_push() of both buffers (memcpy moves 4 bytes per access)
+    void spill(Tracer &t)
+    {
+        size_t slot_off = static_cast<size_t>(head_) * slot_bytes_;
+        for (size_t off = 0; off < window_bytes_; off += sizeof(uint32_t)) {
+            t.read(amp_, off);
+            t.write(amp_history_, slot_off + off);
+        }
+        for (size_t off = 0; off < window_bytes_; off += sizeof(uint32_t)) {
+            t.read(phase_, off);
+            t.write(phase_history_, slot_off + off);
+        }
+        head_ = opt_.history > 0 ? (head_ + 1) % opt_.history : 0;
+    }
+
+private:
+    Buffer alloc(Region region, size_t bytes, uint64_t &next_addr)
+    {
+        // Regions are disjoint address ranges; PSRAM buffers are line aligned
+        Buffer b{region, next_addr};
+        next_addr += (bytes + 4095) / 4096 * 4096;
+        return b;
+    }
+
+    const Options &opt_;
+    Buffer amp_, phase_, rssi_, amp_history_, phase_history_;
+    size_t slot_bytes_ = 0;
+    size_t window_bytes_ = 0;
+    int head_ = 0;
+};
+
+void usage(const char *prog)
+{
+    std::fprintf(stderr,
+                 "Usage: %s [options]\n"
+                 "  --samples N       Samples per window (default 50)\n"
+                 "  --subcarriers N   Subcarriers per sample (default 52)\n"
+                 "  --windows N       Windows simulated per placement (default 100)\n"
+                 "  --history N       Windows in the history ring (default 16)\n"
+                 "  --cache-kb N      Data cache size (default 32)\n"
+                 "  --ways N          Cache associativity (default 8)\n"
+                 "  --line N          Cache line bytes (default %d)\n"
+                 "  --cpu-mhz N       CPU clock (default 240)\n"
+                 "  --spi-mhz N       PSRAM SPI clock (default 80)\n"
+                 "  --cpa X           CPU cycles per load/store incl. compute (default 3)\n"
+                 "  --warm            Keep the cache between windows\n",
+                 prog, CSI_HISTORY_LINE_BYTES);
+}
+
+bool parse_args(int argc, char **argv, Options &opt)
+{
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        auto next = [&]() -> const char * { return i + 1 < argc ? argv[++i] : nullptr; };
+        const char *v = nullptr;
+        if (a == "--samples" && (v = next())) {
+            opt.samples = std::atoi(v);
+        } else if (a == "--subcarriers" && (v = next())) {
+            opt.subcarriers = std::atoi(v);
+        } else if (a == "--windows" && (v = next())) {
+            opt.windows = std::atoi(v);
+        } else if (a == "--history" && (v = next())) {
+            opt.history = std::atoi(v);
+        } else if (a == "--cache-kb" && (v = next())) {
+            opt.cache_kb = std::atoi(v);
+        } else if (a == "--ways" && (v = next())) {
+            opt.ways = std::atoi(v);
+        } else if (a == "--line" && (v = next())) {
+            opt.line = std::atoi(v);
+        } else if (a == "--cpu-mhz" && (v = next())) {
+            opt.cpu_mhz = std::atoi(v);
+        } else if (a == "--spi-mhz" && (v = next())) {
+            opt.spi_mhz = std::atoi(v);
+        } else if (a == "--cpa" && (v = next())) {
+            opt.cycles_per_access = std::atof(v);
+        } else if (a == "--warm") {
+            opt.warm = true;
+        } else {
+            return false;
+        }
+    }
+    return opt.samples > 0 && opt.subcarriers > 0 && opt.windows > 0 && opt.history > 0 &&
+           opt.cache_kb > 0 && opt.ways > 0 && opt.line >= 16 && (opt.line & (opt.line - 1)) == 0 &&
+           opt.cpu_mhz > 0 && opt.spi_mhz > 0;
+}
+
+}  // namespace
+
+int main(int argc, char **argv)
+{
+    Options opt;
+    if (!parse_args(argc, argv, opt)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    // Quad SPI moves 4 bits per clock in each direction
+    double line_spi_clocks = opt.spi_overhead_clocks + opt.line * 2.0;
+    double line_cpu_cycles = line_spi_clocks * opt.cpu_mhz / opt.spi_mhz;
+
+    const Placement placements[] = {
+        {"internal", kSram, kSram},
+        {"psram", kPsram, kPsram},
+        {"hot/cold", kSram, kPsram},
+    };
+    const char *const stage_names[] = {"fill", "stats", "spill"};
+
+    std::printf("Window %dx%d, %d windows, %dKB %d-way cache, %dB lines, %s cache\n",
+                opt.samples, opt.subcarriers, opt.windows, opt.cache_kb, opt.ways, opt.line,
+                opt.warm ? "warm" : "cold");
+    std::printf("PSRAM line transfer: %.0f SPI clocks = %.0f CPU cycles\n\n", line_spi_clocks,
+                line_cpu_cycles);
+    std::printf("%-10s %-6s %10s %10s %10s %10s\n", "placement", "stage", "accesses", "misses",
+                "writebacks", "est us");
+
+    for (const Placement &p : placements) {
+        CacheModel cache(opt.cache_kb * 1024, opt.ways, opt.line);
+        Tracer tracer(cache);
+        uint64_t next_addr = 0;
+        WindowTrace trace(opt, p, next_addr);
+        StageCost cost[3];
+
+        for (int w = 0; w < opt.windows; w++) {
+            for (int stage = 0; stage < 3; stage++) {
+                uint64_t a0 = tracer.accesses, m0 = cache.misses, wb0 = cache.writebacks;
+                if (stage == 0) {
+                    trace.fill(tracer, cache);
+                } else if (stage == 1) {
+                    trace.stats(tracer);
+                } else {
+                    trace.spill(tracer);
+                    if (!opt.warm) {
+                        cache.flush();  // Charge the spill's dirty lines to the spill
+                    }
+                }
+                cost[stage].accesses += tracer.accesses - a0;
+                cost[stage].misses += cache.misses - m0;
+                cost[stage].writebacks += cache.writebacks - wb0;
+            }
+        }
+
+        double total_us = 0.0;
+        for (int stage = 0; stage < 3; stage++) {
+            const StageCost &c = cost[stage];
+            double cycles = c.accesses * opt.cycles_per_access +
+                            (c.misses + c.writebacks) * line_cpu_cycles;
+            double us = cycles / opt.cpu_mhz / opt.windows;
+            total_us += us;
+            std::printf("%-10s %-6s %10llu %10llu %10llu %10.1f\n", p.name, stage_names[stage],
+                        static_cast<unsigned long long>(c.accesses / opt.windows),
+                        static_cast<unsigned long long>(c.misses / opt.windows),
+                        static_cast<unsigned long long>(c.writebacks / opt.windows), us);
+        }
+        std::printf("%-10s %-6s %10s %10s %10s %10.1f\n\n", p.name, "total", "", "", "", total_us);
+    }
+
+    return 0;
+}
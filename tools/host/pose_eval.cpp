@@ -0,0 +1,919 @@
+/**
+ * @file pose_eval.cpp
+ * @brief Batch offline inference over recorded CSI, the way the device runs it
+ *
+ * Replays recordings through the firmware's pipeline (csi_features.c and
+ * pose_pipeline.c, compiled unchanged) and reports per-window predictions,
+ * a confusion matrix against the recorded labels, and throughput.
+ *
+ * Windows are cut from the recording in order, exactly like the device's
+ * temporal buffer: --window samples (TEMPORAL_BUFFER_SIZE on the device),
+ * one inference every --stride samples (the device runs tumbling windows,
+ * so the default stride equals the window). Windows whose samples carry
+ * different labels are reported with true label "mixed" and left out of the
+ * confusion matrix.
+ *
+ * Pipeline per window:
+ *   parallel:   window stats -> classifier (threshold detector or int8 model)
+ *   sequential: post-processing (in window order; stages may keep state):
+ *               HMM smoothing (pose_smoother.c), like the device
+ *
+ * Every window also runs the occupancy estimator (occupancy.c). When the
+ * recording carries people counts ("people" per sample, see
+ * generate_synthetic_data.py --max-people), the report adds a count
+ * confusion matrix, accuracy and the estimator's cost per window.
+ *
+ * Change-detection gating (window_gate.c) runs like on the device: a window
+ * whose sketch matches the last computed window reuses its result, at
+ * least every --gate windows are computed. The report gives the share of
+ * windows reused, the compute time saved net of the sketches, and how many
+ * reused results differ from what computing would have given.
+ *
+ * Smoothing is reported as flicker: class changes per minute and "blips"
+ * (a class that lasts a single window, A B A) per minute, raw and smoothed.
+ * --lag-sweep runs one smoother per lag side by side and prints flicker and
+ * accuracy against the added latency.
+ *
+ * Samples are grouped into batches of --batch windows that run on a thread
+ * pool; at most 2 x threads batches are in flight, so memory stays bounded
+ * for multi-GB recordings.
+ *
+ * The int8 model classifier is available when the host build is configured
+ * with a TFLite Micro implementation of tflite_classifier.h
+ * (-DPOSE_EVAL_TFLITE_SOURCES=...); see tools/host/CMakeLists.txt.
+ *
+ * Usage:
+ *   pose_eval datasets/day1.json datasets/day2.json --predictions preds.csv
+ */
+
+#include "csi_dataset.hpp"
+#include "thread_pool.hpp"
+
+extern "C" {
+#include "csi_features.h"
+#include "occupancy.h"
+#include "pose_pipeline.h"
+#include "pose_smoother.h"
+#include "window_gate.h"
+#ifdef POSE_EVAL_WITH_TFLITE
+#include "tflite_classifier.h"
+#include "uv_map.h"
+#include "pose_record.h"
+#endif
+}
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr int kNumClasses = 6;
+constexpr int kLabelUnlabeled = -1;
+constexpr int kLabelMixed = -2;
+
+const char *const kClassNames[] = {
+    "empty", "present", "moving", "walking", "sitting", "standing", "unknown",
+};
+
+enum class ClassifierKind { Threshold, Model };
+
+struct Options {
+    std::vector<std::string> inputs;
+    std::string predictions_path;
+    int window = 50;
+    int stride = 0;  // 0 = window (tumbling, like the device)
+    int subcarriers = 52;
+    int sampling_rate_hz = 100;
+    unsigned threads = 0;
+    int batch = 64;
+    ClassifierKind classifier = ClassifierKind::Threshold;
+    int smoothing_lag = 2;  // -1 = off; the device default (CONFIG_POSE_SMOOTHING_LAG)
+    float stay_prob = 0.9f; // CONFIG_POSE_SMOOTHING_STAY_PERMILLE / 1000
+    bool lag_sweep = false;
+    int gate_refresh = 10;  // 1 = off; the device default (CONFIG_POSE_GATING_REFRESH)
+};
+
+/**
+ * @brief Contiguous samples holding a batch of windows
+ */
+struct Batch {
+    uint64_t first_window = 0;
+    int num_windows = 0;
+    std::vector<float> amplitude;
+    std::vector<float> phase;
+    std::vector<int8_t> rssi;
+    std::vector<int8_t> label;
+    std::vector<int16_t> people;
+    std::vector<uint32_t> timestamp;
+    size_t size() const { return rssi.size(); }
+};
+
+struct WindowResult {
+    pose_result_t result;
+    int true_label;
+    uint32_t host_us;  // Classifier stage time on the host
+    int true_people;   // People count of the window, or kLabelUnlabeled / kLabelMixed
+    uint32_t occupancy_ns;  // Occupancy estimator time on the host
+    uint32_t uv_record_bytes = 0;  // Encoded part/UV map record (0 = no map)
+    window_sketch_t sketch;  // Gating sketch of the window
+    uint32_t sketch_ns;      // Sketch time on the host (all samples of the window)
+};
+
+/**
+ * @brief Class changes and single-window blips in a stream of classes
+ */
+struct Flicker {
+    int prev = -1;
+    int prev2 = -1;
+    uint64_t windows = 0;
+    uint64_t changes = 0;
+    uint64_t blips = 0;
+
+    void add(int cls)
+    {
+        if (prev >= 0 && cls != prev) {
+            changes++;
+            if (cls == prev2) {
+                blips++;
+            }
+        }
+        prev2 = prev;
+        prev = cls;
+        windows++;
+    }
+};
+
+/**
+ * @brief One smoother of the --lag-sweep
+ */
+struct SweepTrack {
+    int lag = 0;
+    pose_smoother_t smoother;
+    std::deque<int> labels;  // True labels of windows still in the lag
+    Flicker flicker;
+    uint64_t correct = 0;
+    uint64_t labeled = 0;
+};
+
+#ifdef POSE_EVAL_WITH_TFLITE
+// tflite_classifier.h wraps a single interpreter
+std::mutex g_model_mutex;
+#endif
+
+template <typename T>
+int window_label(const std::vector<T> &labels, size_t t0, int window)
+{
+    int label = labels[t0];
+    for (size_t t = t0 + 1; t < t0 + window; t++) {
+        if (labels[t] != label) {
+            return kLabelMixed;
+        }
+    }
+    return label;
+}
+
+std::vector<WindowResult> run_batch(const Batch &b, const Options &opt, int stride)
+{
+    const int subs = opt.subcarriers;
+    std::vector<WindowResult> out(b.num_windows);
+    std::vector<float> occupancy_scratch(OCCUPANCY_SCRATCH_BYTES(subs) / sizeof(float));
+#ifdef POSE_EVAL_WITH_TFLITE
+    std::vector<int8_t> input(static_cast<size_t>(opt.window) * 2 * subs);
+    int8_t scores[TFLITE_NUM_CLASSES];
+    int8_t keypoints[TFLITE_KEYPOINT_OUTPUTS];
+    static_assert(TFLITE_NUM_KEYPOINTS == POSE_NUM_KEYPOINTS, "keypoint head size mismatch");
+    const bool has_keypoints = tflite_classifier_has_keypoints();
+    pose_keypoint_lut_t keypoint_lut;
+    if (has_keypoints) {
+        size_t kp_size;
+        float kp_scale;
+        int kp_zp;
+        tflite_classifier_get_keypoint_details(&kp_size, &kp_scale, &kp_zp);
+        pose_keypoint_lut_init(&keypoint_lut, kp_scale, kp_zp);
+    }
+    const bool has_uv_map = tflite_classifier_has_uv_map();
+    uv_map_lut_t uv_lut;
+    bool uv_lut_ready = false;
+    uv_map_t uv_map;
+    uint8_t uv_record[POSE_RECORD_HEADER_BYTES + UV_MAP_MAX_PAYLOAD + POSE_RECORD_CRC_BYTES];
+#endif
+
+    for (int w = 0; w < b.num_windows; w++) {
+        size_t t0 = static_cast<size_t>(w) * stride;
+        const float *amp = &b.amplitude[t0 * subs];
+        const float *phase = &b.phase[t0 * subs];
+        auto start = std::chrono::steady_clock::now();
+
+        csi_window_stats_t stats;
+        csi_window_stats(amp, phase, &b.rssi[t0], opt.window, subs, &stats);
+
+        pose_result_t &r = out[w].result;
+        std::memset(&r, 0, sizeof(r));
+        r.zone = -1;  // Recordings are single-link
+        if (opt.classifier == ClassifierKind::Threshold) {
+            pose_detect_presence(&stats, &r);
+        } else {
+#ifdef POSE_EVAL_WITH_TFLITE
+            size_t in_size, out_size;
+            float in_scale, out_scale;
+            int in_zp, out_zp;
+            tflite_classifier_get_input_details(&in_size, &in_scale, &in_zp);
+            tflite_classifier_get_output_details(&out_size, &out_scale, &out_zp);
+            pose_model_prepare_input(amp, phase, opt.window, subs, in_scale, in_zp, input.data());
+            {
+                std::lock_guard<std::mutex> lock(g_model_mutex);
+                if (has_keypoints) {
+                    tflite_classifier_run_keypoints(input.data(), scores, keypoints);
+                } else {
+                    tflite_classifier_run(input.data(), scores);
+                }
+                // The part/UV outputs live in the arena until the next run
+                const int8_t *parts, *uv;
+                float uv_scale;
+                int uv_zp;
+                if (has_uv_map &&
+                    tflite_classifier_get_uv_map(&parts, &uv, &uv_scale, &uv_zp) == ESP_OK) {
+                    if (!uv_lut_ready) {
+                        uv_map_lut_init(&uv_lut, uv_scale, uv_zp);
+                        uv_lut_ready = true;
+                    }
+                    uv_map_decode_head(parts, uv, &uv_lut, &uv_map);
+                    out[w].uv_record_bytes = static_cast<uint32_t>(
+                        uv_map_encode(&uv_map, 0, uv_record, sizeof(uv_record)));
+                }
+            }
+            pose_model_decode_output(scores, TFLITE_NUM_CLASSES, out_scale, out_zp, &stats, &r);
+            if (has_keypoints && r.human_detected) {
+                pose_model_decode_keypoints(keypoints, &keypoint_lut, &r.skeleton);
+            }
+
+#endif
+        }
+
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        out[w].host_us = static_cast<uint32_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+        r.inference_time_ms = out[w].host_us / 1000;
+        // The device stamps a result when the last sample of the window arrives
+        r.timestamp = b.timestamp[t0 + opt.window - 1];
+        out[w].true_label = window_label(b.label, t0, opt.window);
+
+        start = std::chrono::steady_clock::now();
+        occupancy_estimate_t occupancy;
+        occupancy_estimate(amp, opt.window, subs, r.human_detected, occupancy_scratch.data(),
+                           &occupancy);
+        elapsed = std::chrono::steady_clock::now() - start;
+        out[w].occupancy_ns = static_cast<uint32_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+        r.occupancy = occupancy.count;
+        r.occupancy_confidence = occupancy.confidence;
+        out[w].true_people = window_label(b.people, t0, opt.window);
+
+        // The device builds the sketch sample by sample as the window fills
+        start = std::chrono::steady_clock::now();
+        window_sketch_reset(&out[w].sketch);
+        for (int t = 0; t < opt.window; t++) {
+            window_sketch_push(&out[w].sketch, &amp[t * subs], subs);
+        }
+        elapsed = std::chrono::steady_clock::now() - start;
+        out[w].sketch_ns = static_cast<uint32_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    }
+    return out;
+}
+
+class Evaluator {
+public:
+    explicit Evaluator(const Options &opt)
+        : opt_(opt),
+          stride_(opt.stride > 0 ? opt.stride : opt.window),
+          pool_(opt.threads ? opt.threads : std::thread::hardware_concurrency()),
+          max_in_flight_(2 * pool_.size())
+    {
+        std::memset(confusion_, 0, sizeof(confusion_));
+        std::memset(occupancy_confusion_, 0, sizeof(occupancy_confusion_));
+        window_gate_config_t gate;
+        window_gate_default_config(&gate, opt.gate_refresh);
+        window_gate_init(&gate_, &gate);
+        if (opt.smoothing_lag >= 0) {
+            pose_smoother_config_t config;
+            pose_smoother_default_config(&config, kNumClasses, opt.stay_prob, opt.smoothing_lag);
+            smoothing_ = pose_smoother_init(&smoother_, &config) == ESP_OK;
+        }
+        if (opt.lag_sweep) {
+            sweep_.resize(POSE_SMOOTHER_MAX_LAG + 1);
+            for (int lag = 0; lag <= POSE_SMOOTHER_MAX_LAG; lag++) {
+                pose_smoother_config_t config;
+                pose_smoother_default_config(&config, kNumClasses, opt.stay_prob, lag);
+                sweep_[lag].lag = lag;
+                pose_smoother_init(&sweep_[lag].smoother, &config);
+            }
+        }
+        if (!opt.predictions_path.empty()) {
+            predictions_ = std::fopen(opt.predictions_path.c_str(), "w");
+            if (predictions_ != nullptr) {
+                std::fprintf(predictions_,
+                             "window,timestamp,true_label,pred_class,human_detected,confidence,"
+                             "motion_level,amp_mean,amp_std,phase_variance,true_people,occupancy,"
+                             "occupancy_confidence\n");
+            }
+        }
+    }
+
+    ~Evaluator()
+    {
+        if (predictions_ != nullptr) {
+            std::fclose(predictions_);
+        }
+    }
+
+    bool ok() const
+    {
+        return (opt_.smoothing_lag < 0 || smoothing_) &&
+               (opt_.predictions_path.empty() || predictions_ != nullptr);
+    }
+
+    void add(const csi::Sample &sample)
+    {
+        uint64_t pos = samples_++;
+        if (pos < next_window_) {
+            // Gap between windows when stride > window
+            return;
+        }
+
+        const int subs = opt_.subcarriers;
+        Batch &b = pending_;
+        size_t n = std::min(sample.amplitude.size(), static_cast<size_t>(subs));
+        size_t base = b.amplitude.size();
+        // Short packets leave the remaining subcarriers at zero
+        b.amplitude.resize(base + subs, 0.0f);
+        b.phase.resize(base + subs, 0.0f);
+        std::memcpy(&b.amplitude[base], sample.amplitude.data(), n * sizeof(float));
+        std::memcpy(&b.phase[base], sample.phase.data(),
+                    std::min(n, sample.phase.size()) * sizeof(float));
+        b.rssi.push_back(sample.rssi);
+        b.label.push_back(static_cast<int8_t>(
+            sample.label.empty() ? kLabelUnlabeled : csi::label_to_class(sample.label)));
+        b.people.push_back(static_cast<int16_t>(sample.people < 0 ? kLabelUnlabeled
+                                                                   : sample.people));
+        b.timestamp.push_back(sample.timestamp);
+
+        if (b.size() >= static_cast<size_t>(opt_.batch - 1) * stride_ + opt_.window) {
+            submit();
+        }
+    }
+
+    void finish()
+    {
+        submit();
+        while (!in_flight_.empty()) {
+            consume_front();
+        }
+    }
+
+    void report(double seconds) const;
+    void report_occupancy() const;
+    void report_gating() const;
+
+private:
+    void submit()
+    {
+        Batch &b = pending_;
+        if (b.size() < static_cast<size_t>(opt_.window)) {
+            return;
+        }
+        b.num_windows = csi_num_windows(static_cast<int>(b.size()), opt_.window, stride_);
+        b.first_window = windows_submitted_;
+        windows_submitted_ += b.num_windows;
+
+        // The next window starts num_windows * stride samples into this batch
+        size_t next = static_cast<size_t>(b.num_windows) * stride_;
+        Batch carry;
+        if (next < b.size()) {
+            const int subs = opt_.subcarriers;
+            carry.amplitude.assign(b.amplitude.begin() + next * subs, b.amplitude.end());
+            carry.phase.assign(b.phase.begin() + next * subs, b.phase.end());
+            carry.rssi.assign(b.rssi.begin() + next, b.rssi.end());
+            carry.label.assign(b.label.begin() + next, b.label.end());
+            carry.people.assign(b.people.begin() + next, b.people.end());
+            carry.timestamp.assign(b.timestamp.begin() + next, b.timestamp.end());
+        }
+        next_window_ = samples_ - b.size() + next;
+
+        auto batch = std::make_shared<Batch>(std::move(b));
+        const Options &opt = opt_;
+        int stride = stride_;
+        in_flight_.push_back(
+            pool_.submit([batch, &opt, stride] { return run_batch(*batch, opt, stride); }));
+        pending_ = std::move(carry);
+
+        while (in_flight_.size() > max_in_flight_) {
+            consume_front();
+        }
+    }
+
+    /**
+     * @brief Sequential stage: post-processing and reporting in window order
+     */
+    void consume_front()
+    {
+        std::vector<WindowResult> results = in_flight_.front().get();
+        in_flight_.pop_front();
+
+        for (WindowResult &wr : results) {
+            postprocess(wr);
+        }
+    }
+
+    /**
+     * @brief Stateful post-processing, in window order, as on the device
+     */
+    void postprocess(WindowResult wr)
+    {
+        gate(wr);
+
+        float probs[kNumClasses];
+        pose_smoother_class_probs(&wr.result, kNumClasses, probs);
+        raw_flicker_.add(class_index(wr.result));
+        if (wr.true_label >= 0) {
+            raw_labeled_++;
+            raw_correct_ += class_index(wr.result) == wr.true_label;
+        }
+
+        for (SweepTrack &track : sweep_) {
+            pose_result_t out;
+            track.labels.push_back(wr.true_label);
+            if (pose_smoother_update(&track.smoother, probs, &wr.result, &out)) {
+                int label = track.labels.front();
+                track.labels.pop_front();
+                track.flicker.add(class_index(out));
+                if (label >= 0) {
+                    track.labeled++;
+                    track.correct += class_index(out) == label;
+                }
+            }
+        }
+
+        if (!smoothing_) {
+            record(wr);
+            return;
+        }
+        // The smoother answers for the window lag windows back
+        lagged_.push_back(wr);
+        pose_result_t out;
+        if (pose_smoother_update(&smoother_, probs, &wr.result, &out)) {
+            WindowResult smoothed = lagged_.front();
+            lagged_.pop_front();
+            smoothed.result = out;
+            record(smoothed);
+        }
+    }
+
+    /**
+     * @brief Change-detection gating: reuse the last computed result if static
+     */
+    void gate(WindowResult &wr)
+    {
+        uint64_t compute_ns = static_cast<uint64_t>(wr.host_us) * 1000 + wr.occupancy_ns;
+        gate_compute_ns_ += compute_ns;
+        gate_sketch_ns_ += wr.sketch_ns;
+        bool labeled = wr.true_label >= 0;
+        gate_computed_correct_ += labeled && class_index(wr.result) == wr.true_label;
+
+        if (window_gate_check(&gate_, &wr.sketch)) {
+            gate_saved_ns_ += compute_ns;
+            gate_class_changed_ += class_index(gate_last_) != class_index(wr.result);
+            gate_people_changed_ += gate_last_.occupancy != wr.result.occupancy;
+            uint32_t timestamp = wr.result.timestamp;
+            wr.result = gate_last_;
+            wr.result.timestamp = timestamp;
+            wr.result.reused = true;
+        } else {
+            gate_last_ = wr.result;
+        }
+        gate_labeled_ += labeled;
+        gate_correct_ += labeled && class_index(wr.result) == wr.true_label;
+    }
+
+    static int class_index(const pose_result_t &r)
+    {
+        return r.pose_class < kNumClasses ? r.pose_class : kNumClasses;
+    }
+
+    void record(const WindowResult &wr)
+    {
+        const pose_result_t &r = wr.result;
+        int pred = class_index(r);
+        flicker_.add(pred);
+        if (wr.true_label >= 0) {
+            confusion_[wr.true_label][pred]++;
+        } else if (wr.true_label == kLabelMixed) {
+            mixed_windows_++;
+        }
+        total_host_us_ += wr.host_us;
+        total_occupancy_ns_ += wr.occupancy_ns;
+        if (wr.true_people >= 0) {
+            // Counts above the estimator's range are expected to saturate
+            int truth = std::min(wr.true_people, OCCUPANCY_MAX_COUNT);
+            occupancy_confusion_[truth][r.occupancy]++;
+            (r.occupancy == truth ? occupancy_conf_right_ : occupancy_conf_wrong_) +=
+                r.occupancy_confidence;
+        }
+        if (wr.uv_record_bytes > 0) {
+            uv_maps_++;
+            uv_bytes_ += wr.uv_record_bytes;
+            uv_max_bytes_ = std::max<uint64_t>(uv_max_bytes_, wr.uv_record_bytes);
+        }
+
+        if (predictions_ != nullptr) {
+            const char *truth = wr.true_label >= 0 ? kClassNames[wr.true_label]
+                                : wr.true_label == kLabelMixed ? "mixed" : "";
+            char people[12] = "";
+            if (wr.true_people >= 0) {
+                std::snprintf(people, sizeof(people), "%d", wr.true_people);
+            } else if (wr.true_people == kLabelMixed) {
+                std::snprintf(people, sizeof(people), "mixed");
+            }
+            std::fprintf(predictions_, "%llu,%u,%s,%s,%d,%.4f,%.4f,%.4f,%.4f,%.6f,%s,%d,%.4f\n",
+                         static_cast<unsigned long long>(windows_done_), r.timestamp, truth,
+                         kClassNames[pred], r.human_detected ? 1 : 0, r.confidence,
+                         r.motion_level, r.amplitude_mean, r.amplitude_std, r.phase_variance,
+                         people, r.occupancy, r.occupancy_confidence);
+        }
+        windows_done_++;
+    }
+
+    const Options &opt_;
+    int stride_;
+    csi::ThreadPool pool_;
+    size_t max_in_flight_;
+    Batch pending_;
+    uint64_t samples_ = 0;
+    uint64_t next_window_ = 0;
+    uint64_t windows_submitted_ = 0;
+    uint64_t windows_done_ = 0;
+    uint64_t mixed_windows_ = 0;
+    uint64_t total_host_us_ = 0;
+    uint64_t uv_maps_ = 0;
+    uint64_t uv_bytes_ = 0;
+    uint64_t uv_max_bytes_ = 0;
+    uint64_t confusion_[kNumClasses][kNumClasses + 1];
+    uint64_t total_occupancy_ns_ = 0;
+    uint64_t occupancy_confusion_[OCCUPANCY_MAX_COUNT + 1][OCCUPANCY_MAX_COUNT + 1];
+    double occupancy_conf_right_ = 0.0;
+    double occupancy_conf_wrong_ = 0.0;
+    std::deque<std::future<std::vector<WindowResult>>> in_flight_;
+    std::FILE *predictions_ = nullptr;
+    bool smoothing_ = false;
+    pose_smoother_t smoother_;
+    std::deque<WindowResult> lagged_;
+    std::vector<SweepTrack> sweep_;
+    window_gate_t gate_;
+    pose_result_t gate_last_ = {};
+    uint64_t gate_compute_ns_ = 0;
+    uint64_t gate_saved_ns_ = 0;
+    uint64_t gate_sketch_ns_ = 0;
+    uint64_t gate_class_changed_ = 0;
+    uint64_t gate_people_changed_ = 0;
+    uint64_t gate_labeled_ = 0;
+    uint64_t gate_correct_ = 0;
+    uint64_t gate_computed_correct_ = 0;
+    Flicker raw_flicker_;
+    Flicker flicker_;
+    uint64_t raw_correct_ = 0;
+    uint64_t raw_labeled_ = 0;
+};
+
+void Evaluator::report(double seconds) const
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+    std::printf("\n============================================================\n");
+    std::printf("CONFUSION MATRIX (rows: true, columns: predicted)\n");
+    std::printf("============================================================\n");
+    std::printf("%10s", "");
+    for (int p = 0; p <= kNumClasses; p++) {
+        std::printf(" %9s", kClassNames[p]);
+    }
+    std::printf("\n");
+
+    uint64_t correct = 0, labeled = 0;
+    for (int t = 0; t < kNumClasses; t++) {
+        uint64_t row = 0;
+        for (int p = 0; p <= kNumClasses; p++) {
+            row += confusion_[t][p];
+        }
+        if (row == 0) {
+            continue;
+        }
+        std::printf("%10s", kClassNames[t]);
+        for (int p = 0; p <= kNumClasses; p++) {
+            std::printf(" %9llu", static_cast<unsigned long long>(confusion_[t][p]));
+        }
+        std::printf("   recall=%.3f\n", static_cast<double>(confusion_[t][t]) / row);
+        correct += confusion_[t][t];
+        labeled += row;
+    }
+
+    std::printf("\n  Windows:        %llu (%llu labeled, %llu mixed-label)\n",
+                static_cast<unsigned long long>(windows_done_),
+                static_cast<unsigned long long>(labeled),
+                static_cast<unsigned long long>(mixed_windows_));
+    if (labeled > 0) {
+        std::printf("  Accuracy:       %.4f\n", static_cast<double>(correct) / labeled);
+    }
+
+    // Windows are stride samples apart
+    const double window_min = static_cast<double>(stride_) / opt_.sampling_rate_hz / 60.0;
+    auto per_min = [window_min](uint64_t count, uint64_t windows) {
+        return windows > 0 ? count / (windows * window_min) : 0.0;
+    };
+    if (smoothing_) {
+        std::printf("  Smoothing:      HMM, lag %d windows (+%.0f ms), stay %.3f; "
+                    "%zu windows still in the lag at the end\n",
+                    opt_.smoothing_lag, opt_.smoothing_lag * window_min * 60000.0,
+                    opt_.stay_prob, lagged_.size());
+    }
+    std::printf("  Class changes:  raw %.1f/min (%.1f blips/min)",
+                per_min(raw_flicker_.changes, raw_flicker_.windows),
+                per_min(raw_flicker_.blips, raw_flicker_.windows));
+    if (smoothing_) {
+        std::printf(" -> smoothed %.1f/min (%.1f blips/min)",
+                    per_min(flicker_.changes, flicker_.windows),
+                    per_min(flicker_.blips, flicker_.windows));
+    }
+    std::printf("\n");
+    std::printf("  Samples:        %llu (%.1f s of CSI at %d Hz)\n",
+                static_cast<unsigned long long>(samples_),
+                static_cast<double>(samples_) / opt_.sampling_rate_hz, opt_.sampling_rate_hz);
+    std::printf("  Time:           %.3f s on %zu threads\n", seconds, pool_.size());
+    if (seconds > 0) {
+        std::printf("  Throughput:     %.0f windows/s, %.0f samples/s (%.0fx real time)\n",
+                    windows_done_ / seconds, samples_ / seconds,
+                    static_cast<double>(samples_) / opt_.sampling_rate_hz / seconds);
+    }
+    if (windows_done_ > 0) {
+        std::printf("  Host latency:   %.1f us/window (stats + classifier)\n",
+                    static_cast<double>(total_host_us_) / windows_done_);
+    }
+    if (windows_done_ > 0) {
+        std::printf("  Occupancy:      %.1f us/window (%zu bytes of scratch)\n",
+                    static_cast<double>(total_occupancy_ns_) / windows_done_ / 1000.0,
+                    OCCUPANCY_SCRATCH_BYTES(opt_.subcarriers));
+    }
+    if (uv_maps_ > 0) {
+        std::printf("  UV map records: %.0f bytes mean, %llu max\n",
+                    static_cast<double>(uv_bytes_) / uv_maps_,
+                    static_cast<unsigned long long>(uv_max_bytes_));
+    }
+    std::printf("  Peak RSS:       %.1f MB\n", usage.ru_maxrss / 1024.0);
+
+    report_occupancy();
+    report_gating();
+
+    if (!sweep_.empty()) {
+        std::printf("\n============================================================\n");
+        std::printf("FLICKER VS LAG (HMM, stay %.3f)\n", opt_.stay_prob);
+        std::printf("============================================================\n");
+        std::printf("%8s %12s %14s %12s %10s\n", "lag", "latency ms", "changes/min",
+                    "blips/min", "accuracy");
+        auto accuracy = [](uint64_t right, uint64_t total) {
+            char buf[16] = "-";
+            if (total > 0) {
+                std::snprintf(buf, sizeof(buf), "%.4f", static_cast<double>(right) / total);
+            }
+            return std::string(buf);
+        };
+        std::printf("%8s %12s %14.1f %12.1f %10s\n", "raw", "0",
+                    per_min(raw_flicker_.changes, raw_flicker_.windows),
+                    per_min(raw_flicker_.blips, raw_flicker_.windows),
+                    accuracy(raw_correct_, raw_labeled_).c_str());
+        for (const SweepTrack &track : sweep_) {
+            std::printf("%8d %12.0f %14.1f %12.1f %10s\n", track.lag,
+                        track.lag * window_min * 60000.0,
+                        per_min(track.flicker.changes, track.flicker.windows),
+                        per_min(track.flicker.blips, track.flicker.windows),
+                        accuracy(track.correct, track.labeled).c_str());
+        }
+    }
+}
+
+void Evaluator::report_occupancy() const
+{
+    uint64_t windows = 0, exact = 0, within_one = 0, abs_error = 0;
+    for (int t = 0; t <= OCCUPANCY_MAX_COUNT; t++) {
+        for (int p = 0; p <= OCCUPANCY_MAX_COUNT; p++) {
+            uint64_t n = occupancy_confusion_[t][p];
+            windows += n;
+            exact += t == p ? n : 0;
+            within_one += std::abs(t - p) <= 1 ? n : 0;
+            abs_error += static_cast<uint64_t>(std::abs(t - p)) * n;
+        }
+    }
+    if (windows == 0) {
+        return;  // Recording has no people counts
+    }
+
+    std::printf("\n============================================================\n");
+    std::printf("OCCUPANCY (rows: true people, columns: estimated; %d = %d or more)\n",
+                OCCUPANCY_MAX_COUNT, OCCUPANCY_MAX_COUNT);
+    std::printf("============================================================\n");
+    std::printf("%10s", "");
+    for (int p = 0; p <= OCCUPANCY_MAX_COUNT; p++) {
+        std::printf(" %9d", p);
+    }
+    std::printf("\n");
+    for (int t = 0; t <= OCCUPANCY_MAX_COUNT; t++) {
+        uint64_t row = 0;
+        for (int p = 0; p <= OCCUPANCY_MAX_COUNT; p++) {
+            row += occupancy_confusion_[t][p];
+        }
+        if (row == 0) {
+            continue;
+        }
+        std::printf("%10d", t);
+        for (int p = 0; p <= OCCUPANCY_MAX_COUNT; p++) {
+            std::printf(" %9llu", static_cast<unsigned long long>(occupancy_confusion_[t][p]));
+        }
+        std::printf("   recall=%.3f\n", static_cast<double>(occupancy_confusion_[t][t]) / row);
+    }
+    std::printf("\n  Windows:        %llu with a single people count\n",
+                static_cast<unsigned long long>(windows));
+    std::printf("  Accuracy:       %.4f exact, %.4f within one\n",
+                static_cast<double>(exact) / windows, static_cast<double>(within_one) / windows);
+    std::printf("  Mean abs error: %.3f people\n", static_cast<double>(abs_error) / windows);
+    std::printf("  Confidence:     %.3f when right, %.3f when wrong\n",
+                exact > 0 ? occupancy_conf_right_ / exact : 0.0,
+                windows > exact ? occupancy_conf_wrong_ / (windows - exact) : 0.0);
+}
+
+void Evaluator::report_gating() const
+{
+    if (opt_.gate_refresh <= 1 || gate_.windows == 0) {
+        return;
+    }
+    const window_gate_config_t &cfg = gate_.config;
+    double windows = gate_.windows;
+    double net_ns = static_cast<double>(gate_saved_ns_) - static_cast<double>(gate_sketch_ns_);
+
+    std::printf("\n============================================================\n");
+    std::printf("GATING (static if bands within %.1f dB, motion within %.1f dB; "
+                "refresh every %d windows)\n",
+                cfg.amp_db, cfg.motion_db, cfg.refresh);
+    std::printf("============================================================\n");
+    std::printf("  Windows reused: %u of %u (%.1f%% skipped)\n", gate_.skipped, gate_.windows,
+                100.0 * gate_.skipped / windows);
+    std::printf("  Compute:        %.1f us/window (stats + classifier + occupancy), "
+                "sketch %.2f us/window\n",
+                gate_compute_ns_ / windows / 1000.0, gate_sketch_ns_ / windows / 1000.0);
+    std::printf("  CPU saved:      %.1f%% of window compute, net of sketches "
+                "(%.1f ms per hour of CSI)\n",
+                gate_compute_ns_ > 0 ? 100.0 * net_ns / gate_compute_ns_ : 0.0,
+                net_ns / 1e6 / (windows * stride_ / opt_.sampling_rate_hz / 3600.0));
+    std::printf("  Reuse changed:  class in %llu windows (%.2f%%), people count in %llu (%.2f%%)\n",
+                static_cast<unsigned long long>(gate_class_changed_),
+                100.0 * gate_class_changed_ / windows,
+                static_cast<unsigned long long>(gate_people_changed_),
+                100.0 * gate_people_changed_ / windows);
+    if (gate_labeled_ > 0) {
+        std::printf("  Raw accuracy:   %.4f gated, %.4f computing every window\n",
+                    static_cast<double>(gate_correct_) / gate_labeled_,
+                    static_cast<double>(gate_computed_correct_) / gate_labeled_);
+    }
+}
+
+void usage(const char *prog)
+{
+    std::fprintf(stderr,
+                 "Usage: %s DATASET [DATASET...] [options]\n"
+                 "  --predictions FILE  Write per-window predictions as CSV\n"
+                 "  --window N          Samples per window (default: 50)\n"
+                 "  --stride N          Samples between inferences (default: window)\n"
+                 "  --subcarriers N     Subcarriers per sample (default: 52)\n"
+                 "  --rate HZ           CSI sampling rate for real-time factor (default: 100)\n"
+                 "  --threads N         Worker threads (default: all cores)\n"
+                 "  --batch N           Windows per work item (default: 64)\n"
+                 "  --classifier NAME   threshold (default) or model\n"
+                 "  --smoothing LAG     HMM smoothing lag in windows, or off (default: 2)\n"
+                 "  --stay P            HMM probability of keeping the class (default: 0.9)\n"
+                 "  --lag-sweep         Report flicker and accuracy for every lag\n"
+                 "  --gate N            Gating refresh in windows, or off (default: 10)\n",
+                 prog);
+}
+
+bool parse_args(int argc, char **argv, Options &opt)
+{
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        auto next = [&]() -> const char * { return i + 1 < argc ? argv[++i] : nullptr; };
+        const char *v = nullptr;
+        if (a == "--predictions" && (v = next())) {
+            opt.predictions_path = v;
+        } else if (a == "--window" && (v = next())) {
+            opt.window = std::atoi(v);
+        } else if (a == "--stride" && (v = next())) {
+            opt.stride = std::atoi(v);
+        } else if (a == "--subcarriers" && (v = next())) {
+            opt.subcarriers = std::atoi(v);
+        } else if (a == "--rate" && (v = next())) {
+            opt.sampling_rate_hz = std::atoi(v);
+        } else if (a == "--threads" && (v = next())) {
+            opt.threads = static_cast<unsigned>(std::atoi(v));
+        } else if (a == "--batch" && (v = next())) {
+            opt.batch = std::atoi(v);
+        } else if (a == "--classifier" && (v = next())) {
+            if (std::strcmp(v, "threshold") == 0) {
+                opt.classifier = ClassifierKind::Threshold;
+            } else if (std::strcmp(v, "model") == 0) {
+                opt.classifier = ClassifierKind::Model;
+            } else {
+                return false;
+            }
+        } else if (a == "--smoothing" && (v = next())) {
+            opt.smoothing_lag = std::strcmp(v, "off") == 0 ? -1 : std::atoi(v);
+            if (opt.smoothing_lag > POSE_SMOOTHER_MAX_LAG) {
+                return false;
+            }
+        } else if (a == "--stay" && (v = next())) {
+            opt.stay_prob = static_cast<float>(std::atof(v));
+        } else if (a == "--lag-sweep") {
+            opt.lag_sweep = true;
+        } else if (a == "--gate" && (v = next())) {
+            opt.gate_refresh = std::strcmp(v, "off") == 0 ? 1 : std::atoi(v);
+            if (opt.gate_refresh < 1) {
+                return false;
+            }
+        } else if (!a.empty() && a[0] != '-') {
+            opt.inputs.push_back(a);
+        } else {
+            return false;
+        }
+    }
+    return !opt.inputs.empty() && opt.window > 0 && opt.stride >= 0 && opt.subcarriers > 0 &&
+           opt.subcarriers <= 64 && opt.batch > 0 && opt.sampling_rate_hz > 0 &&
+           opt.stay_prob > 0.0f && opt.stay_prob < 1.0f;
+}
+
+}  // namespace
+
+int main(int argc, char **argv)
+{
+    Options opt;
+    if (!parse_args(argc, argv, opt)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    if (opt.classifier == ClassifierKind::Model) {
+#ifdef POSE_EVAL_WITH_TFLITE
+        if (tflite_classifier_init() != ESP_OK) {
+            std::fprintf(stderr, "✗ Failed to initialize TFLite classifier\n");
+            return 1;
+        }
+#else
+        std::fprintf(stderr, "✗ Built without a TFLite classifier "
+                             "(configure with -DPOSE_EVAL_TFLITE_SOURCES=...)\n");
+        return 1;
+#endif
+    }
+
+    Evaluator evaluator(opt);
+    if (!evaluator.ok()) {
+        std::fprintf(stderr, "✗ Cannot create %s or invalid smoothing options\n",
+                     opt.predictions_path.c_str());
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (const auto &path : opt.inputs) {
+        csi::DatasetReader reader(path);
+        if (!reader.is_open()) {
+            std::fprintf(stderr, "✗ Cannot open %s\n", path.c_str());
+            return 1;
+        }
+        size_t n = reader.for_each([&](const csi::Sample &s) { evaluator.add(s); });
+        std::printf("✓ %s: %zu samples\n", path.c_str(), n);
+    }
+    evaluator.finish();
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    evaluator.report(secs);
+
+#ifdef POSE_EVAL_WITH_TFLITE
+    if (opt.classifier == ClassifierKind::Model) {
+        tflite_classifier_deinit();
+    }
+#endif
+    return 0;
+}
@@ -0,0 +1,281 @@
+/**
+ * @file result_ring_stress.c
+ * @brief Host concurrency test and benchmark for the pose result ring
+ *
+ * Checks result_ring.c (compiled unchanged from firmware/main) under one
+ * writer and many concurrent readers:
+ *
+ *   - every result a reader gets is internally consistent (never torn)
+ *   - results from result_ring_read_since() arrive in strictly increasing
+ *     sequence order, and returned + lost accounts for every sequence
+ *   - result_ring_latest() never goes backwards
+ *
+ * Then measures publish and read cost, alone and with readers spinning.
+ * Exits non-zero on the first inconsistency.
+ *
+ * Usage:
+ *   result_ring_stress [--readers 4] [--results 200000]
+ */
+
+#include "bench_util.h"
+#include "result_ring.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static result_ring_t s_ring;
+static atomic_bool s_writer_done;
+static uint32_t s_num_results = 200000;
+
+/**
+ * @brief Per-reader counters
+ */
+typedef struct {
+    uint64_t reads;
+    uint64_t results;
+    uint64_t lost;
+} reader_stats_t;
+
+/**
+ * @brief Result whose every field is derived from n
+ */
+static void make_result(uint32_t n, pose_result_t *r)
+{
+    memset(r, 0, sizeof(*r));
+    r->human_detected = (n & 1) != 0;
+    r->pose_class = (pose_class_t)(n % 6);
+    r->confidence = (float)(n % 1000) / 1000.0f;
+    r->motion_level = (float)(n % 97);
+    r->amplitude_mean = (float)(n % 4096);
+    r->amplitude_std = (float)(n % 4099);
+    r->phase_variance = (float)(n % 31);
+    r->inference_time_ms = n * 3;
+    r->timestamp = n * 7;
+}
+
+static int consistent(const pose_result_t *r)
+{
+    pose_result_t expected;
+    make_result(r->timestamp / 7, &expected);
+    expected.sequence = r->sequence;
+    // Results are published in order, so result n gets sequence n
+    return r->sequence == r->timestamp / 7 && memcmp(r, &expected, sizeof(expected)) == 0;
+}
+
+static void *writer(void *arg)
+{
+    int pace = *(int *)arg;
+    pose_result_t r;
+
+    for (uint32_t n = 1; n <= s_num_results; n++) {
+        make_result(n, &r);
+        if (result_ring_publish(&s_ring, &r) != n) {
+            FAIL("publish returned the wrong sequence");
+        }
+        if (pace && n % 16 == 0) {
+            sched_yield();
+        }
+    }
+    atomic_store(&s_writer_done, true);
+    return NULL;
+}
+
+static void *since_reader(void *arg)
+{
+    reader_stats_t *stats = arg;
+    pose_result_t buf[8];
+    uint32_t last = 0;
+
+    for (;;) {
+        bool done = atomic_load(&s_writer_done);
+        uint32_t lost = 0;
+        int n = result_ring_read_since(&s_ring, last, buf, 8, &lost);
+        stats->reads++;
+        stats->lost += lost;
+        uint32_t prev = last;
+        for (int i = 0; i < n; i++) {
+            if (!consistent(&buf[i])) {
+                FAIL("torn result at sequence %u", buf[i].sequence);
+            }
+            if (buf[i].sequence <= prev) {
+                FAIL("sequence went backwards: %u after %u", buf[i].sequence, prev);
+            }
+            prev = buf[i].sequence;
+        }
+        stats->results += n;
+        last += (uint32_t)n + lost;
+        if (n == 0 && lost == 0) {
+            sched_yield();  // Nothing new; let the writer run on small hosts
+        }
+        if (done && last >= s_num_results) {
+            break;
+        }
+    }
+
+    if (last != s_num_results || stats->results + stats->lost != s_num_results) {
+        FAIL("reader accounted for %llu + %llu lost of %u results",
+             (unsigned long long)stats->results, (unsigned long long)stats->lost, s_num_results);
+    }
+    return NULL;
+}
+
+static void *latest_reader(void *arg)
+{
+    reader_stats_t *stats = arg;
+    pose_result_t r;
+    uint32_t last = 0;
+
+    while (!atomic_load(&s_writer_done)) {
+        if (result_ring_latest(&s_ring, &r)) {
+            if (!consistent(&r)) {
+                FAIL("torn latest result at sequence %u", r.sequence);
+            }
+            if (r.sequence < last) {
+                FAIL("latest went backwards: %u after %u", r.sequence, last);
+            }
+            last = r.sequence;
+            stats->results++;
+        }
+        if (++stats->reads % 64 == 0) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief One writer against readers; half read-since, half latest
+ */
+static void run_concurrent(int readers, int pace, const char *label)
+{
+    result_ring_init(&s_ring);
+    atomic_store(&s_writer_done, false);
+
+    pthread_t *threads = calloc((size_t)readers + 1, sizeof(pthread_t));
+    reader_stats_t *stats = calloc((size_t)readers, sizeof(reader_stats_t));
+
+    double t0 = bench_now_s();
+    for (int i = 0; i < readers; i++) {
+        pthread_create(&threads[i + 1], NULL, i % 2 == 0 ? since_reader : latest_reader,
+                       &stats[i]);
+    }
+    pthread_create(&threads[0], NULL, writer, &pace);
+    for (int i = 0; i <= readers; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    double t1 = bench_now_s();
+
+    uint64_t since_results = 0, since_lost = 0, latest_results = 0;
+    for (int i = 0; i < readers; i++) {
+        if (i % 2 == 0) {
+            since_results += stats[i].results;
+            since_lost += stats[i].lost;
+        } else {
+            latest_results += stats[i].results;
+        }
+    }
+    int since_readers = (readers + 1) / 2;
+    printf("  %-8s %u results in %.2fs; read_since: %.1f%% delivered, %.1f%% lost; "
+           "latest: %llu reads\n",
+           label, s_num_results, t1 - t0,
+           100.0 * since_results / ((double)s_num_results * since_readers),
+           100.0 * since_lost / ((double)s_num_results * since_readers),
+           (unsigned long long)latest_results);
+
+    free(threads);
+    free(stats);
+}
+
+static void *spin_reader(void *arg)
+{
+    (void)arg;
+    pose_result_t r;
+    while (!atomic_load(&s_writer_done)) {
+        result_ring_latest(&s_ring, &r);
+    }
+    return NULL;
+}
+
+static void benchmark(int readers)
+{
+    const uint32_t iterations = 2000000;
+    pose_result_t r, buf[RESULT_RING_CAPACITY];
+    make_result(1, &r);
+
+    result_ring_init(&s_ring);
+    double t0 = bench_now_s();
+    for (uint32_t i = 0; i < iterations; i++) {
+        result_ring_publish(&s_ring, &r);
+    }
+    double t_publish = (bench_now_s() - t0) / iterations;
+
+    t0 = bench_now_s();
+    for (uint32_t i = 0; i < iterations; i++) {
+        result_ring_latest(&s_ring, &r);
+    }
+    double t_latest = (bench_now_s() - t0) / iterations;
+
+    uint32_t seq = result_ring_sequence(&s_ring);
+    t0 = bench_now_s();
+    for (uint32_t i = 0; i < iterations / RESULT_RING_CAPACITY; i++) {
+        result_ring_read_since(&s_ring, seq - RESULT_RING_CAPACITY, buf, RESULT_RING_CAPACITY, NULL);
+    }
+    double t_since = (bench_now_s() - t0) / iterations;
+
+    // Publish cost while readers hammer the latest slot
+    atomic_store(&s_writer_done, false);
+    pthread_t *threads = calloc((size_t)readers, sizeof(pthread_t));
+    for (int i = 0; i < readers; i++) {
+        pthread_create(&threads[i], NULL, spin_reader, NULL);
+    }
+    t0 = bench_now_s();
+    for (uint32_t i = 0; i < iterations; i++) {
+        result_ring_publish(&s_ring, &r);
+    }
+    double t_contended = (bench_now_s() - t0) / iterations;
+    atomic_store(&s_writer_done, true);
+    for (int i = 0; i < readers; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    free(threads);
+
+    printf("\nCost (%zu-byte result):\n", sizeof(pose_result_t));
+    printf("  publish:                    %6.1f ns\n", t_publish * 1e9);
+    printf("  publish, %d readers spinning: %6.1f ns\n", readers, t_contended * 1e9);
+    printf("  latest:                     %6.1f ns\n", t_latest * 1e9);
+    printf("  read_since, per result:     %6.1f ns\n", t_since * 1e9);
+}
+
+int main(int argc, char **argv)
+{
+    int readers = 4;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--readers") == 0 && i + 1 < argc) {
+            readers = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--results") == 0 && i + 1 < argc) {
+            s_num_results = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else {
+            fprintf(stderr, "Usage: %s [--readers N] [--results N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (readers < 1 || s_num_results == 0) {
+        fprintf(stderr, "Invalid arguments\n");
+        return 2;
+    }
+
+    printf("result_ring stress: 1 writer, %d readers, ring of %d\n", readers,
+           RESULT_RING_CAPACITY);
+    run_concurrent(readers, 0, "flat-out");
+    run_concurrent(readers, 1, "paced");
+    benchmark(readers);
+
+    int failures = bench_failures();
+    printf("\n%s\n", failures == 0 ? "PASS" : "FAILED");
+    return failures == 0 ? 0 : 1;
+}
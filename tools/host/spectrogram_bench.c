@@ -0,0 +1,291 @@
+/**
+ * @file spectrogram_bench.c
+ * @brief Sliding-DFT spectrogram (spectrogram.h) against an FFT per hop
+ *
+ * Feeds a synthetic CSI amplitude stream (a motion tone sweeping 0.5-8 Hz
+ * on every subcarrier, with noise and steps in level) through
+ * spectrogram.c, compiled unchanged from firmware/main, twice: with
+ * re-anchoring and without. Every hop it recomputes the same columns the
+ * usual way, a Hann-windowed radix-2 FFT of the last N samples of each
+ * selected subcarrier. Checks that:
+ *
+ *   - with re-anchoring every column matches the FFT over the whole run
+ *     (error relative to the column's peak below --tolerance)
+ *   - spectrogram_read() returns the last `columns` columns, oldest first
+ *
+ * and prints how far the column error drifts without re-anchoring. Then
+ * times both per sample for several hops. Exits non-zero if a check fails.
+ *
+ * Usage:
+ *   spectrogram_bench [--samples 360000] [--tolerance 1e-3]
+ */
+
+#include "bench_util.h"
+#include "spectrogram.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RATE_HZ 100
+#define INPUT_SUBCARRIERS 52
+#define DFT_LEN 128
+#define FIRST_BIN 1
+#define BINS 16
+#define SUBS 8
+#define HOP 5
+#define COLUMNS 20
+#define ANCHOR_INTERVAL 64
+#define COLUMN (SUBS * BINS)
+
+/**
+ * @brief One sample of every input subcarrier
+ */
+static void next_sample(uint32_t n, float *amplitude)
+{
+    // Tone sweeping 0.5 -> 8 Hz and back every 60 s; the level steps every 20 s
+    double t = (double)n / RATE_HZ;
+    double sweep = fmod(t, 60.0) / 30.0;
+    double freq = 0.5 + 7.5 * (sweep < 1.0 ? sweep : 2.0 - sweep);
+    static double phase = 0.0;
+    phase += 2.0 * M_PI * freq / RATE_HZ;
+    float level = 20.0f + 5.0f * (float)((n / (20 * RATE_HZ)) % 3);
+    for (int k = 0; k < INPUT_SUBCARRIERS; k++) {
+        amplitude[k] = level + 3.0f * (float)sin(phase + 0.2 * k) + (bench_uniform() - 0.5f);
+    }
+}
+
+/* ---- The usual way: Hann window and a radix-2 FFT of the last N samples ---- */
+
+typedef struct {
+    float cos_table[DFT_LEN / 2];
+    float sin_table[DFT_LEN / 2];
+    float hann[DFT_LEN];
+    int reverse[DFT_LEN];
+    float history[SUBS][DFT_LEN];
+    int pos;
+} fft_stft_t;
+
+static void fft_init(fft_stft_t *f)
+{
+    memset(f, 0, sizeof(*f));
+    for (int i = 0; i < DFT_LEN / 2; i++) {
+        f->cos_table[i] = cosf(2.0f * (float)M_PI * i / DFT_LEN);
+        f->sin_table[i] = sinf(2.0f * (float)M_PI * i / DFT_LEN);
+    }
+    for (int m = 0; m < DFT_LEN; m++) {
+        f->hann[m] = 0.5f - 0.5f * cosf(2.0f * (float)M_PI * m / DFT_LEN);
+        int r = 0;
+        for (int bit = 1, v = m; bit < DFT_LEN; bit <<= 1, v >>= 1) {
+            r = (r << 1) | (v & 1);
+        }
+        f->reverse[m] = r;
+    }
+}
+
+static void fft_push(fft_stft_t *f, const float *amplitude)
+{
+    for (int s = 0; s < SUBS; s++) {
+        f->history[s][f->pos] = amplitude[s * INPUT_SUBCARRIERS / SUBS];
+    }
+    f->pos = (f->pos + 1) % DFT_LEN;
+}
+
+/**
+ * @brief One spectrogram column: FFT of each subcarrier's last N samples
+ */
+static void fft_column(const fft_stft_t *f, float *column)
+{
+    float re[DFT_LEN], im[DFT_LEN];
+    for (int s = 0; s < SUBS; s++) {
+        for (int m = 0; m < DFT_LEN; m++) {
+            re[f->reverse[m]] = f->history[s][(f->pos + m) % DFT_LEN] * f->hann[m];
+            im[f->reverse[m]] = 0.0f;
+        }
+        for (int len = 2; len <= DFT_LEN; len <<= 1) {
+            int stride = DFT_LEN / len;
+            for (int i = 0; i < DFT_LEN; i += len) {
+                for (int j = 0; j < len / 2; j++) {
+                    float wr = f->cos_table[j * stride], wi = -f->sin_table[j * stride];
+                    float *ar = &re[i + j], *ai = &im[i + j];
+                    float *br = &re[i + j + len / 2], *bi = &im[i + j + len / 2];
+                    float tr = *br * wr - *bi * wi;
+                    float ti = *br * wi + *bi * wr;
+                    *br = *ar - tr;
+                    *bi = *ai - ti;
+                    *ar += tr;
+                    *ai += ti;
+                }
+            }
+        }
+        for (int k = 0; k < BINS; k++) {
+            int bin = FIRST_BIN + k;
+            column[s * BINS + k] = sqrtf(re[bin] * re[bin] + im[bin] * im[bin]) / DFT_LEN;
+        }
+    }
+}
+
+/**
+ * @brief Error of a column relative to the reference column's peak
+ */
+static float column_error(const float *column, const float *reference)
+{
+    float peak = 1e-6f, error = 0.0f;
+    for (int i = 0; i < COLUMN; i++) {
+        peak = fmaxf(peak, reference[i]);
+        error = fmaxf(error, fabsf(column[i] - reference[i]));
+    }
+    return error / peak;
+}
+
+static spectrogram_config_t make_config(int hop, int anchor_interval)
+{
+    spectrogram_config_t c = {
+        .dft_len = DFT_LEN,
+        .first_bin = FIRST_BIN,
+        .num_bins = BINS,
+        .num_subcarriers = SUBS,
+        .hop = hop,
+        .columns = COLUMNS,
+        .anchor_interval = anchor_interval,
+        .hann = true,
+    };
+    return c;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t samples = 360000;
+    float tolerance = 1e-3f;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--samples") == 0 && i + 1 < argc) {
+            samples = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) {
+            tolerance = strtof(argv[++i], NULL);
+        } else {
+            fprintf(stderr, "Usage: %s [--samples N] [--tolerance E]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (samples < 10 * DFT_LEN) {
+        fprintf(stderr, "At least %d samples\n", 10 * DFT_LEN);
+        return 2;
+    }
+
+    const size_t storage_bytes = SPECTROGRAM_STORAGE_BYTES(DFT_LEN, BINS, SUBS, COLUMNS);
+    static spectrogram_t anchored, drifting;
+    spectrogram_config_t config = make_config(HOP, ANCHOR_INTERVAL);
+    void *anchored_mem = malloc(storage_bytes);
+    void *drifting_mem = malloc(storage_bytes);
+    spectrogram_config_t no_anchor = make_config(HOP, 0);
+    spectrogram_config_t bad = config;
+    bad.first_bin = 0;
+    if (!spectrogram_init(&anchored, &config, anchored_mem) ||
+        !spectrogram_init(&drifting, &no_anchor, drifting_mem) ||
+        spectrogram_config_valid(&bad)) {
+        FAIL("configuration check");
+        return 1;
+    }
+
+    static fft_stft_t fft;
+    fft_init(&fft);
+    static float reference[COLUMNS][COLUMN];
+    static float ring[COLUMNS * COLUMN];
+    float amplitude[INPUT_SUBCARRIERS];
+    float column[COLUMN];
+    int written = 0;
+    float worst = 0.0f, drift_first = 0.0f, drift_last = 0.0f;
+    uint32_t drift_step = samples / 4;
+    bool ring_ok = true;
+
+    printf("N=%d, bins %d-%d (%.2f-%.2f Hz), %d subcarriers, hop %d, re-anchor every %d "
+           "samples, %zu bytes\n\n", DFT_LEN, FIRST_BIN, FIRST_BIN + BINS - 1,
+           (float)FIRST_BIN * RATE_HZ / DFT_LEN, (float)(FIRST_BIN + BINS - 1) * RATE_HZ / DFT_LEN,
+           SUBS, HOP, ANCHOR_INTERVAL, storage_bytes);
+    printf("  %10s %14s %16s\n", "samples", "anchored err", "no re-anchor err");
+    for (uint32_t n = 0; n < samples; n++) {
+        next_sample(n, amplitude);
+        fft_push(&fft, amplitude);
+        bool a = spectrogram_push(&anchored, amplitude, INPUT_SUBCARRIERS);
+        bool d = spectrogram_push(&drifting, amplitude, INPUT_SUBCARRIERS);
+        if (!a) {
+            continue;
+        }
+        float *ref = reference[written % COLUMNS];
+        fft_column(&fft, ref);
+        written++;
+
+        int last = (anchored.head + COLUMNS - 1) % COLUMNS;
+        float error = column_error(&anchored.ring[last * COLUMN], ref);
+        worst = fmaxf(worst, error);
+        if (d) {
+            float drift = column_error(&drifting.ring[((drifting.head + COLUMNS - 1) % COLUMNS) *
+                                                      COLUMN], ref);
+            drift_last = fmaxf(drift_last, drift);
+            if (n + 1 <= drift_step) {
+                drift_first = drift_last;
+            }
+            if ((n + 1) % drift_step < HOP) {
+                printf("  %10u %14.2e %16.2e\n", n + 1, worst, drift_last);
+            }
+        }
+
+        // Now and then, the whole ring against the last reference columns
+        if (written % 997 == 0) {
+            int count = spectrogram_read(&anchored, ring);
+            for (int i = 0; i < count; i++) {
+                int r = (written - count + i) % COLUMNS;
+                ring_ok &= column_error(&ring[i * COLUMN], reference[r]) <= tolerance;
+            }
+            ring_ok &= count == (written < COLUMNS ? written : COLUMNS);
+        }
+    }
+    printf("\nColumns %d, worst error %.2e with re-anchoring (%u re-anchors), %.2e without "
+           "(first quarter %.2e)\n", written, worst, anchored.anchors, drift_last, drift_first);
+    if (worst > tolerance) {
+        FAIL("column error %.2e above %.2e", worst, tolerance);
+    }
+    if (!ring_ok) {
+        FAIL("spectrogram_read() is not the last columns, oldest first");
+    }
+
+    // Cost per input sample: the sliding DFT works every sample, the FFT every hop
+    static const int hops[] = { 1, 2, 5, 10, 25 };
+    const uint32_t timed = 50000;
+    float checksum = 0.0f;
+    printf("\n  %4s %12s %12s %9s\n", "hop", "sliding ns", "FFT ns", "speedup");
+    for (size_t h = 0; h < sizeof(hops) / sizeof(hops[0]); h++) {
+        spectrogram_config_t c = make_config(hops[h], ANCHOR_INTERVAL);
+        spectrogram_init(&anchored, &c, anchored_mem);
+        fft_init(&fft);
+        static float input[1000][INPUT_SUBCARRIERS];
+        for (int i = 0; i < 1000; i++) {
+            next_sample(i, input[i]);
+        }
+
+        double t0 = bench_now_s();
+        for (uint32_t n = 0; n < timed; n++) {
+            spectrogram_push(&anchored, input[n % 1000], INPUT_SUBCARRIERS);
+        }
+        double sliding = (bench_now_s() - t0) * 1e9 / timed;
+
+        t0 = bench_now_s();
+        for (uint32_t n = 0; n < timed; n++) {
+            fft_push(&fft, input[n % 1000]);
+            if (n >= DFT_LEN && n % hops[h] == 0) {
+                fft_column(&fft, column);
+                checksum += column[0];
+            }
+        }
+        double per_hop = (bench_now_s() - t0) * 1e9 / timed;
+        printf("  %4d %12.0f %12.0f %8.2fx\n", hops[h], sliding, per_hop, per_hop / sliding);
+    }
+
+    printf("  (FFT columns sum %.1f)\n", checksum);
+
+    free(anchored_mem);
+    free(drifting_mem);
+    printf("\n%s\n", bench_failures() == 0 ? "PASS" : "FAILED");
+    return bench_failures() == 0 ? 0 : 1;
+}
@@ -0,0 +1,269 @@
+/**
+ * @file uv_map_bench.c
+ * @brief Encoded size and cost of coarse part/UV map records
+ *
+ * Renders synthetic 24x24 DensePose maps (stick figures of capsule-shaped
+ * body parts with U along and V across each part) and encodes them with
+ * uv_map.c, compiled unchanged from firmware/main:
+ *
+ *   empty      no one in the room
+ *   near       one person filling most of the map height
+ *   far        one smaller person
+ *   two        two people
+ *   speckle    one person plus 3% of pixels misclassified as random parts
+ *   worst      every pixel foreground, part changing every pixel
+ *
+ * For each scene it reports the mean and max record size, the mask encoding
+ * chosen and the encode / decode time, and checks that every record
+ * decodes back to the same map and fits one UDP datagram. Also times
+ * uv_map_decode_head() on the raw int8 head output. Exits non-zero if a
+ * check fails.
+ *
+ * Usage:
+ *   uv_map_bench [--frames 2000]
+ */
+
+#include "bench_util.h"
+#include "uv_map.h"
+#include "pose_record.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Largest UDP payload without IP fragmentation on a 1500-byte MTU
+#define UDP_MAX_PAYLOAD 1472
+
+#define RECORD_CAPACITY (POSE_RECORD_HEADER_BYTES + UV_MAP_MAX_PAYLOAD + POSE_RECORD_CRC_BYTES)
+
+/**
+ * @brief One body part: a capsule from (x0, y0) to (x1, y1) in person units
+ *        (0..1 across the height), DensePose part index
+ */
+typedef struct {
+    uint8_t part;
+    float x0, y0, x1, y1, radius;
+} limb_t;
+
+static const limb_t s_figure[] = {
+    { 1, 0.00f, 0.22f, 0.00f, 0.52f, 0.09f },    // Torso
+    { 23, 0.00f, 0.10f, 0.00f, 0.12f, 0.07f },   // Head
+    { 15, -0.10f, 0.24f, -0.16f, 0.40f, 0.04f }, // Upper arm left
+    { 16, 0.10f, 0.24f, 0.16f, 0.40f, 0.04f },   // Upper arm right
+    { 19, -0.16f, 0.40f, -0.18f, 0.56f, 0.035f },// Lower arm left
+    { 20, 0.16f, 0.40f, 0.18f, 0.56f, 0.035f },  // Lower arm right
+    { 8, -0.05f, 0.52f, -0.06f, 0.75f, 0.05f },  // Upper leg left
+    { 7, 0.05f, 0.52f, 0.06f, 0.75f, 0.05f },    // Upper leg right
+    { 12, -0.06f, 0.75f, -0.07f, 0.97f, 0.04f }, // Lower leg left
+    { 11, 0.06f, 0.75f, 0.07f, 0.97f, 0.04f },   // Lower leg right
+};
+
+static uint8_t to_level(float v)
+{
+    int level = (int)(fminf(fmaxf(v, 0.0f), 0.999f) * UV_MAP_UV_LEVELS);
+    return (uint8_t)level;
+}
+
+/**
+ * @brief Draw a person of the given height (pixels) with feet centered at (cx, bottom)
+ */
+static void draw_person(uv_map_t *map, float cx, float top, float height)
+{
+    for (size_t l = 0; l < sizeof(s_figure) / sizeof(s_figure[0]); l++) {
+        const limb_t *limb = &s_figure[l];
+        float ax = cx + limb->x0 * height, ay = top + limb->y0 * height;
+        float bx = cx + limb->x1 * height, by = top + limb->y1 * height;
+        float r = fmaxf(limb->radius * height, 0.6f);
+        float dx = bx - ax, dy = by - ay;
+        float len2 = fmaxf(dx * dx + dy * dy, 1e-6f);
+        for (int y = 0; y < UV_MAP_SIZE; y++) {
+            for (int x = 0; x < UV_MAP_SIZE; x++) {
+                float px = x + 0.5f - ax, py = y + 0.5f - ay;
+                float t = fminf(fmaxf((px * dx + py * dy) / len2, 0.0f), 1.0f);
+                float ex = px - t * dx, ey = py - t * dy;
+                float across = (ex * dy - ey * dx) / sqrtf(len2);
+                if (ex * ex + ey * ey <= r * r) {
+                    int i = y * UV_MAP_SIZE + x;
+                    map->part[i] = limb->part;
+                    map->u[i] = to_level(t);
+                    map->v[i] = to_level(0.5f + 0.5f * across / r);
+                }
+            }
+        }
+    }
+}
+
+typedef enum {
+    SCENE_EMPTY,
+    SCENE_NEAR,
+    SCENE_FAR,
+    SCENE_TWO,
+    SCENE_SPECKLE,
+    SCENE_WORST,
+    NUM_SCENES
+} scene_t;
+
+static const char *s_scene_names[NUM_SCENES] = {
+    "empty", "near", "far", "two", "speckle", "worst",
+};
+
+static void render(scene_t scene, uv_map_t *map)
+{
+    memset(map, 0, sizeof(*map));
+    switch (scene) {
+    case SCENE_EMPTY:
+        break;
+    case SCENE_NEAR:
+        draw_person(map, 6.0f + 12.0f * bench_uniform(), 1.0f + bench_uniform(), 20.0f + 2.0f * bench_uniform());
+        break;
+    case SCENE_FAR:
+        draw_person(map, 4.0f + 16.0f * bench_uniform(), 4.0f + 6.0f * bench_uniform(), 10.0f + 3.0f * bench_uniform());
+        break;
+    case SCENE_TWO:
+        draw_person(map, 3.0f + 7.0f * bench_uniform(), 2.0f + 3.0f * bench_uniform(), 16.0f + 3.0f * bench_uniform());
+        draw_person(map, 14.0f + 7.0f * bench_uniform(), 4.0f + 4.0f * bench_uniform(), 12.0f + 4.0f * bench_uniform());
+        break;
+    case SCENE_SPECKLE:
+        draw_person(map, 6.0f + 12.0f * bench_uniform(), 1.0f + bench_uniform(), 18.0f + 4.0f * bench_uniform());
+        for (int i = 0; i < UV_MAP_PIXELS; i++) {
+            if (bench_uniform() < 0.03f) {
+                map->part[i] = (uint8_t)(1 + (int)(bench_uniform() * UV_MAP_PARTS) % UV_MAP_PARTS);
+                map->u[i] = to_level(bench_uniform());
+                map->v[i] = to_level(bench_uniform());
+            }
+        }
+        break;
+    case SCENE_WORST:
+        for (int i = 0; i < UV_MAP_PIXELS; i++) {
+            map->part[i] = (uint8_t)(1 + i % UV_MAP_PARTS);
+            map->u[i] = to_level(bench_uniform());
+            map->v[i] = to_level(bench_uniform());
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+static int foreground(const uv_map_t *map)
+{
+    int n = 0;
+    for (int i = 0; i < UV_MAP_PIXELS; i++) {
+        n += map->part[i] != 0;
+    }
+    return n;
+}
+
+static void bench_scene(scene_t scene, int frames)
+{
+    uv_map_t *maps = malloc((size_t)frames * sizeof(uv_map_t));
+    for (int f = 0; f < frames; f++) {
+        render(scene, &maps[f]);
+    }
+
+    uint8_t record[RECORD_CAPACITY];
+    size_t total = 0, largest = 0;
+    long fg_total = 0;
+    int runs_chosen = 0;
+    double encode_s = 0.0, decode_s = 0.0;
+    for (int f = 0; f < frames; f++) {
+        double t0 = bench_now_s();
+        size_t len = uv_map_encode(&maps[f], (uint32_t)f, record, sizeof(record));
+        double t1 = bench_now_s();
+
+        pose_record_type_t type;
+        const uint8_t *payload;
+        size_t payload_len, consumed;
+        uv_map_t decoded;
+        uint32_t seq = 0;
+        double t2 = bench_now_s();
+        esp_err_t err = pose_record_parse(record, len, &type, &payload, &payload_len, &consumed);
+        if (err == ESP_OK) {
+            err = uv_map_decode(payload, payload_len, &decoded, &seq);
+        }
+        double t3 = bench_now_s();
+        encode_s += t1 - t0;
+        decode_s += t3 - t2;
+
+        if (len == 0 || err != ESP_OK || type != POSE_RECORD_TYPE_UV_MAP ||
+            seq != (uint32_t)f || memcmp(&decoded, &maps[f], sizeof(decoded)) != 0) {
+            FAIL("%s frame %d does not round-trip", s_scene_names[scene], f);
+            break;
+        }
+        if (len > UDP_MAX_PAYLOAD) {
+            FAIL("%s frame %d needs %zu bytes", s_scene_names[scene], f, len);
+        }
+        total += len;
+        largest = len > largest ? len : largest;
+        fg_total += foreground(&maps[f]);
+        runs_chosen += payload[5] == 1;
+    }
+
+    printf("  %-8s %8.1f %10.1f %8zu %8.0f%% %10.0f %10.0f\n", s_scene_names[scene],
+           (double)fg_total / frames, (double)total / frames, largest,
+           100.0 * runs_chosen / frames, encode_s / frames * 1e9, decode_s / frames * 1e9);
+    free(maps);
+}
+
+static void bench_decode_head(int frames)
+{
+    const size_t parts_len = (size_t)UV_MAP_PIXELS * (UV_MAP_PARTS + 1);
+    int8_t *parts = malloc(parts_len);
+    int8_t *uv = malloc(2 * UV_MAP_PIXELS);
+    for (size_t i = 0; i < parts_len; i++) {
+        parts[i] = (int8_t)(bench_uniform() * 256.0f - 128.0f);
+    }
+    for (int i = 0; i < 2 * UV_MAP_PIXELS; i++) {
+        uv[i] = (int8_t)(bench_uniform() * 256.0f - 128.0f);
+    }
+    uv_map_lut_t lut;
+    uv_map_lut_init(&lut, 1.0f / 256.0f, -128);
+    uv_map_t map;
+    int sink = 0;
+    double t0 = bench_now_s();
+    for (int f = 0; f < frames; f++) {
+        parts[f % parts_len] ^= 1;
+        sink += uv_map_decode_head(parts, uv, &lut, &map);
+    }
+    double us = (bench_now_s() - t0) / frames * 1e6;
+    printf("\nHead decode (argmax over %d classes x %d pixels): %.1f us per frame\n",
+           UV_MAP_PARTS + 1, UV_MAP_PIXELS, us);
+    if (sink < 0) {
+        printf("%d\n", sink);
+    }
+    free(parts);
+    free(uv);
+}
+
+int main(int argc, char **argv)
+{
+    int frames = 2000;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "Usage: %s [--frames N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (frames <= 0) {
+        fprintf(stderr, "Frames must be positive\n");
+        return 2;
+    }
+
+    printf("Part/UV map records (%dx%d, %d parts, %d-level U/V), %d frames per scene:\n",
+           UV_MAP_SIZE, UV_MAP_SIZE, UV_MAP_PARTS, UV_MAP_UV_LEVELS, frames);
+    printf("  %-8s %8s %10s %8s %9s %10s %10s\n", "scene", "fg px", "mean B", "max B",
+           "run mask", "encode ns", "decode ns");
+    for (int s = 0; s < NUM_SCENES; s++) {
+        bench_scene((scene_t)s, frames);
+    }
+    printf("\nUnencoded: uv_map_t %zu bytes, int8 head outputs %d bytes, one UDP datagram %d\n",
+           sizeof(uv_map_t), UV_MAP_PIXELS * (UV_MAP_PARTS + 3), UDP_MAX_PAYLOAD);
+
+    bench_decode_head(frames);
+
+    printf("\n%s\n", bench_failures() == 0 ? "PASS" : "FAILED");
+    return bench_failures() == 0 ? 0 : 1;
+}
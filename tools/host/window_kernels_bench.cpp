@@ -0,0 +1,245 @@
+/**
+ * @file window_kernels_bench.cpp
+ * @brief Templated window statistics with fixed versus runtime dimensions
+ *
+ * Times csi::window_stats() (firmware/main/csi_window_kernels.hpp) for each
+ * sample type and several window shapes, two ways:
+ *
+ *   runtime  RuntimeDims read from volatiles, so nothing is specialized
+ *   fixed    FixedDims<Samples, Subcarriers>, what the C shim uses
+ *
+ * next to the runtime-dimension C functions the templates stand in for
+ * (csi_window_stats() for float, csi_fixed_window_stats() for int16).
+ *
+ * Checks first that fixed and runtime give bit-identical statistics, that
+ * float and int16 match their C functions bit for bit, and that int8 is
+ * within a quantization step of the float statistics of the same samples.
+ * Exits non-zero if a check fails.
+ *
+ * Usage:
+ *   window_kernels_bench [--iterations 2000]
+ */
+
+#include "csi_fixed.h"
+#include "csi_window_kernels.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+int g_failures = 0;
+uint64_t g_rng = 0x9E3779B97F4A7C15ull;
+
+// Read at run time, so the runtime path cannot be specialized by the compiler
+volatile int g_num_samples = 0;
+volatile int g_num_subcarriers = 0;
+
+float next_uniform()
+{
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 7;
+    g_rng ^= g_rng << 17;
+    return (float)(g_rng >> 40) / (float)(1 << 24);
+}
+
+double now_s()
+{
+    using clock = std::chrono::steady_clock;
+    return std::chrono::duration<double>(clock::now().time_since_epoch()).count();
+}
+
+bool same_stats(const csi_window_stats_t &a, const csi_window_stats_t &b)
+{
+    return a.amplitude_mean == b.amplitude_mean && a.amplitude_std == b.amplitude_std &&
+           a.phase_variance == b.phase_variance && a.rssi_mean == b.rssi_mean;
+}
+
+void check(bool ok, const char *what, int samples, int subcarriers)
+{
+    if (!ok) {
+        std::fprintf(stderr, "FAIL: %s (%dx%d)\n", what, samples, subcarriers);
+        g_failures++;
+    }
+}
+
+/**
+ * @brief One window in every sample type
+ */
+struct Window {
+    std::vector<float> amp, phase;
+    std::vector<int16_t> amp_q, phase_q;
+    std::vector<int8_t> amp_i8, phase_i8;
+    std::vector<float> amp_i8f, phase_i8f;   // The int8 samples as float
+    std::vector<int8_t> rssi;
+
+    Window(int samples, int subcarriers)
+    {
+        const size_t len = (size_t)samples * subcarriers;
+        amp.resize(len);
+        phase.resize(len);
+        amp_q.resize(len);
+        phase_q.resize(len);
+        amp_i8.resize(len);
+        phase_i8.resize(len);
+        amp_i8f.resize(len);
+        phase_i8f.resize(len);
+        rssi.resize(samples);
+        for (size_t i = 0; i < len; i++) {
+            amp[i] = 20.0f + 40.0f * next_uniform();
+            phase[i] = (2.0f * next_uniform() - 1.0f) * (float)M_PI;
+        }
+        for (int t = 0; t < samples; t++) {
+            rssi[t] = (int8_t)(-60 - t % 7);
+        }
+        csi_fixed_from_float(amp.data(), phase.data(), (int)len, amp_q.data(), phase_q.data());
+        for (size_t i = 0; i < len; i++) {
+            long a = std::lround(amp[i]);
+            long p = std::lround(phase[i] / (float)M_PI * 128.0f);
+            amp_i8[i] = (int8_t)(a > 127 ? 127 : a);
+            phase_i8[i] = (int8_t)(p > 127 ? 127 : p < -128 ? -128 : p);
+            amp_i8f[i] = amp_i8[i];
+            phase_i8f[i] = phase_i8[i] * ((float)M_PI / 128.0f);
+        }
+    }
+};
+
+/**
+ * @brief Nanoseconds per call of fn
+ */
+template <typename Fn>
+double time_ns(int iterations, Fn fn)
+{
+    float sink = 0.0f;
+    double t0 = now_s();
+    for (int i = 0; i < iterations; i++) {
+        sink += fn();
+    }
+    double ns = (now_s() - t0) * 1e9 / iterations;
+    if (std::isnan(sink)) {
+        std::printf("%f\n", sink);
+    }
+    return ns;
+}
+
+void print_row(const char *type, double runtime_ns, double fixed_ns, double c_ns)
+{
+    if (c_ns > 0.0) {
+        std::printf("  %-6s %10.0f %10.0f %10.0f %8.2fx\n", type, c_ns, runtime_ns, fixed_ns,
+                    runtime_ns / fixed_ns);
+    } else {
+        std::printf("  %-6s %10s %10.0f %10.0f %8.2fx\n", type, "-", runtime_ns, fixed_ns,
+                    runtime_ns / fixed_ns);
+    }
+}
+
+template <int Samples, int Subcarriers>
+void run_shape(int iterations)
+{
+    using Dims = csi::FixedDims<Samples, Subcarriers>;
+    g_num_samples = Samples;
+    g_num_subcarriers = Subcarriers;
+    const csi::RuntimeDims runtime{g_num_samples, g_num_subcarriers};
+    Window w(Samples, Subcarriers);
+    const int8_t *rssi = w.rssi.data();
+
+    // Equivalence
+    csi_window_stats_t c, fixed, rt, ref;
+    csi_window_stats(w.amp.data(), w.phase.data(), rssi, Samples, Subcarriers, &c);
+    csi::window_stats(Dims{}, w.amp.data(), w.phase.data(), rssi, &fixed);
+    csi::window_stats(runtime, w.amp.data(), w.phase.data(), rssi, &rt);
+    check(same_stats(fixed, rt), "float fixed != runtime", Samples, Subcarriers);
+    check(same_stats(fixed, c), "float != csi_window_stats()", Samples, Subcarriers);
+
+    csi_fixed_window_stats(w.amp_q.data(), w.phase_q.data(), rssi, Samples, Subcarriers, &c);
+    csi::window_stats(Dims{}, w.amp_q.data(), w.phase_q.data(), rssi, &fixed);
+    csi::window_stats(runtime, w.amp_q.data(), w.phase_q.data(), rssi, &rt);
+    check(same_stats(fixed, rt), "int16 fixed != runtime", Samples, Subcarriers);
+    check(same_stats(fixed, c), "int16 != csi_fixed_window_stats()", Samples, Subcarriers);
+
+    csi_window_stats(w.amp_i8f.data(), w.phase_i8f.data(), rssi, Samples, Subcarriers, &ref);
+    csi::window_stats(Dims{}, w.amp_i8.data(), w.phase_i8.data(), rssi, &fixed);
+    csi::window_stats(runtime, w.amp_i8.data(), w.phase_i8.data(), rssi, &rt);
+    check(same_stats(fixed, rt), "int8 fixed != runtime", Samples, Subcarriers);
+    check(std::fabs(fixed.amplitude_mean - ref.amplitude_mean) <= 1e-3f &&
+          std::fabs(fixed.amplitude_std - ref.amplitude_std) <= 1e-3f * ref.amplitude_std &&
+          std::fabs(fixed.phase_variance - ref.phase_variance) <= (float)M_PI / 128.0f,
+          "int8 differs from float", Samples, Subcarriers);
+
+    // Cost
+    csi_window_stats_t s;
+    std::printf("%dx%d window:\n", Samples, Subcarriers);
+    std::printf("  %-6s %10s %10s %10s %9s\n", "type", "C ns", "runtime ns", "fixed ns",
+                "speedup");
+    print_row("float",
+              time_ns(iterations, [&] {
+                  csi::window_stats(runtime, w.amp.data(), w.phase.data(), rssi, &s);
+                  return s.amplitude_std;
+              }),
+              time_ns(iterations, [&] {
+                  csi::window_stats(Dims{}, w.amp.data(), w.phase.data(), rssi, &s);
+                  return s.amplitude_std;
+              }),
+              time_ns(iterations, [&] {
+                  csi_window_stats(w.amp.data(), w.phase.data(), rssi, g_num_samples,
+                                   g_num_subcarriers, &s);
+                  return s.amplitude_std;
+              }));
+    print_row("int16",
+              time_ns(iterations, [&] {
+                  csi::window_stats(runtime, w.amp_q.data(), w.phase_q.data(), rssi, &s);
+                  return s.amplitude_std;
+              }),
+              time_ns(iterations, [&] {
+                  csi::window_stats(Dims{}, w.amp_q.data(), w.phase_q.data(), rssi, &s);
+                  return s.amplitude_std;
+              }),
+              time_ns(iterations, [&] {
+                  csi_fixed_window_stats(w.amp_q.data(), w.phase_q.data(), rssi, g_num_samples,
+                                         g_num_subcarriers, &s);
+                  return s.amplitude_std;
+              }));
+    print_row("int8",
+              time_ns(iterations, [&] {
+                  csi::window_stats(runtime, w.amp_i8.data(), w.phase_i8.data(), rssi, &s);
+                  return s.amplitude_std;
+              }),
+              time_ns(iterations, [&] {
+                  csi::window_stats(Dims{}, w.amp_i8.data(), w.phase_i8.data(), rssi, &s);
+                  return s.amplitude_std;
+              }),
+              0.0);
+}
+
+}  // namespace
+
+int main(int argc, char **argv)
+{
+    int iterations = 2000;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = std::atoi(argv[++i]);
+        } else {
+            std::fprintf(stderr, "Usage: %s [--iterations N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (iterations <= 0) {
+        std::fprintf(stderr, "Iterations must be positive\n");
+        return 2;
+    }
+
+    // The shapes of the dims_matrix sets
+    run_shape<50, 52>(iterations);
+    run_shape<50, 64>(iterations);
+    run_shape<100, 52>(iterations);
+    run_shape<25, 32>(iterations);
+    run_shape<100, 64>(iterations);
+
+    std::printf("\n%s\n", g_failures == 0 ? "PASS" : "FAILED");
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,277 @@
+/**
+ * @file zone_bench.c
+ * @brief Lookup time versus table size and accuracy of zone localization
+ *
+ * Simulates a 6 m x 6 m room with one receiver and --links transmitters
+ * around the walls, split into a 4 x 4 zone grid. A person at p disturbs
+ * link l in proportion to how close p is to the link's path:
+ *
+ *   E_l = gain_l * activity * (0.05 + exp(-d_l(p)^2 / (2 * 0.6 m^2))) * noise_l
+ *
+ * with activity (how much the person moves) shared by all links and noise_l
+ * independent per link, both log-normal. Calibration tables of growing size
+ * are recorded at random positions in every zone, ordered with
+ * zone_table_index() and searched with zone_locate() (zone_locator.c,
+ * compiled unchanged from firmware/main). Queries at fresh random
+ * positions are checked against an exhaustive search (same k nearest
+ * distances) and scored against the true zone.
+ *
+ * Reports, per table size: index build time, k-d and exhaustive lookup
+ * time, entries visited, exact and adjacent-zone accuracy. Exits non-zero
+ * if the k-d search disagrees with the exhaustive search, a table fails
+ * zone_table_valid(), or accuracy of the largest table is below
+ * --min-accuracy.
+ *
+ * Usage:
+ *   zone_bench [--links 6] [--k 5] [--queries 5000] [--min-accuracy 0.65]
+ */
+
+#include "bench_util.h"
+#include "zone_locator.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ROOM_M 6.0f
+#define GRID 4
+#define ZONE_M (ROOM_M / GRID)
+
+// Width of the region around a link path where motion disturbs it
+#define LINK_SIGMA_M 0.6f
+// Log-normal spread of how much the person moves, and of per-link noise
+#define ACTIVITY_SIGMA 0.5f
+#define LINK_NOISE_SIGMA 0.25f
+
+/**
+ * @brief Transmitter-to-receiver path
+ */
+typedef struct {
+    float x0, y0, x1, y1;
+    float gain;
+} link_t;
+
+static link_t s_links[ZONE_MAX_LINKS];
+static int s_num_links = 6;
+
+/**
+ * @brief Receiver at the middle of the bottom wall, transmitters spread
+ *        along the other three walls
+ */
+static void place_links(int num_links)
+{
+    for (int l = 0; l < num_links; l++) {
+        // Perimeter position from the bottom-right corner, anticlockwise
+        float t = 3.0f * ROOM_M * (l + 0.5f) / num_links;
+        float x, y;
+        if (t < ROOM_M) {
+            x = ROOM_M;
+            y = t;
+        } else if (t < 2.0f * ROOM_M) {
+            x = 2.0f * ROOM_M - t;
+            y = ROOM_M;
+        } else {
+            x = 0.0f;
+            y = 3.0f * ROOM_M - t;
+        }
+        s_links[l] = (link_t){ x, y, ROOM_M / 2.0f, 0.0f, 0.5f + bench_uniform() };
+    }
+}
+
+static float distance_to_link(const link_t *link, float px, float py)
+{
+    float dx = link->x1 - link->x0, dy = link->y1 - link->y0;
+    float t = ((px - link->x0) * dx + (py - link->y0) * dy) / (dx * dx + dy * dy);
+    t = fminf(fmaxf(t, 0.0f), 1.0f);
+    float ex = link->x0 + t * dx - px, ey = link->y0 + t * dy - py;
+    return sqrtf(ex * ex + ey * ey);
+}
+
+/**
+ * @brief Fingerprint of a person moving at (px, py)
+ */
+static void fingerprint(float px, float py, uint8_t *energy)
+{
+    float activity = expf(ACTIVITY_SIGMA * bench_gaussian());
+    for (int l = 0; l < s_num_links; l++) {
+        float d = distance_to_link(&s_links[l], px, py);
+        float e = s_links[l].gain * activity *
+                  (0.05f + expf(-d * d / (2.0f * LINK_SIGMA_M * LINK_SIGMA_M)));
+        energy[l] = zone_energy_quantize(e * expf(LINK_NOISE_SIGMA * bench_gaussian()));
+    }
+}
+
+static int zone_of(float px, float py)
+{
+    int col = (int)(px / ZONE_M), row = (int)(py / ZONE_M);
+    col = col < GRID ? col : GRID - 1;
+    row = row < GRID ? row : GRID - 1;
+    return row * GRID + col;
+}
+
+/**
+ * @brief Reference: k nearest distances by exhaustive search, ascending
+ */
+static int brute_force(const zone_table_t *table, const uint8_t *query, int k, uint32_t *dist)
+{
+    int found = 0;
+    for (int i = 0; i < table->count; i++) {
+        uint32_t d = 0;
+        for (int l = 0; l < table->num_links; l++) {
+            int diff = (int)query[l] - table->entries[i].energy[l];
+            d += (uint32_t)(diff * diff);
+        }
+        if (found == k && d >= dist[k - 1]) {
+            continue;
+        }
+        int pos = found < k ? found++ : k - 1;
+        for (; pos > 0 && dist[pos - 1] > d; pos--) {
+            dist[pos] = dist[pos - 1];
+        }
+        dist[pos] = d;
+    }
+    return found;
+}
+
+static void bench_size(int per_zone, int k, const float *qx, const float *qy,
+                       const uint8_t *queries, int num_queries, double *last_accuracy)
+{
+    const int zones = GRID * GRID;
+    int count = per_zone * zones;
+    if (count > ZONE_MAX_ENTRIES) {
+        count = ZONE_MAX_ENTRIES;
+    }
+    zone_fingerprint_t *entries = calloc((size_t)count, sizeof(zone_fingerprint_t));
+    for (int i = 0; i < count; i++) {
+        int zone = i % zones;
+        float px = (zone % GRID + bench_uniform()) * ZONE_M;
+        float py = (zone / GRID + bench_uniform()) * ZONE_M;
+        fingerprint(px, py, entries[i].energy);
+        entries[i].zone = (uint8_t)zone;
+    }
+
+    double t0 = bench_now_s();
+    zone_table_index(entries, count, s_num_links);
+    double build_ms = (bench_now_s() - t0) * 1e3;
+
+    zone_table_t table = {
+        .entries = entries,
+        .count = (uint16_t)count,
+        .num_links = (uint8_t)s_num_links,
+        .grid_cols = GRID,
+        .grid_rows = GRID,
+    };
+    if (!zone_table_valid(&table)) {
+        FAIL("table of %d entries not in k-d order", count);
+    }
+
+    // k-d lookups, timed on their own
+    zone_estimate_t *est = malloc((size_t)num_queries * sizeof(zone_estimate_t));
+    t0 = bench_now_s();
+    for (int q = 0; q < num_queries; q++) {
+        zone_locate(&table, &queries[q * ZONE_MAX_LINKS], k, &est[q]);
+    }
+    double kd_us = (bench_now_s() - t0) / num_queries * 1e6;
+
+    // Exhaustive lookups, timed on their own
+    uint32_t *ref = malloc((size_t)num_queries * ZONE_MAX_K * sizeof(uint32_t));
+    t0 = bench_now_s();
+    for (int q = 0; q < num_queries; q++) {
+        brute_force(&table, &queries[q * ZONE_MAX_LINKS], k, &ref[q * ZONE_MAX_K]);
+    }
+    double brute_us = (bench_now_s() - t0) / num_queries * 1e6;
+
+    // The k-d search must find the same k nearest distances (entries at
+    // equal distance may differ)
+    long exact = 0, adjacent = 0, visited = 0;
+    int mismatches = 0;
+    for (int q = 0; q < num_queries; q++) {
+        uint16_t index[ZONE_MAX_K];
+        uint32_t dist[ZONE_MAX_K];
+        int found = zone_table_nearest(&table, &queries[q * ZONE_MAX_LINKS], k, index, dist, NULL);
+        if (found != (count < k ? count : k) ||
+            memcmp(dist, &ref[q * ZONE_MAX_K], found * sizeof(uint32_t)) != 0) {
+            mismatches++;
+        }
+
+        int truth = zone_of(qx[q], qy[q]);
+        int z = est[q].zone;
+        exact += z == truth;
+        adjacent += z >= 0 && abs(z % GRID - truth % GRID) <= 1 && abs(z / GRID - truth / GRID) <= 1;
+        visited += est[q].visited;
+    }
+    if (mismatches > 0) {
+        FAIL("%d of %d lookups differ from exhaustive search (%d entries)", mismatches, num_queries,
+             count);
+    }
+
+    *last_accuracy = (double)exact / num_queries;
+    printf("  %8d %8zu %9.2f %9.2f %9.2f %7.1fx %9.1f %8.3f %8.3f\n", count,
+           (size_t)count * sizeof(zone_fingerprint_t), build_ms, kd_us, brute_us,
+           kd_us > 0.0 ? brute_us / kd_us : 0.0, (double)visited / num_queries,
+           *last_accuracy, (double)adjacent / num_queries);
+
+    free(ref);
+    free(est);
+    free(entries);
+}
+
+int main(int argc, char **argv)
+{
+    int k = 5;
+    int num_queries = 5000;
+    double min_accuracy = 0.65;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--links") == 0 && i + 1 < argc) {
+            s_num_links = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--k") == 0 && i + 1 < argc) {
+            k = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--queries") == 0 && i + 1 < argc) {
+            num_queries = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--min-accuracy") == 0 && i + 1 < argc) {
+            min_accuracy = atof(argv[++i]);
+        } else {
+            fprintf(stderr, "Usage: %s [--links N] [--k N] [--queries N] [--min-accuracy A]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+    if (s_num_links < 1 || s_num_links > ZONE_MAX_LINKS || k < 1 || k > ZONE_MAX_K ||
+        num_queries <= 0) {
+        fprintf(stderr, "Links must be 1-%d, k 1-%d, queries positive\n", ZONE_MAX_LINKS,
+                ZONE_MAX_K);
+        return 2;
+    }
+
+    place_links(s_num_links);
+
+    float *qx = malloc((size_t)num_queries * sizeof(float));
+    float *qy = malloc((size_t)num_queries * sizeof(float));
+    uint8_t *queries = calloc((size_t)num_queries, ZONE_MAX_LINKS);
+    for (int q = 0; q < num_queries; q++) {
+        qx[q] = bench_uniform() * ROOM_M;
+        qy[q] = bench_uniform() * ROOM_M;
+        fingerprint(qx[q], qy[q], &queries[q * ZONE_MAX_LINKS]);
+    }
+
+    printf("Zone lookup, %d links, %dx%d zones, k=%d, %d queries:\n", s_num_links, GRID, GRID, k,
+           num_queries);
+    printf("  %8s %8s %9s %9s %9s %8s %9s %8s %8s\n", "entries", "bytes", "index ms", "k-d us",
+           "scan us", "speedup", "visited", "exact", "adjacent");
+    static const int per_zone[] = { 4, 16, 64, 256, 1024, 4096 };
+    double accuracy = 0.0;
+    for (size_t i = 0; i < sizeof(per_zone) / sizeof(per_zone[0]); i++) {
+        bench_size(per_zone[i], k, qx, qy, queries, num_queries, &accuracy);
+    }
+    if (accuracy < min_accuracy) {
+        FAIL("accuracy %.3f with the largest table, expected at least %.3f", accuracy,
+             min_accuracy);
+    }
+
+    free(qx);
+    free(qy);
+    free(queries);
+    printf("\n%s\n", bench_failures() == 0 ? "PASS" : "FAILED");
+    return bench_failures() == 0 ? 0 : 1;
+}
@@ -0,0 +1,325 @@
+#!/usr/bin/env -S uv run --with pyserial --script
+"""
+Binary Pose Record Decoder
+
+Decodes the framed binary pose records the firmware writes with
+CONFIG_POSE_BINARY_RECORDS (layout in firmware/main/pose_record.h), and the
+coarse DensePose part/UV map records (firmware/main/uv_map.h) and the
+fall/sudden-motion event records (firmware/main/event_detector.h). Records
+share the serial stream with log text and JSON lines; they are found by
+their sync bytes and accepted only if the CRC matches.
+
+Usage:
+    python3 pose_record.py /dev/ttyUSB0           # live from the device
+    python3 pose_record.py capture.bin            # raw serial capture
+    python3 pose_record.py capture.bin --jsonl records.jsonl
+    python3 pose_record.py capture.bin --show-maps          # part maps as text
+    python3 pose_record.py capture.bin --render-dir maps/   # part/U/V images
+"""
+
+import sys
+import json
+import struct
+import argparse
+from pathlib import Path
+
+SYNC = b'\xa5\x5a'
+VERSION = 2
+TYPE_POSE = 1
+TYPE_UV_MAP = 2
+TYPE_EVENT = 3
+
+HEADER_BYTES = 6
+CRC_BYTES = 2
+POSE_BYTES = 18
+KEYPOINT_BYTES = 5
+NUM_KEYPOINTS = 17
+MAX_PAYLOAD = 1464  # POSE_RECORD_MAX_PAYLOAD
+
+UV_MAP_SIZE = 24
+UV_MAP_PARTS = 24
+UV_LEVELS = 32
+SHORT_RUN = 128
+
+# One character per DensePose part for --show-maps ('.' = background)
+PART_CHARS = '.TtRLlrAaBbCcDdEeFfGgHhIi'
+
+POSE_NAMES = ['empty', 'present', 'moving', 'walking', 'sitting', 'standing']
+
+# motion_event_type_t
+EVENT_NAMES = {1: 'sudden', 2: 'fall'}
+
+# COCO order, as pose_keypoint_t
+KEYPOINT_NAMES = [
+    'nose', 'left_eye', 'right_eye', 'left_ear', 'right_ear',
+    'left_shoulder', 'right_shoulder', 'left_elbow', 'right_elbow',
+    'left_wrist', 'right_wrist', 'left_hip', 'right_hip',
+    'left_knee', 'right_knee', 'left_ankle', 'right_ankle',
+]
+
+
+def crc16(data):
+    """CRC-16/CCITT-FALSE, as pose_record_crc16()"""
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def decode_pose(payload):
+    """Decode a pose payload into a dict (coordinates and scores as floats)"""
+    seq, ts, pose_class, flags, conf, motion, bpm, bq, count, people, people_conf = \
+        struct.unpack_from('<IIBBBBHBBBB', payload)
+    record = {
+        'type': 'pose',
+        'seq': seq,
+        'ts': ts,
+        'pose_class': pose_class,
+        'pose': POSE_NAMES[pose_class] if pose_class < len(POSE_NAMES) else 'unknown',
+        'detected': bool(flags & 0x01),
+        'confidence': conf / 255.0,
+        'motion': motion / 255.0,
+        'breathing_bpm': bpm / 10.0,
+        'breathing_quality': bq / 255.0,
+        'people': people,
+        'people_confidence': people_conf / 255.0,
+    }
+    if count:
+        keypoints = []
+        for k in range(count):
+            x, y, c = struct.unpack_from('<HHB', payload, POSE_BYTES + k * KEYPOINT_BYTES)
+            keypoints.append([x / 65535.0, y / 65535.0, c / 255.0])
+        record['keypoints'] = keypoints
+    return record
+
+
+def decode_event(payload):
+    """Decode a fall/sudden-motion event payload into a dict"""
+    event_id, ts, etype, rise, score = struct.unpack_from('<IIBBH', payload)
+    return {
+        'type': 'event',
+        'id': event_id,
+        'ts': ts,
+        'event': EVENT_NAMES.get(etype, 'unknown'),
+        'rise_db': rise / 2.0,
+        'score': score / 10.0,
+    }
+
+
+def decode_uv_map(payload):
+    """
+    Decode a part/UV map payload.
+
+    Returns a dict with 'seq' and 'part', 'u', 'v' as UV_MAP_SIZE x
+    UV_MAP_SIZE lists (part 0 = background; U/V in [0, 1], 0 on background).
+    """
+    seq, size, encoding, count = struct.unpack_from('<IBBH', payload)
+    if size != UV_MAP_SIZE:
+        raise ValueError(f'unsupported map size {size}')
+    pixels = size * size
+    pos = 8
+
+    mask = [False] * pixels
+    if encoding == 1:
+        pixel, fg = 0, False
+        while pixel < pixels:
+            run = payload[pos]
+            pos += 1
+            if run >= SHORT_RUN:
+                run = ((run & 0x7F) << 8) | payload[pos]
+                pos += 1
+            if fg:
+                mask[pixel:pixel + run] = [True] * run
+            pixel += run
+            fg = not fg
+    else:
+        for i in range(pixels):
+            mask[i] = bool((payload[pos + (i >> 3)] >> (i & 7)) & 1)
+        pos += (pixels + 7) // 8
+
+    part = [0] * pixels
+    u = [0.0] * pixels
+    v = [0.0] * pixels
+    seen = 0
+    for i in range(pixels):
+        if mask[i]:
+            (packed,) = struct.unpack_from('<H', payload, pos + 2 * seen)
+            seen += 1
+            part[i] = packed & 0x1F
+            u[i] = ((packed >> 5) & 0x1F) / (UV_LEVELS - 1)
+            v[i] = ((packed >> 10) & 0x1F) / (UV_LEVELS - 1)
+    if seen != count:
+        raise ValueError('foreground count mismatch')
+
+    def rows(values):
+        return [values[r * size:(r + 1) * size] for r in range(size)]
+
+    return {'seq': seq, 'type': 'uv_map', 'foreground': count,
+            'part': rows(part), 'u': rows(u), 'v': rows(v)}
+
+
+def map_as_text(record):
+    """Part map as text, one character per pixel"""
+    return '\n'.join(''.join(PART_CHARS[p] if p < len(PART_CHARS) else '?' for p in row)
+                     for row in record['part'])
+
+
+def render_map(record, path):
+    """Save part index, U and V side by side as an image"""
+    import numpy as np
+    import matplotlib
+    matplotlib.use('Agg')
+    import matplotlib.pyplot as plt
+
+    part = np.asarray(record['part'], dtype=float)
+    fg = part > 0
+    fig, axes = plt.subplots(1, 3, figsize=(9, 3.2))
+    panels = [
+        ('part', np.where(fg, part, np.nan), 'tab20', (1, UV_MAP_PARTS)),
+        ('U', np.where(fg, record['u'], np.nan), 'viridis', (0, 1)),
+        ('V', np.where(fg, record['v'], np.nan), 'viridis', (0, 1)),
+    ]
+    for ax, (title, image, cmap, (lo, hi)) in zip(axes, panels):
+        ax.imshow(image, cmap=cmap, vmin=lo, vmax=hi, interpolation='nearest')
+        ax.set_title(title)
+        ax.set_xticks([])
+        ax.set_yticks([])
+    fig.suptitle(f"UV map #{record['seq']} ({record['foreground']} px)")
+    fig.tight_layout()
+    fig.savefig(path, dpi=100)
+    plt.close(fig)
+
+
+class RecordScanner:
+    """
+    Pick records out of a byte stream.
+
+    Feed arbitrary chunks; complete records are returned as they become
+    available. Bytes that are not part of a valid record are skipped.
+    """
+
+    def __init__(self):
+        self.buffer = bytearray()
+        self.crc_errors = 0
+
+    def feed(self, data):
+        self.buffer.extend(data)
+        records = []
+        while True:
+            start = self.buffer.find(SYNC)
+            if start < 0:
+                # Keep a trailing first sync byte
+                del self.buffer[:max(len(self.buffer) - 1, 0)]
+                return records
+            del self.buffer[:start]
+            if len(self.buffer) < HEADER_BYTES:
+                return records
+
+            version, rtype, length = struct.unpack_from('<BBH', self.buffer, 2)
+            if length > MAX_PAYLOAD:
+                del self.buffer[:1]  # Sync bytes inside other data
+                continue
+            size = HEADER_BYTES + length + CRC_BYTES
+            if len(self.buffer) < size:
+                return records
+
+            frame = bytes(self.buffer[:size])
+            (crc,) = struct.unpack_from('<H', frame, size - CRC_BYTES)
+            if crc != crc16(frame[:-CRC_BYTES]):
+                self.crc_errors += 1
+                del self.buffer[:1]
+                continue
+            del self.buffer[:size]
+            if version != VERSION:
+                continue
+            if rtype == TYPE_POSE:
+                records.append(decode_pose(frame[HEADER_BYTES:-CRC_BYTES]))
+            elif rtype == TYPE_EVENT:
+                try:
+                    records.append(decode_event(frame[HEADER_BYTES:-CRC_BYTES]))
+                except struct.error:
+                    self.crc_errors += 1
+            elif rtype == TYPE_UV_MAP:
+                try:
+                    records.append(decode_uv_map(frame[HEADER_BYTES:-CRC_BYTES]))
+                except (ValueError, IndexError, struct.error):
+                    self.crc_errors += 1
+
+
+def open_source(path, baud):
+    """Serial port or file, as a readable binary stream"""
+    if Path(path).is_file():
+        return open(path, 'rb')
+    import serial
+    return serial.Serial(path, baud, timeout=1)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode binary pose records from the ESP32')
+    parser.add_argument('source', help='Serial port or raw capture file')
+    parser.add_argument('-b', '--baud', type=int, default=115200, help='Baud rate (default: 115200)')
+    parser.add_argument('--jsonl', help='Also write decoded records to this JSONL file')
+    parser.add_argument('--show-maps', action='store_true', help='Print part/UV maps as text')
+    parser.add_argument('--render-dir', help='Save part/UV maps as PNG images in this directory')
+    args = parser.parse_args()
+
+    if args.render_dir:
+        try:
+            import matplotlib  # noqa: F401
+            import numpy  # noqa: F401
+        except ImportError:
+            print("✗ --render-dir needs numpy and matplotlib")
+            sys.exit(1)
+        Path(args.render_dir).mkdir(parents=True, exist_ok=True)
+
+    from_file = Path(args.source).is_file()
+    try:
+        stream = open_source(args.source, args.baud)
+    except Exception as e:
+        print(f"✗ Cannot open {args.source}: {e}")
+        sys.exit(1)
+
+    out = open(args.jsonl, 'w') if args.jsonl else None
+    scanner = RecordScanner()
+    count = 0
+    try:
+        while True:
+            chunk = stream.read(4096)
+            if not chunk:
+                if from_file:
+                    break
+                continue  # Serial read timeout
+            for record in scanner.feed(chunk):
+                count += 1
+                if out:
+                    out.write(json.dumps(record) + '\n')
+                if record.get('type') == 'event':
+                    print(f"!! ts={record['ts']:8d}ms | event #{record['id']} {record['event']} "
+                          f"(score {record['score']:.1f}, rise {record['rise_db']:.1f} dB)")
+                    continue
+                if record.get('type') == 'uv_map':
+                    print(f"#{record['seq']:6d} UV map | {record['foreground']} foreground px")
+                    if args.show_maps:
+                        print(map_as_text(record))
+                    if args.render_dir:
+                        render_map(record, Path(args.render_dir) / f"uv_map_{record['seq']:06d}.png")
+                    continue
+                skeleton = f" | {len(record['keypoints'])} keypoints" if 'keypoints' in record else ''
+                print(f"#{record['seq']:6d} ts={record['ts']:8d}ms | {record['pose']:8s} "
+                      f"conf={record['confidence']:.2f} motion={record['motion']:.2f} "
+                      f"people={record['people']}{skeleton}")
+    except KeyboardInterrupt:
+        pass
+    finally:
+        stream.close()
+        if out:
+            out.close()
+
+    print(f"\n✓ {count} records ({scanner.crc_errors} CRC errors)")
+
+
+if __name__ == '__main__':
+    main()
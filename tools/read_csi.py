@@ -55,6 +55,12 @@ def main():
                 # Parse JSON
                 data = json.loads(line)
 
+                # Memory alerts from the firmware's mem_metrics module
+                if 'mem_alert' in data:
+                    print(f"!! Memory alert: {data['name']} {data['mem_alert']} = "
+                          f"{data['value']} bytes (threshold {data['threshold']})")
+                    continue
+
                 # Validate expected fields
                 if 'ts' not in data or 'rssi' not in data or 'amp' not in data:
                     continue
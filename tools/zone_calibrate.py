@@ -0,0 +1,218 @@
+#!/usr/bin/env -S uv run --with pyserial --script
+"""
+Zone Calibration Table Builder
+
+Builds firmware/main/zone_calibration.h, the fingerprint table the firmware
+uses to localize motion to a zone of a grid (firmware/main/zone_locator.h).
+
+1. Flash with "Localize motion to zones" enabled and the placeholder table.
+   The device then prints one {"zone_energy":[...],"macs":[...]} line per
+   window: the per-link motion energies of the transmitters it hears.
+2. For each zone of the grid (row-major, 0 = first row, first column),
+   have someone move around inside the zone and capture its fingerprints.
+3. Build the header and reflash.
+
+Usage:
+    python3 zone_calibrate.py capture /dev/ttyUSB0 --zone 0 --seconds 60 --output calib.jsonl
+    python3 zone_calibrate.py capture /dev/ttyUSB0 --zone 1 --seconds 60 --output calib.jsonl
+    ...
+    python3 zone_calibrate.py build calib.jsonl --grid 4x4 \\
+        --output ../firmware/main/zone_calibration.h
+"""
+
+import sys
+import json
+import time
+import argparse
+from pathlib import Path
+
+# Limits of zone_locator.h
+MAX_LINKS = 8
+MAX_ZONES = 16
+MAX_ENTRIES = 65535
+
+
+def capture(args):
+    """Append the fingerprints printed by the device to a JSONL file"""
+    import serial
+
+    try:
+        ser = serial.Serial(args.port, args.baud, timeout=1)
+    except serial.SerialException as e:
+        print(f"Error opening serial port: {e}")
+        sys.exit(1)
+
+    print(f"Capturing zone {args.zone} for {args.seconds}s from {args.port}...")
+    count = 0
+    end = time.monotonic() + args.seconds
+    with open(args.output, 'a') as out:
+        while time.monotonic() < end:
+            line = ser.readline().decode('utf-8', errors='ignore').strip()
+            if not line.startswith('{"zone_energy"'):
+                continue
+            try:
+                data = json.loads(line)
+            except json.JSONDecodeError:
+                continue
+            out.write(json.dumps({'zone': args.zone, 'energy': data['zone_energy'],
+                                  'macs': data['macs']}) + '\n')
+            count += 1
+    ser.close()
+    print(f"Saved {count} fingerprints to {args.output}")
+
+
+def load_captures(paths, zones):
+    """Fingerprints of all captures, energies in one common link order"""
+    macs = []
+    rows = []
+    for path in paths:
+        with open(path) as f:
+            for line in f:
+                line = line.strip()
+                if not line:
+                    continue
+                rec = json.loads(line)
+                if not 0 <= rec['zone'] < zones:
+                    print(f"Warning: zone {rec['zone']} outside the grid, skipped")
+                    continue
+                # The device learns links in the order it hears them, which
+                # may differ between boots: key energies by MAC
+                by_mac = dict(zip(rec['macs'], rec['energy']))
+                for mac in rec['macs']:
+                    if mac not in macs:
+                        macs.append(mac)
+                rows.append((rec['zone'], by_mac))
+
+    if len(macs) > MAX_LINKS:
+        print(f"Warning: {len(macs)} transmitters heard, keeping the first {MAX_LINKS}")
+        macs = macs[:MAX_LINKS]
+
+    entries = []
+    for zone, by_mac in rows:
+        energy = [int(by_mac.get(mac, 0)) for mac in macs]
+        # Windows without motion carry no position information
+        if any(energy):
+            entries.append([energy, zone, 0])
+    return macs, entries
+
+
+def kd_order(entries, num_links, lo, hi):
+    """Implicit k-d order, same layout as zone_table_index()"""
+    while hi - lo > 0:
+        # Split along the dimension of widest spread
+        dim, widest = 0, -1
+        for d in range(num_links):
+            values = [e[0][d] for e in entries[lo:hi]]
+            if max(values) - min(values) > widest:
+                widest = max(values) - min(values)
+                dim = d
+        entries[lo:hi] = sorted(entries[lo:hi], key=lambda e: e[0][dim])
+        mid = lo + (hi - lo) // 2
+        entries[mid][2] = dim
+        kd_order(entries, num_links, lo, mid)
+        lo = mid + 1
+
+
+def write_header(path, macs, entries, cols, rows, captures):
+    lines = [
+        '/**',
+        ' * @file zone_calibration.h',
+        f' * @brief Zone calibration table ({len(entries)} fingerprints, {cols}x{rows} grid)',
+        ' *',
+        ' * Generated by tools/zone_calibrate.py from ' + ', '.join(captures) + '.',
+        ' * Included by pose_inference.c only.',
+        ' */',
+        '',
+        '#ifndef ZONE_CALIBRATION_H',
+        '#define ZONE_CALIBRATION_H',
+        '',
+        '#include "zone_locator.h"',
+        '',
+        f'#define ZONE_CALIBRATION_COUNT {len(entries)}',
+        f'#define ZONE_CALIBRATION_LINKS {len(macs)}',
+        f'#define ZONE_CALIBRATION_COLS {cols}',
+        f'#define ZONE_CALIBRATION_ROWS {rows}',
+        '',
+        '// Transmitter MAC of each link, in fingerprint order',
+        'static const uint8_t s_zone_calibration_macs[ZONE_MAX_LINKS][6] = {',
+    ]
+    for mac in macs:
+        octets = ', '.join(f'0x{b}' for b in mac.split(':'))
+        lines.append(f'    {{ {octets} }},  // {mac}')
+    lines += [
+        '};',
+        '',
+        '// Fingerprints in k-d order (zone_table_index)',
+        f'static const zone_fingerprint_t s_zone_calibration[{len(entries)}] = {{',
+    ]
+    for energy, zone, split in entries:
+        padded = energy + [0] * (MAX_LINKS - len(energy))
+        lines.append(f'    {{ {{ {", ".join(str(v) for v in padded)} }}, {zone}, {split} }},')
+    lines += [
+        '};',
+        '',
+        '#endif // ZONE_CALIBRATION_H',
+        '',
+    ]
+    Path(path).write_text('\n'.join(lines))
+
+
+def build(args):
+    try:
+        cols, rows = (int(v) for v in args.grid.lower().split('x'))
+    except ValueError:
+        print(f"Invalid grid '{args.grid}', expected COLSxROWS (e.g. 4x4)")
+        sys.exit(1)
+    if cols < 1 or rows < 1 or cols * rows > MAX_ZONES:
+        print(f"Grid must have 1 to {MAX_ZONES} zones")
+        sys.exit(1)
+
+    macs, entries = load_captures(args.captures, cols * rows)
+    if not entries:
+        print("No fingerprints with motion in the captures")
+        sys.exit(1)
+    if len(entries) > MAX_ENTRIES:
+        print(f"Warning: {len(entries)} fingerprints, keeping the first {MAX_ENTRIES}")
+        entries = entries[:MAX_ENTRIES]
+
+    kd_order(entries, len(macs), 0, len(entries))
+    write_header(args.output, macs, entries, cols, rows,
+                 [Path(p).name for p in args.captures])
+
+    counts = [0] * (cols * rows)
+    for _, zone, _ in entries:
+        counts[zone] += 1
+    print(f"Wrote {args.output}: {len(entries)} fingerprints, {len(macs)} links, "
+          f"{len(entries) * (MAX_LINKS + 2)} bytes of flash")
+    for r in range(rows):
+        print('  ' + ' '.join(f'{counts[r * cols + c]:6d}' for c in range(cols)))
+    missing = [z for z, n in enumerate(counts) if n == 0]
+    if missing:
+        print(f"Warning: no fingerprints for zones {missing}; they can never be reported")
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Build the zone localization calibration table')
+    sub = parser.add_subparsers(dest='command', required=True)
+
+    cap = sub.add_parser('capture', help='Capture fingerprints of one zone from the device')
+    cap.add_argument('port', help='Serial port (e.g., /dev/ttyUSB0, COM3)')
+    cap.add_argument('--zone', type=int, required=True, help='Zone index (row-major)')
+    cap.add_argument('--seconds', type=float, default=60.0, help='Capture duration (default: 60)')
+    cap.add_argument('--output', required=True, help='Capture file (JSONL, appended to)')
+    cap.add_argument('-b', '--baud', type=int, default=115200, help='Baud rate (default: 115200)')
+
+    bld = sub.add_parser('build', help='Build zone_calibration.h from captures')
+    bld.add_argument('captures', nargs='+', help='Capture files')
+    bld.add_argument('--grid', default='4x4', help='Zone grid COLSxROWS (default: 4x4)')
+    bld.add_argument('--output', default='zone_calibration.h', help='Header to write')
+
+    args = parser.parse_args()
+    if args.command == 'capture':
+        capture(args)
+    else:
+        build(args)
+
+
+if __name__ == '__main__':
+    main()